@@ -52,6 +52,13 @@ static uint32_t ScanDoneEventCounter = 0;
 //--------------------------------------------------------------------------------------------------
 static char   InterfaceName[LE_WIFIDEFS_MAX_IFNAME_BYTES] = {0};
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Whether the IP address is got by the DHCP client of the WiFi service
+ */
+//--------------------------------------------------------------------------------------------------
+static bool   IsDhcpIntegrated = false;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * IP Handling must be done by the application once the WiFi link is established
@@ -233,10 +240,22 @@ static void WifiClientEventIndHandler
             strncpy(InterfaceName, wifiEventPtr->ifName, LE_WIFIDEFS_MAX_IFNAME_LENGTH);
             InterfaceName[LE_WIFIDEFS_MAX_IFNAME_LENGTH] = '\0';
 
-            AskForIpAddress();
+            // Otherwise LE_WIFICLIENT_EVENT_IP_READY follows
+            if (!IsDhcpIntegrated)
+            {
+                AskForIpAddress();
 
-            TestToPingGooglesDNS();
+                TestToPingGooglesDNS();
+            }
+        }
+        break;
 
+        case LE_WIFICLIENT_EVENT_IP_READY:
+        {
+            // IP address got by the WiFi service
+            LE_DEBUG("LE_WIFICLIENT_EVENT_IP_READY");
+
+            TestToPingGooglesDNS();
         }
         break;
 
@@ -358,6 +377,8 @@ void Testle_wifiClient
     IndHdlrRef = le_wifiClient_AddConnectionEventHandler(WifiClientEventIndHandler, NULL);
     // Add WiFi client event handler (will be deprecated)
     HdlrRef = le_wifiClient_AddNewEventHandler(WifiClientEventHandler, NULL);
+    // Get the IP address from the WiFi service once connected
+    IsDhcpIntegrated = (LE_OK == le_wifiClient_SetDhcp(true));
 
     result = le_wifiClient_Start();
     if (LE_OK == result)
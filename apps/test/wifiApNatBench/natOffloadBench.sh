@@ -0,0 +1,129 @@
+#!/bin/sh
+# Copyright (C) Sierra Wireless Inc.
+#
+# Benchmark of the NAT uplink of the WiFi access point, with and without its fast path.
+#
+# The access point is emulated on the host with network namespaces linked by veth pairs:
+#   client (AP station) <-> router (wlan side | uplink side) <-> server (uplink network)
+# The router gets the rules of the WIFIAP_NAT_START and WIFIAP_NAT_OFFLOAD_START commands of
+# pa_wifi.sh, and the forwarding throughput is measured with iperf3. No reference result is
+# recorded: the gain of the fast path, if any, is the one this script reports on the target.
+#
+# Requires root, iproute2, iptables, nft and iperf3, and a kernel with nf_flow_table.
+#
+# $1: Duration of each measurement in seconds (default 10)
+# $2: Number of parallel streams (default 4)
+
+DURATION=${1:-10}
+STREAMS=${2:-4}
+
+NS_CLIENT=wifiapbench-client
+NS_ROUTER=wifiapbench-router
+NS_SERVER=wifiapbench-server
+# Interfaces of the router standing for the WiFi and uplink interfaces
+IFACE=wlan-bench
+UPLINK=uplink-bench
+NFT_TABLE=wifiap
+
+LAN_ROUTER=192.168.10.1
+LAN_CLIENT=192.168.10.10
+WAN_ROUTER=10.10.0.1
+WAN_SERVER=10.10.0.2
+
+cleanup()
+{
+    # Stop the iperf3 server before its namespace goes away
+    ip netns pids ${NS_SERVER} 2> /dev/null | xargs -r kill
+    ip netns del ${NS_CLIENT} 2> /dev/null
+    ip netns del ${NS_ROUTER} 2> /dev/null
+    ip netns del ${NS_SERVER} 2> /dev/null
+}
+
+fail()
+{
+    echo "ERROR: $1"
+    cleanup
+    exit 1
+}
+
+# Run a command in the router namespace
+router()
+{
+    ip netns exec ${NS_ROUTER} "$@"
+}
+
+# Measure the forwarding throughput from the client to the server, in Mbit/s
+measure()
+{
+    ip netns exec ${NS_CLIENT} iperf3 -c ${WAN_SERVER} -t ${DURATION} -P ${STREAMS} -f m \
+     | grep 'SUM.*receiver' | awk '{ print $6 }'
+}
+
+[ "$(id -u)" = "0" ] || fail "must be run as root"
+for TOOL in ip iptables nft iperf3; do
+    command -v ${TOOL} > /dev/null || fail "${TOOL} not found"
+done
+
+cleanup
+trap cleanup INT TERM
+
+ip netns add ${NS_CLIENT} || fail "unable to create the namespaces"
+ip netns add ${NS_ROUTER}
+ip netns add ${NS_SERVER}
+
+ip link add veth-client netns ${NS_CLIENT} type veth peer name ${IFACE} netns ${NS_ROUTER} \
+ || fail "unable to create the veth pairs"
+ip link add veth-server netns ${NS_SERVER} type veth peer name ${UPLINK} netns ${NS_ROUTER}
+
+ip -n ${NS_CLIENT} addr add ${LAN_CLIENT}/24 dev veth-client
+ip -n ${NS_CLIENT} link set veth-client up
+ip -n ${NS_CLIENT} link set lo up
+ip -n ${NS_CLIENT} route add default via ${LAN_ROUTER}
+
+ip -n ${NS_ROUTER} addr add ${LAN_ROUTER}/24 dev ${IFACE}
+ip -n ${NS_ROUTER} addr add ${WAN_ROUTER}/24 dev ${UPLINK}
+ip -n ${NS_ROUTER} link set ${IFACE} up
+ip -n ${NS_ROUTER} link set ${UPLINK} up
+ip -n ${NS_ROUTER} link set lo up
+
+# The server only knows the uplink network: the client is reachable through NAT only
+ip -n ${NS_SERVER} addr add ${WAN_SERVER}/24 dev veth-server
+ip -n ${NS_SERVER} link set veth-server up
+ip -n ${NS_SERVER} link set lo up
+ip netns exec ${NS_SERVER} iperf3 -s -D || fail "unable to start the iperf3 server"
+
+# WIFIAP_NAT_START
+router sysctl -q -w net.ipv4.ip_forward=1
+router iptables -t nat -I POSTROUTING -o ${UPLINK} -j MASQUERADE || fail "unable to set NAT"
+router iptables -I FORWARD -i ${UPLINK} -o ${IFACE} -m state \
+ --state RELATED,ESTABLISHED -j ACCEPT
+router iptables -I FORWARD -i ${IFACE} -o ${UPLINK} -j ACCEPT
+
+sleep 1
+SLOW_PATH=$(measure)
+[ -n "${SLOW_PATH}" ] || fail "measurement failed on the netfilter path"
+
+# WIFIAP_NAT_OFFLOAD_START
+router nft add table inet ${NFT_TABLE} || fail "nftables not supported"
+router nft add flowtable inet ${NFT_TABLE} ft \
+ "{ hook ingress priority 0; devices = { ${IFACE}, ${UPLINK} }; }" \
+ || fail "flowtables not supported"
+router nft add chain inet ${NFT_TABLE} forward \
+ "{ type filter hook forward priority 0; policy accept; }"
+router nft add rule inet ${NFT_TABLE} forward meta l4proto { tcp, udp } flow add @ft
+
+# Count the offloaded flows while the measurement runs
+( sleep $(( (DURATION + 1) / 2 )); \
+  router grep -c OFFLOAD /proc/net/nf_conntrack > /tmp/wifiapbench-flows 2> /dev/null ) &
+FAST_PATH=$(measure)
+wait
+OFFLOADED_FLOWS=$(cat /tmp/wifiapbench-flows 2> /dev/null)
+rm -f /tmp/wifiapbench-flows
+[ -n "${FAST_PATH}" ] || fail "measurement failed on the fast path"
+
+echo "Streams: ${STREAMS}, duration: ${DURATION} s"
+echo "Netfilter path: ${SLOW_PATH} Mbit/s"
+echo "Fast path:      ${FAST_PATH} Mbit/s, offloaded flows: ${OFFLOADED_FLOWS:-0}"
+
+cleanup
+exit 0
@@ -45,3 +45,59 @@ le_msg_SessionEventHandlerRef_t MyAddServiceCloseHandler
     le_msg_SessionEventHandler_t    handlerFunc,///< [IN] Handler function.
     void*                           contextPtr  ///< [IN] Opaque pointer value to pass to handler.
 );
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a read transaction in the config tree, counting the calls (STUBBED FUNCTION)
+ */
+//--------------------------------------------------------------------------------------------------
+le_cfg_IteratorRef_t MyCfgCreateReadTxn
+(
+    const char *basePath    ///< [IN] Path to the location to create the new iterator.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of read transactions created in the config tree and of items read from secStore.
+ */
+//--------------------------------------------------------------------------------------------------
+extern uint32_t StubCfgReadTxnCount;
+extern uint32_t StubSecStoreReadCount;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Result of the next connection attempts, and BSSID hint given for the last one.
+ */
+//--------------------------------------------------------------------------------------------------
+extern le_result_t StubConnectResult;
+extern char        StubBssidHint[LE_WIFIDEFS_MAX_BSSID_BYTES];
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * SSID of the last network connected to.
+ */
+//--------------------------------------------------------------------------------------------------
+extern char StubConnectedSsid[LE_WIFIDEFS_MAX_SSID_BYTES];
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Clear the access points returned by the next scans (STUBBED FUNCTION)
+ */
+//--------------------------------------------------------------------------------------------------
+void StubClearScanResults
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add an access point to the ones returned by the next scans (STUBBED FUNCTION)
+ */
+//--------------------------------------------------------------------------------------------------
+void StubAddScanResult
+(
+    const char *ssidPtr,    ///< [IN] SSID of the access point.
+    const char *bssidPtr,   ///< [IN] BSSID of the access point.
+    int16_t     signal,     ///< [IN] Signal strength in dBm.
+    uint16_t    frequency   ///< [IN] Channel frequency in MHz.
+);
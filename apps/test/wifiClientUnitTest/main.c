@@ -101,6 +101,7 @@ static void TestWifiClient_CreateDestroy
  * API tested:
  * - le_wifiClient_Create
  * - le_wifiClient_Connect
+ * - le_wifiClient_Roam
  * - le_wifiClient_Disconnect
  */
 //--------------------------------------------------------------------------------------------------
@@ -119,10 +120,323 @@ static void TestWifiClient_ConnectDisconnect
     LE_ASSERT(LE_BAD_PARAMETER == le_wifiClient_Connect(NULL));
     LE_ASSERT(LE_OK == le_wifiClient_Connect(ref));
 
+    // A reference created without scan has no BSSID to roam to
+    LE_ASSERT(LE_BAD_PARAMETER == le_wifiClient_Roam(NULL));
+    LE_ASSERT(LE_BAD_PARAMETER == le_wifiClient_Roam(ref));
+
     LE_ASSERT(LE_OK == le_wifiClient_Disconnect());
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Configure the roaming engine
+ *
+ * API tested:
+ * - le_wifiClient_SetRoamingThreshold
+ * - le_wifiClient_SetRoaming
+ * - le_wifiClient_GetRoamStats
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestWifiClient_Roaming
+(
+    void
+)
+{
+    uint32_t attemptCount, failureCount, lastLatencyMs, avgLatencyMs, maxLatencyMs;
+
+    LE_ASSERT(LE_OUT_OF_RANGE == le_wifiClient_SetRoamingThreshold(-101, 8));
+    LE_ASSERT(LE_OUT_OF_RANGE == le_wifiClient_SetRoamingThreshold(-29, 8));
+    LE_ASSERT(LE_OUT_OF_RANGE == le_wifiClient_SetRoamingThreshold(-75, 31));
+    LE_ASSERT(LE_OK == le_wifiClient_SetRoamingThreshold(-70, 5));
+
+    LE_ASSERT(LE_OK == le_wifiClient_SetRoaming(true));
+    LE_ASSERT(LE_OK == le_wifiClient_SetRoaming(false));
+
+    LE_ASSERT(LE_BAD_PARAMETER == le_wifiClient_GetRoamStats(NULL, &failureCount,
+                                                             &lastLatencyMs, &avgLatencyMs,
+                                                             &maxLatencyMs));
+    LE_ASSERT(LE_OK == le_wifiClient_GetRoamStats(&attemptCount, &failureCount, &lastLatencyMs,
+                                                  &avgLatencyMs, &maxLatencyMs));
+
+    // Rejected roam requests are not accounted
+    LE_ASSERT(0 == attemptCount);
+    LE_ASSERT(0 == failureCount);
+    LE_ASSERT(0 == avgLatencyMs);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Monitor the link quality
+ *
+ * API tested:
+ * - le_wifiClient_GetStationInfo
+ * - le_wifiClient_SetRssiThreshold
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestWifiClient_LinkQuality
+(
+    void
+)
+{
+    int16_t  rssi;
+    uint32_t txBitrate, rxBitrate, txRetries, txFailed, beaconLoss;
+
+    LE_ASSERT(LE_BAD_PARAMETER == le_wifiClient_GetStationInfo(NULL, &txBitrate, &rxBitrate,
+                                                               &txRetries, &txFailed,
+                                                               &beaconLoss));
+    // Not associated
+    LE_ASSERT(LE_NOT_FOUND == le_wifiClient_GetStationInfo(&rssi, &txBitrate, &rxBitrate,
+                                                           &txRetries, &txFailed, &beaconLoss));
+
+    LE_ASSERT(LE_OUT_OF_RANGE == le_wifiClient_SetRssiThreshold(-101, 4));
+    LE_ASSERT(LE_OUT_OF_RANGE == le_wifiClient_SetRssiThreshold(-70, 31));
+    // Not associated: set on the next connection
+    LE_ASSERT(LE_OK == le_wifiClient_SetRssiThreshold(-70, 4));
+    LE_ASSERT(LE_OK == le_wifiClient_SetRssiThreshold(0, 0));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Configure the integrated DHCP client
+ *
+ * API tested:
+ * - le_wifiClient_SetDhcp
+ * - le_wifiClient_GetIpAddress
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestWifiClient_Dhcp
+(
+    void
+)
+{
+    char address[16];
+
+    LE_ASSERT(LE_BAD_PARAMETER == le_wifiClient_GetIpAddress(NULL, sizeof(address)));
+
+    LE_ASSERT(LE_OK == le_wifiClient_SetDhcp(true));
+    // No connection, no lease
+    LE_ASSERT(LE_NOT_FOUND == le_wifiClient_GetIpAddress(address, sizeof(address)));
+    LE_ASSERT(LE_OK == le_wifiClient_SetDhcp(false));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get and select the network interface of the station
+ *
+ * API tested:
+ * - le_wifiClient_GetInterfaceName
+ * - le_wifiClient_SetInterface
+ * - le_wifiClient_GetInterfaces
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestWifiClient_InterfaceName
+(
+    void
+)
+{
+    char                          ifName[LE_WIFIDEFS_MAX_IFNAME_BYTES];
+    le_wifiClient_InterfaceInfo_t interfaces[4];
+    size_t                        numInterfaces = NUM_ARRAY_MEMBERS(interfaces);
+
+    LE_ASSERT(LE_BAD_PARAMETER == le_wifiClient_GetInterfaceName(NULL, sizeof(ifName)));
+    LE_ASSERT(LE_OVERFLOW == le_wifiClient_GetInterfaceName(ifName, 2));
+    LE_ASSERT(LE_OK == le_wifiClient_GetInterfaceName(ifName, sizeof(ifName)));
+    LE_ASSERT('\0' != ifName[0]);
+
+    LE_ASSERT(LE_OK == le_wifiClient_GetInterfaces(interfaces, &numInterfaces));
+    LE_ASSERT(1 <= numInterfaces);
+    LE_ASSERT(LE_BAD_PARAMETER == le_wifiClient_SetInterface(""));
+    LE_ASSERT(LE_OK == le_wifiClient_SetInterface(interfaces[0].ifName));
+    // The interface is kept while the client is started
+    LE_ASSERT(LE_OK == le_wifiClient_Start());
+    LE_ASSERT(LE_BUSY == le_wifiClient_SetInterface(interfaces[0].ifName));
+    LE_ASSERT(LE_OK == le_wifiClient_Stop());
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Select the best access point of an SSID
+ *
+ * API tested:
+ * - le_wifiClient_GetBestAccessPoint
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestWifiClient_BestAccessPoint
+(
+    void
+)
+{
+    const uint8_t ssid[] = "NotInRange";
+    le_wifiClient_AccessPointRef_t apRef = NULL;
+
+    LE_ASSERT(LE_BAD_PARAMETER == le_wifiClient_GetBestAccessPoint(NULL, 0, &apRef));
+    LE_ASSERT(LE_BAD_PARAMETER == le_wifiClient_GetBestAccessPoint(ssid, sizeof(ssid) - 1,
+                                                                    NULL));
+    // Created but not found in a scan
+    LE_ASSERT(NULL != le_wifiClient_Create(ssid, sizeof(ssid) - 1));
+    LE_ASSERT(LE_NOT_FOUND == le_wifiClient_GetBestAccessPoint(ssid, sizeof(ssid) - 1, &apRef));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Configure the auto-reconnect
+ *
+ * API tested:
+ * - le_wifiClient_SetAutoReconnect
+ * - le_wifiClient_SetSsidPriority
+ * - le_wifiClient_GetReconnectStats
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestWifiClient_AutoReconnect
+(
+    void
+)
+{
+    const uint8_t ssid[] = "Example";
+    size_t ssidNumElements = sizeof(ssid) - 1;
+    le_wifiClient_AccessPointRef_t ref;
+    uint32_t attemptCount, recoveryCount, lastRecoveryMs, maxRecoveryMs;
+
+    ref = le_wifiClient_Create(ssid, ssidNumElements);
+    LE_ASSERT(NULL != ref);
+
+    LE_ASSERT(LE_BAD_PARAMETER == le_wifiClient_SetAutoReconnect(NULL, true));
+    LE_ASSERT(LE_OK == le_wifiClient_SetAutoReconnect(ref, true));
+    LE_ASSERT(LE_OK == le_wifiClient_SetAutoReconnect(ref, false));
+
+    LE_ASSERT(LE_BAD_PARAMETER == le_wifiClient_SetSsidPriority(NULL, ssidNumElements, 1));
+    LE_ASSERT(LE_BAD_PARAMETER == le_wifiClient_SetSsidPriority(ssid, 0, 1));
+    LE_ASSERT(LE_OK == le_wifiClient_SetSsidPriority(ssid, ssidNumElements, 1));
+
+    LE_ASSERT(LE_BAD_PARAMETER == le_wifiClient_GetReconnectStats(NULL, &recoveryCount,
+                                                                  &lastRecoveryMs,
+                                                                  &maxRecoveryMs));
+    LE_ASSERT(LE_OK == le_wifiClient_GetReconnectStats(&attemptCount, &recoveryCount,
+                                                       &lastRecoveryMs, &maxRecoveryMs));
+
+    // No connection has been lost
+    LE_ASSERT(0 == attemptCount);
+    LE_ASSERT(0 == recoveryCount);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Connect to the best known network
+ *
+ * API tested:
+ * - le_wifiClient_ConnectKnownNetwork
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestWifiClient_ConnectKnownNetwork
+(
+    void
+)
+{
+    le_wifiClient_AccessPointRef_t ref = NULL;
+
+    LE_ASSERT(LE_BAD_PARAMETER == le_wifiClient_ConnectKnownNetwork(NULL));
+
+    // No scan has been done
+    LE_ASSERT(LE_NOT_FOUND == le_wifiClient_ConnectKnownNetwork(&ref));
+    LE_ASSERT(NULL == ref);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the phase timing of the last connection attempts
+ *
+ * API tested:
+ * - le_wifiClient_GetConnectTiming
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestWifiClient_ConnectTiming
+(
+    void
+)
+{
+    le_result_t result;
+    uint32_t configMs, supplicantMs, authMs, assocMs, handshakeMs, dhcpMs, totalMs;
+
+    LE_ASSERT(LE_BAD_PARAMETER == le_wifiClient_GetConnectTiming(0, NULL, &configMs,
+                                                                  &supplicantMs, &authMs,
+                                                                  &assocMs, &handshakeMs,
+                                                                  &dhcpMs, &totalMs));
+
+    // TestWifiClient_ConnectDisconnect() made a connection attempt
+    LE_ASSERT(LE_OK == le_wifiClient_GetConnectTiming(0, &result, &configMs, &supplicantMs,
+                                                      &authMs, &assocMs, &handshakeMs,
+                                                      &dhcpMs, &totalMs));
+    LE_ASSERT(LE_OK == result);
+    LE_ASSERT(0 == dhcpMs);
+
+    LE_ASSERT(LE_NOT_FOUND == le_wifiClient_GetConnectTiming(UINT32_MAX, &result, &configMs,
+                                                             &supplicantMs, &authMs, &assocMs,
+                                                             &handshakeMs, &dhcpMs, &totalMs));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Import SSID profiles from a file
+ *
+ * API tested:
+ * - le_wifiClient_ImportProfiles
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestWifiClient_ImportProfiles
+(
+    void
+)
+{
+    const char validProfiles[] =
+        "# SSID\tprotocol\tsecret\tpassword\n"
+        "Open\t0\n"
+        "\n"
+        "Home\t3\tmySecret\n"
+        "Office\t5\tmyName\tmySecret\n";
+    const char invalidProfiles[] =
+        "Home\t3\tmySecret\n"
+        "Short\t3\tsecret\n";
+    char path[] = "/tmp/wifiProfilesXXXXXX";
+    uint32_t count;
+    int fd;
+
+    LE_ASSERT(LE_BAD_PARAMETER == le_wifiClient_ImportProfiles(-1, &count));
+
+    // The service closes the descriptor it is given, as the one received through IPC: it gets a
+    // duplicate so that the test closes its own
+    fd = mkstemp(path);
+    LE_ASSERT(fd >= 0);
+    LE_ASSERT(sizeof(validProfiles) - 1 == write(fd, validProfiles, sizeof(validProfiles) - 1));
+    LE_ASSERT(0 == lseek(fd, 0, SEEK_SET));
+    LE_ASSERT(LE_OK == le_wifiClient_ImportProfiles(dup(fd), &count));
+    LE_ASSERT(3 == count);
+    close(fd);
+
+    // Too short passphrase at line 2
+    fd = open(path, O_WRONLY | O_TRUNC);
+    LE_ASSERT(fd >= 0);
+    LE_ASSERT(sizeof(invalidProfiles) - 1 == write(fd, invalidProfiles,
+                                                   sizeof(invalidProfiles) - 1));
+    close(fd);
+    fd = open(path, O_RDONLY);
+    LE_ASSERT(fd >= 0);
+    LE_ASSERT(LE_FORMAT_ERROR == le_wifiClient_ImportProfiles(dup(fd), &count));
+    LE_ASSERT(2 == count);
+    close(fd);
+
+    unlink(path);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Configure a WIFI client reference
@@ -195,6 +509,220 @@ static void TestWifiClient_Configure
     LE_ASSERT(LE_OK == le_wifiClient_SetHiddenNetworkAttribute(ref, false));
     LE_ASSERT(LE_OK == le_wifiClient_SetHiddenNetworkAttribute(ref, true));
 
+    // Setting the fast BSS transition attribute
+    LE_ASSERT(LE_BAD_PARAMETER == le_wifiClient_SetFastTransition(NULL, true));
+    LE_ASSERT(LE_OK == le_wifiClient_SetFastTransition(ref, true));
+    LE_ASSERT(LE_OK == le_wifiClient_SetFastTransition(ref, false));
+
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Access points of the selection test, and size of the connection history of the service.
+ */
+//--------------------------------------------------------------------------------------------------
+#define TEST_BSSID_2G_WEAK      "00:11:22:33:44:01"
+#define TEST_BSSID_2G_STRONG    "00:11:22:33:44:02"
+#define TEST_BSSID_5G           "00:11:22:33:44:03"
+#define TEST_BSSID_5G_FAR       "00:11:22:33:44:04"
+#define TEST_BSS_HISTORY_MAX    32
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Scan the access points set into the PA stub, and wait for the end of the scan.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ScanAccessPoints
+(
+    void
+)
+{
+    const uint8_t                  probe[] = "Probe";
+    le_wifiClient_AccessPointRef_t apRef;
+    int                            i;
+
+    LE_ASSERT(LE_OK == le_wifiClient_Scan());
+    for (i = 0; (i < 500) &&
+                (LE_BUSY == le_wifiClient_GetBestAccessPoint(probe, sizeof(probe) - 1, &apRef));
+         i++)
+    {
+        usleep(10000);
+    }
+    LE_ASSERT(i < 500);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Find an access point of the latest scan by its BSSID.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_wifiClient_AccessPointRef_t FindAccessPoint
+(
+    const char *bssidPtr
+)
+{
+    le_wifiClient_AccessPointRef_t apRef;
+    char                           bssid[LE_WIFIDEFS_MAX_BSSID_BYTES];
+
+    for (apRef = le_wifiClient_GetFirstAccessPoint(); NULL != apRef;
+         apRef = le_wifiClient_GetNextAccessPoint())
+    {
+        LE_ASSERT(LE_OK == le_wifiClient_GetBssid(apRef, bssid, sizeof(bssid)));
+        if (0 == strcmp(bssid, bssidPtr))
+        {
+            return apRef;
+        }
+    }
+    LE_FATAL("Access point %s not found", bssidPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check the best access point of an SSID.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CheckBestAccessPoint
+(
+    const char *ssidPtr,
+    const char *bssidPtr
+)
+{
+    le_wifiClient_AccessPointRef_t apRef = NULL;
+    char                           bssid[LE_WIFIDEFS_MAX_BSSID_BYTES];
+
+    LE_ASSERT(LE_OK == le_wifiClient_GetBestAccessPoint((const uint8_t *)ssidPtr,
+                                                        strlen(ssidPtr), &apRef));
+    LE_ASSERT(LE_OK == le_wifiClient_GetBssid(apRef, bssid, sizeof(bssid)));
+    LE_ASSERT(0 == strcmp(bssid, bssidPtr));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Scan the access points of the SSID used by the selection test.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ScanSelectionAccessPoints
+(
+    const char *ssidPtr
+)
+{
+    StubClearScanResults();
+    StubAddScanResult(ssidPtr, TEST_BSSID_2G_WEAK, -60, 2412);
+    StubAddScanResult(ssidPtr, TEST_BSSID_2G_STRONG, -50, 2437);
+    StubAddScanResult(ssidPtr, TEST_BSSID_5G, -55, 5180);
+    ScanAccessPoints();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Rank the access points of an SSID found in a scan and steer the connection to the best one
+ *
+ * API tested:
+ * - le_wifiClient_Scan
+ * - le_wifiClient_GetBestAccessPoint
+ * - le_wifiClient_Connect
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestWifiClient_SelectAccessPoint
+(
+    void
+)
+{
+    const char ssid[] = "Selection";
+    char       bssid[LE_WIFIDEFS_MAX_BSSID_BYTES];
+    int        i;
+
+    // The 5 GHz bonus outweighs a slightly stronger 2.4 GHz signal
+    ScanSelectionAccessPoints(ssid);
+    CheckBestAccessPoint(ssid, TEST_BSSID_5G);
+
+    // The connection is steered to the best access point, whatever the one requested
+    StubConnectResult = LE_FAULT;
+    LE_ASSERT(LE_FAULT == le_wifiClient_Connect(FindAccessPoint(TEST_BSSID_2G_WEAK)));
+    LE_ASSERT(0 == strcmp(StubBssidHint, TEST_BSSID_5G));
+    StubConnectResult = LE_OK;
+
+    // The failed attempt is penalized, then the strongest signal wins
+    CheckBestAccessPoint(ssid, TEST_BSSID_2G_STRONG);
+    LE_ASSERT(LE_OK == le_wifiClient_Connect(FindAccessPoint(TEST_BSSID_2G_WEAK)));
+    LE_ASSERT(0 == strcmp(StubBssidHint, TEST_BSSID_2G_STRONG));
+
+    // No 5 GHz bonus when the signal is too weak
+    StubClearScanResults();
+    StubAddScanResult(ssid, TEST_BSSID_2G_WEAK, -65, 2412);
+    StubAddScanResult(ssid, TEST_BSSID_5G_FAR, -72, 5180);
+    ScanAccessPoints();
+    CheckBestAccessPoint(ssid, TEST_BSSID_2G_WEAK);
+
+    // Fill the connection history with other access points: the failure is kept while there is
+    // room for it, then its entry is the least recently used one and is evicted first
+    for (i = 0; i < (TEST_BSS_HISTORY_MAX - 1); i++)
+    {
+        snprintf(bssid, sizeof(bssid), "00:11:22:33:55:%02x", i);
+        StubClearScanResults();
+        StubAddScanResult("Filler", bssid, -40, 2412);
+        ScanAccessPoints();
+        LE_ASSERT(LE_OK == le_wifiClient_Connect(FindAccessPoint(bssid)));
+        LE_ASSERT(0 == strcmp(StubBssidHint, bssid));
+
+        if ((TEST_BSS_HISTORY_MAX - 3) == i)
+        {
+            ScanSelectionAccessPoints(ssid);
+            CheckBestAccessPoint(ssid, TEST_BSSID_2G_STRONG);
+        }
+    }
+    ScanSelectionAccessPoints(ssid);
+    CheckBestAccessPoint(ssid, TEST_BSSID_5G);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Connect to the known network in range with the highest priority, whatever its signal strength
+ *
+ * API tested:
+ * - le_wifiClient_SetSsidPriority
+ * - le_wifiClient_ConnectKnownNetwork
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestWifiClient_ConnectKnownNetworkPriority
+(
+    void
+)
+{
+    const uint8_t                  preferred[] = "Preferred";
+    const uint8_t                  other[] = "Other";
+    const uint8_t                  secret[] = "mySecret";
+    le_wifiClient_AccessPointRef_t apRef = NULL;
+    uint8_t                        ssid[LE_WIFIDEFS_MAX_SSID_BYTES] = {0};
+    size_t                         ssidLength = sizeof(ssid);
+
+    LE_ASSERT(LE_OK == le_wifiClient_ConfigurePsk(preferred, sizeof(preferred) - 1,
+                                                  LE_WIFICLIENT_SECURITY_WPA2_PSK_PERSONAL,
+                                                  secret, sizeof(secret) - 1, NULL, 0));
+    LE_ASSERT(LE_OK == le_wifiClient_SetSsidPriority(preferred, sizeof(preferred) - 1, 5));
+    LE_ASSERT(LE_OK == le_wifiClient_ConfigurePsk(other, sizeof(other) - 1,
+                                                  LE_WIFICLIENT_SECURITY_WPA2_PSK_PERSONAL,
+                                                  secret, sizeof(secret) - 1, NULL, 0));
+    LE_ASSERT(LE_OK == le_wifiClient_SetSsidPriority(other, sizeof(other) - 1, 1));
+
+    // The SSID with the lower priority has the stronger signal
+    StubClearScanResults();
+    StubAddScanResult((const char *)preferred, TEST_BSSID_2G_WEAK, -75, 2412);
+    StubAddScanResult((const char *)other, TEST_BSSID_2G_STRONG, -40, 2437);
+    ScanAccessPoints();
+
+    StubConnectedSsid[0] = '\0';
+    LE_ASSERT(LE_OK == le_wifiClient_ConnectKnownNetwork(&apRef));
+    LE_ASSERT(0 == strcmp(StubConnectedSsid, (const char *)preferred));
+    LE_ASSERT(LE_OK == le_wifiClient_GetSsid(apRef, ssid, &ssidLength));
+    LE_ASSERT((sizeof(preferred) - 1 == ssidLength) &&
+              (0 == memcmp(ssid, preferred, ssidLength)));
+
+    LE_ASSERT(LE_OK == le_wifiClient_Disconnect());
+    LE_ASSERT(LE_OK == le_wifiClient_RemoveSsidSecurityConfigs(preferred, sizeof(preferred) - 1));
+    LE_ASSERT(LE_OK == le_wifiClient_RemoveSsidSecurityConfigs(other, sizeof(other) - 1));
 }
 
 
@@ -220,6 +748,9 @@ static void TestWifiClient_LoadSsid
     const uint8_t secret[] = "mySecret";
     le_result_t ret;
     le_wifiClient_AccessPointRef_t ref;
+    uint32_t cfgReadTxnCount;
+    uint32_t secStoreReadCount;
+    int i;
 
     // Test le_wifiClient_LoadSsid() with WEP
     LE_INFO("Test Wifi's config setting & loading of WEP");
@@ -289,6 +820,33 @@ static void TestWifiClient_LoadSsid
     }
     LE_ASSERT(ret == LE_OK);
 
+    // Test le_wifiClient_LoadSsid() again, from the profile cache: neither the config tree nor
+    // secStore is read
+    LE_INFO("Test Wifi's loading of a cached profile");
+    cfgReadTxnCount = StubCfgReadTxnCount;
+    secStoreReadCount = StubSecStoreReadCount;
+    for (i = 0; i < 3; i++)
+    {
+        ret = le_wifiClient_LoadSsid(ssid, sizeof(ssid), &ref);
+        LE_ASSERT(ret == LE_OK);
+        LE_ASSERT(ref != NULL);
+        le_wifiClient_Delete(ref);
+        ref = NULL;
+    }
+    LE_ASSERT(StubCfgReadTxnCount == cfgReadTxnCount);
+    LE_ASSERT(StubSecStoreReadCount == secStoreReadCount);
+
+    // A new configuration of the SSID is read again
+    ret = le_wifiClient_ConfigurePsk(ssid, sizeof(ssid), LE_WIFICLIENT_SECURITY_WPA2_PSK_PERSONAL,
+                                     NULL, 0, secret, sizeof(secret));
+    LE_ASSERT(ret == LE_OK);
+    ret = le_wifiClient_LoadSsid(ssid, sizeof(ssid), &ref);
+    LE_ASSERT(ret == LE_OK);
+    le_wifiClient_Delete(ref);
+    ref = NULL;
+    LE_ASSERT(StubCfgReadTxnCount == cfgReadTxnCount + 1);
+    LE_ASSERT(StubSecStoreReadCount > secStoreReadCount);
+
     // Test le_wifiClient_LoadSsid() with WPA EAP
     LE_INFO("Test Wifi's config setting & loading of WPA EAP");
     ret = le_wifiClient_ConfigureEap(ssid, sizeof(ssid),
@@ -440,10 +998,30 @@ COMPONENT_INIT
 
     TestWifiClient_ConnectDisconnect();
 
+    TestWifiClient_Roaming();
+
+    TestWifiClient_LinkQuality();
+
+    TestWifiClient_Dhcp();
+    TestWifiClient_InterfaceName();
+    TestWifiClient_BestAccessPoint();
+
+    TestWifiClient_AutoReconnect();
+
+    TestWifiClient_ConnectKnownNetwork();
+
+    TestWifiClient_ConnectTiming();
+
+    TestWifiClient_ImportProfiles();
+
     TestWifiClient_Configure();
 
     TestWifiClient_LoadSsid();
 
+    TestWifiClient_SelectAccessPoint();
+
+    TestWifiClient_ConnectKnownNetworkPriority();
+
     TestWifiClient_ConfigureSecurity_NegTests();
 
     LE_INFO ("======== UnitTest of WiFi client SUCCESS ========");
@@ -55,8 +55,96 @@ typedef struct
     uint8_t  ssidLength;                            ///< The number of bytes in the ssidBytes.
     uint8_t  ssidBytes[LE_WIFIDEFS_MAX_SSID_BYTES]; ///< Contains ssidLength number of bytes.
     char     bssid[LE_WIFIDEFS_MAX_BSSID_BYTES];    ///< Contains the bssid.
+    uint16_t frequency;                             ///< Channel frequency in MHz, 0 if not found.
 } pa_wifiClient_AccessPoint_t;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Access points returned by the next scans.
+ */
+//--------------------------------------------------------------------------------------------------
+#define STUB_SCAN_RESULT_MAX    8
+static pa_wifiClient_AccessPoint_t StubScanResults[STUB_SCAN_RESULT_MAX];
+static size_t                      StubScanResultCount = 0;
+static size_t                      StubScanResultIndex = 0;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Result of the next connection attempts, and BSSID hint given for the last one.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t StubConnectResult = LE_OK;
+char        StubBssidHint[LE_WIFIDEFS_MAX_BSSID_BYTES] = "";
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * SSID of the last network connected to, and network with the highest priority among those added
+ * for the next pa_wifiClient_ConnectNetworks().
+ */
+//--------------------------------------------------------------------------------------------------
+char           StubConnectedSsid[LE_WIFIDEFS_MAX_SSID_BYTES] = "";
+static char    StubBestNetwork[LE_WIFIDEFS_MAX_SSID_BYTES] = "";
+static int32_t StubBestNetworkPriority = 0;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Duration of the phases of a connection attempt.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_result_t result;         ///< Result of the connection attempt.
+    uint32_t    configMs;       ///< wpa_supplicant configuration generation.
+    uint32_t    supplicantMs;   ///< wpa_supplicant start.
+    uint32_t    authMs;         ///< IEEE 802.11 authentication, including the scan.
+    uint32_t    assocMs;        ///< IEEE 802.11 association.
+    uint32_t    handshakeMs;    ///< 4-way handshake or EAP completion.
+    uint32_t    totalMs;        ///< Whole connection attempt.
+} pa_wifiClient_ConnectTiming_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Live statistics of the link with the associated access point.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    int16_t  signal;        ///< Signal strength in dBm.
+    uint32_t txBitrate;     ///< Bitrate of the last frame sent, in kbit/s.
+    uint32_t rxBitrate;     ///< Bitrate of the last frame received, in kbit/s.
+    uint32_t txRetries;     ///< Number of retried transmissions.
+    uint32_t txFailed;      ///< Number of failed transmissions.
+    uint32_t beaconLoss;    ///< Number of beacon loss events.
+} pa_wifiClient_StationInfo_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * DHCP client state from which a lease is requested.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    PA_WIFICLIENT_DHCP_DISCOVER,    ///< Full DISCOVER/OFFER/REQUEST/ACK exchange.
+    PA_WIFICLIENT_DHCP_INIT_REBOOT, ///< REQUEST of the address of a cached lease.
+    PA_WIFICLIENT_DHCP_RENEW        ///< REQUEST extending the lease in use.
+}
+pa_wifiClient_DhcpRequest_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * DHCP lease.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t address;       ///< Address leased.
+    uint32_t netmask;       ///< Subnet mask.
+    uint32_t gateway;       ///< Default router.
+    uint32_t dns;           ///< DNS server.
+    uint32_t server;        ///< DHCP server identifier.
+    uint32_t leaseTime;     ///< Lease duration in seconds.
+} pa_wifiClient_DhcpLease_t;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Struct to hold the AccessPoint from the Scan's data.
@@ -135,6 +223,96 @@ le_result_t pa_wifiClient_Connect
         ///< The number of Bytes in the ssidBytes
 )
 {
+    if (LE_OK == StubConnectResult)
+    {
+        memset(StubConnectedSsid, 0, sizeof(StubConnectedSsid));
+        memcpy(StubConnectedSsid, ssidBytes,
+               (ssidLength < sizeof(StubConnectedSsid)) ? ssidLength :
+                                                          (sizeof(StubConnectedSsid) - 1));
+    }
+    return StubConnectResult;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function adds a network to the ones pa_wifiClient_ConnectNetworks() will connect to.
+ *
+ * @return LE_BAD_PARAMETER  Invalid parameter.
+ * @return LE_OK             The function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiClient_AddNetwork
+(
+    const uint8_t *ssidPtr,
+        ///< [IN]
+        ///< The SSID as an octet array.
+
+    size_t ssidNumElements,
+        ///< [IN]
+        ///< The length of the SSID in octets.
+
+    int32_t priority
+        ///< [IN]
+        ///< wpa_supplicant priority of the network, the highest is selected first.
+)
+{
+    if (NULL == ssidPtr)
+    {
+        return LE_BAD_PARAMETER;
+    }
+
+    if (('\0' == StubBestNetwork[0]) || (priority > StubBestNetworkPriority))
+    {
+        memset(StubBestNetwork, 0, sizeof(StubBestNetwork));
+        memcpy(StubBestNetwork, ssidPtr, (ssidNumElements < sizeof(StubBestNetwork)) ?
+                                         ssidNumElements : (sizeof(StubBestNetwork) - 1));
+        StubBestNetworkPriority = priority;
+    }
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function connects a wifiClient to the best of the networks added.
+ *
+ * @return LE_FAULT  The function failed.
+ * @return LE_OK     The function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiClient_ConnectNetworks
+(
+    void
+)
+{
+    if (LE_OK == StubConnectResult)
+    {
+        le_utf8_Copy(StubConnectedSsid, StubBestNetwork, sizeof(StubConnectedSsid), NULL);
+    }
+    StubBestNetwork[0] = '\0';
+    return StubConnectResult;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function gets the duration of the phases of the last connection attempt.
+ *
+ * @return LE_BAD_PARAMETER  Invalid parameter.
+ * @return LE_OK             The function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiClient_GetConnectTiming
+(
+    pa_wifiClient_ConnectTiming_t *timingPtr
+        ///< [OUT]
+        ///< Duration of the phases of the last connection attempt.
+)
+{
+    if (NULL == timingPtr)
+    {
+        return LE_BAD_PARAMETER;
+    }
+    memset(timingPtr, 0, sizeof(*timingPtr));
+    timingPtr->result = LE_OK;
     return LE_OK;
 }
 
@@ -296,6 +474,247 @@ void pa_wifiClient_SetHiddenNetworkAttribute
 {
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function specifies whether IEEE 802.11r fast BSS transition (FT-PSK or FT-EAP key
+ * management) is to be negotiated with the target Access Point.
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_wifiClient_SetFastTransition
+(
+    bool enable
+        ///< [IN]
+        ///< If TRUE, fast BSS transition is negotiated with the access point.
+)
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function sets the access point preferred for the initial association with the next network
+ * configured.
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_wifiClient_SetBssidHint
+(
+    const char *bssidPtr
+        ///< [IN]
+        ///< BSSID of the preferred access point, NULL or empty for none.
+)
+{
+    le_utf8_Copy(StubBssidHint, (NULL != bssidPtr) ? bssidPtr : "", sizeof(StubBssidHint), NULL);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function makes the connected wifiClient reassociate with another BSS of the same ESS.
+ *
+ * @return LE_BAD_PARAMETER  Invalid parameter.
+ * @return LE_OK             The function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiClient_Roam
+(
+    const char *bssidPtr
+        ///< [IN]
+        ///< BSSID of the target access point
+)
+{
+    return (NULL != bssidPtr) ? LE_OK : LE_BAD_PARAMETER;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function gets the BSSID and the signal strength of the BSS the wifiClient is currently
+ * associated with.
+ *
+ * @return LE_NOT_FOUND      The wifiClient is not associated.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiClient_GetLinkSignal
+(
+    char *bssidPtr,
+        ///< [OUT]
+        ///< BSSID of the associated access point
+    size_t bssidSize,
+        ///< [IN]
+        ///< Size of the BSSID buffer
+    int16_t *signalPtr
+        ///< [OUT]
+        ///< Signal strength in dBm
+)
+{
+    return LE_NOT_FOUND;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function gets the live statistics of the link with the associated access point.
+ *
+ * @return LE_NOT_FOUND      The wifiClient is not associated.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiClient_GetStationInfo
+(
+    pa_wifiClient_StationInfo_t *infoPtr
+        ///< [OUT]
+        ///< Statistics of the link
+)
+{
+    return LE_NOT_FOUND;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function sets the connection quality monitor signal threshold. As the driver, it fails
+ * since the station is never associated in the unit test.
+ *
+ * @return LE_FAULT          The function failed.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiClient_SetRssiThreshold
+(
+    int16_t threshold,
+        ///< [IN]
+        ///< Signal strength threshold in dBm, 0 to disable the monitoring
+    uint8_t hysteresis
+        ///< [IN]
+        ///< Hysteresis in dB around the threshold
+)
+{
+    return LE_FAULT;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Select the network interface of the station.
+ *
+ * @return LE_BAD_PARAMETER  Invalid interface name.
+ * @return LE_OK             The function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiClient_SetInterface
+(
+    const char *ifNamePtr
+        ///< [IN]
+        ///< Network interface of the station
+)
+{
+    if ((NULL == ifNamePtr) || ('\0' == ifNamePtr[0]))
+    {
+        return LE_BAD_PARAMETER;
+    }
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the network interface of the station.
+ *
+ * @return LE_OVERFLOW       The buffer is too small.
+ * @return LE_OK             The function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiClient_GetInterface
+(
+    char   *ifNamePtr,
+        ///< [OUT]
+        ///< Network interface of the station
+    size_t  ifNameSize
+        ///< [IN]
+        ///< Size of the interface name buffer
+)
+{
+    return le_utf8_Copy(ifNamePtr, "wlan0", ifNameSize, NULL);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the WiFi interfaces of all the radios of the module.
+ *
+ * @return LE_OK             The function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiClient_GetInterfaces
+(
+    le_wifiClient_InterfaceInfo_t *interfacesPtr,
+        ///< [OUT]
+        ///< WiFi interfaces and their radio
+    size_t *numInterfacesPtr
+        ///< [INOUT]
+        ///< In: size of the interfaces array. Out: number of interfaces returned.
+)
+{
+    if (*numInterfacesPtr > 0)
+    {
+        le_utf8_Copy(interfacesPtr[0].ifName, "wlan0", sizeof(interfacesPtr[0].ifName), NULL);
+        interfacesPtr[0].phyIndex = 0;
+        *numInterfacesPtr = 1;
+    }
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function gets a DHCP lease on the given interface.
+ *
+ * @return LE_BAD_PARAMETER  Invalid parameter.
+ * @return LE_TIMEOUT        No answer from a DHCP server.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiClient_RequestLease
+(
+    const char *ifNamePtr,
+        ///< [IN]
+        ///< WLAN interface name
+    pa_wifiClient_DhcpRequest_t request,
+        ///< [IN]
+        ///< State from which the lease is requested
+    pa_wifiClient_DhcpLease_t *leasePtr
+        ///< [IN/OUT]
+        ///< Lease to request again, then lease granted
+)
+{
+    return ((NULL == ifNamePtr) || (NULL == leasePtr)) ? LE_BAD_PARAMETER : LE_TIMEOUT;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function sets the address, default route and DNS server of a DHCP lease.
+ *
+ * @return LE_OK             The function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiClient_SetIpConfig
+(
+    const char *ifNamePtr,
+        ///< [IN]
+        ///< WLAN interface name
+    const pa_wifiClient_DhcpLease_t *leasePtr
+        ///< [IN]
+        ///< Lease granted by the DHCP server
+)
+{
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function removes the address and default route set by pa_wifiClient_SetIpConfig().
+ *
+ * @return LE_OK             The function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiClient_ClearIpConfig
+(
+    const char *ifNamePtr
+        ///< [IN]
+        ///< WLAN interface name
+)
+{
+    return LE_OK;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This function must be called after the pa_wifiClient_Scan() has been done.
@@ -330,9 +749,32 @@ le_result_t pa_wifiClient_Scan
     void
 )
 {
+    StubScanResultIndex = 0;
     return LE_OK;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function starts a scan directed to the given SSID.
+ *
+ * @return LE_BAD_PARAMETER  Invalid parameter.
+ * @return LE_OK             The function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiClient_ScanSsid
+(
+    const uint8_t *ssidPtr,
+        ///< [IN]
+        ///< SSID to probe
+    size_t ssidNumElements
+        ///< [IN]
+        ///< The number of bytes in the SSID
+)
+{
+    StubScanResultIndex = 0;
+    return (NULL != ssidPtr) ? LE_OK : LE_BAD_PARAMETER;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This function can be called after pa_wifi_Scan.
@@ -346,15 +788,63 @@ le_result_t pa_wifiClient_Scan
 //--------------------------------------------------------------------------------------------------
 le_result_t pa_wifiClient_GetScanResult
 (
-    pa_wifiClient_AccessPoint_t *accessPointPtr
+    pa_wifiClient_AccessPoint_t *accessPointPtr,
     ///< [IN][OUT]
     ///< Structure provided by calling function.
     ///< Results filled out if result was LE_OK.
+    char scanIfName[]
+    ///< [IN][OUT]
+    ///< Array provided by calling function.
+    ///< Store WLAN interface used for scan.
 )
 {
+    if (StubScanResultIndex >= StubScanResultCount)
+    {
+        return LE_NOT_FOUND;
+    }
+    *accessPointPtr = StubScanResults[StubScanResultIndex++];
+    strcpy(scanIfName, "wlan0");
     return LE_OK;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Clear the access points returned by the next scans.
+ */
+//--------------------------------------------------------------------------------------------------
+void StubClearScanResults
+(
+    void
+)
+{
+    memset(StubScanResults, 0, sizeof(StubScanResults));
+    StubScanResultCount = 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add an access point to the ones returned by the next scans.
+ */
+//--------------------------------------------------------------------------------------------------
+void StubAddScanResult
+(
+    const char *ssidPtr,    ///< [IN] SSID of the access point.
+    const char *bssidPtr,   ///< [IN] BSSID of the access point.
+    int16_t     signal,     ///< [IN] Signal strength in dBm.
+    uint16_t    frequency   ///< [IN] Channel frequency in MHz.
+)
+{
+    pa_wifiClient_AccessPoint_t *apPtr;
+
+    LE_ASSERT(StubScanResultCount < STUB_SCAN_RESULT_MAX);
+    apPtr = &StubScanResults[StubScanResultCount++];
+    apPtr->signalStrength = signal;
+    apPtr->ssidLength = strlen(ssidPtr);
+    memcpy(apPtr->ssidBytes, ssidPtr, apPtr->ssidLength);
+    le_utf8_Copy(apPtr->bssid, bssidPtr, sizeof(apPtr->bssid), NULL);
+    apPtr->frequency = frequency;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Set the WEP key (Wired Equivalent Privacy)
@@ -507,10 +997,54 @@ le_msg_SessionEventHandlerRef_t MyAddServiceCloseHandler
     return NULL;
 }
 
+//--------------------------------------------------------------------------------------------------
+// Config tree service stubbing
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of read transactions created in the config tree.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t StubCfgReadTxnCount = 0;
+
+#undef le_cfg_CreateReadTxn
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Config tree function renamed by the build flags of the component.
+ */
+//--------------------------------------------------------------------------------------------------
+le_cfg_IteratorRef_t le_cfg_CreateReadTxn
+(
+    const char *basePath
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a read transaction in the config tree, counting the calls.
+ */
+//--------------------------------------------------------------------------------------------------
+le_cfg_IteratorRef_t MyCfgCreateReadTxn
+(
+    const char *basePath    ///< [IN] Path to the location to create the new iterator.
+)
+{
+    StubCfgReadTxnCount++;
+    return le_cfg_CreateReadTxn(basePath);
+}
+
 //--------------------------------------------------------------------------------------------------
 // Secure storage service stubbing
 //--------------------------------------------------------------------------------------------------
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of items read from secure storage.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t StubSecStoreReadCount = 0;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Stub for reading an item from secure storage.
@@ -524,6 +1058,7 @@ le_result_t le_secStore_Read
 )
 {
     #define STUB_SECSTORE_ITEM_VALUE "mySecret"
+    StubSecStoreReadCount++;
     *bufNumElementsPtr = strlen(STUB_SECSTORE_ITEM_VALUE);
     memcpy(bufPtr, STUB_SECSTORE_ITEM_VALUE, *bufNumElementsPtr);
     return LE_OK;
@@ -15,6 +15,26 @@
 #include "interfaces.h"
 #include "wifi_internal.h"
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of stations got per call to le_wifiAp_GetStations().
+ */
+//--------------------------------------------------------------------------------------------------
+#define STATIONS_PAGE_SIZE 8
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Names of the tuning parameters, in the order of le_wifiAp_TuningParam_t.
+ */
+//--------------------------------------------------------------------------------------------------
+static const char *TuningParamNames[] =
+{
+    "beacon_int", "dtim_period", "rts_threshold", "fragm_threshold", "wmm_enabled",
+    "wmm_ac_be_aifs", "wmm_ac_be_cwmin", "wmm_ac_be_cwmax", "wmm_ac_be_txop_limit",
+    "wmm_ac_bk_aifs", "wmm_ac_bk_cwmin", "wmm_ac_bk_cwmax", "wmm_ac_bk_txop_limit",
+    "wmm_ac_vi_aifs", "wmm_ac_vi_cwmin", "wmm_ac_vi_cwmax", "wmm_ac_vi_txop_limit",
+    "wmm_ac_vo_aifs", "wmm_ac_vo_cwmin", "wmm_ac_vo_cwmax", "wmm_ac_vo_txop_limit",
+};
 
 
 //--------------------------------------------------------------------------------------------------
@@ -60,6 +80,48 @@ void PrintApHelp(void)
         "\tbetween 1 and 6   for IEEE 802.11ad\n"
         "\tSome legal restrictions might apply for your region\n"
 
+        "To move the started WiFi access point to another channel without disconnecting the\n"
+        "stations, announcing the switch in [beacons] beacons (default 5):\n"
+        "\twifi ap switchchannel [ChannelNo] [beacons]\n"
+
+        "To select the least loaded channel on start, and every [period] seconds (0: on start\n"
+        "only) while the load of the channel is above [threshold] percent:\n"
+        "\twifi ap setautochannel [state] [period] [threshold]\n"
+        "Values for state;\n"
+        "\t0: Automatic channel selection disabled\n"
+        "\t1: Automatic channel selection enabled\n"
+
+        "To get the channel of the WiFi access point:\n"
+        "\twifi ap getchannel\n"
+
+        "To set the channel width in MHz: 20, 40 (IEEE 802.11n) or 80 (IEEE 802.11ac):\n"
+        "\twifi ap setchannelwidth [width]\n"
+
+        "To set the optional HT/VHT capabilities and the number of spatial streams (0: all):\n"
+        "\twifi ap setphycaps [capMask] [streams]\n"
+        "Values for capMask, to be ORed;\n"
+        "\t0x1: Short guard interval\n"
+        "\t0x2: LDPC coding\n"
+        "\t0x4: STBC\n"
+
+        "To get the channel width, capabilities and spatial streams supported by the radio:\n"
+        "\twifi ap getphycaps\n"
+
+        "To set the tuning profile of the radio, which resets the tuning parameters:\n"
+        "\twifi ap setprofile [profile]\n"
+        "Values for profile;\n"
+        "\t0: Default\n"
+        "\t1: Low latency\n"
+        "\t2: High throughput\n"
+        "\t3: Power save\n"
+        "\t4: Dense\n"
+
+        "To override a tuning parameter of the profile, named as listed by 'gettuning':\n"
+        "\twifi ap settuning [name] [value]\n"
+
+        "To get the tuning parameters:\n"
+        "\twifi ap gettuning\n"
+
         "To set the countrycode of the WiFi access point:\n"
         "\twifi ap setcountrycode [CountryCode]\n"
 
@@ -81,10 +143,81 @@ void PrintApHelp(void)
         "To maximum nbr of clients for the WiFi access point:\n"
         "\twifi ap setmaxclients [MAXNBR]\n"
 
+        "To get the maximum nbr of clients supported by the WiFi driver:\n"
+        "\twifi ap getmaxclients\n"
+
+        "To disconnect the clients idle for more than [SECONDS] (default 300):\n"
+        "\twifi ap setinactivity [SECONDS]\n"
+        "To evict the most idle client for a new one when the maximum nbr is reached:\n"
+        "\twifi ap setevictidle [state]\n"
+        "Values for state;\n"
+        "\t0: New clients refused when full\n"
+        "\t1: Most idle client evicted when full\n"
+        "To reject the clients with a signal strength under [RSSI] dBm (0: none):\n"
+        "\twifi ap setminrssi [RSSI]\n"
+
         "To define the address of the AP and the IP addresses range as well:\n"
         "WARNING: Only IPv4 addresses are supported.\n"
         "\twifi ap setiprange [IP AP] [IP START] [IP STOP]\n"
 
+        "To set the uplink of the WiFi access point, with the uplink interface [ifname]:\n"
+        "\twifi ap setuplink [mode] [ifname]\n"
+        "Values for mode;\n"
+        "\t0: No uplink\n"
+        "\t1: WiFi interface bridged with [ifname], clients addressed by its network\n"
+        "\t2: Clients routed to [ifname] with NAT\n"
+
+        "To get the uplink of the WiFi access point:\n"
+        "\twifi ap getuplink\n"
+
+        "To offload the established flows of the NAT uplink to the kernel fast path:\n"
+        "\twifi ap setnatoffload [state]\n"
+        "Values for state;\n"
+        "\t0: NAT fast path disabled\n"
+        "\t1: NAT fast path enabled\n"
+
+        "To get the traffic statistics of the WiFi access point, the throughput being\n"
+        "measured since the previous call:\n"
+        "\twifi ap uplinkstats\n"
+
+        "To limit the downlink and uplink rates in kbit/s of a station, 0 for no limit:\n"
+        "\twifi ap setratelimit [MAC] [downlink] [uplink]\n"
+        "To get the rate limits of a station and the packets dropped or queued by them:\n"
+        "\twifi ap shapingstats [MAC]\n"
+        "To share the airtime fairly between the stations, if the driver supports it:\n"
+        "\twifi ap setairtimefairness [state]\n"
+        "Values for state;\n"
+        "\t0: Airtime fairness disabled\n"
+        "\t1: Airtime fairness enabled\n"
+
+        "To run the WiFi access point next to the WiFi client, on a virtual interface\n"
+        "sharing the radio and the channel of the station:\n"
+        "\twifi ap setconcurrent [state]\n"
+        "Values for state;\n"
+        "\t0: Concurrent mode disabled\n"
+        "\t1: Concurrent mode enabled\n"
+
+        "To get the network interface of the WiFi access point:\n"
+        "\twifi ap interface\n"
+        "To select the interface of the radio of the WiFi access point, among the ones\n"
+        "listed by 'wifi client interfaces', while it is stopped:\n"
+        "\twifi ap setinterface [ifname]\n"
+
+        "To create an additional BSS on the radio of the WiFi access point and get [REF]:\n"
+        "\twifi ap createbss [SSID]\n"
+        "To delete an additional BSS set in 'createbss':\n"
+        "\twifi ap deletebss [REF]\n"
+        "To set the security protocol, WPA2 passphrase or maximum nbr of clients of a BSS,\n"
+        "with the values of 'setsecurityproto', 'setpassphrase' and 'setmaxclients':\n"
+        "\twifi ap setbsssecurityproto [REF] [SecuProto]\n"
+        "\twifi ap setbsspassphrase [REF] [passphrase]\n"
+        "\twifi ap setbssmaxclients [REF] [MAXNBR]\n"
+        "To define the address of the AP and the IP addresses range of a BSS:\n"
+        "\twifi ap setbssiprange [REF] [IP AP] [IP START] [IP STOP]\n"
+
+        "To list the stations associated with the WiFi access point and their statistics:\n"
+        "\twifi ap stations\n"
+
         "\n");
 }
 
@@ -308,6 +441,271 @@ void ExecuteWifiApCommand
             exit(EXIT_FAILURE);
         }
     }
+    else if (strcmp(commandPtr, "switchchannel") == 0)
+    {
+        // wifi ap switchchannel [ChannelNo] [beacons]
+        const char *channelPtr = le_arg_GetArg(2);
+        const char *beaconsPtr = le_arg_GetArg(3);
+        int         channelNo  = 0;
+        int         beacons    = 5;
+
+        if (NULL == channelPtr)
+        {
+            printf("ERROR: Missing or bad argument.\n");
+            exit(EXIT_FAILURE);
+        }
+
+        channelNo = strtol(channelPtr, NULL, 10);
+        if (NULL != beaconsPtr)
+        {
+            beacons = strtol(beaconsPtr, NULL, 10);
+        }
+        if ((errno != 0) || (beacons < 1) || (beacons > UINT8_MAX))
+        {
+            printf("ERROR: Bad argument value.\n");
+            exit(EXIT_FAILURE);
+        }
+
+        if (LE_OK == (result = le_wifiAp_SwitchChannel(channelNo, beacons)))
+        {
+            printf("Switching to channel %d in %d beacons.\n", channelNo, beacons);
+            exit(EXIT_SUCCESS);
+        }
+        else
+        {
+            printf("ERROR: le_wifiAp_SwitchChannel returns %d.\n", result);
+            exit(EXIT_FAILURE);
+        }
+    }
+    else if (strcmp(commandPtr, "setautochannel") == 0)
+    {
+        // wifi ap setautochannel [state] [period] [threshold]
+        const char *statePtr     = le_arg_GetArg(2);
+        const char *periodPtr    = le_arg_GetArg(3);
+        const char *thresholdPtr = le_arg_GetArg(4);
+        uint32_t    period       = 0;
+        int         threshold    = 0;
+
+        if ((NULL == statePtr) || (('0' != statePtr[0]) && ('1' != statePtr[0])))
+        {
+            printf("ERROR: Missing or bad argument.\n");
+            exit(EXIT_FAILURE);
+        }
+        if (NULL != periodPtr)
+        {
+            period = strtoul(periodPtr, NULL, 10);
+        }
+        if (NULL != thresholdPtr)
+        {
+            threshold = strtol(thresholdPtr, NULL, 10);
+        }
+        if ((errno != 0) || (threshold < 0) || (threshold > 100))
+        {
+            printf("ERROR: Bad argument value.\n");
+            exit(EXIT_FAILURE);
+        }
+
+        if (LE_OK == (result = le_wifiAp_SetAutoChannel('1' == statePtr[0], period, threshold)))
+        {
+            printf("Automatic channel selection %s.\n",
+                   ('1' == statePtr[0]) ? "enabled" : "disabled");
+            exit(EXIT_SUCCESS);
+        }
+        else
+        {
+            printf("ERROR: le_wifiAp_SetAutoChannel returns %d.\n", result);
+            exit(EXIT_FAILURE);
+        }
+    }
+    else if (strcmp(commandPtr, "getchannel") == 0)
+    {
+        // wifi ap getchannel
+        uint16_t channelNo = 0;
+
+        if (LE_OK == (result = le_wifiAp_GetChannel(&channelNo)))
+        {
+            printf("Channel: %d\n", channelNo);
+            exit(EXIT_SUCCESS);
+        }
+        else
+        {
+            printf("ERROR: le_wifiAp_GetChannel returns %d.\n", result);
+            exit(EXIT_FAILURE);
+        }
+    }
+    else if (strcmp(commandPtr, "setchannelwidth") == 0)
+    {
+        // wifi ap setchannelwidth [width]
+        const char               *widthArgPtr = le_arg_GetArg(2);
+        le_wifiAp_ChannelWidth_t  width;
+
+        if (NULL == widthArgPtr)
+        {
+            printf("ERROR: Missing or bad argument.\n");
+            exit(EXIT_FAILURE);
+        }
+        switch (strtol(widthArgPtr, NULL, 10))
+        {
+            case 20:
+                width = LE_WIFIAP_CHANNEL_WIDTH_20_MHZ;
+                break;
+            case 40:
+                width = LE_WIFIAP_CHANNEL_WIDTH_40_MHZ;
+                break;
+            case 80:
+                width = LE_WIFIAP_CHANNEL_WIDTH_80_MHZ;
+                break;
+            default:
+                printf("ERROR: Bad argument value. Should be 20, 40 or 80.\n");
+                exit(EXIT_FAILURE);
+        }
+
+        if (LE_OK == (result = le_wifiAp_SetChannelWidth(width)))
+        {
+            printf("Channel width set to %s MHz.\n", widthArgPtr);
+            exit(EXIT_SUCCESS);
+        }
+        else
+        {
+            printf("ERROR: le_wifiAp_SetChannelWidth returns %d.\n", result);
+            exit(EXIT_FAILURE);
+        }
+    }
+    else if (strcmp(commandPtr, "setphycaps") == 0)
+    {
+        // wifi ap setphycaps [capMask] [streams]
+        const char *capMaskPtr = le_arg_GetArg(2);
+        const char *streamsPtr = le_arg_GetArg(3);
+        uint32_t    capMask;
+        int         streams    = 0;
+
+        if (NULL == capMaskPtr)
+        {
+            printf("ERROR: Missing or bad argument.\n");
+            exit(EXIT_FAILURE);
+        }
+        capMask = strtoul(capMaskPtr, NULL, 0);
+        if (NULL != streamsPtr)
+        {
+            streams = strtol(streamsPtr, NULL, 10);
+        }
+        if ((errno != 0) || (streams < 0) || (streams > UINT8_MAX))
+        {
+            printf("ERROR: Bad argument value.\n");
+            exit(EXIT_FAILURE);
+        }
+
+        if (LE_OK == (result = le_wifiAp_SetPhyCapabilities(capMask, streams)))
+        {
+            printf("Capabilities set to 0x%X, %d spatial streams.\n", capMask, streams);
+            exit(EXIT_SUCCESS);
+        }
+        else
+        {
+            printf("ERROR: le_wifiAp_SetPhyCapabilities returns %d.\n", result);
+            exit(EXIT_FAILURE);
+        }
+    }
+    else if (strcmp(commandPtr, "getphycaps") == 0)
+    {
+        // wifi ap getphycaps
+        le_wifiAp_ChannelWidth_t  maxWidth;
+        le_wifiAp_PhyCapBitMask_t capMask;
+        uint8_t                   streams;
+
+        if (LE_OK == (result = le_wifiAp_GetPhyCapabilities(&maxWidth, &capMask, &streams)))
+        {
+            printf("Max width: %d MHz\tCapabilities: 0x%X\tSpatial streams: %d\n",
+                   (LE_WIFIAP_CHANNEL_WIDTH_80_MHZ == maxWidth) ? 80 :
+                   (LE_WIFIAP_CHANNEL_WIDTH_40_MHZ == maxWidth) ? 40 : 20,
+                   (unsigned int)capMask, streams);
+            exit(EXIT_SUCCESS);
+        }
+        else
+        {
+            printf("ERROR: le_wifiAp_GetPhyCapabilities returns %d.\n", result);
+            exit(EXIT_FAILURE);
+        }
+    }
+    else if (strcmp(commandPtr, "setprofile") == 0)
+    {
+        // wifi ap setprofile [profile]
+        const char *profilePtr = le_arg_GetArg(2);
+        int         profile;
+
+        if (NULL == profilePtr)
+        {
+            printf("ERROR: Missing or bad argument.\n");
+            exit(EXIT_FAILURE);
+        }
+        profile = strtol(profilePtr, NULL, 10);
+
+        if (LE_OK == (result = le_wifiAp_SetProfile(profile)))
+        {
+            printf("Profile set to %d.\n", profile);
+            exit(EXIT_SUCCESS);
+        }
+        else
+        {
+            printf("ERROR: le_wifiAp_SetProfile returns %d.\n", result);
+            exit(EXIT_FAILURE);
+        }
+    }
+    else if (strcmp(commandPtr, "settuning") == 0)
+    {
+        // wifi ap settuning [name] [value]
+        const char *namePtr  = le_arg_GetArg(2);
+        const char *valuePtr = le_arg_GetArg(3);
+        int32_t     value;
+        size_t      param;
+
+        if ((NULL == namePtr) || (NULL == valuePtr))
+        {
+            printf("ERROR: Missing or bad argument(s).\n");
+            exit(EXIT_FAILURE);
+        }
+        for (param = 0; param < NUM_ARRAY_MEMBERS(TuningParamNames); param++)
+        {
+            if (0 == strcmp(namePtr, TuningParamNames[param]))
+            {
+                break;
+            }
+        }
+        if (NUM_ARRAY_MEMBERS(TuningParamNames) == param)
+        {
+            printf("ERROR: Unknown tuning parameter %s.\n", namePtr);
+            exit(EXIT_FAILURE);
+        }
+        value = strtol(valuePtr, NULL, 10);
+
+        if (LE_OK == (result = le_wifiAp_SetTuningParameter(param, value)))
+        {
+            printf("%s set to %d.\n", namePtr, value);
+            exit(EXIT_SUCCESS);
+        }
+        else
+        {
+            printf("ERROR: le_wifiAp_SetTuningParameter returns %d.\n", result);
+            exit(EXIT_FAILURE);
+        }
+    }
+    else if (strcmp(commandPtr, "gettuning") == 0)
+    {
+        // wifi ap gettuning
+        int32_t value;
+        size_t  param;
+
+        for (param = 0; param < NUM_ARRAY_MEMBERS(TuningParamNames); param++)
+        {
+            if (LE_OK != (result = le_wifiAp_GetTuningParameter(param, &value)))
+            {
+                printf("ERROR: le_wifiAp_GetTuningParameter returns %d.\n", result);
+                exit(EXIT_FAILURE);
+            }
+            printf("%s=%d\n", TuningParamNames[param], value);
+        }
+        exit(EXIT_SUCCESS);
+    }
     else if (strcmp(commandPtr, "setcountrycode") == 0)
     {
         // wifi ap setcountrycode [CountryCode]
@@ -424,6 +822,73 @@ void ExecuteWifiApCommand
             exit(EXIT_FAILURE);
         }
     }
+    else if (strcmp(commandPtr, "setinactivity") == 0)
+    {
+        // wifi ap setinactivity [SECONDS]
+        const char *timeoutPtr = le_arg_GetArg(2);
+
+        if (NULL == timeoutPtr)
+        {
+            printf("ERROR: Missing argument.\n");
+            exit(EXIT_FAILURE);
+        }
+
+        if (LE_OK == (result = le_wifiAp_SetInactivityTimeout(strtoul(timeoutPtr, NULL, 10))))
+        {
+            printf("Inactivity timeout set to %s s.\n", timeoutPtr);
+            exit(EXIT_SUCCESS);
+        }
+        else
+        {
+            printf("ERROR: le_wifiAp_SetInactivityTimeout returns %d.\n", result);
+            exit(EXIT_FAILURE);
+        }
+    }
+    else if (strcmp(commandPtr, "setevictidle") == 0)
+    {
+        // wifi ap setevictidle [state]
+        const char *statePtr = le_arg_GetArg(2);
+
+        if ((NULL == statePtr) || (('0' != statePtr[0]) && ('1' != statePtr[0])))
+        {
+            printf("ERROR: Missing or bad argument.\n");
+            exit(EXIT_FAILURE);
+        }
+
+        if (LE_OK == (result = le_wifiAp_SetEvictIdleWhenFull('1' == statePtr[0])))
+        {
+            printf("Eviction of idle clients %s.\n",
+                   ('1' == statePtr[0]) ? "enabled" : "disabled");
+            exit(EXIT_SUCCESS);
+        }
+        else
+        {
+            printf("ERROR: le_wifiAp_SetEvictIdleWhenFull returns %d.\n", result);
+            exit(EXIT_FAILURE);
+        }
+    }
+    else if (strcmp(commandPtr, "setminrssi") == 0)
+    {
+        // wifi ap setminrssi [RSSI]
+        const char *rssiPtr = le_arg_GetArg(2);
+
+        if (NULL == rssiPtr)
+        {
+            printf("ERROR: Missing argument.\n");
+            exit(EXIT_FAILURE);
+        }
+
+        if (LE_OK == (result = le_wifiAp_SetMinAssocRssi(strtol(rssiPtr, NULL, 10))))
+        {
+            printf("Minimum signal strength set to %s dBm.\n", rssiPtr);
+            exit(EXIT_SUCCESS);
+        }
+        else
+        {
+            printf("ERROR: le_wifiAp_SetMinAssocRssi returns %d.\n", result);
+            exit(EXIT_FAILURE);
+        }
+    }
     else if (strcmp(commandPtr, "setmaxclients") == 0)
     {
         // wifi ap setmaxclients [MAXNBR]
@@ -453,6 +918,22 @@ void ExecuteWifiApCommand
             exit(EXIT_FAILURE);
         }
     }
+    else if (strcmp(commandPtr, "getmaxclients") == 0)
+    {
+        // wifi ap getmaxclients
+        uint32_t maxClients = 0;
+
+        if (LE_OK == (result = le_wifiAp_GetMaxNumberOfClientsCapability(&maxClients)))
+        {
+            printf("The WiFi driver supports up to %u clients.\n", maxClients);
+            exit(EXIT_SUCCESS);
+        }
+        else
+        {
+            printf("ERROR: le_wifiAp_GetMaxNumberOfClientsCapability returns %d.\n", result);
+            exit(EXIT_FAILURE);
+        }
+    }
     else if (strcmp(commandPtr, "setiprange") == 0)
     {
         // Only IPv4 addresses are supported.
@@ -479,6 +960,417 @@ void ExecuteWifiApCommand
             exit(EXIT_FAILURE);
         }
     }
+    else if (strcmp(commandPtr, "setuplink") == 0)
+    {
+        // wifi ap setuplink [mode] [ifname]
+        const char *modePtr   = le_arg_GetArg(2);
+        const char *ifNamePtr = le_arg_GetArg(3);
+        int         mode;
+
+        if (NULL == modePtr)
+        {
+            printf("ERROR: Missing or bad argument.\n");
+            exit(EXIT_FAILURE);
+        }
+        mode = strtol(modePtr, NULL, 10);
+
+        if (LE_OK == (result = le_wifiAp_SetUplink(mode, (NULL != ifNamePtr) ? ifNamePtr : "")))
+        {
+            printf("Uplink set to %d.\n", mode);
+            exit(EXIT_SUCCESS);
+        }
+        else
+        {
+            printf("ERROR: le_wifiAp_SetUplink returns %d.\n", result);
+            exit(EXIT_FAILURE);
+        }
+    }
+    else if (strcmp(commandPtr, "getuplink") == 0)
+    {
+        // wifi ap getuplink
+        le_wifiAp_UplinkMode_t mode;
+        char                   ifName[LE_WIFIDEFS_MAX_IFNAME_BYTES];
+
+        if (LE_OK == (result = le_wifiAp_GetUplink(&mode, ifName, sizeof(ifName))))
+        {
+            printf("Uplink: %d, interface: %s\n", mode, ifName);
+            exit(EXIT_SUCCESS);
+        }
+        else
+        {
+            printf("ERROR: le_wifiAp_GetUplink returns %d.\n", result);
+            exit(EXIT_FAILURE);
+        }
+    }
+    else if (strcmp(commandPtr, "setnatoffload") == 0)
+    {
+        // wifi ap setnatoffload [state]
+        const char *statePtr = le_arg_GetArg(2);
+
+        if ((NULL == statePtr) || (('0' != statePtr[0]) && ('1' != statePtr[0])))
+        {
+            printf("ERROR: Missing or bad argument.\n");
+            exit(EXIT_FAILURE);
+        }
+
+        if (LE_OK == (result = le_wifiAp_SetNatOffload('1' == statePtr[0])))
+        {
+            printf("NAT fast path %s.\n", ('1' == statePtr[0]) ? "enabled" : "disabled");
+            exit(EXIT_SUCCESS);
+        }
+        else
+        {
+            printf("ERROR: le_wifiAp_SetNatOffload returns %d.\n", result);
+            exit(EXIT_FAILURE);
+        }
+    }
+    else if (strcmp(commandPtr, "uplinkstats") == 0)
+    {
+        // wifi ap uplinkstats
+        le_wifiAp_UplinkStats_t stats;
+
+        if (LE_OK == (result = le_wifiAp_GetUplinkStats(&stats)))
+        {
+            printf("rx: %" PRIu64 " bytes, %u kbit/s\n", stats.rxBytes, stats.rxKbps);
+            printf("tx: %" PRIu64 " bytes, %u kbit/s\n", stats.txBytes, stats.txKbps);
+            printf("NAT fast path: %s, offloaded flows: %u\n",
+                   stats.isOffloaded ? "on" : "off", stats.offloadedFlows);
+            exit(EXIT_SUCCESS);
+        }
+        else
+        {
+            printf("ERROR: le_wifiAp_GetUplinkStats returns %d.\n", result);
+            exit(EXIT_FAILURE);
+        }
+    }
+    else if (strcmp(commandPtr, "setratelimit") == 0)
+    {
+        // wifi ap setratelimit [MAC] [downlink] [uplink]
+        const char *macPtr      = le_arg_GetArg(2);
+        const char *downlinkPtr = le_arg_GetArg(3);
+        const char *uplinkPtr   = le_arg_GetArg(4);
+
+        if ((NULL == macPtr) || (NULL == downlinkPtr) || (NULL == uplinkPtr))
+        {
+            printf("ERROR: Missing argument.\n");
+            exit(EXIT_FAILURE);
+        }
+
+        result = le_wifiAp_SetStationRateLimit(macPtr, strtoul(downlinkPtr, NULL, 10),
+                                               strtoul(uplinkPtr, NULL, 10));
+        if (LE_OK == result)
+        {
+            printf("Rate limit of %s set.\n", macPtr);
+            exit(EXIT_SUCCESS);
+        }
+        else
+        {
+            printf("ERROR: le_wifiAp_SetStationRateLimit returns %d.\n", result);
+            exit(EXIT_FAILURE);
+        }
+    }
+    else if (strcmp(commandPtr, "shapingstats") == 0)
+    {
+        // wifi ap shapingstats [MAC]
+        const char                      *macPtr = le_arg_GetArg(2);
+        le_wifiAp_StationShapingStats_t  stats;
+
+        if (NULL == macPtr)
+        {
+            printf("ERROR: Missing argument.\n");
+            exit(EXIT_FAILURE);
+        }
+
+        if (LE_OK == (result = le_wifiAp_GetStationShapingStats(macPtr, &stats)))
+        {
+            printf("Downlink: %u kbit/s, dropped %u, queued %u bytes %u packets\n",
+                   stats.downlinkKbps, stats.txDropped, stats.txBacklogBytes,
+                   stats.txBacklogPackets);
+            printf("Uplink: %u kbit/s, dropped %u\n", stats.uplinkKbps, stats.rxDropped);
+            exit(EXIT_SUCCESS);
+        }
+        else
+        {
+            printf("ERROR: le_wifiAp_GetStationShapingStats returns %d.\n", result);
+            exit(EXIT_FAILURE);
+        }
+    }
+    else if (strcmp(commandPtr, "setairtimefairness") == 0)
+    {
+        // wifi ap setairtimefairness [state]
+        const char *statePtr = le_arg_GetArg(2);
+
+        if ((NULL == statePtr) || (('0' != statePtr[0]) && ('1' != statePtr[0])))
+        {
+            printf("ERROR: Missing or bad argument.\n");
+            exit(EXIT_FAILURE);
+        }
+
+        if (LE_OK == (result = le_wifiAp_SetAirtimeFairness('1' == statePtr[0])))
+        {
+            printf("Airtime fairness %s.\n", ('1' == statePtr[0]) ? "enabled" : "disabled");
+            exit(EXIT_SUCCESS);
+        }
+        else
+        {
+            printf("ERROR: le_wifiAp_SetAirtimeFairness returns %d.\n", result);
+            exit(EXIT_FAILURE);
+        }
+    }
+    else if (strcmp(commandPtr, "setconcurrent") == 0)
+    {
+        // wifi ap setconcurrent [state]
+        const char *statePtr = le_arg_GetArg(2);
+
+        if ((NULL == statePtr) || (('0' != statePtr[0]) && ('1' != statePtr[0])))
+        {
+            printf("ERROR: Missing or bad argument.\n");
+            exit(EXIT_FAILURE);
+        }
+
+        if (LE_OK == (result = le_wifiAp_SetConcurrentMode('1' == statePtr[0])))
+        {
+            printf("Concurrent mode %s.\n", ('1' == statePtr[0]) ? "enabled" : "disabled");
+            exit(EXIT_SUCCESS);
+        }
+        else
+        {
+            printf("ERROR: le_wifiAp_SetConcurrentMode returns %d.\n", result);
+            exit(EXIT_FAILURE);
+        }
+    }
+    else if (strcmp(commandPtr, "interface") == 0)
+    {
+        // wifi ap interface
+        char ifName[LE_WIFIDEFS_MAX_IFNAME_BYTES];
+
+        if (LE_OK == (result = le_wifiAp_GetInterfaceName(ifName, sizeof(ifName))))
+        {
+            printf("Interface: %s\n", ifName);
+            exit(EXIT_SUCCESS);
+        }
+        else
+        {
+            printf("ERROR: le_wifiAp_GetInterfaceName returns %d.\n", result);
+            exit(EXIT_FAILURE);
+        }
+    }
+    else if (strcmp(commandPtr, "setinterface") == 0)
+    {
+        // wifi ap setinterface [ifname]
+        const char *ifNamePtr = le_arg_GetArg(2);
+
+        if (NULL == ifNamePtr)
+        {
+            printf("ERROR: Missing argument.\n");
+            exit(EXIT_FAILURE);
+        }
+
+        if (LE_OK == (result = le_wifiAp_SetInterface(ifNamePtr)))
+        {
+            printf("Interface set to %s.\n", ifNamePtr);
+            exit(EXIT_SUCCESS);
+        }
+        else
+        {
+            printf("ERROR: le_wifiAp_SetInterface returns %d.\n", result);
+            exit(EXIT_FAILURE);
+        }
+    }
+    else if (strcmp(commandPtr, "createbss") == 0)
+    {
+        // wifi ap createbss [SSID]
+        const char         *ssidPtr = le_arg_GetArg(2);
+        le_wifiAp_BssRef_t  bssRef;
+        char                ifName[LE_WIFIDEFS_MAX_IFNAME_BYTES];
+
+        if (NULL == ssidPtr)
+        {
+            printf("ERROR: Missing argument.\n");
+            exit(EXIT_FAILURE);
+        }
+        length = strlen(ssidPtr);
+
+        if (NULL == (bssRef = le_wifiAp_CreateBss()))
+        {
+            printf("ERROR: le_wifiAp_CreateBss returns NULL.\n");
+            exit(EXIT_FAILURE);
+        }
+
+        if ((LE_OK != (result = le_wifiAp_SetBssSsid(bssRef, (const uint8_t *)ssidPtr, length))) ||
+            (LE_OK != (result = le_wifiAp_GetBssInterface(bssRef, ifName, sizeof(ifName)))))
+        {
+            printf("ERROR: Unable to set the SSID of the BSS, error %d.\n", result);
+            le_wifiAp_DeleteBss(bssRef);
+            exit(EXIT_FAILURE);
+        }
+
+        printf("Created %s on %s has reference %p.\n", ssidPtr, ifName, bssRef);
+        exit(EXIT_SUCCESS);
+    }
+    else if (strcmp(commandPtr, "deletebss") == 0)
+    {
+        // wifi ap deletebss [REF]
+        const char         *refPtr = le_arg_GetArg(2);
+        le_wifiAp_BssRef_t  bssRef = NULL;
+
+        if ((NULL == refPtr) || (1 != sscanf(refPtr, "%x", (unsigned int *)&bssRef)))
+        {
+            printf("ERROR: Missing or bad argument.\n");
+            exit(EXIT_FAILURE);
+        }
+
+        if (LE_OK == (result = le_wifiAp_DeleteBss(bssRef)))
+        {
+            printf("Successful deletion.\n");
+            exit(EXIT_SUCCESS);
+        }
+        else
+        {
+            printf("ERROR: le_wifiAp_DeleteBss returns %d.\n", result);
+            exit(EXIT_FAILURE);
+        }
+    }
+    else if (strcmp(commandPtr, "setbsssecurityproto") == 0)
+    {
+        // wifi ap setbsssecurityproto [REF] [SecuProto]
+        const char         *refPtr   = le_arg_GetArg(2);
+        const char         *protoPtr = le_arg_GetArg(3);
+        le_wifiAp_BssRef_t  bssRef   = NULL;
+
+        if ((NULL == refPtr) || (NULL == protoPtr) ||
+            (1 != sscanf(refPtr, "%x", (unsigned int *)&bssRef)))
+        {
+            printf("ERROR: Missing or bad argument.\n");
+            exit(EXIT_FAILURE);
+        }
+
+        if (LE_OK == (result = le_wifiAp_SetBssSecurityProtocol(bssRef,
+                                                                 strtol(protoPtr, NULL, 10))))
+        {
+            printf("Successfully set security protocol.\n");
+            exit(EXIT_SUCCESS);
+        }
+        else
+        {
+            printf("ERROR: le_wifiAp_SetBssSecurityProtocol returns %d.\n", result);
+            exit(EXIT_FAILURE);
+        }
+    }
+    else if (strcmp(commandPtr, "setbsspassphrase") == 0)
+    {
+        // wifi ap setbsspassphrase [REF] [passphrase]
+        const char         *refPtr        = le_arg_GetArg(2);
+        const char         *passPhrasePtr = le_arg_GetArg(3);
+        le_wifiAp_BssRef_t  bssRef        = NULL;
+
+        if ((NULL == refPtr) || (NULL == passPhrasePtr) ||
+            (1 != sscanf(refPtr, "%x", (unsigned int *)&bssRef)))
+        {
+            printf("ERROR: Missing or bad argument.\n");
+            exit(EXIT_FAILURE);
+        }
+
+        if (LE_OK == (result = le_wifiAp_SetBssPassPhrase(bssRef, passPhrasePtr)))
+        {
+            printf("Successfully set passphrase.\n");
+            exit(EXIT_SUCCESS);
+        }
+        else
+        {
+            printf("ERROR: le_wifiAp_SetBssPassPhrase returns %d.\n", result);
+            exit(EXIT_FAILURE);
+        }
+    }
+    else if (strcmp(commandPtr, "setbssmaxclients") == 0)
+    {
+        // wifi ap setbssmaxclients [REF] [MAXNBR]
+        const char         *refPtr = le_arg_GetArg(2);
+        const char         *maxPtr = le_arg_GetArg(3);
+        le_wifiAp_BssRef_t  bssRef = NULL;
+
+        if ((NULL == refPtr) || (NULL == maxPtr) ||
+            (1 != sscanf(refPtr, "%x", (unsigned int *)&bssRef)))
+        {
+            printf("ERROR: Missing or bad argument.\n");
+            exit(EXIT_FAILURE);
+        }
+
+        if (LE_OK == (result = le_wifiAp_SetBssMaxNumberOfClients(bssRef,
+                                                                   strtol(maxPtr, NULL, 10))))
+        {
+            printf("Max number of clients set to %s.\n", maxPtr);
+            exit(EXIT_SUCCESS);
+        }
+        else
+        {
+            printf("ERROR: le_wifiAp_SetBssMaxNumberOfClients returns %d.\n", result);
+            exit(EXIT_FAILURE);
+        }
+    }
+    else if (strcmp(commandPtr, "setbssiprange") == 0)
+    {
+        // Only IPv4 addresses are supported.
+        // wifi ap setbssiprange [REF] [IP AP] [IP START] [IP STOP]
+        const char         *refPtr  = le_arg_GetArg(2);
+        const char         *ipAp    = le_arg_GetArg(3);
+        const char         *ipStart = le_arg_GetArg(4);
+        const char         *ipStop  = le_arg_GetArg(5);
+        le_wifiAp_BssRef_t  bssRef  = NULL;
+
+        if ((NULL == refPtr) || (NULL == ipAp) || (NULL == ipStart) || (NULL == ipStop) ||
+            (1 != sscanf(refPtr, "%x", (unsigned int *)&bssRef)))
+        {
+            printf("ERROR: Missing or bad argument(s).\n");
+            exit(EXIT_FAILURE);
+        }
+
+        if (LE_OK == (result = le_wifiAp_SetBssIpRange(bssRef, ipAp, ipStart, ipStop)))
+        {
+            printf("IP AP@=%s, Start@=%s, Stop@=%s\n", ipAp, ipStart, ipStop);
+            exit(EXIT_SUCCESS);
+        }
+        else
+        {
+            printf("ERROR: le_wifiAp_SetBssIpRange returns %d.\n", result);
+            exit(EXIT_FAILURE);
+        }
+    }
+    else if (strcmp(commandPtr, "stations") == 0)
+    {
+        // wifi ap stations
+        le_wifiAp_StationInfo_t stations[STATIONS_PAGE_SIZE];
+        size_t                  numStations;
+        uint32_t                index = 0;
+        uint32_t                total = 0;
+        size_t                  i;
+
+        do
+        {
+            numStations = STATIONS_PAGE_SIZE;
+            result = le_wifiAp_GetStations(index, stations, &numStations, &total);
+            if (LE_OK != result)
+            {
+                printf("ERROR: le_wifiAp_GetStations returns %d.\n", result);
+                exit(EXIT_FAILURE);
+            }
+            for (i = 0; i < numStations; i++)
+            {
+                printf("Station: %s\tSignal: %d dBm\tConnected: %u s\tInactive: %u ms\n"
+                       "\tTx: %" PRIu64 " bytes, %u packets, %u kbit/s\n"
+                       "\tRx: %" PRIu64 " bytes, %u packets, %u kbit/s\n",
+                       stations[i].macAddr, stations[i].signal, stations[i].connectedSec,
+                       stations[i].inactiveMs, stations[i].txBytes, stations[i].txPackets,
+                       stations[i].txBitrate, stations[i].rxBytes, stations[i].rxPackets,
+                       stations[i].rxBitrate);
+            }
+            index += numStations;
+        }
+        while ((0 != numStations) && (index < total));
+
+        printf("%u station(s)\n", total);
+        exit(EXIT_SUCCESS);
+    }
     else
     {
         printf("Invalid command for WiFi service.\n");
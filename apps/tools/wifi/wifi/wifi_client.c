@@ -113,6 +113,14 @@ static void WifiClientConnectEventHandler
         }
         break;
 
+        case LE_WIFICLIENT_EVENT_RSSI_LOW:
+        case LE_WIFICLIENT_EVENT_RSSI_HIGH:
+        case LE_WIFICLIENT_EVENT_IP_READY:
+        {
+            LE_DEBUG("FYI: Got EVENT %d, while waiting for CONNECT.", wifiEventPtr->event);
+        }
+        break;
+
         default:
             LE_ERROR("ERROR Unknown event %d", wifiEventPtr->event);
         break;
@@ -204,6 +212,14 @@ static void WifiClientScanEventHandler
         }
         break;
 
+        case LE_WIFICLIENT_EVENT_RSSI_LOW:
+        case LE_WIFICLIENT_EVENT_RSSI_HIGH:
+        case LE_WIFICLIENT_EVENT_IP_READY:
+        {
+            LE_DEBUG("FYI: Got EVENT %d", wifiEventPtr->event);
+        }
+        break;
+
         case LE_WIFICLIENT_EVENT_SCAN_DONE:
         {
             if (!ScanInProgress)
@@ -267,6 +283,9 @@ void PrintClientHelp(void)
            "To connect to an access point set in 'create':\n"
            "\twifi client connect [REF]\n"
 
+           "To connect to the best saved SSID found by 'scan':\n"
+           "\twifi client connectknown\n"
+
            "To get the signal strength of the AccessPoint:\n"
            "\twifi client signal [REF]\n"
 
@@ -288,6 +307,73 @@ void PrintClientHelp(void)
            "\t0: SSID of AP is discoverable\n"
            "\t1: SSID of AP is hidden\n"
 
+           "To enable IEEE 802.11r fast BSS transition (WPA2 only):\n"
+           "\twifi client setft [REF] [state]\n"
+
+           "Values for state;\n"
+           "\t0: Fast BSS transition disabled\n"
+           "\t1: Fast BSS transition enabled\n"
+
+           "To get the best access point of [SSID] found by 'scan', preferred on connection:\n"
+           "\twifi client bestap [SSID]\n"
+
+           "To roam to another access point of the connected network, [REF] found by 'scan':\n"
+           "\twifi client roam [REF]\n"
+
+           "To enable roaming when the signal drops below [threshold] dBm, to an access point\n"
+           "at least [hysteresis] dB stronger:\n"
+           "\twifi client setroaming [state] [threshold] [hysteresis]\n"
+
+           "Values for state;\n"
+           "\t0: Roaming disabled\n"
+           "\t1: Roaming enabled\n"
+
+           "To get the roaming statistics:\n"
+           "\twifi client roamstats\n"
+
+           "To get the live statistics of the link with the associated access point:\n"
+           "\twifi client stationinfo\n"
+
+           "To be notified when the signal crosses [threshold] dBm by more than [hysteresis] dB,\n"
+           "0 to disable:\n"
+           "\twifi client setrssithreshold [threshold] [hysteresis]\n"
+
+           "To get the IP address by the WiFi service on connection:\n"
+           "\twifi client dhcp [state]\n"
+
+           "Values for state;\n"
+           "\t0: IP address handled by the application\n"
+           "\t1: IP address got by the WiFi service, cached per access point\n"
+
+           "To get the IP address got by the WiFi service:\n"
+           "\twifi client ipaddress\n"
+           "To get the network interface of the WiFi client:\n"
+           "\twifi client interface\n"
+           "To list the WiFi interfaces of the module and their radio:\n"
+           "\twifi client interfaces\n"
+           "To select the network interface of the WiFi client, while it is stopped:\n"
+           "\twifi client setinterface [ifname]\n"
+
+           "To reconnect automatically when the connection to [REF] is lost:\n"
+           "\twifi client autoreconnect [REF] [state]\n"
+
+           "Values for state;\n"
+           "\t0: Auto-reconnect disabled\n"
+           "\t1: Auto-reconnect enabled\n"
+
+           "To set the priority of a saved SSID to fall back to, highest first:\n"
+           "\twifi client setpriority [SSID] [priority]\n"
+
+           "To import SSID profiles from a file, one per line with tab separated fields\n"
+           "SSID, SecuProto and the secret(s): key, passphrase, PSK or username and password:\n"
+           "\twifi client import [file]\n"
+
+           "To get the auto-reconnect statistics:\n"
+           "\twifi client reconnectstats\n"
+
+           "To get the phase timing of the last connection attempts:\n"
+           "\twifi client stats\n"
+
            "To disconnect from an access point:\n"
            "\twifi client disconnect\n"
 
@@ -479,6 +565,26 @@ void ExecuteWifiClientCommand
             exit(EXIT_FAILURE);
         }
     }
+    else if (strcmp(commandPtr, "connectknown") == 0)
+    {
+        // Command: wifi client connectknown
+        le_wifiClient_AccessPointRef_t  apRef  = NULL;
+
+        // Add a handler function to handle message reception
+        ConnectHdlrRef =
+            le_wifiClient_AddConnectionEventHandler(WifiClientConnectEventHandler, NULL);
+
+        if (LE_OK == (result = le_wifiClient_ConnectKnownNetwork(&apRef)))
+        {
+            printf("Connecting... Ref:%p\n", apRef);
+        }
+        else
+        {
+            printf("ERROR: le_wifiClient_ConnectKnownNetwork returns error code %d.\n", result);
+            le_wifiClient_RemoveConnectionEventHandler(ConnectHdlrRef);
+            exit(EXIT_FAILURE);
+        }
+    }
     else if (strcmp(commandPtr, "disconnect") == 0)
     {
         // Command: wifi client disconnect
@@ -579,6 +685,449 @@ void ExecuteWifiClientCommand
             exit(EXIT_FAILURE);
         }
     }
+    else if (strcmp(commandPtr, "setft") == 0)
+    {
+        // Command: wifi client setft [REF] [value]
+        const char*                       refPtr    = le_arg_GetArg(2);
+        const char*                       enablePtr = le_arg_GetArg(3);
+        le_wifiClient_AccessPointRef_t    apRef     = NULL;
+        unsigned int                      enable    = 0;
+
+        if ((NULL == refPtr) || (NULL == enablePtr))
+        {
+            printf("ERROR. Missing argument.\n");
+            exit(EXIT_FAILURE);
+        }
+
+        rc1 = sscanf(refPtr, "%x", (unsigned int *)&apRef);
+        rc2 = sscanf(enablePtr, "%u", &enable);
+        result = le_wifiClient_SetFastTransition(apRef, (enable ? true : false));
+
+        if ((1 == rc1) && (1 == rc2) && (LE_OK == result))
+        {
+            printf("Fast BSS transition: %u\n", enable);
+            exit(EXIT_SUCCESS);
+        }
+        else
+        {
+            printf("ERROR: le_wifiClient_SetFastTransition returns %d.\n", result);
+            exit(EXIT_FAILURE);
+        }
+    }
+    else if (strcmp(commandPtr, "bestap") == 0)
+    {
+        // Command: wifi client bestap [SSID]
+        const char*                     ssidPtr = le_arg_GetArg(2);
+        le_wifiClient_AccessPointRef_t  apRef   = NULL;
+
+        if (NULL == ssidPtr)
+        {
+            printf("ERROR: Missing argument.\n");
+            exit(EXIT_FAILURE);
+        }
+
+        result = le_wifiClient_GetBestAccessPoint((const uint8_t *)ssidPtr, strlen(ssidPtr),
+                                                  &apRef);
+        if (LE_OK == result)
+        {
+            printf("Best access point: Ref:%p\n", apRef);
+            exit(EXIT_SUCCESS);
+        }
+        else
+        {
+            printf("ERROR: le_wifiClient_GetBestAccessPoint returns error code %d.\n", result);
+            exit(EXIT_FAILURE);
+        }
+    }
+    else if (strcmp(commandPtr, "roam") == 0)
+    {
+        // Command: wifi client roam [REF]
+        const char*                     refPtr = le_arg_GetArg(2);
+        le_wifiClient_AccessPointRef_t  apRef  = NULL;
+
+        if (NULL == refPtr)
+        {
+            printf("ERROR: Missing argument.\n");
+            exit(EXIT_FAILURE);
+        }
+        rc1 = sscanf(refPtr, "%x", (unsigned int *)&apRef);
+
+        if ((1 == rc1) && (LE_OK == (result = le_wifiClient_Roam(apRef))))
+        {
+            printf("Roamed.\n");
+            exit(EXIT_SUCCESS);
+        }
+        else
+        {
+            printf("ERROR: le_wifiClient_Roam returns error code %d.\n", result);
+            exit(EXIT_FAILURE);
+        }
+    }
+    else if (strcmp(commandPtr, "setroaming") == 0)
+    {
+        // Command: wifi client setroaming [state] [threshold] [hysteresis]
+        const char*     enablePtr     = le_arg_GetArg(2);
+        const char*     thresholdPtr  = le_arg_GetArg(3);
+        const char*     hysteresisPtr = le_arg_GetArg(4);
+        unsigned int    enable        = 0;
+        int             threshold     = 0;
+        unsigned int    hysteresis    = 0;
+
+        if (NULL == enablePtr)
+        {
+            printf("ERROR: Missing argument.\n");
+            exit(EXIT_FAILURE);
+        }
+
+        if (1 != sscanf(enablePtr, "%u", &enable))
+        {
+            printf("ERROR: wrong state.\n");
+            exit(EXIT_FAILURE);
+        }
+
+        if ((NULL != thresholdPtr) && (NULL != hysteresisPtr))
+        {
+            rc1 = sscanf(thresholdPtr, "%d", &threshold);
+            rc2 = sscanf(hysteresisPtr, "%u", &hysteresis);
+            if ((1 != rc1) || (1 != rc2) || (hysteresis > UINT8_MAX) ||
+                (LE_OK != (result = le_wifiClient_SetRoamingThreshold(threshold, hysteresis))))
+            {
+                printf("ERROR: le_wifiClient_SetRoamingThreshold returns error code %d.\n",
+                       result);
+                exit(EXIT_FAILURE);
+            }
+        }
+
+        result = le_wifiClient_SetRoaming(enable ? true : false);
+        if (LE_OK == result)
+        {
+            printf("Roaming: %u\n", enable);
+            exit(EXIT_SUCCESS);
+        }
+        else
+        {
+            printf("ERROR: le_wifiClient_SetRoaming returns error code %d.\n", result);
+            exit(EXIT_FAILURE);
+        }
+    }
+    else if (strcmp(commandPtr, "roamstats") == 0)
+    {
+        // Command: wifi client roamstats
+        uint32_t attemptCount, failureCount, lastLatencyMs, avgLatencyMs, maxLatencyMs;
+
+        result = le_wifiClient_GetRoamStats(&attemptCount, &failureCount, &lastLatencyMs,
+                                            &avgLatencyMs, &maxLatencyMs);
+        if (LE_OK == result)
+        {
+            printf("Roams: %u, failed: %u\n", attemptCount, failureCount);
+            printf("Latency: last %u ms, average %u ms, max %u ms\n",
+                   lastLatencyMs, avgLatencyMs, maxLatencyMs);
+            exit(EXIT_SUCCESS);
+        }
+        else
+        {
+            printf("ERROR: le_wifiClient_GetRoamStats returns error code %d.\n", result);
+            exit(EXIT_FAILURE);
+        }
+    }
+    else if (strcmp(commandPtr, "stationinfo") == 0)
+    {
+        // Command: wifi client stationinfo
+        int16_t  rssi;
+        uint32_t txBitrate, rxBitrate, txRetries, txFailed, beaconLoss;
+
+        result = le_wifiClient_GetStationInfo(&rssi, &txBitrate, &rxBitrate, &txRetries,
+                                              &txFailed, &beaconLoss);
+        if (LE_OK == result)
+        {
+            printf("Signal: %d dBm\n", rssi);
+            printf("Bitrate: tx %u kbit/s, rx %u kbit/s\n", txBitrate, rxBitrate);
+            printf("Tx retries: %u, tx failed: %u, beacon loss: %u\n",
+                   txRetries, txFailed, beaconLoss);
+            exit(EXIT_SUCCESS);
+        }
+        else if (LE_NOT_FOUND == result)
+        {
+            printf("Not associated.\n");
+            exit(EXIT_FAILURE);
+        }
+        else
+        {
+            printf("ERROR: le_wifiClient_GetStationInfo returns error code %d.\n", result);
+            exit(EXIT_FAILURE);
+        }
+    }
+    else if (strcmp(commandPtr, "setrssithreshold") == 0)
+    {
+        // Command: wifi client setrssithreshold [threshold] [hysteresis]
+        const char*     thresholdPtr  = le_arg_GetArg(2);
+        const char*     hysteresisPtr = le_arg_GetArg(3);
+        int             threshold     = 0;
+        unsigned int    hysteresis    = 0;
+
+        if (NULL == thresholdPtr)
+        {
+            printf("ERROR: Missing argument.\n");
+            exit(EXIT_FAILURE);
+        }
+
+        rc1 = sscanf(thresholdPtr, "%d", &threshold);
+        rc2 = (NULL != hysteresisPtr) ? sscanf(hysteresisPtr, "%u", &hysteresis) : 1;
+        if ((1 != rc1) || (1 != rc2) || (hysteresis > UINT8_MAX))
+        {
+            printf("ERROR: wrong threshold or hysteresis.\n");
+            exit(EXIT_FAILURE);
+        }
+
+        result = le_wifiClient_SetRssiThreshold(threshold, hysteresis);
+        if (LE_OK == result)
+        {
+            printf("Signal threshold: %d dBm, hysteresis: %u dB\n", threshold, hysteresis);
+            exit(EXIT_SUCCESS);
+        }
+        else
+        {
+            printf("ERROR: le_wifiClient_SetRssiThreshold returns error code %d.\n", result);
+            exit(EXIT_FAILURE);
+        }
+    }
+    else if (strcmp(commandPtr, "dhcp") == 0)
+    {
+        // Command: wifi client dhcp [state]
+        const char*     enablePtr = le_arg_GetArg(2);
+        unsigned int    enable    = 0;
+
+        if ((NULL == enablePtr) || (1 != sscanf(enablePtr, "%u", &enable)))
+        {
+            printf("ERROR: wrong state.\n");
+            exit(EXIT_FAILURE);
+        }
+
+        result = le_wifiClient_SetDhcp(enable ? true : false);
+        if (LE_OK == result)
+        {
+            printf("DHCP: %u\n", enable);
+            exit(EXIT_SUCCESS);
+        }
+        else
+        {
+            printf("ERROR: le_wifiClient_SetDhcp returns error code %d.\n", result);
+            exit(EXIT_FAILURE);
+        }
+    }
+    else if (strcmp(commandPtr, "ipaddress") == 0)
+    {
+        // Command: wifi client ipaddress
+        char address[16];
+
+        result = le_wifiClient_GetIpAddress(address, sizeof(address));
+        if (LE_OK == result)
+        {
+            printf("IP address: %s\n", address);
+            exit(EXIT_SUCCESS);
+        }
+        else
+        {
+            printf("ERROR: le_wifiClient_GetIpAddress returns error code %d.\n", result);
+            exit(EXIT_FAILURE);
+        }
+    }
+    else if (strcmp(commandPtr, "interface") == 0)
+    {
+        // Command: wifi client interface
+        char ifName[LE_WIFIDEFS_MAX_IFNAME_BYTES];
+
+        result = le_wifiClient_GetInterfaceName(ifName, sizeof(ifName));
+        if (LE_OK == result)
+        {
+            printf("Interface: %s\n", ifName);
+            exit(EXIT_SUCCESS);
+        }
+        else
+        {
+            printf("ERROR: le_wifiClient_GetInterfaceName returns error code %d.\n", result);
+            exit(EXIT_FAILURE);
+        }
+    }
+    else if (strcmp(commandPtr, "interfaces") == 0)
+    {
+        // Command: wifi client interfaces
+        le_wifiClient_InterfaceInfo_t interfaces[8];
+        size_t                        numInterfaces = NUM_ARRAY_MEMBERS(interfaces);
+        size_t                        i;
+
+        result = le_wifiClient_GetInterfaces(interfaces, &numInterfaces);
+        if (LE_OK == result)
+        {
+            for (i = 0; i < numInterfaces; i++)
+            {
+                printf("Interface: %s, radio: phy%u\n", interfaces[i].ifName,
+                       interfaces[i].phyIndex);
+            }
+            exit(EXIT_SUCCESS);
+        }
+        else
+        {
+            printf("ERROR: le_wifiClient_GetInterfaces returns error code %d.\n", result);
+            exit(EXIT_FAILURE);
+        }
+    }
+    else if (strcmp(commandPtr, "setinterface") == 0)
+    {
+        // Command: wifi client setinterface [ifname]
+        const char *ifNamePtr = le_arg_GetArg(2);
+
+        if (NULL == ifNamePtr)
+        {
+            printf("ERROR. Missing argument.\n");
+            exit(EXIT_FAILURE);
+        }
+
+        result = le_wifiClient_SetInterface(ifNamePtr);
+        if (LE_OK == result)
+        {
+            printf("Interface set to %s.\n", ifNamePtr);
+            exit(EXIT_SUCCESS);
+        }
+        else
+        {
+            printf("ERROR: le_wifiClient_SetInterface returns error code %d.\n", result);
+            exit(EXIT_FAILURE);
+        }
+    }
+    else if (strcmp(commandPtr, "autoreconnect") == 0)
+    {
+        // Command: wifi client autoreconnect [REF] [value]
+        const char*                       refPtr    = le_arg_GetArg(2);
+        const char*                       enablePtr = le_arg_GetArg(3);
+        le_wifiClient_AccessPointRef_t    apRef     = NULL;
+        unsigned int                      enable    = 0;
+
+        if ((NULL == refPtr) || (NULL == enablePtr))
+        {
+            printf("ERROR. Missing argument.\n");
+            exit(EXIT_FAILURE);
+        }
+
+        rc1 = sscanf(refPtr, "%x", (unsigned int *)&apRef);
+        rc2 = sscanf(enablePtr, "%u", &enable);
+        result = le_wifiClient_SetAutoReconnect(apRef, (enable ? true : false));
+
+        if ((1 == rc1) && (1 == rc2) && (LE_OK == result))
+        {
+            printf("Auto-reconnect: %u\n", enable);
+            exit(EXIT_SUCCESS);
+        }
+        else
+        {
+            printf("ERROR: le_wifiClient_SetAutoReconnect returns %d.\n", result);
+            exit(EXIT_FAILURE);
+        }
+    }
+    else if (strcmp(commandPtr, "import") == 0)
+    {
+        // Command: wifi client import [file]
+        const char*     filePtr = le_arg_GetArg(2);
+        uint32_t        count   = 0;
+        int             fd;
+
+        if (NULL == filePtr)
+        {
+            printf("ERROR. Missing argument.\n");
+            exit(EXIT_FAILURE);
+        }
+
+        fd = open(filePtr, O_RDONLY);
+        if (fd < 0)
+        {
+            printf("ERROR: Unable to open %s.\n", filePtr);
+            exit(EXIT_FAILURE);
+        }
+
+        // The file descriptor is closed when sent to the WiFi service
+        result = le_wifiClient_ImportProfiles(fd, &count);
+        if (LE_OK == result)
+        {
+            printf("%u profiles imported.\n", count);
+            exit(EXIT_SUCCESS);
+        }
+        else if (LE_FORMAT_ERROR == result)
+        {
+            printf("ERROR: Invalid profile at line %u, nothing imported.\n", count);
+            exit(EXIT_FAILURE);
+        }
+        else
+        {
+            printf("ERROR: le_wifiClient_ImportProfiles returns %d.\n", result);
+            exit(EXIT_FAILURE);
+        }
+    }
+    else if (strcmp(commandPtr, "setpriority") == 0)
+    {
+        // Command: wifi client setpriority [SSID] [priority]
+        const char*     ssidPtr     = le_arg_GetArg(2);
+        const char*     priorityPtr = le_arg_GetArg(3);
+        int             priority    = 0;
+
+        if ((NULL == ssidPtr) || (NULL == priorityPtr))
+        {
+            printf("ERROR. Missing argument.\n");
+            exit(EXIT_FAILURE);
+        }
+
+        rc1 = sscanf(priorityPtr, "%d", &priority);
+        result = le_wifiClient_SetSsidPriority((const uint8_t *)ssidPtr, strlen(ssidPtr),
+                                               priority);
+
+        if ((1 == rc1) && (LE_OK == result))
+        {
+            printf("Priority of SSID %s: %d\n", ssidPtr, priority);
+            exit(EXIT_SUCCESS);
+        }
+        else
+        {
+            printf("ERROR: le_wifiClient_SetSsidPriority returns %d.\n", result);
+            exit(EXIT_FAILURE);
+        }
+    }
+    else if (strcmp(commandPtr, "reconnectstats") == 0)
+    {
+        // Command: wifi client reconnectstats
+        uint32_t attemptCount, recoveryCount, lastRecoveryMs, maxRecoveryMs;
+
+        result = le_wifiClient_GetReconnectStats(&attemptCount, &recoveryCount, &lastRecoveryMs,
+                                                 &maxRecoveryMs);
+        if (LE_OK == result)
+        {
+            printf("Attempts: %u, recovered: %u\n", attemptCount, recoveryCount);
+            printf("Time to recover: last %u ms, max %u ms\n", lastRecoveryMs, maxRecoveryMs);
+            exit(EXIT_SUCCESS);
+        }
+        else
+        {
+            printf("ERROR: le_wifiClient_GetReconnectStats returns error code %d.\n", result);
+            exit(EXIT_FAILURE);
+        }
+    }
+    else if (strcmp(commandPtr, "stats") == 0)
+    {
+        // Command: wifi client stats
+        le_result_t connectResult;
+        uint32_t    index = 0;
+        uint32_t    configMs, supplicantMs, authMs, assocMs, handshakeMs, dhcpMs, totalMs;
+
+        printf("Connection attempts, last first (ms):\n");
+        printf("result\tconfig\tsupplicant\tauth\tassoc\thandshake\tdhcp\ttotal\n");
+        while (LE_OK == le_wifiClient_GetConnectTiming(index, &connectResult, &configMs,
+                                                       &supplicantMs, &authMs, &assocMs,
+                                                       &handshakeMs, &dhcpMs, &totalMs))
+        {
+            printf("%d\t%u\t%u\t\t%u\t%u\t%u\t\t%u\t%u\n", connectResult, configMs,
+                   supplicantMs, authMs, assocMs, handshakeMs, dhcpMs, totalMs);
+            index++;
+        }
+        exit(EXIT_SUCCESS);
+    }
     else if (strcmp(commandPtr, "setpassphrase") == 0)
     {
         // Command: wifi client setpassphrase [REF] [passPhrasePtr]
@@ -12,6 +12,35 @@
 
 #include "pa_wifi_ap.h"
 
+#include "wifiApDhcp.h"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of stations kept in the station table.
+ */
+//--------------------------------------------------------------------------------------------------
+#define STATION_MAX 64
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Age in milliseconds below which the statistics of the station table are not dumped again.
+ */
+//--------------------------------------------------------------------------------------------------
+#define STATION_REFRESH_MS 1000
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Station associated with the access point.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_wifiAp_StationInfo_t info;         ///< Statistics of the station, keyed by its MAC address
+    le_clk_Time_t           connectTime;  ///< Time of the association, relative to boot
+    bool                    isDumped;     ///< Whether the station is in the last dump
+}
+Station_t;
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -21,6 +50,185 @@
 //--------------------------------------------------------------------------------------------------
 static le_event_Id_t NewWifiApEventId;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Event ID for the station events, with the MAC address of the station.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_event_Id_t StationEventId;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pool and table of the stations associated with the access point, keyed by MAC address.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t StationPool;
+static le_hashmap_Ref_t StationMap;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Time of the last dump of the station statistics.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_clk_Time_t StationRefreshTime;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Safe references of the additional BSS, to their index in the PA.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_ref_MapRef_t BssRefMap;
+static uint8_t         BssIndexes[PA_WIFIAP_MAX_BSS];
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a station to the table, or get it if already known.
+ *
+ * @return The station, NULL if the table is full.
+ */
+//--------------------------------------------------------------------------------------------------
+static Station_t *AddStation
+(
+    const char *macAddrPtr,
+    le_clk_Time_t connectTime
+)
+{
+    Station_t *stationPtr = le_hashmap_Get(StationMap, macAddrPtr);
+
+    if (NULL != stationPtr)
+    {
+        return stationPtr;
+    }
+    if (STATION_MAX <= le_hashmap_Size(StationMap))
+    {
+        LE_WARN("Station table full, %s not tracked", macAddrPtr);
+        return NULL;
+    }
+
+    stationPtr = le_mem_ForceAlloc(StationPool);
+    memset(stationPtr, 0, sizeof(*stationPtr));
+    le_utf8_Copy(stationPtr->info.macAddr, macAddrPtr, sizeof(stationPtr->info.macAddr), NULL);
+    stationPtr->connectTime = connectTime;
+    le_hashmap_Put(StationMap, stationPtr->info.macAddr, stationPtr);
+    return stationPtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove a station from the table.
+ */
+//--------------------------------------------------------------------------------------------------
+static void DeleteStation
+(
+    const char *macAddrPtr
+)
+{
+    Station_t *stationPtr = le_hashmap_Remove(StationMap, macAddrPtr);
+
+    if (NULL != stationPtr)
+    {
+        le_mem_Release(stationPtr);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove all the stations from the table.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ClearStations
+(
+    void
+)
+{
+    le_hashmap_It_Ref_t iterRef = le_hashmap_GetIterator(StationMap);
+
+    while (LE_OK == le_hashmap_NextNode(iterRef))
+    {
+        le_mem_Release((void *)le_hashmap_GetValue(iterRef));
+    }
+    le_hashmap_RemoveAll(StationMap);
+    StationRefreshTime = (le_clk_Time_t){0, 0};
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Refresh the station table with the statistics dumped by the driver, unless it was done less than
+ * STATION_REFRESH_MS ago. The stations missed by the events are added or removed.
+ *
+ * @return LE_FAULT The statistics could not be dumped.
+ * @return LE_OK    Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t RefreshStations
+(
+    void
+)
+{
+    static le_wifiAp_StationInfo_t stations[STATION_MAX];
+    size_t                         numStations = STATION_MAX;
+    le_clk_Time_t                  now = le_clk_GetRelativeTime();
+    le_clk_Time_t                  age = le_clk_Sub(now, StationRefreshTime);
+    le_hashmap_It_Ref_t            iterRef;
+    le_result_t                    result;
+    size_t                         i;
+
+    if (((0 != StationRefreshTime.sec) || (0 != StationRefreshTime.usec)) &&
+        ((age.sec * 1000 + age.usec / 1000) < STATION_REFRESH_MS))
+    {
+        return LE_OK;
+    }
+
+    result = pa_wifiAp_GetStations(stations, &numStations);
+    if (LE_OK != result)
+    {
+        return LE_FAULT;
+    }
+
+    iterRef = le_hashmap_GetIterator(StationMap);
+    while (LE_OK == le_hashmap_NextNode(iterRef))
+    {
+        ((Station_t *)le_hashmap_GetValue(iterRef))->isDumped = false;
+    }
+
+    for (i = 0; i < numStations; i++)
+    {
+        le_clk_Time_t connectTime = now;
+        Station_t    *stationPtr;
+
+        connectTime.sec -= stations[i].connectedSec;
+        stationPtr = AddStation(stations[i].macAddr, connectTime);
+        if (NULL == stationPtr)
+        {
+            continue;
+        }
+        stationPtr->info = stations[i];
+        if (0 == stationPtr->info.connectedSec)
+        {
+            // Not all drivers dump the connected time
+            stationPtr->info.connectedSec = le_clk_Sub(now, stationPtr->connectTime).sec;
+        }
+        stationPtr->isDumped = true;
+    }
+
+    // The stations left have been disconnected without event
+    iterRef = le_hashmap_GetIterator(StationMap);
+    while (LE_OK == le_hashmap_NextNode(iterRef))
+    {
+        Station_t *stationPtr = (Station_t *)le_hashmap_GetValue(iterRef);
+
+        if (!stationPtr->isDumped)
+        {
+            LE_DEBUG("Station %s gone", stationPtr->info.macAddr);
+            DeleteStation(stationPtr->info.macAddr);
+            iterRef = le_hashmap_GetIterator(StationMap);
+        }
+    }
+
+    StationRefreshTime = now;
+    return LE_OK;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * CallBack for PA Access Point Events.
@@ -29,14 +237,31 @@ static le_event_Id_t NewWifiApEventId;
 
 static void PaEventApHandler
 (
-    le_wifiAp_Event_t event,
+    const le_wifiAp_EventInd_t *wifiEventPtr,
     void *ctxPtr
 )
 {
+    LE_DEBUG("Event: %d, station: %s", wifiEventPtr->event, wifiEventPtr->macAddr);
 
-    LE_DEBUG("Event: %d", event);
+    if ('\0' != wifiEventPtr->macAddr[0])
+    {
+        if (LE_WIFIAP_EVENT_CLIENT_CONNECTED == wifiEventPtr->event)
+        {
+            AddStation(wifiEventPtr->macAddr, le_clk_GetRelativeTime());
+            // Evict the most idle station if the new one exceeds the maximum number of clients
+            if (LE_OK != pa_wifiAp_AdmitStation(wifiEventPtr->macAddr))
+            {
+                LE_WARN("Admission policy not applied to %s", wifiEventPtr->macAddr);
+            }
+        }
+        else if (LE_WIFIAP_EVENT_CLIENT_DISCONNECTED == wifiEventPtr->event)
+        {
+            DeleteStation(wifiEventPtr->macAddr);
+        }
+    }
 
-    le_event_Report(NewWifiApEventId, (void *)&event, sizeof(le_wifiAp_Event_t));
+    le_event_Report(NewWifiApEventId, (void *)&wifiEventPtr->event, sizeof(le_wifiAp_Event_t));
+    le_event_Report(StationEventId, (void *)wifiEventPtr, sizeof(le_wifiAp_EventInd_t));
 }
 
 
@@ -118,6 +343,139 @@ void le_wifiAp_RemoveNewEventHandler
     le_event_RemoveHandler((le_event_HandlerRef_t)handlerRef);
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * The first-layer station event handler.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void FirstLayerStationEventHandler
+(
+    void *reportPtr,
+    void *secondLayerHandlerFunc
+)
+{
+    le_wifiAp_StationEventHandlerFunc_t  clientHandlerFunc = secondLayerHandlerFunc;
+    le_wifiAp_EventInd_t                *wifiEventPtr      = (le_wifiAp_EventInd_t *)reportPtr;
+
+    if (NULL != wifiEventPtr)
+    {
+        clientHandlerFunc(wifiEventPtr, le_event_GetContextPtr());
+    }
+    else
+    {
+        LE_ERROR("Event is NULL");
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add handler function for EVENT 'le_wifiAp_StationEvent'
+ *
+ * These events provide information on the stations of the WiFi Access Point, with their MAC
+ * address.
+ */
+//--------------------------------------------------------------------------------------------------
+le_wifiAp_StationEventHandlerRef_t le_wifiAp_AddStationEventHandler
+(
+    le_wifiAp_StationEventHandlerFunc_t handlerFuncPtr,
+        ///< [IN]
+        ///< Event handler function
+
+    void *contextPtr
+        ///< [IN]
+        ///< Associated event context
+)
+{
+    le_event_HandlerRef_t handlerRef;
+
+    if (handlerFuncPtr == NULL)
+    {
+        LE_KILL_CLIENT("handlerFuncPtr is NULL !");
+        return NULL;
+    }
+
+    handlerRef = le_event_AddLayeredHandler("WiFiApStationEventHandler",
+        StationEventId,
+        FirstLayerStationEventHandler,
+        (le_event_HandlerFunc_t)handlerFuncPtr);
+
+    le_event_SetContextPtr(handlerRef, contextPtr);
+
+    return (le_wifiAp_StationEventHandlerRef_t)(handlerRef);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove handler function for EVENT 'le_wifiAp_StationEvent'
+ */
+//--------------------------------------------------------------------------------------------------
+void le_wifiAp_RemoveStationEventHandler
+(
+    le_wifiAp_StationEventHandlerRef_t handlerRef
+        ///< [IN]
+        ///< Event handler function to remove.
+)
+{
+    le_event_RemoveHandler((le_event_HandlerRef_t)handlerRef);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get a page of the station table: the statistics of the stations associated with the Access
+ * Point, from the given index. The statistics are refreshed from the driver at most once per
+ * second.
+ *
+ * @return LE_BAD_PARAMETER Some parameter is invalid.
+ * @return LE_FAULT         The statistics could not be dumped.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_wifiAp_GetStations
+(
+    uint32_t startIndex,
+        ///< [IN]
+        ///< Index of the first station of the page.
+    le_wifiAp_StationInfo_t *stationsPtr,
+        ///< [OUT]
+        ///< Statistics of the stations.
+    size_t *stationsNumElementsPtr,
+        ///< [INOUT]
+        ///< In: size of the page. Out: number of stations returned.
+    uint32_t *totalPtr
+        ///< [OUT]
+        ///< Number of stations associated with the Access Point.
+)
+{
+    le_hashmap_It_Ref_t iterRef;
+    uint32_t            index = 0;
+    size_t              numStations = 0;
+
+    if ((NULL == stationsPtr) || (NULL == stationsNumElementsPtr) || (NULL == totalPtr))
+    {
+        LE_KILL_CLIENT("Invalid parameter");
+        return LE_BAD_PARAMETER;
+    }
+
+    if (LE_OK != RefreshStations())
+    {
+        return LE_FAULT;
+    }
+
+    iterRef = le_hashmap_GetIterator(StationMap);
+    while ((LE_OK == le_hashmap_NextNode(iterRef)) && (numStations < *stationsNumElementsPtr))
+    {
+        if (index++ >= startIndex)
+        {
+            stationsPtr[numStations++] = ((Station_t *)le_hashmap_GetValue(iterRef))->info;
+        }
+    }
+
+    *stationsNumElementsPtr = numStations;
+    *totalPtr = le_hashmap_Size(StationMap);
+    return LE_OK;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This function starts the WiFi Access Point.
@@ -152,6 +510,8 @@ le_result_t le_wifiAp_Stop
     void
 )
 {
+    wifiApDhcp_Stop();
+    ClearStations();
     return pa_wifiAp_Stop();
 }
 
@@ -160,10 +520,12 @@ le_result_t le_wifiAp_Stop
 //--------------------------------------------------------------------------------------------------
 /**
  * Set the Service Set IDentification (SSID) of the access point
+ * If the access point is started, the setting is applied at once without a restart.
  *
  * @note The SSID does not have to be human readable ASCII values, but often is.
  *
  * @return LE_BAD_PARAMETER Some parameter is invalid.
+ * @return LE_FAULT         The started access point could not be reconfigured.
  * @return LE_OK            Function succeeded.
  */
 //--------------------------------------------------------------------------------------------------
@@ -185,10 +547,12 @@ le_result_t le_wifiAp_SetSsid
 //--------------------------------------------------------------------------------------------------
 /**
  * Set the security protocol to use.
+ * If the access point is started, the setting is applied at once without a restart.
  *
  * @note that the SSID does not have to be human readable ASCII values, but often has.
  *
  * @return LE_BAD_PARAMETER Some parameter is invalid.
+ * @return LE_FAULT         The started access point could not be reconfigured.
  * @return LE_OK            Function succeeded.
  */
 //--------------------------------------------------------------------------------------------------
@@ -206,12 +570,14 @@ le_result_t le_wifiAp_SetSecurityProtocol
 //--------------------------------------------------------------------------------------------------
 /**
  * Set the passphrase used to generate the PSK.
+ * If the access point is started, the setting is applied at once without a restart.
  *
  * @note This is one way to authenticate against the access point. The other one is provided by the
  * le_wifiAp_SetPreSharedKey() function. Both ways are exclusive and are effective only when used
  * with WPA-personal authentication.
  *
  * @return LE_BAD_PARAMETER Parameter is invalid.
+ * @return LE_FAULT         The started access point could not be reconfigured.
  * @return LE_OK            Function succeeded.
  *
  */
@@ -230,12 +596,14 @@ le_result_t le_wifiAp_SetPassPhrase
 //--------------------------------------------------------------------------------------------------
 /**
  * Set the pre-shared key (PSK).
+ * If the access point is started, the setting is applied at once without a restart.
  *
  * @note This is one way to authenticate against the access point. The other one is provided by the
  * le_wifiAp_SetPassPhrase() function. Both ways are exclusive and are effective only when used
  * with WPA-personal authentication.
  *
  * @return LE_BAD_PARAMETER Parameter is invalid.
+ * @return LE_FAULT         The started access point could not be reconfigured.
  * @return LE_OK            Function succeeded.
  *
  */
@@ -256,7 +624,9 @@ le_result_t le_wifiAp_SetPreSharedKey
  * Set if the Access Point should announce its presence.
  * Default value is TRUE.
  * If the value is set to FALSE, the Access Point will be hidden.
+ * If the access point is started, the setting is applied at once without a restart.
  *
+ * @return LE_FAULT         The started access point could not be reconfigured.
  * @return LE_OK            Function succeeded.
  *
  */
@@ -280,8 +650,11 @@ le_result_t le_wifiAp_SetDiscoverable
  * The channel number must be between 1 and 14 for IEEE 802.11b/g.
  * The channel number must be between 7 and 196 for IEEE 802.11a.
  * The channel number must be between 1 and 6 for IEEE 802.11ad.
+ * If the access point is started, the setting is applied at once without a restart.
+ * The automatic channel selection is disabled.
  * @return
  *      - LE_OUT_OF_RANGE if requested channel number is out of range.
+ *      - LE_FAULT if the started access point could not be reconfigured.
  *      - LE_OK if the function succeeded.
  *
  */
@@ -296,108 +669,373 @@ le_result_t le_wifiAp_SetChannel
     return pa_wifiAp_SetChannel(channelNumber);
 }
 
-
 //--------------------------------------------------------------------------------------------------
 /**
- * Set which IEEE standard to use.
- * Default hardware mode is IEEE 802.11g.
+ * Move the started access point to another channel without disconnecting the stations, unlike a
+ * stop and a start. The switch is announced to the stations in the given number of beacons (CSA),
+ * and LE_WIFIAP_EVENT_CHANNEL_SWITCHED is reported to the event handlers once it has occurred.
+ * The channel must be valid for the IEEE standard, as for le_wifiAp_SetChannel().
+ * The automatic channel selection is disabled.
  *
  * @return
- *      - LE_BAD_PARAMETER if invalid IEEE standard is set.
+ *      - LE_OUT_OF_RANGE if the channel number is out of range, or the number of beacons is 0.
+ *      - LE_UNAVAILABLE if the access point is not started.
+ *      - LE_UNSUPPORTED if the driver does not support the channel switch.
+ *      - LE_FAULT if the function failed.
  *      - LE_OK if the function succeeded.
  *
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t le_wifiAp_SetIeeeStandard
+le_result_t le_wifiAp_SwitchChannel
 (
-    le_wifiAp_IeeeStdBitMask_t stdMask
+    uint16_t channelNumber,
         ///< [IN]
-        ///< Bit mask for the IEEE standard.
+        ///< the channel number.
+    uint8_t beaconCount
+        ///< [IN]
+        ///< Number of beacons announcing the switch before it occurs.
 )
 {
-    return pa_wifiAp_SetIeeeStandard(stdMask);
+    return pa_wifiAp_SwitchChannel(channelNumber, beaconCount);
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Get which IEEE standard was set.
- * Default hardware mode is IEEE 802.11g.
+ * Select the channel automatically. The least loaded channel is selected from a scan and a survey
+ * of the busy time and noise of the channels before the access point starts: one of the
+ * non-overlapping channels 1, 6 and 11 in the 2.4 GHz band, or a channel without radar detection
+ * in the 5 GHz band. While started, the channel is re-evaluated periodically and switched live if
+ * the load of the current channel crosses the threshold.
  *
  * @return
- *      - LE_FAULT if the function failed.
+ *      - LE_BAD_PARAMETER if the threshold is above 100%.
  *      - LE_OK if the function succeeded.
  *
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t le_wifiAp_GetIeeeStandard
+le_result_t le_wifiAp_SetAutoChannel
 (
-    le_wifiAp_IeeeStdBitMask_t *stdMaskPtr
-        ///< [OUT]
-        ///< Bit mask for the IEEE standard.
+    bool isEnabled,
+        ///< [IN]
+        ///< Whether the channel is selected automatically.
+    uint32_t periodSec,
+        ///< [IN]
+        ///< Period in seconds of the re-evaluation while started, 0 to select on start only.
+    uint8_t loadThreshold
+        ///< [IN]
+        ///< Load in percent of the current channel above which another channel is selected.
 )
 {
-    if ( NULL == stdMaskPtr )
-    {
-        LE_WARN("stdMaskPtr is NULL.");
-        return LE_FAULT;
-    }
-    return pa_wifiAp_GetIeeeStandard(stdMaskPtr);
+    return pa_wifiAp_SetAutoChannel(isEnabled, periodSec, loadThreshold);
 }
 
+//--------------------------------------------------------------------------------------------------
 /**
- * Set what country code to use for regulatory domain.
- * ISO/IEC 3166-1 Alpha-2 code is used.
- * Default country code is US.
+ * Set the channel width: 20, 40 or 80 MHz. The 40 MHz width requires IEEE 802.11n, the 80 MHz width
+ * IEEE 802.11ac in the 5 GHz band: the width is narrowed on a channel or an IEEE standard which does
+ * not allow it.
+ * If the access point is started, the setting is applied by a restart of hostapd.
+ *
  * @return
- *      - LE_FAULT if the function failed.
+ *      - LE_BAD_PARAMETER if the width is invalid.
+ *      - LE_UNSUPPORTED if the radio does not support the width.
+ *      - LE_FAULT if the started access point could not be reconfigured.
  *      - LE_OK if the function succeeded.
  *
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t le_wifiAp_SetCountryCode
+le_result_t le_wifiAp_SetChannelWidth
 (
-    const char *countryCodePtr
+    le_wifiAp_ChannelWidth_t width
         ///< [IN]
-        ///< the country code.
+        ///< the channel width.
 )
 {
-    return pa_wifiAp_SetCountryCode(countryCodePtr);
+    return pa_wifiAp_SetChannelWidth(width);
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- *  WiFi access point component initialization.
+ * Set the optional HT/VHT capabilities: short guard interval, LDPC coding and STBC, and the number
+ * of spatial streams. Each capability is enabled as far as the radio supports it. The number of
+ * spatial streams takes effect on the next start of the access point.
+ * If the access point is started, the capabilities are applied by a restart of hostapd.
+ *
+ * @return
+ *      - LE_BAD_PARAMETER if a capability is invalid.
+ *      - LE_UNSUPPORTED if the radio does not support a capability or the number of streams.
+ *      - LE_FAULT if the started access point could not be reconfigured.
+ *      - LE_OK if the function succeeded.
+ *
  */
 //--------------------------------------------------------------------------------------------------
-void le_wifiAp_Init
+le_result_t le_wifiAp_SetPhyCapabilities
 (
-    void
+    le_wifiAp_PhyCapBitMask_t capMask,
+        ///< [IN]
+        ///< the optional capabilities to enable.
+    uint8_t numSpatialStreams
+        ///< [IN]
+        ///< the number of spatial streams, 0 for all the streams of the radio.
 )
 {
-    LE_DEBUG("WiFi Access Point Service is ready");
-
-    pa_wifiAp_Init();
-
-    // Create an event Id for new WiFi Events
-    NewWifiApEventId = le_event_CreateId("WiFiApEventId", sizeof(le_wifiAp_Event_t));
-
-    // register for events from PA.
-    pa_wifiAp_AddEventHandler(PaEventApHandler, NULL);
-
+    return pa_wifiAp_SetPhyCapabilities(capMask, numSpatialStreams);
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Set number of maximally allowed clients to connect to the Access Point at the same time.
+ * Get the capabilities of the radio in the band of the IEEE standard: the widest channel, the
+ * optional HT/VHT capabilities and the number of spatial streams. They are discovered from the
+ * driver when the access point starts.
  *
- * @return LE_OUT_OF_RANGE  Requested number of users exceeds the capabilities of the Access Point.
- * @return LE_OK            Function succeeded.
+ * @return
+ *      - LE_UNAVAILABLE if the WiFi hardware is not started: the capabilities are unknown.
+ *      - LE_OK if the function succeeded.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_wifiAp_GetPhyCapabilities
+(
+    le_wifiAp_ChannelWidth_t *maxWidthPtr,
+        ///< [OUT]
+        ///< the widest channel supported.
+    le_wifiAp_PhyCapBitMask_t *capMaskPtr,
+        ///< [OUT]
+        ///< the optional capabilities supported.
+    uint8_t *numSpatialStreamsPtr
+        ///< [OUT]
+        ///< the number of spatial streams.
+)
+{
+    if ((NULL == maxWidthPtr) || (NULL == capMaskPtr) || (NULL == numSpatialStreamsPtr))
+    {
+        LE_KILL_CLIENT("Invalid parameter !");
+        return LE_BAD_PARAMETER;
+    }
+    return pa_wifiAp_GetPhyCapabilities(maxWidthPtr, capMaskPtr, numSpatialStreamsPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the tuning profile of the radio: beacon interval, DTIM period, RTS and fragmentation
+ * thresholds and WMM EDCA parameters suited to
+ * - LE_WIFIAP_PROFILE_DEFAULT: the hostapd defaults,
+ * - LE_WIFIAP_PROFILE_LOW_LATENCY: interactive traffic,
+ * - LE_WIFIAP_PROFILE_HIGH_THROUGHPUT: bulk and video transfers,
+ * - LE_WIFIAP_PROFILE_POWER_SAVE: battery powered stations, with a long DTIM period,
+ * - LE_WIFIAP_PROFILE_DENSE: many stations and access points around.
+ * The overridden tuning parameters are reset to the values of the profile.
+ * If the access point is started, the setting is applied by a restart of hostapd.
+ *
+ * @return
+ *      - LE_BAD_PARAMETER if the profile is invalid.
+ *      - LE_FAULT if the started access point could not be reconfigured.
+ *      - LE_OK if the function succeeded.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_wifiAp_SetProfile
+(
+    le_wifiAp_Profile_t profile
+        ///< [IN]
+        ///< the tuning profile.
+)
+{
+    return pa_wifiAp_SetProfile(profile);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Override a tuning parameter of the profile. The contention windows of the WMM parameters are
+ * exponents: CW = 2^value - 1.
+ * If the access point is started, the setting is applied by a restart of hostapd.
+ *
+ * @return
+ *      - LE_BAD_PARAMETER if the parameter is invalid.
+ *      - LE_OUT_OF_RANGE if the value is out of the range of the parameter.
+ *      - LE_FAULT if the started access point could not be reconfigured.
+ *      - LE_OK if the function succeeded.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_wifiAp_SetTuningParameter
+(
+    le_wifiAp_TuningParam_t param,
+        ///< [IN]
+        ///< the tuning parameter.
+    int32_t value
+        ///< [IN]
+        ///< the value of the parameter.
+)
+{
+    return pa_wifiAp_SetTuningParameter(param, value);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the value of a tuning parameter: its override, or else its value in the profile.
+ *
+ * @return
+ *      - LE_BAD_PARAMETER if the parameter is invalid.
+ *      - LE_OK if the function succeeded.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_wifiAp_GetTuningParameter
+(
+    le_wifiAp_TuningParam_t param,
+        ///< [IN]
+        ///< the tuning parameter.
+    int32_t *valuePtr
+        ///< [OUT]
+        ///< the value of the parameter.
+)
+{
+    if (NULL == valuePtr)
+    {
+        LE_KILL_CLIENT("valuePtr is NULL !");
+        return LE_BAD_PARAMETER;
+    }
+    return pa_wifiAp_GetTuningParameter(param, valuePtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the channel of the access point, as set or as selected automatically.
+ *
+ * @return
+ *      - LE_OK if the function succeeded.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_wifiAp_GetChannel
+(
+    uint16_t *channelNumberPtr
+        ///< [OUT]
+        ///< the channel number.
+)
+{
+    if (NULL == channelNumberPtr)
+    {
+        LE_KILL_CLIENT("channelNumberPtr is NULL !");
+        return LE_BAD_PARAMETER;
+    }
+    return pa_wifiAp_GetChannel(channelNumberPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set which IEEE standard to use.
+ * Default hardware mode is IEEE 802.11g.
+ *
+ * @return
+ *      - LE_BAD_PARAMETER if invalid IEEE standard is set.
+ *      - LE_OK if the function succeeded.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_wifiAp_SetIeeeStandard
+(
+    le_wifiAp_IeeeStdBitMask_t stdMask
+        ///< [IN]
+        ///< Bit mask for the IEEE standard.
+)
+{
+    return pa_wifiAp_SetIeeeStandard(stdMask);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get which IEEE standard was set.
+ * Default hardware mode is IEEE 802.11g.
+ *
+ * @return
+ *      - LE_FAULT if the function failed.
+ *      - LE_OK if the function succeeded.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_wifiAp_GetIeeeStandard
+(
+    le_wifiAp_IeeeStdBitMask_t *stdMaskPtr
+        ///< [OUT]
+        ///< Bit mask for the IEEE standard.
+)
+{
+    if ( NULL == stdMaskPtr )
+    {
+        LE_WARN("stdMaskPtr is NULL.");
+        return LE_FAULT;
+    }
+    return pa_wifiAp_GetIeeeStandard(stdMaskPtr);
+}
+
+/**
+ * Set what country code to use for regulatory domain.
+ * ISO/IEC 3166-1 Alpha-2 code is used.
+ * Default country code is US.
+ * @return
+ *      - LE_FAULT if the function failed.
+ *      - LE_OK if the function succeeded.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_wifiAp_SetCountryCode
+(
+    const char *countryCodePtr
+        ///< [IN]
+        ///< the country code.
+)
+{
+    return pa_wifiAp_SetCountryCode(countryCodePtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  WiFi access point component initialization.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_wifiAp_Init
+(
+    void
+)
+{
+    LE_DEBUG("WiFi Access Point Service is ready");
+
+    pa_wifiAp_Init();
+
+    // Create an event Id for new WiFi Events
+    NewWifiApEventId = le_event_CreateId("WiFiApEventId", sizeof(le_wifiAp_Event_t));
+
+    StationEventId = le_event_CreateId("WiFiApStationEventId", sizeof(le_wifiAp_EventInd_t));
+    StationPool = le_mem_CreatePool("WiFiApStationPool", sizeof(Station_t));
+    StationMap = le_hashmap_Create("WiFiApStations", STATION_MAX, le_hashmap_HashString,
+                                   le_hashmap_EqualsString);
+
+    // register for events from PA.
+    pa_wifiAp_AddEventIndHandler(PaEventApHandler, NULL);
+
+    BssRefMap = le_ref_CreateMap("le_wifiAp_Bss", PA_WIFIAP_MAX_BSS);
+
+    wifiApDhcp_Init();
+
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set number of maximally allowed clients to connect to the Access Point at the same time.
+ * If the access point is started, the setting is applied at once without a restart.
+ *
+ * @return LE_OUT_OF_RANGE  Requested number of users exceeds the capabilities of the Access Point.
+ * @return LE_FAULT         The started access point could not be reconfigured.
+ * @return LE_OK            Function succeeded.
  *
  */
 //--------------------------------------------------------------------------------------------------
 le_result_t le_wifiAp_SetMaxNumberOfClients
 (
-    int8_t maxNumberOfClients
+    uint16_t maxNumberOfClients
         ///< [IN]
         ///< the maximum number of clients
 )
@@ -411,9 +1049,38 @@ le_result_t le_wifiAp_SetMaxNumberOfClients
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Defines the IP adresses range for the host AP.
+ * Get the maximum number of clients the WiFi driver supports in Access Point mode, which bounds
+ * le_wifiAp_SetMaxNumberOfClients(). It is discovered from the driver when the Access Point starts.
+ *
+ * @return LE_UNAVAILABLE   The WiFi hardware is not started or the driver does not report the
+ *                          capability: the capability is unknown, and up to 10 clients are
+ *                          accepted once started.
+ * @return LE_OK            Function succeeded.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_wifiAp_GetMaxNumberOfClientsCapability
+(
+    uint32_t *maxNumberOfClientsPtr
+        ///< [OUT]
+        ///< the maximum number of clients supported by the driver
+)
+{
+    if (NULL == maxNumberOfClientsPtr)
+    {
+        LE_KILL_CLIENT("maxNumberOfClientsPtr is NULL !");
+        return LE_BAD_PARAMETER;
+    }
+    return pa_wifiAp_GetMaxNumberClientsCapability(maxNumberOfClientsPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Defines the IP adresses range for the host AP. The addresses are served by the DHCP server of
+ * the WiFi service; changing the range keeps the leases which are still within it.
  *
  * @return LE_BAD_PARAMETER At least, one of the given IP addresses is invalid.
+ * @return LE_NOT_PERMITTED The access point is bridged with its uplink.
  * @return LE_FAULT         A system call has failed.
  * @return LE_OK            Function succeeded.
  *
@@ -432,6 +1099,630 @@ le_result_t le_wifiAp_SetIpRange
         ///< the stop IP address of the Access Point.
 )
 {
-    return pa_wifiAp_SetIpRange(ip_ap, ip_start, ip_stop);
+    char        ifName[LE_WIFIDEFS_MAX_IFNAME_BYTES];
+    le_result_t result = pa_wifiAp_SetIpRange(ip_ap, ip_start, ip_stop);
+
+    if (LE_OK != result)
+    {
+        return result;
+    }
+    pa_wifiAp_GetInterface(ifName, sizeof(ifName));
+    return wifiApDhcp_Start(ifName, ip_ap, ip_start, ip_stop);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the uplink of the access point. In bridge mode, the WiFi interface is bridged at layer 2
+ * with the uplink interface, e.g. Ethernet or USB, and the clients are addressed by its network.
+ * In NAT mode, the traffic of the clients is routed to the uplink interface with NAT, and they are
+ * addressed with the range set by le_wifiAp_SetIpRange(). Default is no uplink.
+ * If the access point is started, a NAT uplink is applied at once without a restart.
+ *
+ * @return LE_BAD_PARAMETER Some parameter is invalid, or the uplink interface does not exist.
+ * @return LE_BUSY          The access point is started and the bridge mode is set or requested.
+ * @return LE_FAULT         The uplink could not be set up.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_wifiAp_SetUplink
+(
+    le_wifiAp_UplinkMode_t mode,
+        ///< [IN]
+        ///< The uplink mode.
+    const char *ifNamePtr
+        ///< [IN]
+        ///< The uplink interface, ignored without uplink.
+)
+{
+    return pa_wifiAp_SetUplink(mode, ifNamePtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the uplink of the access point.
+ *
+ * @return LE_BAD_PARAMETER Some parameter is invalid.
+ * @return LE_OVERFLOW      The interface name does not fit in the buffer.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_wifiAp_GetUplink
+(
+    le_wifiAp_UplinkMode_t *modePtr,
+        ///< [OUT]
+        ///< The uplink mode.
+    char *ifNamePtr,
+        ///< [OUT]
+        ///< The uplink interface, empty without uplink.
+    size_t ifNameSize
+        ///< [IN]
+        ///< The size in bytes of the interface name buffer.
+)
+{
+    return pa_wifiAp_GetUplink(modePtr, ifNamePtr, ifNameSize);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Enable or disable the fast path of the NAT uplink, which offloads the established flows to a
+ * flowtable. Default is disabled. Its effect on the throughput depends on the platform.
+ * If the access point is started with a NAT uplink, the setting is applied at once.
+ *
+ * @return LE_FAULT  The flowtable could not be installed: the flows stay on the netfilter path.
+ * @return LE_OK     Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_wifiAp_SetNatOffload
+(
+    bool enable
+        ///< [IN]
+        ///< True to offload the established flows.
+)
+{
+    return pa_wifiAp_SetNatOffload(enable);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the traffic statistics of the access point: byte counters of the WiFi interface, throughput
+ * since the previous call and number of flows offloaded to the fast path of the NAT uplink.
+ *
+ * @return LE_BAD_PARAMETER Some parameter is invalid.
+ * @return LE_FAULT         The function failed.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_wifiAp_GetUplinkStats
+(
+    le_wifiAp_UplinkStats_t *statsPtr
+        ///< [OUT]
+        ///< Statistics of the uplink.
+)
+{
+    return pa_wifiAp_GetUplinkStats(statsPtr);
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Limit the rates of a station of the access point by its MAC address, whether associated or not,
+ * so that a bulk transfer of one station does not starve the others. The downlink is shaped in
+ * queues of its own, one per WMM access category each limited to the rate, and the excess of the
+ * uplink is dropped, so that the station backs off. A rate of 0 does not limit the direction, and
+ * both at 0 remove the limits of the station.
+ * If the access point is started, the limits are applied at once.
+ *
+ * @return LE_BAD_PARAMETER The MAC address is invalid.
+ * @return LE_NO_MEMORY     Too many stations are already limited.
+ * @return LE_FAULT         The limits could not be applied to the started access point.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_wifiAp_SetStationRateLimit
+(
+    const char *macAddrPtr,
+        ///< [IN]
+        ///< MAC address of the station.
+    uint32_t downlinkKbps,
+        ///< [IN]
+        ///< Rate to the station in kbit/s, 0 for no limit.
+    uint32_t uplinkKbps
+        ///< [IN]
+        ///< Rate from the station in kbit/s, 0 for no limit.
+)
+{
+    return pa_wifiAp_SetStationRateLimit(macAddrPtr, downlinkKbps, uplinkKbps);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the rate limits of a station and the counters of its shaping, to verify their effect: the
+ * downlink packets dropped and queued, and the uplink packets dropped. The counters are 0 while
+ * the access point is stopped.
+ *
+ * @return LE_BAD_PARAMETER Some parameter is invalid.
+ * @return LE_NOT_FOUND     The station has no rate limit.
+ * @return LE_FAULT         The counters could not be read.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_wifiAp_GetStationShapingStats
+(
+    const char *macAddrPtr,
+        ///< [IN]
+        ///< MAC address of the station.
+    le_wifiAp_StationShapingStats_t *statsPtr
+        ///< [OUT]
+        ///< Rate limits and shaping counters of the station.
+)
+{
+    return pa_wifiAp_GetStationShapingStats(macAddrPtr, statsPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Enable or disable the airtime fairness scheduling of the driver: the stations get an equal share
+ * of the airtime whatever their rate, so that a slow or distant station does not hold the channel
+ * at the expense of the others. Default is disabled.
+ * If the access point is started, the setting is applied at once.
+ *
+ * @return LE_UNSUPPORTED   The driver does not schedule the airtime fairly.
+ * @return LE_FAULT         The setting could not be applied to the started access point.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_wifiAp_SetAirtimeFairness
+(
+    bool enable
+        ///< [IN]
+        ///< True to share the airtime fairly between the stations.
+)
+{
+    return pa_wifiAp_SetAirtimeFairness(enable);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the time after which a station which sends nothing is disconnected, freeing its slot for
+ * another one. Default is 300 seconds.
+ * If the access point is started, the setting is applied at once.
+ *
+ * @return LE_OUT_OF_RANGE  The timeout is 0.
+ * @return LE_FAULT         The started access point could not be reconfigured.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_wifiAp_SetInactivityTimeout
+(
+    uint32_t timeoutSec
+        ///< [IN]
+        ///< Inactivity timeout in seconds.
+)
+{
+    return pa_wifiAp_SetInactivityTimeout(timeoutSec);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Enable or disable the eviction of the most idle station when a new one associates to the access
+ * point having reached its maximum number of clients. The most idle station is disconnected if it
+ * has been idle for 30 seconds at least, else the new one is refused. Default is disabled: the new
+ * stations are refused.
+ * If the access point is started, the setting is applied at once.
+ *
+ * @return LE_FAULT         The started access point could not be reconfigured.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_wifiAp_SetEvictIdleWhenFull
+(
+    bool enable
+        ///< [IN]
+        ///< True to evict the most idle station for a new one.
+)
+{
+    return pa_wifiAp_SetEvictIdleWhenFull(enable);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the signal strength under which the association of a station is rejected, so that slow and
+ * distant stations do not lower the rate of the others. 0 accepts all the stations, as by default.
+ * If the access point is started, the setting is applied at once.
+ *
+ * @return LE_OUT_OF_RANGE  The signal strength is not between -100 and -1 dBm, or 0.
+ * @return LE_FAULT         The started access point could not be reconfigured.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_wifiAp_SetMinAssocRssi
+(
+    int16_t rssi
+        ///< [IN]
+        ///< Signal strength in dBm, 0 for no minimum.
+)
+{
+    return pa_wifiAp_SetMinAssocRssi(rssi);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the PA index of an additional BSS.
+ *
+ * @return The index, NULL if the reference is invalid.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint8_t *GetBssIndex
+(
+    le_wifiAp_BssRef_t bssRef
+)
+{
+    uint8_t *bssIndexPtr = le_ref_Lookup(BssRefMap, bssRef);
+
+    if (NULL == bssIndexPtr)
+    {
+        LE_ERROR("Invalid BSS reference %p", bssRef);
+    }
+    return bssIndexPtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create an additional BSS sharing the radio of the access point, with its own SSID, security,
+ * client limit and IP range. It is started with the access point, once given an SSID.
+ *
+ * @return The reference of the BSS, NULL if the access point is started or no BSS is left.
+ */
+//--------------------------------------------------------------------------------------------------
+le_wifiAp_BssRef_t le_wifiAp_CreateBss
+(
+    void
+)
+{
+    uint8_t bssIndex;
+
+    if (LE_OK != pa_wifiAp_CreateBss(&bssIndex))
+    {
+        return NULL;
+    }
+    BssIndexes[bssIndex] = bssIndex;
+    return le_ref_CreateRef(BssRefMap, &BssIndexes[bssIndex]);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete an additional BSS of the access point.
+ *
+ * @return LE_BAD_PARAMETER The reference is invalid.
+ * @return LE_BUSY          The access point is started.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_wifiAp_DeleteBss
+(
+    le_wifiAp_BssRef_t bssRef
+        ///< [IN]
+        ///< Reference of the BSS.
+)
+{
+    uint8_t     *bssIndexPtr = GetBssIndex(bssRef);
+    char         ifName[LE_WIFIDEFS_MAX_IFNAME_BYTES];
+    le_result_t  result;
+
+    if ((NULL == bssIndexPtr) ||
+        (LE_OK != pa_wifiAp_GetBssInterface(*bssIndexPtr, ifName, sizeof(ifName))))
+    {
+        return LE_BAD_PARAMETER;
+    }
+
+    result = pa_wifiAp_DeleteBss(*bssIndexPtr);
+    if (LE_OK == result)
+    {
+        wifiApDhcp_Remove(ifName);
+        le_ref_DeleteRef(BssRefMap, bssRef);
+    }
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the network interface of an additional BSS of the access point, which exists while the
+ * access point is started.
+ *
+ * @return LE_BAD_PARAMETER Some parameter is invalid.
+ * @return LE_OVERFLOW      The interface name does not fit in the buffer.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_wifiAp_GetBssInterface
+(
+    le_wifiAp_BssRef_t bssRef,
+        ///< [IN]
+        ///< Reference of the BSS.
+    char *ifNamePtr,
+        ///< [OUT]
+        ///< The network interface of the BSS.
+    size_t ifNameSize
+        ///< [IN]
+        ///< The size in bytes of the interface name buffer.
+)
+{
+    uint8_t *bssIndexPtr = GetBssIndex(bssRef);
+
+    if (NULL == bssIndexPtr)
+    {
+        return LE_BAD_PARAMETER;
+    }
+    return pa_wifiAp_GetBssInterface(*bssIndexPtr, ifNamePtr, ifNameSize);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the SSID of an additional BSS of the access point.
+ * If the access point is started, the setting is applied at once: the BSS alone is reloaded,
+ * or the whole radio if hostapd cannot reload a single BSS.
+ *
+ * @return LE_BAD_PARAMETER Some parameter is invalid.
+ * @return LE_FAULT         The started access point could not be reconfigured.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_wifiAp_SetBssSsid
+(
+    le_wifiAp_BssRef_t bssRef,
+        ///< [IN]
+        ///< Reference of the BSS.
+    const uint8_t *ssidPtr,
+        ///< [IN]
+        ///< The SSID to set as an octet array.
+    size_t ssidNumElements
+        ///< [IN]
+        ///< The length of the SSID in bytes.
+)
+{
+    uint8_t *bssIndexPtr = GetBssIndex(bssRef);
+
+    if (NULL == bssIndexPtr)
+    {
+        return LE_BAD_PARAMETER;
+    }
+    return pa_wifiAp_SetBssSsid(*bssIndexPtr, ssidPtr, ssidNumElements);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the security protocol of an additional BSS of the access point. Default is no security.
+ * If the access point is started, the setting is applied at once: the BSS alone is reloaded,
+ * or the whole radio if hostapd cannot reload a single BSS.
+ *
+ * @return LE_BAD_PARAMETER Some parameter is invalid.
+ * @return LE_FAULT         The started access point could not be reconfigured.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_wifiAp_SetBssSecurityProtocol
+(
+    le_wifiAp_BssRef_t bssRef,
+        ///< [IN]
+        ///< Reference of the BSS.
+    le_wifiAp_SecurityProtocol_t securityProtocol
+        ///< [IN]
+        ///< The security protocol used to communicate with the BSS.
+)
+{
+    uint8_t *bssIndexPtr = GetBssIndex(bssRef);
+
+    if (NULL == bssIndexPtr)
+    {
+        return LE_BAD_PARAMETER;
+    }
+    return pa_wifiAp_SetBssSecurityProtocol(*bssIndexPtr, securityProtocol);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the passphrase used to generate the PSK of an additional BSS of the access point.
+ * If the access point is started, the setting is applied at once: the BSS alone is reloaded,
+ * or the whole radio if hostapd cannot reload a single BSS.
+ *
+ * @return LE_BAD_PARAMETER Some parameter is invalid.
+ * @return LE_FAULT         The started access point could not be reconfigured.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_wifiAp_SetBssPassPhrase
+(
+    le_wifiAp_BssRef_t bssRef,
+        ///< [IN]
+        ///< Reference of the BSS.
+    const char *passphrasePtr
+        ///< [IN]
+        ///< Passphrase to authenticate against the BSS.
+)
+{
+    uint8_t *bssIndexPtr = GetBssIndex(bssRef);
+
+    if (NULL == bssIndexPtr)
+    {
+        return LE_BAD_PARAMETER;
+    }
+    return pa_wifiAp_SetBssPassPhrase(*bssIndexPtr, passphrasePtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the pre-shared key (PSK) of an additional BSS of the access point.
+ * If the access point is started, the setting is applied at once: the BSS alone is reloaded,
+ * or the whole radio if hostapd cannot reload a single BSS.
+ *
+ * @return LE_BAD_PARAMETER Some parameter is invalid.
+ * @return LE_FAULT         The started access point could not be reconfigured.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_wifiAp_SetBssPreSharedKey
+(
+    le_wifiAp_BssRef_t bssRef,
+        ///< [IN]
+        ///< Reference of the BSS.
+    const char *preSharedKeyPtr
+        ///< [IN]
+        ///< Pre-shared key used to authenticate against the BSS.
+)
+{
+    uint8_t *bssIndexPtr = GetBssIndex(bssRef);
+
+    if (NULL == bssIndexPtr)
+    {
+        return LE_BAD_PARAMETER;
+    }
+    return pa_wifiAp_SetBssPreSharedKey(*bssIndexPtr, preSharedKeyPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the maximum number of clients connected to an additional BSS of the access point at the
+ * same time. Default value is 10.
+ * If the access point is started, the setting is applied at once: the BSS alone is reloaded,
+ * or the whole radio if hostapd cannot reload a single BSS.
+ *
+ * @return LE_BAD_PARAMETER Some parameter is invalid.
+ * @return LE_OUT_OF_RANGE  Requested number of users exceeds the capabilities of the Access Point.
+ * @return LE_FAULT         The started access point could not be reconfigured.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_wifiAp_SetBssMaxNumberOfClients
+(
+    le_wifiAp_BssRef_t bssRef,
+        ///< [IN]
+        ///< Reference of the BSS.
+    uint16_t maxNumberOfClient
+        ///< [IN]
+        ///< The maximum number of clients of the BSS.
+)
+{
+    uint8_t *bssIndexPtr = GetBssIndex(bssRef);
+
+    if (NULL == bssIndexPtr)
+    {
+        return LE_BAD_PARAMETER;
+    }
+    return pa_wifiAp_SetBssMaxNumberClients(*bssIndexPtr, maxNumberOfClient);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Define the IP address of an additional BSS of the access point and its client IP addresses
+ * range, served by the DHCP server of the WiFi service. It is set once the access point is
+ * started, as the network interface of the BSS exists only then.
+ *
+ * @return LE_BAD_PARAMETER At least, one of the given IP addresses is invalid.
+ * @return LE_NOT_PERMITTED The access point is bridged with its uplink.
+ * @return LE_FAULT         A system call has failed.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_wifiAp_SetBssIpRange
+(
+    le_wifiAp_BssRef_t bssRef,
+        ///< [IN]
+        ///< Reference of the BSS.
+    const char *ip_ap,
+        ///< [IN]
+        ///< the IP address of the BSS.
+    const char *ip_start,
+        ///< [IN]
+        ///< the start IP address of the BSS clients.
+    const char *ip_stop
+        ///< [IN]
+        ///< the stop IP address of the BSS clients.
+)
+{
+    uint8_t     *bssIndexPtr = GetBssIndex(bssRef);
+    char         ifName[LE_WIFIDEFS_MAX_IFNAME_BYTES];
+    le_result_t  result;
+
+    if ((NULL == bssIndexPtr) ||
+        (LE_OK != pa_wifiAp_GetBssInterface(*bssIndexPtr, ifName, sizeof(ifName))))
+    {
+        return LE_BAD_PARAMETER;
+    }
+
+    result = pa_wifiAp_SetBssIpRange(*bssIndexPtr, ip_ap, ip_start, ip_stop);
+    if (LE_OK != result)
+    {
+        return result;
+    }
+    return wifiApDhcp_Start(ifName, ip_ap, ip_start, ip_stop);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the concurrent mode of the access point: it runs on a virtual interface next to the station
+ * interface of the WiFi client, so that both share the radio, e.g. to extend the network the
+ * station is connected to. As the radio operates on a single channel, the access point follows
+ * the channel of the station if it is connected on start. Default is disabled.
+ *
+ * @note The network interfaces are given by le_wifiAp_GetInterfaceName() and
+ * le_wifiClient_GetInterfaceName().
+ *
+ * @return LE_BUSY          The access point is started.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_wifiAp_SetConcurrentMode
+(
+    bool isConcurrent
+        ///< [IN]
+        ///< True to run the access point concurrently with the station.
+)
+{
+    return pa_wifiAp_SetConcurrentMode(isConcurrent);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the network interface of the access point, which depends on the concurrent mode.
+ *
+ * @return LE_OVERFLOW      The interface name does not fit in the buffer.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_wifiAp_GetInterfaceName
+(
+    char *ifNamePtr,
+        ///< [OUT]
+        ///< The network interface of the access point.
+    size_t ifNameSize
+        ///< [IN]
+        ///< The size in bytes of the interface name buffer.
+)
+{
+    return pa_wifiAp_GetInterface(ifNamePtr, ifNameSize);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Select the network interface of the radio of the access point, among the ones returned by
+ * le_wifiClient_GetInterfaces(), so that the access point and the station run on distinct radios
+ * of the module. In concurrent mode, it must be the station interface of the WiFi client.
+ * Default is wlan0.
+ *
+ * @note The service runs a single access point: the interface applies to all the clients of the
+ * service, not to a session. In concurrent mode, the access point runs on the virtual interface
+ * ap0 created on the selected radio.
+ *
+ * @return LE_BAD_PARAMETER The interface name is invalid.
+ * @return LE_BUSY          The access point is started.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_wifiAp_SetInterface
+(
+    const char *ifNamePtr
+        ///< [IN]
+        ///< Network interface of the radio of the access point.
+)
+{
+    return pa_wifiAp_SetInterface(ifNamePtr);
+}
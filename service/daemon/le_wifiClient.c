@@ -6,6 +6,8 @@
  *
  */
 // -------------------------------------------------------------------------------------------------
+#include <arpa/inet.h>
+
 #include "legato.h"
 
 #include "interfaces.h"
@@ -22,6 +24,16 @@
 #define CFG_PATH_WIFI               "wifi/channel"
 #define CFG_NODE_HIDDEN_SSID        "hidden"
 #define CFG_NODE_SECPROTOCOL        "secProtocol"
+#define CFG_NODE_FAST_TRANSITION    "fastTransition"
+#define CFG_NODE_PRIORITY           "priority"
+#define CFG_PATH_LEASE              "wifi/lease"
+#define CFG_NODE_LEASE_ADDRESS      "address"
+#define CFG_NODE_LEASE_NETMASK      "netmask"
+#define CFG_NODE_LEASE_GATEWAY      "gateway"
+#define CFG_NODE_LEASE_DNS          "dns"
+#define CFG_NODE_LEASE_SERVER       "server"
+#define CFG_NODE_LEASE_TIME         "leaseTime"
+#define CFG_NODE_LEASE_EXPIRY       "expiry"
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -43,6 +55,94 @@
 //-------------------------------------------------------------------------------------------------
 #define INIT_AP_COUNT 32
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Roaming engine settings.
+ * The link is monitored by the driver, which reports when the signal crosses the threshold by more
+ * than ROAM_CQM_HYSTERESIS. Once a targeted scan has been triggered, no other one is done before
+ * ROAM_HOLDOFF_MS to avoid flapping between two BSS of similar signal; the search is done again
+ * then if the signal is still low.
+ */
+//-------------------------------------------------------------------------------------------------
+#define ROAM_HOLDOFF_MS             10000
+#define ROAM_CQM_HYSTERESIS         2
+#define ROAM_DEFAULT_THRESHOLD      -75
+#define ROAM_DEFAULT_HYSTERESIS     8
+#define ROAM_MIN_THRESHOLD          -100
+#define ROAM_MAX_THRESHOLD          -30
+#define ROAM_MAX_HYSTERESIS         30
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Auto-reconnect settings.
+ * The delay before each attempt doubles from RECONNECT_BACKOFF_MIN_MS up to
+ * RECONNECT_BACKOFF_MAX_MS, and is randomized in its upper half to avoid synchronized retries.
+ * After RECONNECT_ATTEMPTS_PER_SSID failed attempts, the next saved SSID is tried, by decreasing
+ * priority, among at most RECONNECT_MAX_FALLBACK_SSIDS of them.
+ */
+//-------------------------------------------------------------------------------------------------
+#define RECONNECT_BACKOFF_MIN_MS        1000
+#define RECONNECT_BACKOFF_MAX_MS        60000
+#define RECONNECT_ATTEMPTS_PER_SSID     3
+#define RECONNECT_MAX_FALLBACK_SSIDS    8
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of SSIDs loaded from the config tree to select the network to connect to.
+ */
+//-------------------------------------------------------------------------------------------------
+#define KNOWN_NETWORKS_MAX              32
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of SSID profiles kept decoded in memory by le_wifiClient_LoadSsid().
+ */
+//-------------------------------------------------------------------------------------------------
+#define PROFILE_CACHE_MAX               8
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum length of a line of a profile file given to le_wifiClient_ImportProfiles(), and field
+ * separator of these lines.
+ */
+//-------------------------------------------------------------------------------------------------
+#define IMPORT_LINE_MAX_BYTES           256
+#define IMPORT_FIELD_SEPARATOR          "\t"
+#define IMPORT_SECRET_NODE_COUNT        5
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of connection attempts which phase timing is kept.
+ */
+//-------------------------------------------------------------------------------------------------
+#define CONNECT_TIMING_HISTORY          8
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * A cached DHCP lease is requested again only if it is still valid for this time. A failed renewal
+ * is retried after DHCP_RENEW_RETRY_MS until the lease expires.
+ */
+//-------------------------------------------------------------------------------------------------
+#define DHCP_LEASE_MIN_REMAINING_SEC    10
+#define DHCP_RENEW_RETRY_MS             60000
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Access point selection among the BSSIDs of an SSID. The score starts from the signal strength in
+ * dBm: a 5 GHz access point gets a bonus as long as its signal is good enough, while the failed
+ * connection attempts and the connection time measured in the past are penalized.
+ */
+//-------------------------------------------------------------------------------------------------
+#define BSS_HISTORY_MAX                 32
+#define BSS_5GHZ_MIN_FREQUENCY          4900
+#define BSS_5GHZ_MIN_SIGNAL             -70
+#define BSS_5GHZ_BONUS                  10
+#define BSS_FAILURE_PENALTY             10
+#define BSS_FAILURE_MAX                 5
+#define BSS_LATENCY_STEP_MS             500
+#define BSS_LATENCY_MAX_PENALTY         10
+#define BSS_SCORE_UNKNOWN               INT16_MIN
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Struct to hold the AccessPoint from the Scan's data.
@@ -53,9 +153,262 @@ typedef struct
 {
     pa_wifiClient_AccessPoint_t accessPoint;
     bool                        foundInLatestScan;
+    bool                        autoReconnect;
 }
 FoundAccessPoint_t;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Struct to hold a roam event report.
+ *
+ */
+//-------------------------------------------------------------------------------------------------
+typedef struct
+{
+    char        fromBssid[LE_WIFIDEFS_MAX_BSSID_BYTES]; ///< BSSID of the BSS left.
+    char        toBssid[LE_WIFIDEFS_MAX_BSSID_BYTES];   ///< BSSID of the target BSS.
+    le_result_t result;                                 ///< Result of the reassociation.
+    uint32_t    latencyMs;                              ///< Duration of the reassociation.
+}
+RoamEvent_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Struct to hold the request and the result of a scan.
+ *
+ */
+//-------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_result_t result;                             ///< Result of the completed scan.
+    bool        isRoaming;                          ///< Scan done for the roaming engine.
+    uint8_t     ssidLength;                         ///< Length of the SSID to scan, 0 for all.
+    uint8_t     ssidBytes[LE_WIFIDEFS_MAX_SSID_BYTES]; ///< SSID to scan.
+}
+ScanContext_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Struct to hold the roaming engine state and statistics.
+ *
+ */
+//-------------------------------------------------------------------------------------------------
+typedef struct
+{
+    bool            isEnabled;                              ///< Roaming engine enabled.
+    int16_t         threshold;                              ///< Signal in dBm triggering a scan.
+    uint8_t         hysteresis;                             ///< Signal gain in dB needed to roam.
+    le_timer_Ref_t  monitorTimer;                           ///< Hold-off of the next search.
+    bool            isSignalLow;                            ///< Signal below the threshold.
+    int16_t         linkSignal;                             ///< Signal of the current BSS in the
+                                                            ///< last targeted scan.
+    uint32_t        attemptCount;                           ///< Number of reassociations tried.
+    uint32_t        failureCount;                           ///< Number of reassociations failed.
+    uint32_t        lastLatencyMs;                          ///< Latency of the last roam.
+    uint32_t        maxLatencyMs;                           ///< Highest roam latency.
+    uint64_t        totalLatencyMs;                         ///< Sum of the successful roams.
+}
+RoamingEngine_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Struct to hold a saved SSID to fall back to, and its priority.
+ *
+ */
+//-------------------------------------------------------------------------------------------------
+typedef struct
+{
+    char    ssid[LE_WIFIDEFS_MAX_SSID_BYTES];   ///< Saved SSID.
+    int32_t priority;                           ///< Priority, the highest is tried first.
+}
+FallbackSsid_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Struct to hold the settings of an SSID saved in the config tree, and its best access point found
+ * in the latest scan.
+ *
+ */
+//-------------------------------------------------------------------------------------------------
+typedef struct
+{
+    char                             ssid[LE_WIFIDEFS_MAX_SSID_BYTES]; ///< Saved SSID.
+    int32_t                          priority;          ///< Priority, the highest is selected.
+    le_wifiClient_SecurityProtocol_t secProtocol;       ///< Security protocol.
+    bool                             isHidden;          ///< SSID is hidden.
+    bool                             isFastTransition;  ///< IEEE 802.11r fast BSS transition.
+    int16_t                          signalStrength;    ///< Signal of the selected access point.
+    int32_t                          score;             ///< Score of the selected access point.
+    le_wifiClient_AccessPointRef_t   apRef;             ///< Access point with the best score.
+}
+KnownNetwork_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Struct to hold an SSID profile as loaded from the config tree and the secStore, so that loading
+ * it again does not need any IPC.
+ *
+ */
+//-------------------------------------------------------------------------------------------------
+typedef struct
+{
+    char                             ssid[LE_WIFIDEFS_MAX_SSID_BYTES]; ///< Empty if unused.
+    uint32_t                         lastUse;           ///< Use tick, the oldest is replaced.
+    le_wifiClient_SecurityProtocol_t secProtocol;       ///< Security protocol.
+    bool                             hasAttributes;     ///< Hidden and 802.11r flags loaded.
+    bool                             isHidden;          ///< SSID is hidden.
+    bool                             isFastTransition;  ///< IEEE 802.11r fast BSS transition.
+    union {
+        uint8_t passphrase[LE_WIFIDEFS_MAX_PASSPHRASE_BYTES];
+        uint8_t username[LE_WIFIDEFS_MAX_USERNAME_BYTES];
+        uint8_t wepKey[LE_WIFIDEFS_MAX_WEPKEY_BYTES];
+    } u1;                                               ///< Passphrase, user name or WEP key.
+    size_t                           size1;             ///< Length of u1.
+    union {
+        uint8_t preSharedKey[LE_WIFIDEFS_MAX_PSK_BYTES];
+        uint8_t password[LE_WIFIDEFS_MAX_PASSWORD_BYTES];
+    } u2;                                               ///< Pre-shared key or password.
+    size_t                           size2;             ///< Length of u2.
+}
+CachedProfile_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Struct to hold an SSID profile read from a file given to le_wifiClient_ImportProfiles().
+ *
+ */
+//-------------------------------------------------------------------------------------------------
+typedef struct
+{
+    char                             ssid[LE_WIFIDEFS_MAX_SSID_BYTES];     ///< SSID.
+    le_wifiClient_SecurityProtocol_t secProtocol;                         ///< Security protocol.
+    const char                      *secret1NodePtr;    ///< secStore node of secret1, or NULL.
+    char                             secret1[LE_WIFIDEFS_MAX_PSK_BYTES];  ///< Key or user name.
+    const char                      *secret2NodePtr;    ///< secStore node of secret2, or NULL.
+    char                             secret2[LE_WIFIDEFS_MAX_PASSWORD_BYTES]; ///< Password.
+}
+ImportedProfile_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Struct to hold the credentials of an SSID in the secStore before an import replaces them, to
+ * restore them if the import fails.
+ *
+ */
+//-------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_sls_Link_t link;                                         ///< Link in the list of backups.
+    char          ssid[LE_WIFIDEFS_MAX_SSID_BYTES];             ///< SSID.
+    size_t        secretSize[IMPORT_SECRET_NODE_COUNT];         ///< Size of each secret, 0 if none.
+    uint8_t       secret[IMPORT_SECRET_NODE_COUNT][LE_WIFIDEFS_MAX_PSK_BYTES]; ///< Secrets.
+}
+ImportBackup_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Struct to hold the auto-reconnect state machine and statistics.
+ *
+ * The reconnection attempts are run by a worker thread, so that the connection timeout does not
+ * block the main thread. The session is incremented when the auto-reconnect is stopped: the outcome
+ * of an attempt started before is dropped.
+ */
+//-------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_timer_Ref_t                  timer;                      ///< Backoff timer.
+    bool                            isActive;                   ///< Recovery ongoing.
+    le_thread_Ref_t                 threadRef;                  ///< Attempt running, else NULL.
+    uint32_t                        session;                    ///< Current recovery session.
+    le_wifiClient_AccessPointRef_t  apRef;                      ///< Access point lost.
+    char                            ssid[LE_WIFIDEFS_MAX_SSID_BYTES]; ///< SSID lost.
+    bool                            isCredentialReplaced;       ///< Other SSID loaded since.
+    uint32_t                        attempt;                    ///< Attempts of this recovery.
+    le_clk_Time_t                   lostTime;                   ///< Time of the disconnection.
+    size_t                          fallbackCount;              ///< Number of fallback SSIDs.
+    FallbackSsid_t                  fallback[RECONNECT_MAX_FALLBACK_SSIDS]; ///< By priority.
+    uint32_t                        attemptCount;               ///< Total number of attempts.
+    uint32_t                        recoveryCount;              ///< Number of recoveries.
+    uint32_t                        lastRecoveryMs;             ///< Last time-to-recover.
+    uint32_t                        maxRecoveryMs;              ///< Highest time-to-recover.
+}
+AutoReconnect_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Integrated DHCP client. The leases are cached in the config tree per SSID and BSSID, so that
+ * the address is requested again directly on reconnection.
+ *
+ * The DHCP exchanges are run by a worker thread, one request at a time, so that the retransmissions
+ * do not block the main thread. The session is incremented when the lease in use is released: the
+ * outcome of a request started for a previous session is dropped.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    bool                      isEnabled;                        ///< DHCP run on connection.
+    bool                      hasLease;                         ///< Lease in use.
+    bool                      isIpConfigSet;                    ///< Lease set on ifName.
+    pa_wifiClient_DhcpLease_t lease;                            ///< Lease in use.
+    time_t                    expiry;                           ///< Lease expiry, absolute time.
+    char                      ifName[LE_WIFIDEFS_MAX_IFNAME_BYTES];    ///< Interface.
+    char                      bssid[LE_WIFIDEFS_MAX_BSSID_BYTES];      ///< Access point.
+    char                      ssid[LE_WIFIDEFS_MAX_SSID_BYTES];        ///< Network, may be empty.
+    le_timer_Ref_t            renewTimer;                       ///< Lease renewal timer.
+    le_thread_Ref_t           threadRef;                        ///< Request running, else NULL.
+    bool                      isStartPending;                   ///< Start once the request ends.
+    uint32_t                  session;                          ///< Current lease session.
+    le_clk_Time_t             startTime;                        ///< Start of the address request.
+}
+DhcpClient_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * DHCP request run by the worker thread. It is only accessed by the main thread while no request
+ * is running.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    pa_wifiClient_DhcpRequest_t request;                        ///< Request type.
+    uint32_t                    session;                        ///< Session of the request.
+    char                        ifName[LE_WIFIDEFS_MAX_IFNAME_BYTES];  ///< Interface.
+    pa_wifiClient_DhcpLease_t   lease;                          ///< Lease requested and granted.
+    le_result_t                 result;                         ///< Outcome of the request.
+}
+DhcpContext_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reconnection attempt run by the worker thread. It is only accessed by the main thread while no
+ * attempt is running.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t                        session;                    ///< Session of the attempt.
+    le_wifiClient_AccessPointRef_t  apRef;                      ///< Access point to connect to.
+    uint8_t                         ssidBytes[LE_WIFIDEFS_MAX_SSID_BYTES]; ///< SSID.
+    size_t                          ssidLength;                 ///< SSID length in bytes.
+    char                            bssid[LE_WIFIDEFS_MAX_BSSID_BYTES]; ///< Hint, empty if none.
+    le_result_t                     result;                     ///< Outcome of the attempt.
+}
+ReconnectContext_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Connection history of an access point, used to score it.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    char     bssid[LE_WIFIDEFS_MAX_BSSID_BYTES];  ///< Access point, empty if the slot is free.
+    uint32_t failureCount;                       ///< Consecutive failed connection attempts.
+    uint32_t connectMs;                          ///< Average connection time, 0 if unknown.
+    uint32_t lastUse;                            ///< Tick of the last update, for eviction.
+}
+BssHistory_t;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Safe Reference Map for Access Points found during scan or le_wifiClient_Create()
@@ -105,10 +458,11 @@ static le_thread_Ref_t ScanThreadRef = NULL;
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Result of completed scan
+ * Context of the scan thread. It is set before the thread starts and only accessed by the thread
+ * until it ends.
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t ScanResult = LE_OK;
+static ScanContext_t ScanContext;
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -133,6 +487,27 @@ static le_event_Id_t WifiEventIndicationId;
 //--------------------------------------------------------------------------------------------------
 static le_mem_PoolRef_t WifiEventPool;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pool for the credentials saved by le_wifiClient_ImportProfiles().
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t ImportBackupPool;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * secStore nodes of the credentials of an SSID.
+ */
+//--------------------------------------------------------------------------------------------------
+static const char *const ImportSecretNodes[IMPORT_SECRET_NODE_COUNT] =
+{
+    SECSTORE_NODE_WEP_KEY,
+    SECSTORE_NODE_PASSPHRASE,
+    SECSTORE_NODE_PSK,
+    SECSTORE_NODE_USERNAME,
+    SECSTORE_NODE_USERPWD
+};
+
 //--------------------------------------------------------------------------------------------------
 /**
  * The number of calls to le_wifiClient_Start().
@@ -161,1434 +536,3818 @@ static char scanIfName[LE_WIFIDEFS_MAX_IFNAME_BYTES] = {0};
 
 //--------------------------------------------------------------------------------------------------
 /**
- * CallBack for PA WiFi Event Indications.
+ * BSSID of the BSS the client is associated with, as reported by the last connection event or
+ * reassociation. Empty if the client is not associated.
  */
 //--------------------------------------------------------------------------------------------------
-static void PaEventIndicationHandler
-(
-    le_wifiClient_EventInd_t* wifiEventIndicationPtr,
-    void *contextPtr
-)
-{
-    LE_DEBUG("WiFi event: %d, interface: %s, bssid: %s",
-            wifiEventIndicationPtr->event,
-            wifiEventIndicationPtr->ifName,
-            wifiEventIndicationPtr->apBssid);
-
-    if (LE_WIFICLIENT_EVENT_DISCONNECTED == wifiEventIndicationPtr->event)
-    {
-        LE_DEBUG("disconnectCause: %d", wifiEventIndicationPtr->disconnectionCause);
-    }
-
-    le_event_ReportWithRefCounting(WifiEventIndicationId, wifiEventIndicationPtr);
-}
+static char CurrentBssid[LE_WIFIDEFS_MAX_BSSID_BYTES] = {0};
 
 //--------------------------------------------------------------------------------------------------
 /**
- * CallBack for PA Events.
- * @deprecated pa_wifiClient_AddEventHandler() should not be used anymore.
- * It has been replaced by pa_wifiClient_AddEventIndHandler().
+ * Roaming engine. Disabled by default.
  */
 //--------------------------------------------------------------------------------------------------
-static void PaEventHandler
-(
-    le_wifiClient_Event_t event,
-    void *contextPtr
-)
+static RoamingEngine_t Roaming =
 {
-    LE_DEBUG("Event: %d ", event);
+    .isEnabled  = false,
+    .threshold  = ROAM_DEFAULT_THRESHOLD,
+    .hysteresis = ROAM_DEFAULT_HYSTERESIS,
+};
 
-    le_event_Report(WifiEventId, (void *)&event, sizeof(le_wifiClient_Event_t));
-}
+//--------------------------------------------------------------------------------------------------
+/**
+ * Search of a roaming candidate, started by the signal events of the driver.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RoamSearchCandidate(void);
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Local function to find an access point reference based on BSSID among the AP found in scan.
- * If not found will return NULL.
+ * Event ID for roam event notification.
+ *
  */
 //--------------------------------------------------------------------------------------------------
-static le_wifiClient_AccessPointRef_t FindAccessPointRefFromBssid
-(
-    const char* bssidPtr
-        ///< [OUT]
-        ///< The BSSID returned as a byte array.
-)
-{
-    le_wifiClient_AccessPointRef_t apRef = NULL;
-    le_ref_IterRef_t               iter  = le_ref_GetIterator(ScanApRefMap);
+static le_event_Id_t RoamEventId;
 
-    LE_DEBUG("Find AP from BSSID");
+//--------------------------------------------------------------------------------------------------
+/**
+ * Thread running the WiFi client service, where the roaming decisions are taken.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_thread_Ref_t MainThreadRef = NULL;
 
-    while (le_ref_NextNode(iter) == LE_OK)
-    {
-        apRef = (le_wifiClient_AccessPointRef_t)le_ref_GetSafeRef(iter);
-        if (NULL != apRef)
-        {
-            FoundAccessPoint_t *apPtr = (FoundAccessPoint_t *)le_ref_Lookup(ScanApRefMap, apRef);
-            if (NULL != apPtr)
-            {
-                if (0 == strncmp(apPtr->accessPoint.bssid, bssidPtr, LE_WIFIDEFS_MAX_BSSID_BYTES))
-                {
-                    LE_DEBUG("Found apRef %p", apRef);
-                    return apRef;
-                }
-            }
-        }
-        else
-        {
-            LE_ERROR("ERROR le_ref_GetSafeRef returned NULL iter:%p", iter);
-        }
-    }
-    return NULL;
-}
+//--------------------------------------------------------------------------------------------------
+/**
+ * Auto-reconnect state machine. Idle until a connection with auto-reconnect enabled is lost.
+ */
+//--------------------------------------------------------------------------------------------------
+static AutoReconnect_t    Reconnect;
+static ReconnectContext_t ReconnectContext;
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Local function to find an access point reference based on SSID among the AP found in scan.
- * If not found will return NULL.
+ * SSID profiles loaded by le_wifiClient_LoadSsid(). They are invalidated when reconfigured through
+ * this API or when the config tree changes under CFG_PATH_WIFI.
  */
 //--------------------------------------------------------------------------------------------------
-static le_wifiClient_AccessPointRef_t FindAccessPointRefFromSsid
-(
-    const uint8_t* ssidPtr,
-        ///< [OUT]
-        ///< The SSID returned as a byte array.
-
-    size_t ssidNumElements
-        ///< [INOUT]
-        ///< SSID length in bytes.
-)
-{
-    le_wifiClient_AccessPointRef_t apRef = NULL;
-    le_ref_IterRef_t               iter  = le_ref_GetIterator(ScanApRefMap);
-
-    LE_DEBUG("Find AP from SSID");
-
-    while (le_ref_NextNode(iter) == LE_OK)
-    {
-        apRef = (le_wifiClient_AccessPointRef_t)le_ref_GetSafeRef(iter);
-        if (NULL != apRef)
-        {
-            FoundAccessPoint_t *apPtr = (FoundAccessPoint_t *)le_ref_Lookup(ScanApRefMap, apRef);
-            if (NULL != apPtr)
-            {
-                if (apPtr->accessPoint.ssidLength == ssidNumElements)
-                {
-                    if (0 == memcmp(apPtr->accessPoint.ssidBytes, ssidPtr, ssidNumElements))
-                    {
-                        LE_DEBUG("Found apRef %p", apRef);
-                        return apRef;
-                    }
-                }
-            }
-        }
-        else
-        {
-            LE_ERROR("ERROR le_ref_GetSafeRef returned NULL iter:%p", iter);
-        }
-    }
-    return NULL;
-}
-
+static CachedProfile_t ProfileCache[PROFILE_CACHE_MAX];
+static uint32_t        ProfileCacheTick = 0;
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Local function to add AP:s found during scan to AddRef point interface
+ * Phase timing of the last connection attempts, as a ring buffer. The DHCP phase is 0 as long as
+ * the IP address is not handled by the WiFi service.
  */
 //--------------------------------------------------------------------------------------------------
+static pa_wifiClient_ConnectTiming_t ConnectTimings[CONNECT_TIMING_HISTORY];
+static uint32_t                      ConnectTimingsDhcpMs[CONNECT_TIMING_HISTORY];
+static uint32_t                      ConnectTimingCount = 0;
 
-static le_wifiClient_AccessPointRef_t AddAccessPointToApRefMap
-(
-    pa_wifiClient_AccessPoint_t *apPtr
-)
-{
-    // first see if it alreay exists in our list of reference.
-    le_wifiClient_AccessPointRef_t returnedRef = FindAccessPointRefFromBssid(apPtr->bssid);
-
-    if (NULL != returnedRef)
-    {
-        FoundAccessPoint_t *oldAccessPointPtr =
-            (FoundAccessPoint_t *)le_ref_Lookup(ScanApRefMap, returnedRef);
-
-
-        if (NULL != oldAccessPointPtr)
-        {
-            LE_DEBUG("Already exists %p. Update SignalStrength %d, SSID '%s'",
-                     returnedRef, apPtr->signalStrength, &apPtr->ssidBytes[0]);
-
-            oldAccessPointPtr->accessPoint.signalStrength = apPtr->signalStrength;
-            oldAccessPointPtr->accessPoint.ssidLength = apPtr->ssidLength;
-            memcpy(&oldAccessPointPtr->accessPoint.ssidBytes, &apPtr->ssidBytes,
-                   apPtr->ssidLength);
-            oldAccessPointPtr->foundInLatestScan = true;
-        }
-
-        return returnedRef;
-    }
-    else
-    {
-        FoundAccessPoint_t *foundAccessPointPtr = le_mem_ForceAlloc(AccessPointPool);
-
-        if (foundAccessPointPtr)
-        {
-            FoundWifiApCount++;
-            LE_DEBUG("New AP[%d] SignalStrength %d | SSID length %d | SSID: \"%.*s\"",
-                FoundWifiApCount,
-                apPtr->signalStrength,
-                apPtr->ssidLength,
-                apPtr->ssidLength,
-                (char *)apPtr->ssidBytes
-               );
-
-            // struct member value copy
-            foundAccessPointPtr->accessPoint = *apPtr;
-            foundAccessPointPtr->foundInLatestScan = true;
-
-            // Create a Safe Reference for this object.
-            returnedRef = le_ref_CreateRef(ScanApRefMap, foundAccessPointPtr);
-
-            LE_DEBUG("le_ref_CreateRef foundAccessPointPtr %p; Ref%p ",
-                foundAccessPointPtr, returnedRef);
-        }
-        else
-        {
-            LE_ERROR("le_mem_ForceAlloc failed. Count %d", FoundWifiApCount);
-        }
-    }
+//--------------------------------------------------------------------------------------------------
+/**
+ * Connection quality monitor signal threshold set by le_wifiClient_SetRssiThreshold(), 0 when
+ * disabled. It is set again into the driver on each connection.
+ */
+//--------------------------------------------------------------------------------------------------
+static int16_t RssiThreshold = 0;
+static uint8_t RssiHysteresis = 0;
 
-    return returnedRef;
-}
+//--------------------------------------------------------------------------------------------------
+/**
+ * Integrated DHCP client, disabled by default.
+ */
+//--------------------------------------------------------------------------------------------------
+static DhcpClient_t  Dhcp;
+static DhcpContext_t DhcpContext;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Connection history of the last access points tried, the least recently used is evicted.
+ */
+//--------------------------------------------------------------------------------------------------
+static BssHistory_t BssHistory[BSS_HISTORY_MAX];
+static uint32_t     BssHistoryTick = 0;
 
 //--------------------------------------------------------------------------------------------------
 /**
- *  Frees one members of the access point and the corresponding access points memory
+ * Keep the phase timing of the connection attempt just made by the PA.
+ *
+ * @return
+ *      Total time of the attempt in milliseconds, 0 if unknown.
  */
 //--------------------------------------------------------------------------------------------------
-static void RemoveAccessPoint
+static uint32_t RecordConnectTiming
 (
-    le_wifiClient_AccessPointRef_t apRef
+    void
 )
 {
-    FoundAccessPoint_t *apPtr = (FoundAccessPoint_t *)le_ref_Lookup(ScanApRefMap, apRef);
+    uint32_t index = ConnectTimingCount % CONNECT_TIMING_HISTORY;
 
-    if (apPtr == NULL)
+    if (LE_OK == pa_wifiClient_GetConnectTiming(&ConnectTimings[index]))
     {
-        LE_ERROR("Bad reference");
-        return;
+        ConnectTimingsDhcpMs[index] = 0;
+        ConnectTimingCount++;
+        return ConnectTimings[index].totalMs;
     }
-
-    le_ref_DeleteRef(ScanApRefMap, apRef);
-    le_mem_Release(apPtr);
+    return 0;
 }
 
-
 //--------------------------------------------------------------------------------------------------
 /**
- *  Frees all members of the AddRef and the corresponding AccessPoints added during Scan and
- *  le_wifiClient_Create()
+ * Get the connection history of an access point, optionally creating it in place of the least
+ * recently used one.
+ *
+ * @return
+ *      The history, NULL if not found and not created.
  */
 //--------------------------------------------------------------------------------------------------
-static void ReleaseAllAccessPoints
+static BssHistory_t *GetBssHistory
 (
-    void
+    const char *bssidPtr,
+    bool        create
 )
 {
-    le_wifiClient_AccessPointRef_t apRef = NULL;
-    le_ref_IterRef_t               iter  = le_ref_GetIterator(ScanApRefMap);
-
-    LE_DEBUG("Release all AP");
+    BssHistory_t *oldestPtr = &BssHistory[0];
+    int           i;
 
-    while (le_ref_NextNode(iter) == LE_OK)
+    for (i = 0; i < BSS_HISTORY_MAX; i++)
     {
-        apRef = (le_wifiClient_AccessPointRef_t)le_ref_GetSafeRef(iter);
-        if (NULL != apRef)
+        if (('\0' != BssHistory[i].bssid[0]) &&
+            (0 == strncasecmp(BssHistory[i].bssid, bssidPtr, LE_WIFIDEFS_MAX_BSSID_BYTES)))
         {
-            RemoveAccessPoint(apRef);
+            return &BssHistory[i];
         }
-        else
+        if (BssHistory[i].lastUse < oldestPtr->lastUse)
         {
-            LE_ERROR("ERROR le_ref_GetSafeRef returned NULL iter:%p", iter);
-            return;
+            oldestPtr = &BssHistory[i];
         }
     }
-}
 
+    if (!create)
+    {
+        return NULL;
+    }
+
+    memset(oldestPtr, 0, sizeof(BssHistory_t));
+    le_utf8_Copy(oldestPtr->bssid, bssidPtr, sizeof(oldestPtr->bssid), NULL);
+    return oldestPtr;
+}
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Marks the current access points as old by changing the values for foundInLatestScan
- * and signalStrength.
- * These values will be updated later, if the same AP is still found.
- * This way the new and old AccessPoints can be separated.
- *
+ * Account the result and the duration of a connection attempt to an access point.
  */
 //--------------------------------------------------------------------------------------------------
-static void MarkAllAccessPointsOld
+static void RecordBssConnect
 (
-    void
+    const char *bssidPtr,   ///< [IN] Access point, NULL or empty if unknown.
+    le_result_t result,     ///< [IN] Result of the attempt.
+    uint32_t    connectMs   ///< [IN] Duration of the attempt, 0 if unknown.
 )
 {
-    le_wifiClient_AccessPointRef_t apRef   = NULL;
-    le_ref_IterRef_t               iter    = le_ref_GetIterator(ScanApRefMap);
-    uint32_t                       counter = 0;
-
-    LE_DEBUG("Mark all AP as old");
+    BssHistory_t *historyPtr;
 
-    while (le_ref_NextNode(iter) == LE_OK)
+    if ((NULL == bssidPtr) || ('\0' == bssidPtr[0]))
     {
-        apRef = (le_wifiClient_AccessPointRef_t)le_ref_GetSafeRef(iter);
-        if (NULL != apRef)
-        {
-            FoundAccessPoint_t* apPtr = (FoundAccessPoint_t *)le_ref_Lookup(ScanApRefMap, apRef);
+        return;
+    }
 
-            if (apPtr != NULL)
-            {
-                apPtr->accessPoint.signalStrength = LE_WIFICLIENT_NO_SIGNAL_STRENGTH;
-                apPtr->foundInLatestScan = false;
-                LE_DEBUG("Marking %p as old", apRef);
-                counter++;
-            }
-            else
-            {
-                LE_ERROR("Bad reference");
-                return;
-            }
+    historyPtr = GetBssHistory(bssidPtr, true);
+    historyPtr->lastUse = ++BssHistoryTick;
 
-        }
-        else
+    if (LE_OK != result)
+    {
+        if (historyPtr->failureCount < BSS_FAILURE_MAX)
         {
-            LE_ERROR("ERROR le_ref_GetSafeRef returned NULL iter:%p", iter);
-            break;
+            historyPtr->failureCount++;
         }
+        return;
     }
-    LE_DEBUG("Marked: %d", counter);
-}
 
+    historyPtr->failureCount = 0;
+    if (connectMs > 0)
+    {
+        // Smooth the connection time over the last attempts
+        historyPtr->connectMs = (0 == historyPtr->connectMs) ?
+                                connectMs : ((3 * historyPtr->connectMs) + connectMs) / 4;
+    }
+}
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Start Scanning for WiFi Access points
- * Will result in an event LE_WIFICLIENT_EVENT_SCAN_DONE when the scan results are available or
- * an event LE_WIFICLIENT_EVENT_SCAN_FAILED if there was an error while scanning.
+ * Score an access point, the higher the better.
  *
- * @return LE_FAULT         Function failed.
- * @return LE_OK            Function succeeded.
+ * @return
+ *      The score, BSS_SCORE_UNKNOWN if the access point was not found in the latest scan.
  */
 //--------------------------------------------------------------------------------------------------
-static void *ScanThread
+static int32_t ScoreAccessPoint
 (
-    void *contextPtr
+    const FoundAccessPoint_t *apPtr
 )
 {
-    pa_wifiClient_AccessPoint_t accessPoint;
-    le_result_t                 *scanResultPtr = contextPtr;
-    le_result_t                 paResult    = pa_wifiClient_Scan();
+    const BssHistory_t *historyPtr;
+    int32_t             score;
+    uint32_t            latencyPenalty;
 
-    if (LE_OK != paResult)
+    if ((!apPtr->foundInLatestScan) || ('\0' == apPtr->accessPoint.bssid[0]) ||
+        (LE_WIFICLIENT_NO_SIGNAL_STRENGTH == apPtr->accessPoint.signalStrength))
     {
-        LE_ERROR("Scan failed (%d)", paResult);
-        *scanResultPtr = LE_FAULT;
-        return NULL;
+        return BSS_SCORE_UNKNOWN;
     }
 
-    FoundWifiApCount = 0;
-
-    MarkAllAccessPointsOld();
-    memset(scanIfName, 0, LE_WIFIDEFS_MAX_IFNAME_BYTES);
-    while (LE_OK == (paResult = pa_wifiClient_GetScanResult(&accessPoint, scanIfName)))
+    score = apPtr->accessPoint.signalStrength;
+    if ((apPtr->accessPoint.frequency >= BSS_5GHZ_MIN_FREQUENCY) &&
+        (apPtr->accessPoint.signalStrength >= BSS_5GHZ_MIN_SIGNAL))
     {
-        if (AddAccessPointToApRefMap(&accessPoint) == NULL)
-        {
-            LE_ERROR("pa_wifiClient_ScanDone() failed");
-            paResult = LE_FAULT;
-            break;
-        }
+        score += BSS_5GHZ_BONUS;
     }
 
-    *scanResultPtr = ((paResult == LE_OK) || (paResult == LE_NOT_FOUND)) ? LE_OK : paResult;
-
-    paResult = pa_wifiClient_ScanDone();
-    if (LE_OK != paResult)
+    historyPtr = GetBssHistory(apPtr->accessPoint.bssid, false);
+    if (NULL != historyPtr)
     {
-        LE_ERROR("pa_wifiClient_ScanDone() failed (%d)", paResult);
-        *scanResultPtr = paResult;
+        latencyPenalty = historyPtr->connectMs / BSS_LATENCY_STEP_MS;
+        score -= (int32_t)(historyPtr->failureCount * BSS_FAILURE_PENALTY);
+        score -= (int32_t)((latencyPenalty > BSS_LATENCY_MAX_PENALTY) ?
+                           BSS_LATENCY_MAX_PENALTY : latencyPenalty);
     }
-
-    return NULL;
+    return score;
 }
 
-
 //--------------------------------------------------------------------------------------------------
 /**
- * Thread Destructor for scan
+ * Select the access point with the best score among those of an SSID.
+ *
+ * @return
+ *      The access point reference, NULL if none has this SSID.
  */
 //--------------------------------------------------------------------------------------------------
-static void ScanThreadDestructor
+static le_wifiClient_AccessPointRef_t SelectBestAccessPoint
 (
-    void *context
+    const uint8_t *ssidPtr,
+    size_t         ssidNumElements
 )
 {
-    le_result_t scanResult = *((le_result_t*)context);
-
-    LE_DEBUG("Destruct scan thread");
-    ScanThreadRef = NULL;
-    le_wifiClient_EventInd_t* wifiEventIndicationPtr = le_mem_ForceAlloc(WifiEventPool);
+    le_wifiClient_AccessPointRef_t bestRef   = NULL;
+    int32_t                        bestScore = BSS_SCORE_UNKNOWN;
+    int32_t                        score;
+    FoundAccessPoint_t            *apPtr;
+    le_ref_IterRef_t               iter      = le_ref_GetIterator(ScanApRefMap);
 
-    if (scanResult == LE_OK)
-    {
-        wifiEventIndicationPtr->event = LE_WIFICLIENT_EVENT_SCAN_DONE;
-    }
-    else
+    while (LE_OK == le_ref_NextNode(iter))
     {
-        LE_WARN("Scan failed");
-        wifiEventIndicationPtr->event = LE_WIFICLIENT_EVENT_SCAN_FAILED;
-    }
+        apPtr = (FoundAccessPoint_t *)le_ref_GetValue(iter);
+        if ((NULL == apPtr) || (apPtr->accessPoint.ssidLength != ssidNumElements) ||
+            (0 != memcmp(apPtr->accessPoint.ssidBytes, ssidPtr, ssidNumElements)))
+        {
+            continue;
+        }
 
-    wifiEventIndicationPtr->disconnectionCause = LE_WIFICLIENT_UNKNOWN_CAUSE;
-    strncpy(wifiEventIndicationPtr->ifName, scanIfName, LE_WIFIDEFS_MAX_IFNAME_LENGTH);
-    wifiEventIndicationPtr->ifName[LE_WIFIDEFS_MAX_IFNAME_LENGTH] = '\0';
-    wifiEventIndicationPtr->apBssid[0] = '\0';
-    PaEventIndicationHandler(wifiEventIndicationPtr, NULL);
+        score = ScoreAccessPoint(apPtr);
+        if ((NULL == bestRef) || (score > bestScore))
+        {
+            bestRef = (le_wifiClient_AccessPointRef_t)le_ref_GetSafeRef(iter);
+            bestScore = score;
+        }
+    }
 
-    PaEventHandler(wifiEventIndicationPtr->event, NULL);
+    LE_DEBUG("Best AP %p, score %d", bestRef, (int)bestScore);
+    return bestRef;
 }
 
-
 //--------------------------------------------------------------------------------------------------
 /**
- * Handler function to the close session service to detect if the application crashed.
+ * Get the BSSID of the access point with the best score among those of an SSID found in the latest
+ * scan.
  *
+ * @return
+ *      The BSSID, NULL if none was found in the latest scan.
  */
 //--------------------------------------------------------------------------------------------------
-static void CloseSessionEventHandler
+static const char *GetBestBssid
 (
-    le_msg_SessionRef_t  sessionRef,
-    void                *contextPtr
+    const uint8_t *ssidPtr,
+    size_t         ssidNumElements
 )
 {
-    if (sessionRef == GetFirstSessionRef)
+    FoundAccessPoint_t *apPtr = le_ref_Lookup(ScanApRefMap,
+                                              SelectBestAccessPoint(ssidPtr, ssidNumElements));
+
+    if ((NULL == apPtr) || (BSS_SCORE_UNKNOWN == ScoreAccessPoint(apPtr)))
     {
-        GetFirstSessionRef = NULL;
+        return NULL;
     }
+    return apPtr->accessPoint.bssid;
 }
 
-
 //--------------------------------------------------------------------------------------------------
 /**
- * Is Scan running. Checks if the ScanThread is still running
- */
-//--------------------------------------------------------------------------------------------------
-static bool IsScanRunning(void)
-{
-    LE_DEBUG("IsScanRunning .%d", (NULL != ScanThreadRef));
-    return (NULL != ScanThreadRef);
-}
-
-//--------------------------------------------------------------------------------------------------
-/**
- * The first-layer WiFi Client Event Handler.
- *
- * @deprecated le_wifiClient_AddNewEventHandler() should not be used anymore.
+ * Connect to the given access point, which security parameters have been set into the PA.
  *
- * It has been replaced by le_wifiClient_AddConnectionEventHandler().
+ * @return
+ *      - LE_OK             Function succeeded.
+ *      - LE_BAD_PARAMETER  Invalid parameter.
+ *      - LE_DUPLICATE      Duplicated request.
+ *      - LE_TIMEOUT        Connection request time out.
+ *      - LE_FAULT          The function failed.
  */
 //--------------------------------------------------------------------------------------------------
-static void FirstLayerWifiClientEventHandler
+static le_result_t ConnectAccessPoint
 (
-    void *reportPtr,
-    void *secondLayerHandlerFunc
+    le_wifiClient_AccessPointRef_t apRef
+        ///< [IN]
+        ///< WiFi access point reference.
 )
 {
-    le_wifiClient_NewEventHandlerFunc_t  clientHandlerFunc = secondLayerHandlerFunc;
-    le_wifiClient_Event_t               *wifiEventPtr      = (le_wifiClient_Event_t *)reportPtr;
+    le_result_t         result = LE_BAD_PARAMETER;
+    FoundAccessPoint_t *apPtr  = le_ref_Lookup(ScanApRefMap, apRef);
+    const char         *bssidPtr;
+    uint16_t ssidLen;
 
-    if (NULL != wifiEventPtr)
-    {
-        LE_DEBUG("Event: %d", *wifiEventPtr);
-        clientHandlerFunc(*wifiEventPtr, le_event_GetContextPtr());
-    }
-    else
+    // verify le_ref_Lookup
+    if (NULL !=  apPtr)
     {
-        LE_ERROR("Event is NULL");
+        ssidLen = apPtr->accessPoint.ssidLength;
+        LE_DEBUG("SSID length %d | SSID: \"%.*s\"", ssidLen, ssidLen,
+                 (char *)apPtr->accessPoint.ssidBytes);
+
+        // Steer wpa_supplicant to the best scored access point of the SSID
+        bssidPtr = GetBestBssid(apPtr->accessPoint.ssidBytes, ssidLen);
+        pa_wifiClient_SetBssidHint(bssidPtr);
+        result = pa_wifiClient_Connect(apPtr->accessPoint.ssidBytes, ssidLen);
+        RecordBssConnect(bssidPtr, result, RecordConnectTiming());
+        if (LE_OK == result)
+        {
+            CurrentConnection = apRef;
+        }
     }
+    return result;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * The first-layer WiFi Client Connection Event Handler.
- *
+ * Stop the ongoing auto-reconnect, if any.
  */
 //--------------------------------------------------------------------------------------------------
-static void FirstLayerWifiClientConnectionEventHandler
+static void StopReconnect
 (
-    void *reportPtr,
-    void *secondLayerHandlerFunc
+    void
 )
 {
-    le_wifiClient_EventInd_t*  wifiEventPtr = reportPtr;
-    le_wifiClient_ConnectionEventHandlerFunc_t  clientHandlerFunc = secondLayerHandlerFunc;
-
-
-    if (NULL != wifiEventPtr)
-    {
-        clientHandlerFunc(wifiEventPtr, le_event_GetContextPtr());
-    }
-    else
+    if (Reconnect.isActive)
     {
-        LE_WARN("wifiEventPtr is NULL");
+        LE_INFO("Auto-reconnect stopped after %u attempts", Reconnect.attempt);
+        le_timer_Stop(Reconnect.timer);
+        Reconnect.isActive = false;
+        Reconnect.session++;
     }
-    // The reportPtr is a reference counted object, so need to release it
-    le_mem_Release(reportPtr);
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * returns the value of the field "foundInLatestScan"
- * This is used to determine if a Ref was found in the last scan or not.
+ * The connection is established again: account the time to recover and go back to idle.
  */
 //--------------------------------------------------------------------------------------------------
-static bool WasApFoundInLastScan
+static void ReconnectDone
 (
-    le_wifiClient_AccessPointRef_t apRef
-        ///< [IN]
-        ///< WiFi Access Point reference.
+    void
 )
 {
-    FoundAccessPoint_t *apPtr = (FoundAccessPoint_t *)le_ref_Lookup(ScanApRefMap, apRef);
+    le_clk_Time_t recoveryTime = le_clk_Sub(le_clk_GetRelativeTime(), Reconnect.lostTime);
 
-    if (apPtr == NULL)
+    le_timer_Stop(Reconnect.timer);
+    Reconnect.isActive = false;
+
+    Reconnect.recoveryCount++;
+    Reconnect.lastRecoveryMs = (uint32_t)((recoveryTime.sec * 1000) + (recoveryTime.usec / 1000));
+    if (Reconnect.lastRecoveryMs > Reconnect.maxRecoveryMs)
     {
-        LE_ERROR("Bad reference");
-        return false;
+        Reconnect.maxRecoveryMs = Reconnect.lastRecoveryMs;
     }
 
-    return apPtr->foundInLatestScan;
+    LE_INFO("Connection recovered after %u attempts in %u ms", Reconnect.attempt,
+            Reconnect.lastRecoveryMs);
 }
 
-
 //--------------------------------------------------------------------------------------------------
 /**
- * Add handler function for EVENT 'le_wifiClient_NewEvent'
- *
- * This event provide information on Wifi Client event changes.
- *
- * @deprecated le_wifiClient_AddNewEventHandler() should not be used anymore.
- *
- * It has been replaced by le_wifiClient_AddConnectionEventHandler().
+ * Arm the backoff timer for the next reconnection attempt. The delay doubles with each attempt
+ * up to RECONNECT_BACKOFF_MAX_MS, and is drawn at random in the upper half of that window.
  */
 //--------------------------------------------------------------------------------------------------
-le_wifiClient_NewEventHandlerRef_t le_wifiClient_AddNewEventHandler
+static void ScheduleReconnect
 (
-    le_wifiClient_NewEventHandlerFunc_t handlerFuncPtr,
-        ///< [IN]
-        ///< Event handling function
-
-    void *contextPtr
-        ///< [IN]
-        ///< Associated event context
+    void
 )
 {
-    le_event_HandlerRef_t handlerRef;
-
-    // Note: THIS ONE REGISTERS THE CB function..
-    LE_DEBUG("Add new event handler");
+    uint32_t windowMs = RECONNECT_BACKOFF_MAX_MS;
+    uint32_t delayMs;
 
-    if (handlerFuncPtr == NULL)
+    if (Reconnect.attempt < 16)
     {
-        LE_KILL_CLIENT("handlerFuncPtr is NULL !");
-        return NULL;
+        windowMs = RECONNECT_BACKOFF_MIN_MS << Reconnect.attempt;
+        if (windowMs > RECONNECT_BACKOFF_MAX_MS)
+        {
+            windowMs = RECONNECT_BACKOFF_MAX_MS;
+        }
     }
+    delayMs = (windowMs / 2) + ((uint32_t)rand() % ((windowMs / 2) + 1));
 
-    handlerRef = le_event_AddLayeredHandler("NewWiFiClientMsgHandler",
-                                            WifiEventId,
-                                            FirstLayerWifiClientEventHandler,
-                                            (le_event_HandlerFunc_t)handlerFuncPtr);
-
-    le_event_SetContextPtr(handlerRef, contextPtr);
-
-    return (le_wifiClient_NewEventHandlerRef_t)(handlerRef);
+    LE_DEBUG("Reconnection attempt %u in %u ms", Reconnect.attempt + 1, delayMs);
+    le_timer_SetMsInterval(Reconnect.timer, delayMs);
+    le_timer_Start(Reconnect.timer);
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * This function must be called to register an handler for WiFi connection state change.
- *
- * @return A handler reference, which is only needed for later removal of the handler.
+ * Load the settings of the SSIDs saved in the config tree, in a single transaction.
  *
- * @note Doesn't return on failure, so there's no need to check the return value for errors.
+ * @return The number of SSIDs loaded.
  */
 //--------------------------------------------------------------------------------------------------
-le_wifiClient_ConnectionEventHandlerRef_t le_wifiClient_AddConnectionEventHandler
+static size_t LoadKnownNetworks
 (
-    le_wifiClient_ConnectionEventHandlerFunc_t handlerFuncPtr,
-        ///< [IN]
-        ///< Event handling function
+    KnownNetwork_t *networksPtr,
+        ///< [OUT]
+        ///< SSIDs loaded.
 
-    void *contextPtr
+    size_t maxCount
         ///< [IN]
-        ///< Associated event context
+        ///< Maximum number of SSIDs to load.
 )
 {
-    le_event_HandlerRef_t handlerRef;
-
-    // Note: THIS ONE REGISTERS THE CB function..
-    LE_DEBUG("Add wifi connection event handler");
+    char                 configPath[LE_CFG_STR_LEN_BYTES] = {0};
+    KnownNetwork_t      *networkPtr;
+    le_cfg_IteratorRef_t cfg;
+    size_t               count = 0;
 
-    if (handlerFuncPtr == NULL)
+    snprintf(configPath, sizeof(configPath), "%s/%s", CFG_TREE_ROOT_DIR, CFG_PATH_WIFI);
+    cfg = le_cfg_CreateReadTxn(configPath);
+    if (LE_OK != le_cfg_GoToFirstChild(cfg))
     {
-        LE_KILL_CLIENT("handlerFuncPtr is NULL !");
-        return NULL;
+        le_cfg_CancelTxn(cfg);
+        return 0;
     }
 
-    handlerRef = le_event_AddLayeredHandler("WiFiClientMsgHandler",
-                                            WifiEventIndicationId,
-                                            FirstLayerWifiClientConnectionEventHandler,
-                                            (le_event_HandlerFunc_t)handlerFuncPtr);
+    do
+    {
+        networkPtr = &networksPtr[count];
+        memset(networkPtr, 0, sizeof(KnownNetwork_t));
+        if ((LE_OK != le_cfg_GetNodeName(cfg, "", networkPtr->ssid, sizeof(networkPtr->ssid))) ||
+            (0 == networkPtr->ssid[0]))
+        {
+            continue;
+        }
 
-    le_event_SetContextPtr(handlerRef, contextPtr);
+        networkPtr->priority = le_cfg_GetInt(cfg, CFG_NODE_PRIORITY, 0);
+        if (!le_cfg_NodeExists(cfg, CFG_NODE_SECPROTOCOL))
+        {
+            networkPtr->secProtocol = LE_WIFICLIENT_SECURITY_NONE;
+        }
+        else
+        {
+            networkPtr->secProtocol = le_cfg_GetInt(cfg, CFG_NODE_SECPROTOCOL,
+                                                    LE_WIFICLIENT_SECURITY_WPA2_PSK_PERSONAL);
+        }
+        networkPtr->isHidden = le_cfg_GetBool(cfg, CFG_NODE_HIDDEN_SSID, false);
+        networkPtr->isFastTransition = le_cfg_GetBool(cfg, CFG_NODE_FAST_TRANSITION, false);
+        networkPtr->signalStrength = LE_WIFICLIENT_NO_SIGNAL_STRENGTH;
+        networkPtr->apRef = NULL;
+        count++;
+    }
+    while ((count < maxCount) && (LE_OK == le_cfg_GoToNextSibling(cfg)));
 
-    return (le_wifiClient_ConnectionEventHandlerRef_t)(handlerRef);
+    le_cfg_CancelTxn(cfg);
+    LE_DEBUG("%zu known networks", count);
+    return count;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Remove handler function for EVENT 'le_wifiClient_NewEvent'
- *
- * @deprecated le_wifiClient_AddNewEventHandler() should not be used anymore.
- *
- * It has been replaced by le_wifiClient_AddConnectionEventHandler().
+ * Load the SSIDs saved in the config tree, other than the one lost, by decreasing priority.
  */
 //--------------------------------------------------------------------------------------------------
-void le_wifiClient_RemoveNewEventHandler
+static void LoadFallbackSsids
 (
-    le_wifiClient_NewEventHandlerRef_t handlerRef
-        ///< [IN]
-        ///< Reference of the event handler to remove
+    void
 )
 {
-    LE_DEBUG("Remove event handler");
-    le_event_RemoveHandler((le_event_HandlerRef_t)handlerRef);
+    KnownNetwork_t networks[KNOWN_NETWORKS_MAX];
+    FallbackSsid_t entry;
+    size_t         count;
+    size_t         i, j;
+
+    Reconnect.fallbackCount = 0;
+
+    count = LoadKnownNetworks(networks, KNOWN_NETWORKS_MAX);
+    for (j = 0; j < count; j++)
+    {
+        if (0 == strcmp(networks[j].ssid, Reconnect.ssid))
+        {
+            continue;
+        }
+        le_utf8_Copy(entry.ssid, networks[j].ssid, sizeof(entry.ssid), NULL);
+        entry.priority = networks[j].priority;
+
+        // Insertion by decreasing priority, the lowest one is dropped when the list is full
+        i = Reconnect.fallbackCount;
+        if (RECONNECT_MAX_FALLBACK_SSIDS == i)
+        {
+            if (entry.priority <= Reconnect.fallback[i - 1].priority)
+            {
+                continue;
+            }
+            i--;
+        }
+        else
+        {
+            Reconnect.fallbackCount++;
+        }
+        while ((i > 0) && (Reconnect.fallback[i - 1].priority < entry.priority))
+        {
+            Reconnect.fallback[i] = Reconnect.fallback[i - 1];
+            i--;
+        }
+        Reconnect.fallback[i] = entry;
+    }
+
+    LE_DEBUG("%zu fallback SSIDs", Reconnect.fallbackCount);
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Remove handler function for EVENT 'le_wifiClient_ConnectionEvent'
+ * Reconnection worker thread: start over with the configuration set into the PA, then connect.
  */
 //--------------------------------------------------------------------------------------------------
-void le_wifiClient_RemoveConnectionEventHandler
+static void *ReconnectThread
 (
-    le_wifiClient_ConnectionEventHandlerRef_t handlerRef
-        ///< [IN]
-        ///< Reference of the event handler to remove
+    void *contextPtr
 )
 {
-    LE_DEBUG("Remove event handler");
-    le_event_RemoveHandler((le_event_HandlerRef_t)handlerRef);
+    ReconnectContext_t *reconnectContextPtr = contextPtr;
+
+    // Terminate wpa_supplicant if still running, to start over with the new configuration
+    (void)pa_wifiClient_Disconnect();
+    reconnectContextPtr->result = pa_wifiClient_Connect(reconnectContextPtr->ssidBytes,
+                                                        reconnectContextPtr->ssidLength);
+    return NULL;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Starts the WIFI device.
- *
- * @return
- *      - LE_OK             Function succeeded.
- *      - LE_FAULT          Function failed.
- *      - LE_BUSY           The WiFi device is already started.
- *      - LE_NOT_FOUND      The WiFi device is absent.
- *      - LE_NOT_POSSIBLE   The WiFi device may not work.
+ * Outcome of the reconnection attempt run by the worker thread, handled by the main thread.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t le_wifiClient_Start
+static void ReconnectAttemptDone
 (
-    void
+    void *param1Ptr,
+    void *param2Ptr
 )
 {
-    le_result_t result;
+    ReconnectContext_t *reconnectContextPtr = param1Ptr;
+    le_result_t         result = reconnectContextPtr->result;
+    FoundAccessPoint_t *apPtr;
 
-    // Only the first client starts the WIFI module
-    if (!ClientStartCount)
+    Reconnect.threadRef = NULL;
+    RecordBssConnect(('\0' != reconnectContextPtr->bssid[0]) ? reconnectContextPtr->bssid : NULL,
+                     result, RecordConnectTiming());
+
+    if (reconnectContextPtr->session != Reconnect.session)
     {
-        result = pa_wifiClient_Start();
-        if (LE_OK == result)
+        LE_DEBUG("Reconnection attempt of a stopped auto-reconnect dropped");
+        return;
+    }
+
+    if (LE_OK == result)
+    {
+        apPtr = le_ref_Lookup(ScanApRefMap, reconnectContextPtr->apRef);
+        if (NULL != apPtr)
         {
-            LE_DEBUG("WIFI client started successfully");
-            // Increment the number of clients calling this start function
-            ClientStartCount++;
+            apPtr->autoReconnect = true;
         }
-        else
+        // The connection event may have been handled while the attempt was running
+        if (Reconnect.isActive)
         {
-            LE_WARN("Unable to start WIFI client; return code: %d", result);
+            ReconnectDone();
         }
+        return;
     }
-    else
+
+    LE_WARN("Reconnection attempt %u failed (%d)", Reconnect.attempt, result);
+    if (Reconnect.isActive)
     {
-        LE_WARN("WIFI client already started");
-        // Increment the number of clients calling this start function
-        ClientStartCount++;
-        result = LE_BUSY;
+        ScheduleReconnect();
     }
-
-    return result;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Stops the WIFI device.
- *
- * @return
- *      - LE_OK        Function succeeded.
- *      - LE_FAULT     Function failed.
- *      - LE_DUPLICATE The WIFI device is already stopped.
- *
+ * Thread destructor of the reconnection worker: its outcome is handled by the main thread, which
+ * owns the auto-reconnect state machine.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t le_wifiClient_Stop
+static void ReconnectThreadDestructor
 (
-    void
+    void *contextPtr
 )
 {
-    le_result_t result = LE_OK;
+    le_event_QueueFunctionToThread(MainThreadRef, ReconnectAttemptDone, contextPtr, NULL);
+}
 
-    if (0 == ClientStartCount)
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start a reconnection attempt on the given access point in the worker thread. The access point
+ * becomes the selected connection.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StartReconnectAttempt
+(
+    le_wifiClient_AccessPointRef_t apRef
+)
+{
+    FoundAccessPoint_t *apPtr = le_ref_Lookup(ScanApRefMap, apRef);
+    const char         *bssidPtr;
+
+    memset(&ReconnectContext, 0, sizeof(ReconnectContext));
+    ReconnectContext.session = Reconnect.session;
+    ReconnectContext.apRef = apRef;
+    ReconnectContext.result = LE_FAULT;
+    ReconnectContext.ssidLength = apPtr->accessPoint.ssidLength;
+    memcpy(ReconnectContext.ssidBytes, apPtr->accessPoint.ssidBytes, ReconnectContext.ssidLength);
+
+    // Steer wpa_supplicant to the best scored access point of the SSID
+    bssidPtr = GetBestBssid(apPtr->accessPoint.ssidBytes, apPtr->accessPoint.ssidLength);
+    if (NULL != bssidPtr)
     {
-        LE_WARN("The WIFI device is already stopped");
-        return LE_DUPLICATE;
+        le_utf8_Copy(ReconnectContext.bssid, bssidPtr, sizeof(ReconnectContext.bssid), NULL);
     }
+    pa_wifiClient_SetBssidHint(bssidPtr);
+    CurrentConnection = apRef;
+
+    Reconnect.threadRef = le_thread_Create("WiFi Client Reconnect Thread", ReconnectThread,
+                                           &ReconnectContext);
+    le_thread_AddChildDestructor(Reconnect.threadRef, ReconnectThreadDestructor,
+                                 &ReconnectContext);
+    le_thread_Start(Reconnect.threadRef);
+}
 
-    // Only the last client closes the WIFI module
-    if (1 == ClientStartCount)
-    {
-        pa_wifiClient_ClearAllCredentials();
-        CurrentConnection = NULL;
-
-        result = pa_wifiClient_Stop();
-        if (LE_OK != result)
+//--------------------------------------------------------------------------------------------------
+/**
+ * Backoff timer expiry: start one reconnection attempt.
+ * The lost access point is tried first, then each fallback SSID in turn, RECONNECT_ATTEMPTS_PER_SSID
+ * times each, cycling until the connection is recovered or the auto-reconnect stopped.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReconnectTimerHandler
+(
+    le_timer_Ref_t timerRef
+)
+{
+    size_t                          slot;
+    const char                     *ssidPtr;
+    le_wifiClient_AccessPointRef_t  apRef = NULL;
+
+    // The attempt of a previous recovery is still running
+    if (NULL != Reconnect.threadRef)
+    {
+        ScheduleReconnect();
+        return;
+    }
+
+    slot = (Reconnect.attempt / RECONNECT_ATTEMPTS_PER_SSID) % (1 + Reconnect.fallbackCount);
+    Reconnect.attempt++;
+    Reconnect.attemptCount++;
+
+    if ((0 == slot) && !Reconnect.isCredentialReplaced &&
+        (NULL != le_ref_Lookup(ScanApRefMap, Reconnect.apRef)))
+    {
+        // Security parameters of the lost access point are still set into the PA
+        apRef = Reconnect.apRef;
+    }
+    else
+    {
+        ssidPtr = (0 == slot) ? Reconnect.ssid : Reconnect.fallback[slot - 1].ssid;
+        Reconnect.isCredentialReplaced = true;
+        if (LE_OK != le_wifiClient_LoadSsid((const uint8_t *)ssidPtr, strlen(ssidPtr), &apRef))
         {
-            LE_ERROR("Unable to stop WIFI client. Err: %d", result);
+            LE_WARN("Unable to load SSID %s to reconnect", ssidPtr);
+            apRef = NULL;
         }
+    }
 
-        ReleaseAllAccessPoints();
-        LE_DEBUG("WIFI client stopped successfully");
+    if (NULL == le_ref_Lookup(ScanApRefMap, apRef))
+    {
+        ScheduleReconnect();
+        return;
     }
 
-    // Decrement the number of clients calling this stop function
-    if ((LE_OK == result) && (ClientStartCount))
+    LE_INFO("Reconnection attempt %u on access point %p", Reconnect.attempt, apRef);
+    StartReconnectAttempt(apRef);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start the auto-reconnect upon a disconnection, unless it is not wanted for this access point or
+ * cannot succeed because of the disconnection cause.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StartReconnect
+(
+    le_wifiClient_DisconnectionCause_t cause
+)
+{
+    FoundAccessPoint_t *apPtr = le_ref_Lookup(ScanApRefMap, CurrentConnection);
+
+    if (Reconnect.isActive || (NULL == apPtr) || !apPtr->autoReconnect)
     {
-        ClientStartCount--;
+        return;
     }
 
-    return result;
+    if ((LE_WIFICLIENT_CLIENT_REQUEST == cause) || (LE_WIFICLIENT_HARDWARE_STOP == cause))
+    {
+        LE_DEBUG("No auto-reconnect on disconnection cause %d", cause);
+        return;
+    }
+
+    LE_INFO("Connection to %p lost (cause %d), auto-reconnect started", CurrentConnection, cause);
+
+    Reconnect.isActive = true;
+    Reconnect.apRef = CurrentConnection;
+    memset(Reconnect.ssid, 0, sizeof(Reconnect.ssid));
+    memcpy(Reconnect.ssid, apPtr->accessPoint.ssidBytes, apPtr->accessPoint.ssidLength);
+    Reconnect.isCredentialReplaced = false;
+    Reconnect.attempt = 0;
+    Reconnect.lostTime = le_clk_GetRelativeTime();
+    LoadFallbackSsids();
+
+    ScheduleReconnect();
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Start Scanning for WiFi Access points
- * Will result in event LE_WIFICLIENT_EVENT_SCAN_DONE when the scan results are available.
+ * Build the config tree path of the DHCP lease cached for the SSID and BSSID of the connection.
  *
  * @return
- *      - LE_OK     Function succeeded.
- *      - LE_FAULT  Function failed.
- *      - LE_BUSY   Scan already running.
+ *      - LE_OK             Function succeeded.
+ *      - LE_NOT_FOUND      The SSID of the connection is unknown.
+ *      - LE_OVERFLOW       Path too long.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t le_wifiClient_Scan
+static le_result_t GetLeasePath
+(
+    char   *pathPtr,
+    size_t  pathSize
+)
+{
+    char   bssidNode[LE_WIFIDEFS_MAX_BSSID_BYTES];
+    size_t i, j = 0;
+    int    len;
+
+    if (('\0' == Dhcp.ssid[0]) || ('\0' == Dhcp.bssid[0]))
+    {
+        return LE_NOT_FOUND;
+    }
+
+    // ':' is not allowed in a node name
+    for (i = 0; ('\0' != Dhcp.bssid[i]) && (j < (sizeof(bssidNode) - 1)); i++)
+    {
+        if (':' != Dhcp.bssid[i])
+        {
+            bssidNode[j++] = Dhcp.bssid[i];
+        }
+    }
+    bssidNode[j] = '\0';
+
+    len = snprintf(pathPtr, pathSize, CFG_TREE_ROOT_DIR "/" CFG_PATH_LEASE "/%s/%s", Dhcp.ssid,
+                   bssidNode);
+    return ((len < 0) || ((size_t)len >= pathSize)) ? LE_OVERFLOW : LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write an IPv4 address of the lease into the config tree.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SetLeaseAddress
+(
+    le_cfg_IteratorRef_t  cfg,
+    const char           *nodePtr,
+    uint32_t              address
+)
+{
+    char addressStr[INET_ADDRSTRLEN];
+
+    inet_ntop(AF_INET, &address, addressStr, sizeof(addressStr));
+    le_cfg_SetString(cfg, nodePtr, addressStr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read an IPv4 address of the lease from the config tree.
+ *
+ * @return The address in network byte order, 0 if absent.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t GetLeaseAddress
+(
+    le_cfg_IteratorRef_t  cfg,
+    const char           *nodePtr
+)
+{
+    char           addressStr[INET_ADDRSTRLEN];
+    struct in_addr address = { 0 };
+
+    if ((LE_OK == le_cfg_GetString(cfg, nodePtr, addressStr, sizeof(addressStr), "")) &&
+        (1 != inet_pton(AF_INET, addressStr, &address)))
+    {
+        address.s_addr = 0;
+    }
+    return address.s_addr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Load the lease cached for the connection into the DHCP client, if still valid.
+ *
+ * @return
+ *      - true  A valid lease has been loaded.
+ *      - false Otherwise.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool LoadLease
 (
     void
 )
 {
-    if (!IsScanRunning())
+    char                 path[LE_CFG_STR_LEN_BYTES];
+    char                 expiryStr[24];
+    le_cfg_IteratorRef_t cfg;
+
+    if (LE_OK != GetLeasePath(path, sizeof(path)))
     {
-        LE_DEBUG("Scan started");
+        return false;
+    }
 
-        // Start the thread
-        ScanResult = LE_OK;
-        ScanThreadRef = le_thread_Create("WiFi Client Scan Thread", ScanThread, &ScanResult);
-        le_thread_AddChildDestructor(ScanThreadRef, ScanThreadDestructor, &ScanResult);
+    cfg = le_cfg_CreateReadTxn(path);
+    Dhcp.lease.address = GetLeaseAddress(cfg, CFG_NODE_LEASE_ADDRESS);
+    Dhcp.lease.netmask = GetLeaseAddress(cfg, CFG_NODE_LEASE_NETMASK);
+    Dhcp.lease.gateway = GetLeaseAddress(cfg, CFG_NODE_LEASE_GATEWAY);
+    Dhcp.lease.dns = GetLeaseAddress(cfg, CFG_NODE_LEASE_DNS);
+    Dhcp.lease.server = GetLeaseAddress(cfg, CFG_NODE_LEASE_SERVER);
+    Dhcp.lease.leaseTime = (uint32_t)le_cfg_GetInt(cfg, CFG_NODE_LEASE_TIME, 0);
+    le_cfg_GetString(cfg, CFG_NODE_LEASE_EXPIRY, expiryStr, sizeof(expiryStr), "0");
+    le_cfg_CancelTxn(cfg);
 
-        le_thread_Start(ScanThreadRef);
-        return LE_OK;
+    Dhcp.expiry = (time_t)strtoll(expiryStr, NULL, 10);
+    if ((0 == Dhcp.lease.address) ||
+        (Dhcp.expiry < (le_clk_GetAbsoluteTime().sec + DHCP_LEASE_MIN_REMAINING_SEC)))
+    {
+        LE_DEBUG("No valid cached lease in %s", path);
+        return false;
+    }
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Cache the lease of the connection in the config tree, or delete it when it is refused.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SaveLease
+(
+    bool isValid
+)
+{
+    char                 path[LE_CFG_STR_LEN_BYTES];
+    char                 expiryStr[24];
+    le_cfg_IteratorRef_t cfg;
+
+    if (LE_OK != GetLeasePath(path, sizeof(path)))
+    {
+        return;
+    }
+
+    cfg = le_cfg_CreateWriteTxn(path);
+    if (!isValid)
+    {
+        le_cfg_DeleteNode(cfg, "");
     }
     else
     {
-        LE_DEBUG("ERROR: Scan already running");
-        return LE_BUSY;
+        SetLeaseAddress(cfg, CFG_NODE_LEASE_ADDRESS, Dhcp.lease.address);
+        SetLeaseAddress(cfg, CFG_NODE_LEASE_NETMASK, Dhcp.lease.netmask);
+        SetLeaseAddress(cfg, CFG_NODE_LEASE_GATEWAY, Dhcp.lease.gateway);
+        SetLeaseAddress(cfg, CFG_NODE_LEASE_DNS, Dhcp.lease.dns);
+        SetLeaseAddress(cfg, CFG_NODE_LEASE_SERVER, Dhcp.lease.server);
+        le_cfg_SetInt(cfg, CFG_NODE_LEASE_TIME, (int32_t)Dhcp.lease.leaseTime);
+        snprintf(expiryStr, sizeof(expiryStr), "%lld", (long long)Dhcp.expiry);
+        le_cfg_SetString(cfg, CFG_NODE_LEASE_EXPIRY, expiryStr);
+    }
+    le_cfg_CommitTxn(cfg);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Lease granted: start its renewal timer, at half the lease time.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StartLeaseRenewal
+(
+    void
+)
+{
+    uint64_t renewMs = ((uint64_t)Dhcp.lease.leaseTime * 1000) / 2;
+
+    Dhcp.hasLease = true;
+    Dhcp.expiry = le_clk_GetAbsoluteTime().sec + Dhcp.lease.leaseTime;
+    le_timer_Stop(Dhcp.renewTimer);
+    if (0 != renewMs)
+    {
+        le_timer_SetMsInterval(Dhcp.renewTimer, (renewMs > UINT32_MAX) ? UINT32_MAX :
+                                                                         (uint32_t)renewMs);
+        le_timer_Start(Dhcp.renewTimer);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Release the lease in use, e.g. on disconnection: the address and default route set from it are
+ * removed. The cached lease is kept, and the outcome of a request still running is dropped.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StopDhcp
+(
+    void
+)
+{
+    if (Dhcp.isIpConfigSet)
+    {
+        if (LE_OK != pa_wifiClient_ClearIpConfig(Dhcp.ifName))
+        {
+            LE_WARN("Failed to remove the IP address of %s", Dhcp.ifName);
+        }
+        Dhcp.isIpConfigSet = false;
+    }
+    le_timer_Stop(Dhcp.renewTimer);
+    Dhcp.hasLease = false;
+    Dhcp.isStartPending = false;
+    Dhcp.session++;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Report the IP address as usable to the connection event handlers.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReportIpReady
+(
+    void
+)
+{
+    le_wifiClient_EventInd_t* wifiEventIndicationPtr = le_mem_ForceAlloc(WifiEventPool);
+
+    memset(wifiEventIndicationPtr, 0, sizeof(le_wifiClient_EventInd_t));
+    wifiEventIndicationPtr->event = LE_WIFICLIENT_EVENT_IP_READY;
+    wifiEventIndicationPtr->disconnectionCause = LE_WIFICLIENT_UNKNOWN_CAUSE;
+    le_utf8_Copy(wifiEventIndicationPtr->ifName, Dhcp.ifName,
+                 sizeof(wifiEventIndicationPtr->ifName), NULL);
+    le_utf8_Copy(wifiEventIndicationPtr->apBssid, Dhcp.bssid,
+                 sizeof(wifiEventIndicationPtr->apBssid), NULL);
+
+    le_event_ReportWithRefCounting(WifiEventIndicationId, wifiEventIndicationPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * DHCP worker thread: run the exchange of the request. The address granted is set by the main
+ * thread, once the request is known to belong to the current session.
+ */
+//--------------------------------------------------------------------------------------------------
+static void *DhcpThread
+(
+    void *contextPtr
+)
+{
+    DhcpContext_t *dhcpContextPtr = contextPtr;
+
+    dhcpContextPtr->result = pa_wifiClient_RequestLease(dhcpContextPtr->ifName,
+                                                        dhcpContextPtr->request,
+                                                        &dhcpContextPtr->lease);
+    return NULL;
+}
+
+// Forward declaration: the outcome of a request may start the next one
+static void DhcpRequestDone(void *param1Ptr, void *param2Ptr);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Thread destructor of the DHCP worker: its outcome is handled by the main thread, which owns the
+ * DHCP client.
+ */
+//--------------------------------------------------------------------------------------------------
+static void DhcpThreadDestructor
+(
+    void *contextPtr
+)
+{
+    le_event_QueueFunctionToThread(MainThreadRef, DhcpRequestDone, contextPtr, NULL);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start a DHCP request in the worker thread, for the lease in use except on DISCOVER.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StartLeaseRequest
+(
+    pa_wifiClient_DhcpRequest_t request
+)
+{
+    memset(&DhcpContext, 0, sizeof(DhcpContext));
+    DhcpContext.request = request;
+    DhcpContext.session = Dhcp.session;
+    DhcpContext.result = LE_FAULT;
+    le_utf8_Copy(DhcpContext.ifName, Dhcp.ifName, sizeof(DhcpContext.ifName), NULL);
+    if (PA_WIFICLIENT_DHCP_DISCOVER != request)
+    {
+        DhcpContext.lease = Dhcp.lease;
+    }
+
+    Dhcp.threadRef = le_thread_Create("WiFi Client DHCP Thread", DhcpThread, &DhcpContext);
+    le_thread_AddChildDestructor(Dhcp.threadRef, DhcpThreadDestructor, &DhcpContext);
+    le_thread_Start(Dhcp.threadRef);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get an IP address once connected: the cached lease is requested again (INIT-REBOOT), falling
+ * back to the full DHCP exchange. When a request of the previous connection is still running, the
+ * address is requested once it ends.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StartDhcp
+(
+    void
+)
+{
+    if (!Dhcp.isEnabled)
+    {
+        return;
+    }
+
+    if (NULL != Dhcp.threadRef)
+    {
+        Dhcp.isStartPending = true;
+        return;
+    }
+
+    Dhcp.startTime = le_clk_GetRelativeTime();
+    if (LoadLease())
+    {
+        StartLeaseRequest(PA_WIFICLIENT_DHCP_INIT_REBOOT);
+    }
+    else
+    {
+        StartLeaseRequest(PA_WIFICLIENT_DHCP_DISCOVER);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * IP address granted and configured: renew and cache the lease, then report the address.
+ */
+//--------------------------------------------------------------------------------------------------
+static void LeaseGranted
+(
+    void
+)
+{
+    le_clk_Time_t duration;
+    uint32_t      dhcpMs;
+
+    StartLeaseRenewal();
+    SaveLease(true);
+
+    // Account the DHCP phase to the connection attempt just made
+    duration = le_clk_Sub(le_clk_GetRelativeTime(), Dhcp.startTime);
+    dhcpMs = (uint32_t)((duration.sec * 1000) + (duration.usec / 1000));
+    if (ConnectTimingCount > 0)
+    {
+        uint32_t slot = (ConnectTimingCount - 1) % CONNECT_TIMING_HISTORY;
+        if ((LE_OK == ConnectTimings[slot].result) && (0 == ConnectTimingsDhcpMs[slot]))
+        {
+            ConnectTimingsDhcpMs[slot] = dhcpMs;
+        }
+    }
+    LE_INFO("IP address ready on %s in %u ms", Dhcp.ifName, dhcpMs);
+
+    ReportIpReady();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Outcome of the DHCP request run by the worker thread, handled by the main thread. The IP
+ * configuration of a new lease is set here, once the request is known to be current.
+ */
+//--------------------------------------------------------------------------------------------------
+static void DhcpRequestDone
+(
+    void *param1Ptr,
+    void *param2Ptr
+)
+{
+    DhcpContext_t *dhcpContextPtr = param1Ptr;
+    le_result_t    result = dhcpContextPtr->result;
+
+    Dhcp.threadRef = NULL;
+
+    if ((!Dhcp.isEnabled) || (dhcpContextPtr->session != Dhcp.session))
+    {
+        LE_DEBUG("DHCP request of a previous connection dropped");
+        if (Dhcp.isStartPending)
+        {
+            Dhcp.isStartPending = false;
+            StartDhcp();
+        }
+        return;
+    }
+
+    if ((LE_OK == result) && (PA_WIFICLIENT_DHCP_RENEW != dhcpContextPtr->request))
+    {
+        if (LE_OK == pa_wifiClient_SetIpConfig(Dhcp.ifName, &dhcpContextPtr->lease))
+        {
+            Dhcp.isIpConfigSet = true;
+        }
+        else
+        {
+            result = LE_FAULT;
+        }
+    }
+
+    switch (dhcpContextPtr->request)
+    {
+        case PA_WIFICLIENT_DHCP_INIT_REBOOT:
+            if (LE_OK == result)
+            {
+                Dhcp.lease = dhcpContextPtr->lease;
+                LeaseGranted();
+                return;
+            }
+            if (LE_NOT_POSSIBLE == result)
+            {
+                // Another network behind the same SSID and BSSID, or the address has been
+                // reassigned
+                SaveLease(false);
+            }
+            memset(&Dhcp.lease, 0, sizeof(Dhcp.lease));
+            StartLeaseRequest(PA_WIFICLIENT_DHCP_DISCOVER);
+            break;
+
+        case PA_WIFICLIENT_DHCP_DISCOVER:
+            if (LE_OK != result)
+            {
+                LE_ERROR("Failed to get an IP address on %s", Dhcp.ifName);
+                return;
+            }
+            Dhcp.lease = dhcpContextPtr->lease;
+            LeaseGranted();
+            break;
+
+        case PA_WIFICLIENT_DHCP_RENEW:
+            if (LE_OK == result)
+            {
+                Dhcp.lease = dhcpContextPtr->lease;
+                StartLeaseRenewal();
+                SaveLease(true);
+                return;
+            }
+            if ((LE_NOT_POSSIBLE == result) || (le_clk_GetAbsoluteTime().sec >= Dhcp.expiry))
+            {
+                LE_WARN("Lease lost, requesting a new one");
+                SaveLease(false);
+                StopDhcp();
+                StartDhcp();
+                return;
+            }
+            le_timer_SetMsInterval(Dhcp.renewTimer, DHCP_RENEW_RETRY_MS);
+            le_timer_Start(Dhcp.renewTimer);
+            break;
+
+        default:
+            LE_ERROR("Unknown DHCP request %d", dhcpContextPtr->request);
+            break;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Lease renewal timer handler: extend the lease from its server.
+ */
+//--------------------------------------------------------------------------------------------------
+static void DhcpRenewTimerHandler
+(
+    le_timer_Ref_t timerRef
+)
+{
+    if ((!Dhcp.hasLease) || (NULL != Dhcp.threadRef))
+    {
+        return;
+    }
+
+    StartLeaseRequest(PA_WIFICLIENT_DHCP_RENEW);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the signal threshold monitored by the driver for the current connection: the threshold of the
+ * roaming engine when enabled, else the one set by le_wifiClient_SetRssiThreshold().
+ *
+ * @return
+ *      - LE_OK     Function succeeded, or not connected.
+ *      - LE_FAULT  Function failed.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ApplyRssiThreshold
+(
+    void
+)
+{
+    if ('\0' == CurrentBssid[0])
+    {
+        // The driver monitors the signal of an association only: set on the next connection
+        return LE_OK;
+    }
+    if (Roaming.isEnabled)
+    {
+        return pa_wifiClient_SetRssiThreshold(Roaming.threshold, ROAM_CQM_HYSTERESIS);
+    }
+    return pa_wifiClient_SetRssiThreshold(RssiThreshold, RssiHysteresis);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * CallBack for PA WiFi Event Indications.
+ */
+//--------------------------------------------------------------------------------------------------
+static void PaEventIndicationHandler
+(
+    le_wifiClient_EventInd_t* wifiEventIndicationPtr,
+    void *contextPtr
+)
+{
+    LE_DEBUG("WiFi event: %d, interface: %s, bssid: %s",
+            wifiEventIndicationPtr->event,
+            wifiEventIndicationPtr->ifName,
+            wifiEventIndicationPtr->apBssid);
+
+    if (LE_WIFICLIENT_EVENT_CONNECTED == wifiEventIndicationPtr->event)
+    {
+        le_utf8_Copy(CurrentBssid, wifiEventIndicationPtr->apBssid, sizeof(CurrentBssid), NULL);
+
+        // wpa_supplicant may recover the connection by itself before the next attempt
+        if (Reconnect.isActive)
+        {
+            ReconnectDone();
+        }
+
+        Roaming.isSignalLow = false;
+        if (((0 != RssiThreshold) || Roaming.isEnabled) && (LE_OK != ApplyRssiThreshold()))
+        {
+            LE_WARN("Failed to set the signal threshold");
+        }
+
+        // Get the IP address once the connection is reported to the applications
+        if (Dhcp.isEnabled)
+        {
+            FoundAccessPoint_t *apPtr = le_ref_Lookup(ScanApRefMap, CurrentConnection);
+
+            StopDhcp();
+            le_utf8_Copy(Dhcp.ifName, wifiEventIndicationPtr->ifName, sizeof(Dhcp.ifName), NULL);
+            le_utf8_Copy(Dhcp.bssid, wifiEventIndicationPtr->apBssid, sizeof(Dhcp.bssid), NULL);
+            memset(Dhcp.ssid, 0, sizeof(Dhcp.ssid));
+            if (NULL != apPtr)
+            {
+                size_t ssidLen = apPtr->accessPoint.ssidLength;
+                memcpy(Dhcp.ssid, apPtr->accessPoint.ssidBytes,
+                       (ssidLen < sizeof(Dhcp.ssid)) ? ssidLen : (sizeof(Dhcp.ssid) - 1));
+            }
+            StartDhcp();
+        }
+    }
+    else if (LE_WIFICLIENT_EVENT_DISCONNECTED == wifiEventIndicationPtr->event)
+    {
+        LE_DEBUG("disconnectCause: %d", wifiEventIndicationPtr->disconnectionCause);
+        CurrentBssid[0] = '\0';
+        Roaming.isSignalLow = false;
+        StopDhcp();
+        StartReconnect(wifiEventIndicationPtr->disconnectionCause);
+    }
+    else if (LE_WIFICLIENT_EVENT_RSSI_LOW == wifiEventIndicationPtr->event)
+    {
+        Roaming.isSignalLow = true;
+        RoamSearchCandidate();
+    }
+    else if (LE_WIFICLIENT_EVENT_RSSI_HIGH == wifiEventIndicationPtr->event)
+    {
+        Roaming.isSignalLow = false;
+    }
+
+    le_event_ReportWithRefCounting(WifiEventIndicationId, wifiEventIndicationPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * CallBack for PA Events.
+ * @deprecated pa_wifiClient_AddEventHandler() should not be used anymore.
+ * It has been replaced by pa_wifiClient_AddEventIndHandler().
+ */
+//--------------------------------------------------------------------------------------------------
+static void PaEventHandler
+(
+    le_wifiClient_Event_t event,
+    void *contextPtr
+)
+{
+    LE_DEBUG("Event: %d ", event);
+
+    le_event_Report(WifiEventId, (void *)&event, sizeof(le_wifiClient_Event_t));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Local function to find an access point reference based on BSSID among the AP found in scan.
+ * If not found will return NULL.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_wifiClient_AccessPointRef_t FindAccessPointRefFromBssid
+(
+    const char* bssidPtr
+        ///< [OUT]
+        ///< The BSSID returned as a byte array.
+)
+{
+    le_wifiClient_AccessPointRef_t apRef = NULL;
+    le_ref_IterRef_t               iter  = le_ref_GetIterator(ScanApRefMap);
+
+    LE_DEBUG("Find AP from BSSID");
+
+    while (le_ref_NextNode(iter) == LE_OK)
+    {
+        apRef = (le_wifiClient_AccessPointRef_t)le_ref_GetSafeRef(iter);
+        if (NULL != apRef)
+        {
+            FoundAccessPoint_t *apPtr = (FoundAccessPoint_t *)le_ref_Lookup(ScanApRefMap, apRef);
+            if (NULL != apPtr)
+            {
+                if (0 == strncmp(apPtr->accessPoint.bssid, bssidPtr, LE_WIFIDEFS_MAX_BSSID_BYTES))
+                {
+                    LE_DEBUG("Found apRef %p", apRef);
+                    return apRef;
+                }
+            }
+        }
+        else
+        {
+            LE_ERROR("ERROR le_ref_GetSafeRef returned NULL iter:%p", iter);
+        }
+    }
+    return NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Local function to find an access point reference based on SSID among the AP found in scan.
+ * If several access points have this SSID, the one with the best score is returned.
+ * If not found will return NULL.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_wifiClient_AccessPointRef_t FindAccessPointRefFromSsid
+(
+    const uint8_t* ssidPtr,
+        ///< [IN]
+        ///< The SSID as a byte array.
+
+    size_t ssidNumElements
+        ///< [IN]
+        ///< SSID length in bytes.
+)
+{
+    LE_DEBUG("Find AP from SSID");
+    return SelectBestAccessPoint(ssidPtr, ssidNumElements);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Local function to add AP:s found during scan to AddRef point interface
+ */
+//--------------------------------------------------------------------------------------------------
+
+static le_wifiClient_AccessPointRef_t AddAccessPointToApRefMap
+(
+    pa_wifiClient_AccessPoint_t *apPtr
+)
+{
+    // first see if it alreay exists in our list of reference.
+    le_wifiClient_AccessPointRef_t returnedRef = FindAccessPointRefFromBssid(apPtr->bssid);
+
+    if (NULL != returnedRef)
+    {
+        FoundAccessPoint_t *oldAccessPointPtr =
+            (FoundAccessPoint_t *)le_ref_Lookup(ScanApRefMap, returnedRef);
+
+
+        if (NULL != oldAccessPointPtr)
+        {
+            LE_DEBUG("Already exists %p. Update SignalStrength %d, SSID '%s'",
+                     returnedRef, apPtr->signalStrength, &apPtr->ssidBytes[0]);
+
+            oldAccessPointPtr->accessPoint.signalStrength = apPtr->signalStrength;
+            oldAccessPointPtr->accessPoint.frequency = apPtr->frequency;
+            oldAccessPointPtr->accessPoint.ssidLength = apPtr->ssidLength;
+            memcpy(&oldAccessPointPtr->accessPoint.ssidBytes, &apPtr->ssidBytes,
+                   apPtr->ssidLength);
+            oldAccessPointPtr->foundInLatestScan = true;
+        }
+
+        return returnedRef;
+    }
+    else
+    {
+        FoundAccessPoint_t *foundAccessPointPtr = le_mem_ForceAlloc(AccessPointPool);
+
+        if (foundAccessPointPtr)
+        {
+            FoundWifiApCount++;
+            LE_DEBUG("New AP[%d] SignalStrength %d | SSID length %d | SSID: \"%.*s\"",
+                FoundWifiApCount,
+                apPtr->signalStrength,
+                apPtr->ssidLength,
+                apPtr->ssidLength,
+                (char *)apPtr->ssidBytes
+               );
+
+            // struct member value copy
+            foundAccessPointPtr->accessPoint = *apPtr;
+            foundAccessPointPtr->foundInLatestScan = true;
+            foundAccessPointPtr->autoReconnect = false;
+
+            // Create a Safe Reference for this object.
+            returnedRef = le_ref_CreateRef(ScanApRefMap, foundAccessPointPtr);
+
+            LE_DEBUG("le_ref_CreateRef foundAccessPointPtr %p; Ref%p ",
+                foundAccessPointPtr, returnedRef);
+        }
+        else
+        {
+            LE_ERROR("le_mem_ForceAlloc failed. Count %d", FoundWifiApCount);
+        }
+    }
+
+    return returnedRef;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Frees one members of the access point and the corresponding access points memory
+ */
+//--------------------------------------------------------------------------------------------------
+static void RemoveAccessPoint
+(
+    le_wifiClient_AccessPointRef_t apRef
+)
+{
+    FoundAccessPoint_t *apPtr = (FoundAccessPoint_t *)le_ref_Lookup(ScanApRefMap, apRef);
+
+    if (apPtr == NULL)
+    {
+        LE_ERROR("Bad reference");
+        return;
+    }
+
+    le_ref_DeleteRef(ScanApRefMap, apRef);
+    le_mem_Release(apPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Frees all members of the AddRef and the corresponding AccessPoints added during Scan and
+ *  le_wifiClient_Create()
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReleaseAllAccessPoints
+(
+    void
+)
+{
+    le_wifiClient_AccessPointRef_t apRef = NULL;
+    le_ref_IterRef_t               iter  = le_ref_GetIterator(ScanApRefMap);
+
+    LE_DEBUG("Release all AP");
+
+    while (le_ref_NextNode(iter) == LE_OK)
+    {
+        apRef = (le_wifiClient_AccessPointRef_t)le_ref_GetSafeRef(iter);
+        if (NULL != apRef)
+        {
+            RemoveAccessPoint(apRef);
+        }
+        else
+        {
+            LE_ERROR("ERROR le_ref_GetSafeRef returned NULL iter:%p", iter);
+            return;
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Marks the current access points as old by changing the values for foundInLatestScan
+ * and signalStrength.
+ * These values will be updated later, if the same AP is still found.
+ * This way the new and old AccessPoints can be separated.
+ * A scan targeting an SSID only marks the access points of this SSID, so that the results of the
+ * last full scan of the other SSIDs are kept.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void MarkAccessPointsOld
+(
+    const uint8_t *ssidPtr,
+        ///< [IN] SSID of the scanned access points
+    size_t ssidLength
+        ///< [IN] Length of the SSID, 0 for all the access points
+)
+{
+    le_wifiClient_AccessPointRef_t apRef   = NULL;
+    le_ref_IterRef_t               iter    = le_ref_GetIterator(ScanApRefMap);
+    uint32_t                       counter = 0;
+
+    LE_DEBUG("Mark AP as old");
+
+    while (le_ref_NextNode(iter) == LE_OK)
+    {
+        apRef = (le_wifiClient_AccessPointRef_t)le_ref_GetSafeRef(iter);
+        if (NULL != apRef)
+        {
+            FoundAccessPoint_t* apPtr = (FoundAccessPoint_t *)le_ref_Lookup(ScanApRefMap, apRef);
+
+            if (apPtr != NULL)
+            {
+                if ((0 != ssidLength) &&
+                    ((apPtr->accessPoint.ssidLength != ssidLength) ||
+                     (0 != memcmp(apPtr->accessPoint.ssidBytes, ssidPtr, ssidLength))))
+                {
+                    continue;
+                }
+                apPtr->accessPoint.signalStrength = LE_WIFICLIENT_NO_SIGNAL_STRENGTH;
+                apPtr->foundInLatestScan = false;
+                LE_DEBUG("Marking %p as old", apRef);
+                counter++;
+            }
+            else
+            {
+                LE_ERROR("Bad reference");
+                return;
+            }
+
+        }
+        else
+        {
+            LE_ERROR("ERROR le_ref_GetSafeRef returned NULL iter:%p", iter);
+            break;
+        }
+    }
+    LE_DEBUG("Marked: %d", counter);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Select the best roaming candidate among the access points of the current SSID found by the
+ * targeted scan, and reassociate with it if its signal is better than the current one by at least
+ * the configured hysteresis.
+ *
+ * @note Queued to the service thread by the scan thread destructor.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RoamSelectCandidate
+(
+    void *param1Ptr,
+        ///< [IN]
+        ///< Result of the targeted scan.
+    void *param2Ptr
+        ///< [IN]
+        ///< Unused.
+)
+{
+    le_result_t                    scanResult = (le_result_t)(intptr_t)param1Ptr;
+    le_wifiClient_AccessPointRef_t apRef      = NULL;
+    le_wifiClient_AccessPointRef_t bestRef    = NULL;
+    int16_t                        bestSignal = LE_WIFICLIENT_NO_SIGNAL_STRENGTH;
+    FoundAccessPoint_t            *curPtr;
+    le_ref_IterRef_t               iter;
+
+    if (LE_OK != scanResult)
+    {
+        LE_WARN("Roaming scan failed (%d)", scanResult);
+        return;
+    }
+
+    curPtr = le_ref_Lookup(ScanApRefMap, CurrentConnection);
+    if ((!Roaming.isEnabled) || (!Roaming.isSignalLow) || (NULL == curPtr))
+    {
+        LE_DEBUG("Roaming no longer needed");
+        return;
+    }
+
+    // The driver reported the signal below the threshold, unless the current BSS is scanned
+    Roaming.linkSignal = Roaming.threshold;
+    iter = le_ref_GetIterator(ScanApRefMap);
+    while (le_ref_NextNode(iter) == LE_OK)
+    {
+        apRef = (le_wifiClient_AccessPointRef_t)le_ref_GetSafeRef(iter);
+        FoundAccessPoint_t *apPtr = le_ref_Lookup(ScanApRefMap, apRef);
+
+        if ((NULL == apPtr) || (!apPtr->foundInLatestScan) ||
+            (LE_WIFICLIENT_NO_SIGNAL_STRENGTH == apPtr->accessPoint.signalStrength) ||
+            (apPtr->accessPoint.ssidLength != curPtr->accessPoint.ssidLength) ||
+            (0 != memcmp(apPtr->accessPoint.ssidBytes, curPtr->accessPoint.ssidBytes,
+                         curPtr->accessPoint.ssidLength)))
+        {
+            continue;
+        }
+        if (0 == strncasecmp(apPtr->accessPoint.bssid, CurrentBssid, LE_WIFIDEFS_MAX_BSSID_BYTES))
+        {
+            Roaming.linkSignal = apPtr->accessPoint.signalStrength;
+            continue;
+        }
+
+        if ((NULL == bestRef) || (apPtr->accessPoint.signalStrength > bestSignal))
+        {
+            bestRef = apRef;
+            bestSignal = apPtr->accessPoint.signalStrength;
+        }
+    }
+
+    if (NULL == bestRef)
+    {
+        LE_INFO("No roaming candidate found");
+        return;
+    }
+
+    if (bestSignal < (Roaming.linkSignal + Roaming.hysteresis))
+    {
+        LE_INFO("Best candidate %p at %d dBm not enough better than current %d dBm",
+                bestRef, bestSignal, Roaming.linkSignal);
+        return;
+    }
+
+    LE_INFO("Roaming from %d dBm to candidate %p at %d dBm", Roaming.linkSignal, bestRef,
+            bestSignal);
+    (void)le_wifiClient_Roam(bestRef);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start Scanning for WiFi Access points
+ * Will result in an event LE_WIFICLIENT_EVENT_SCAN_DONE when the scan results are available or
+ * an event LE_WIFICLIENT_EVENT_SCAN_FAILED if there was an error while scanning.
+ *
+ * @return LE_FAULT         Function failed.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+static void *ScanThread
+(
+    void *contextPtr
+)
+{
+    pa_wifiClient_AccessPoint_t accessPoint;
+    ScanContext_t               *scanContextPtr = contextPtr;
+    le_result_t                 *scanResultPtr  = &scanContextPtr->result;
+    le_result_t                 paResult;
+
+    if (0 != scanContextPtr->ssidLength)
+    {
+        // Only probe the current SSID when looking for a roaming candidate
+        paResult = pa_wifiClient_ScanSsid(scanContextPtr->ssidBytes, scanContextPtr->ssidLength);
+    }
+    else
+    {
+        paResult = pa_wifiClient_Scan();
+    }
+
+    if (LE_OK != paResult)
+    {
+        LE_ERROR("Scan failed (%d)", paResult);
+        *scanResultPtr = LE_FAULT;
+        return NULL;
+    }
+
+    FoundWifiApCount = 0;
+
+    MarkAccessPointsOld(scanContextPtr->ssidBytes, scanContextPtr->ssidLength);
+    memset(scanIfName, 0, LE_WIFIDEFS_MAX_IFNAME_BYTES);
+    while (LE_OK == (paResult = pa_wifiClient_GetScanResult(&accessPoint, scanIfName)))
+    {
+        if (AddAccessPointToApRefMap(&accessPoint) == NULL)
+        {
+            LE_ERROR("pa_wifiClient_ScanDone() failed");
+            paResult = LE_FAULT;
+            break;
+        }
+    }
+
+    *scanResultPtr = ((paResult == LE_OK) || (paResult == LE_NOT_FOUND)) ? LE_OK : paResult;
+
+    paResult = pa_wifiClient_ScanDone();
+    if (LE_OK != paResult)
+    {
+        LE_ERROR("pa_wifiClient_ScanDone() failed (%d)", paResult);
+        *scanResultPtr = paResult;
+    }
+
+    return NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Thread Destructor for scan
+ */
+//--------------------------------------------------------------------------------------------------
+static void ScanThreadDestructor
+(
+    void *context
+)
+{
+    ScanContext_t *scanContextPtr = context;
+    le_result_t    scanResult     = scanContextPtr->result;
+
+    LE_DEBUG("Destruct scan thread");
+    ScanThreadRef = NULL;
+
+    // Scan done on behalf of the roaming engine is not notified to the applications, and the
+    // candidate is selected by the main thread which owns the roaming engine
+    if (scanContextPtr->isRoaming)
+    {
+        le_event_QueueFunctionToThread(MainThreadRef, RoamSelectCandidate,
+                                       (void *)(intptr_t)scanResult, NULL);
+        return;
+    }
+
+    le_wifiClient_EventInd_t* wifiEventIndicationPtr = le_mem_ForceAlloc(WifiEventPool);
+
+    if (scanResult == LE_OK)
+    {
+        wifiEventIndicationPtr->event = LE_WIFICLIENT_EVENT_SCAN_DONE;
+    }
+    else
+    {
+        LE_WARN("Scan failed");
+        wifiEventIndicationPtr->event = LE_WIFICLIENT_EVENT_SCAN_FAILED;
+    }
+
+    wifiEventIndicationPtr->disconnectionCause = LE_WIFICLIENT_UNKNOWN_CAUSE;
+    strncpy(wifiEventIndicationPtr->ifName, scanIfName, LE_WIFIDEFS_MAX_IFNAME_LENGTH);
+    wifiEventIndicationPtr->ifName[LE_WIFIDEFS_MAX_IFNAME_LENGTH] = '\0';
+    wifiEventIndicationPtr->apBssid[0] = '\0';
+    PaEventIndicationHandler(wifiEventIndicationPtr, NULL);
+
+    PaEventHandler(wifiEventIndicationPtr->event, NULL);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handler function to the close session service to detect if the application crashed.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void CloseSessionEventHandler
+(
+    le_msg_SessionRef_t  sessionRef,
+    void                *contextPtr
+)
+{
+    if (sessionRef == GetFirstSessionRef)
+    {
+        GetFirstSessionRef = NULL;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Is Scan running. Checks if the ScanThread is still running
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsScanRunning(void)
+{
+    LE_DEBUG("IsScanRunning .%d", (NULL != ScanThreadRef));
+    return (NULL != ScanThreadRef);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start the scan thread. A scan targeted on an SSID is done for the roaming engine.
+ *
+ * @return
+ *      - LE_OK     Function succeeded.
+ *      - LE_BUSY   Scan already running.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t StartScan
+(
+    const uint8_t *ssidPtr,
+    uint8_t        ssidLength
+)
+{
+    if (IsScanRunning())
+    {
+        LE_DEBUG("ERROR: Scan already running");
+        return LE_BUSY;
+    }
+
+    LE_DEBUG("Scan started");
+    memset(&ScanContext, 0, sizeof(ScanContext));
+    ScanContext.result = LE_OK;
+    if (NULL != ssidPtr)
+    {
+        ScanContext.isRoaming = true;
+        ScanContext.ssidLength = ssidLength;
+        memcpy(ScanContext.ssidBytes, ssidPtr, ssidLength);
+    }
+
+    // Start the thread
+    ScanThreadRef = le_thread_Create("WiFi Client Scan Thread", ScanThread, &ScanContext);
+    le_thread_AddChildDestructor(ScanThreadRef, ScanThreadDestructor, &ScanContext);
+
+    le_thread_Start(ScanThreadRef);
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Roaming engine search of a candidate, once the driver has reported the signal of the current BSS
+ * below the threshold: a scan targeted on the current SSID is started, and the candidate selection
+ * is done once the scan is complete. The search is done again after the hold-off as long as the
+ * signal stays low.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RoamSearchCandidate
+(
+    void
+)
+{
+    FoundAccessPoint_t *curPtr = le_ref_Lookup(ScanApRefMap, CurrentConnection);
+
+    if ((!Roaming.isEnabled) || (!Roaming.isSignalLow) || (NULL == curPtr) ||
+        le_timer_IsRunning(Roaming.monitorTimer))
+    {
+        return;
+    }
+
+    // A scan of the applications delays the search until the end of the hold-off
+    le_timer_Start(Roaming.monitorTimer);
+    if (IsScanRunning())
+    {
+        return;
+    }
+
+    LE_INFO("Signal of %s below %d dBm, looking for a roaming candidate",
+            CurrentBssid, Roaming.threshold);
+    if (LE_OK != StartScan(curPtr->accessPoint.ssidBytes, curPtr->accessPoint.ssidLength))
+    {
+        LE_WARN("Unable to start the roaming scan");
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Roaming engine hold-off expiry.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RoamMonitorTimerHandler
+(
+    le_timer_Ref_t timerRef
+)
+{
+    RoamSearchCandidate();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * The first-layer WiFi Client Roam Event Handler.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void FirstLayerRoamEventHandler
+(
+    void *reportPtr,
+    void *secondLayerHandlerFunc
+)
+{
+    RoamEvent_t                          *roamEventPtr      = reportPtr;
+    le_wifiClient_RoamEventHandlerFunc_t  clientHandlerFunc = secondLayerHandlerFunc;
+
+    if (NULL != roamEventPtr)
+    {
+        clientHandlerFunc(roamEventPtr->fromBssid, roamEventPtr->toBssid, roamEventPtr->result,
+                          roamEventPtr->latencyMs, le_event_GetContextPtr());
+    }
+    else
+    {
+        LE_WARN("roamEventPtr is NULL");
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * The first-layer WiFi Client Event Handler.
+ *
+ * @deprecated le_wifiClient_AddNewEventHandler() should not be used anymore.
+ *
+ * It has been replaced by le_wifiClient_AddConnectionEventHandler().
+ */
+//--------------------------------------------------------------------------------------------------
+static void FirstLayerWifiClientEventHandler
+(
+    void *reportPtr,
+    void *secondLayerHandlerFunc
+)
+{
+    le_wifiClient_NewEventHandlerFunc_t  clientHandlerFunc = secondLayerHandlerFunc;
+    le_wifiClient_Event_t               *wifiEventPtr      = (le_wifiClient_Event_t *)reportPtr;
+
+    if (NULL != wifiEventPtr)
+    {
+        LE_DEBUG("Event: %d", *wifiEventPtr);
+        clientHandlerFunc(*wifiEventPtr, le_event_GetContextPtr());
+    }
+    else
+    {
+        LE_ERROR("Event is NULL");
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * The first-layer WiFi Client Connection Event Handler.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void FirstLayerWifiClientConnectionEventHandler
+(
+    void *reportPtr,
+    void *secondLayerHandlerFunc
+)
+{
+    le_wifiClient_EventInd_t*  wifiEventPtr = reportPtr;
+    le_wifiClient_ConnectionEventHandlerFunc_t  clientHandlerFunc = secondLayerHandlerFunc;
+
+
+    if (NULL != wifiEventPtr)
+    {
+        clientHandlerFunc(wifiEventPtr, le_event_GetContextPtr());
+    }
+    else
+    {
+        LE_WARN("wifiEventPtr is NULL");
+    }
+    // The reportPtr is a reference counted object, so need to release it
+    le_mem_Release(reportPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * returns the value of the field "foundInLatestScan"
+ * This is used to determine if a Ref was found in the last scan or not.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool WasApFoundInLastScan
+(
+    le_wifiClient_AccessPointRef_t apRef
+        ///< [IN]
+        ///< WiFi Access Point reference.
+)
+{
+    FoundAccessPoint_t *apPtr = (FoundAccessPoint_t *)le_ref_Lookup(ScanApRefMap, apRef);
+
+    if (apPtr == NULL)
+    {
+        LE_ERROR("Bad reference");
+        return false;
+    }
+
+    return apPtr->foundInLatestScan;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add handler function for EVENT 'le_wifiClient_NewEvent'
+ *
+ * This event provide information on Wifi Client event changes.
+ *
+ * @deprecated le_wifiClient_AddNewEventHandler() should not be used anymore.
+ *
+ * It has been replaced by le_wifiClient_AddConnectionEventHandler().
+ */
+//--------------------------------------------------------------------------------------------------
+le_wifiClient_NewEventHandlerRef_t le_wifiClient_AddNewEventHandler
+(
+    le_wifiClient_NewEventHandlerFunc_t handlerFuncPtr,
+        ///< [IN]
+        ///< Event handling function
+
+    void *contextPtr
+        ///< [IN]
+        ///< Associated event context
+)
+{
+    le_event_HandlerRef_t handlerRef;
+
+    // Note: THIS ONE REGISTERS THE CB function..
+    LE_DEBUG("Add new event handler");
+
+    if (handlerFuncPtr == NULL)
+    {
+        LE_KILL_CLIENT("handlerFuncPtr is NULL !");
+        return NULL;
+    }
+
+    handlerRef = le_event_AddLayeredHandler("NewWiFiClientMsgHandler",
+                                            WifiEventId,
+                                            FirstLayerWifiClientEventHandler,
+                                            (le_event_HandlerFunc_t)handlerFuncPtr);
+
+    le_event_SetContextPtr(handlerRef, contextPtr);
+
+    return (le_wifiClient_NewEventHandlerRef_t)(handlerRef);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function must be called to register an handler for WiFi connection state change.
+ *
+ * @return A handler reference, which is only needed for later removal of the handler.
+ *
+ * @note Doesn't return on failure, so there's no need to check the return value for errors.
+ */
+//--------------------------------------------------------------------------------------------------
+le_wifiClient_ConnectionEventHandlerRef_t le_wifiClient_AddConnectionEventHandler
+(
+    le_wifiClient_ConnectionEventHandlerFunc_t handlerFuncPtr,
+        ///< [IN]
+        ///< Event handling function
+
+    void *contextPtr
+        ///< [IN]
+        ///< Associated event context
+)
+{
+    le_event_HandlerRef_t handlerRef;
+
+    // Note: THIS ONE REGISTERS THE CB function..
+    LE_DEBUG("Add wifi connection event handler");
+
+    if (handlerFuncPtr == NULL)
+    {
+        LE_KILL_CLIENT("handlerFuncPtr is NULL !");
+        return NULL;
+    }
+
+    handlerRef = le_event_AddLayeredHandler("WiFiClientMsgHandler",
+                                            WifiEventIndicationId,
+                                            FirstLayerWifiClientConnectionEventHandler,
+                                            (le_event_HandlerFunc_t)handlerFuncPtr);
+
+    le_event_SetContextPtr(handlerRef, contextPtr);
+
+    return (le_wifiClient_ConnectionEventHandlerRef_t)(handlerRef);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove handler function for EVENT 'le_wifiClient_NewEvent'
+ *
+ * @deprecated le_wifiClient_AddNewEventHandler() should not be used anymore.
+ *
+ * It has been replaced by le_wifiClient_AddConnectionEventHandler().
+ */
+//--------------------------------------------------------------------------------------------------
+void le_wifiClient_RemoveNewEventHandler
+(
+    le_wifiClient_NewEventHandlerRef_t handlerRef
+        ///< [IN]
+        ///< Reference of the event handler to remove
+)
+{
+    LE_DEBUG("Remove event handler");
+    le_event_RemoveHandler((le_event_HandlerRef_t)handlerRef);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove handler function for EVENT 'le_wifiClient_ConnectionEvent'
+ */
+//--------------------------------------------------------------------------------------------------
+void le_wifiClient_RemoveConnectionEventHandler
+(
+    le_wifiClient_ConnectionEventHandlerRef_t handlerRef
+        ///< [IN]
+        ///< Reference of the event handler to remove
+)
+{
+    LE_DEBUG("Remove event handler");
+    le_event_RemoveHandler((le_event_HandlerRef_t)handlerRef);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function must be called to register an handler for roam events, reporting each
+ * reassociation with another BSS of the current network, its result and its latency.
+ *
+ * @return A handler reference, which is only needed for later removal of the handler.
+ *
+ * @note Doesn't return on failure, so there's no need to check the return value for errors.
+ */
+//--------------------------------------------------------------------------------------------------
+le_wifiClient_RoamEventHandlerRef_t le_wifiClient_AddRoamEventHandler
+(
+    le_wifiClient_RoamEventHandlerFunc_t handlerFuncPtr,
+        ///< [IN]
+        ///< Event handling function
+
+    void *contextPtr
+        ///< [IN]
+        ///< Associated event context
+)
+{
+    le_event_HandlerRef_t handlerRef;
+
+    LE_DEBUG("Add wifi roam event handler");
+
+    if (handlerFuncPtr == NULL)
+    {
+        LE_KILL_CLIENT("handlerFuncPtr is NULL !");
+        return NULL;
+    }
+
+    handlerRef = le_event_AddLayeredHandler("WiFiClientRoamHandler",
+                                            RoamEventId,
+                                            FirstLayerRoamEventHandler,
+                                            (le_event_HandlerFunc_t)handlerFuncPtr);
+
+    le_event_SetContextPtr(handlerRef, contextPtr);
+
+    return (le_wifiClient_RoamEventHandlerRef_t)(handlerRef);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove handler function for EVENT 'le_wifiClient_RoamEvent'
+ */
+//--------------------------------------------------------------------------------------------------
+void le_wifiClient_RemoveRoamEventHandler
+(
+    le_wifiClient_RoamEventHandlerRef_t handlerRef
+        ///< [IN]
+        ///< Reference of the event handler to remove
+)
+{
+    LE_DEBUG("Remove roam event handler");
+    le_event_RemoveHandler((le_event_HandlerRef_t)handlerRef);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Starts the WIFI device.
+ *
+ * @return
+ *      - LE_OK             Function succeeded.
+ *      - LE_FAULT          Function failed.
+ *      - LE_BUSY           The WiFi device is already started.
+ *      - LE_NOT_FOUND      The WiFi device is absent.
+ *      - LE_NOT_POSSIBLE   The WiFi device may not work.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_wifiClient_Start
+(
+    void
+)
+{
+    le_result_t result;
+
+    // Only the first client starts the WIFI module
+    if (!ClientStartCount)
+    {
+        result = pa_wifiClient_Start();
+        if (LE_OK == result)
+        {
+            LE_DEBUG("WIFI client started successfully");
+            // Increment the number of clients calling this start function
+            ClientStartCount++;
+        }
+        else
+        {
+            LE_WARN("Unable to start WIFI client; return code: %d", result);
+        }
+    }
+    else
+    {
+        LE_WARN("WIFI client already started");
+        // Increment the number of clients calling this start function
+        ClientStartCount++;
+        result = LE_BUSY;
+    }
+
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stops the WIFI device.
+ *
+ * @return
+ *      - LE_OK        Function succeeded.
+ *      - LE_FAULT     Function failed.
+ *      - LE_DUPLICATE The WIFI device is already stopped.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_wifiClient_Stop
+(
+    void
+)
+{
+    le_result_t result = LE_OK;
+
+    if (0 == ClientStartCount)
+    {
+        LE_WARN("The WIFI device is already stopped");
+        return LE_DUPLICATE;
+    }
+
+    // Only the last client closes the WIFI module
+    if (1 == ClientStartCount)
+    {
+        StopReconnect();
+        pa_wifiClient_ClearAllCredentials();
+        CurrentConnection = NULL;
+        CurrentBssid[0] = '\0';
+
+        result = pa_wifiClient_Stop();
+        if (LE_OK != result)
+        {
+            LE_ERROR("Unable to stop WIFI client. Err: %d", result);
+        }
+
+        ReleaseAllAccessPoints();
+        LE_DEBUG("WIFI client stopped successfully");
+    }
+
+    // Decrement the number of clients calling this stop function
+    if ((LE_OK == result) && (ClientStartCount))
+    {
+        ClientStartCount--;
+    }
+
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start Scanning for WiFi Access points
+ * Will result in event LE_WIFICLIENT_EVENT_SCAN_DONE when the scan results are available.
+ *
+ * @return
+ *      - LE_OK     Function succeeded.
+ *      - LE_FAULT  Function failed.
+ *      - LE_BUSY   Scan already running.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_wifiClient_Scan
+(
+    void
+)
+{
+    return StartScan(NULL, 0);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the first WiFi Access Point found.
+ *
+ * @return
+ *      - WiFi  Access Point reference if ok.
+ *      - NULL  If no Access Point reference available.
+ */
+//--------------------------------------------------------------------------------------------------
+le_wifiClient_AccessPointRef_t le_wifiClient_GetFirstAccessPoint
+(
+    void
+)
+{
+    le_wifiClient_AccessPointRef_t apRef = NULL;
+    bool                           found = false;
+
+    if (IsScanRunning())
+    {
+        LE_ERROR("ERROR: Scan is running.");
+        return NULL;
+    }
+    IterRef = le_ref_GetIterator(ScanApRefMap);
+    GetFirstSessionRef = le_wifiClient_GetClientSessionRef();
+
+    LE_DEBUG("Get first AP");
+
+    while (le_ref_NextNode(IterRef) == LE_OK)
+    {
+        apRef = (le_wifiClient_AccessPointRef_t)le_ref_GetSafeRef(IterRef);
+        if (WasApFoundInLastScan(apRef))
+        {
+            found = true;
+            break;
+        }
+    }
+
+    if (found)
+    {
+        LE_DEBUG("AP ref = %p", apRef);
+        return apRef;
+    }
+    else
+    {
+        LE_DEBUG("AP not found");
+        return NULL;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the next WiFi Access Point.
+ * Will return the Access Points in the order of found.
+ * This function must be called in the same context as the GetFirstAccessPoint
+ *
+ * @return
+ *      - WiFi  Access Point reference if ok.
+ *      - NULL  If no Access Point reference available.
+*/
+//--------------------------------------------------------------------------------------------------
+le_wifiClient_AccessPointRef_t le_wifiClient_GetNextAccessPoint
+(
+    void
+)
+{
+    le_wifiClient_AccessPointRef_t apRef = NULL;
+    bool                           found = false;
+
+    LE_DEBUG("Get next AP");
+    if (IsScanRunning())
+    {
+        LE_ERROR("ERROR: Scan is running.");
+        return NULL;
+    }
+
+    /* This check to protect the variable IterRef that shouldn't be called from different contexts*/
+    if (le_wifiClient_GetClientSessionRef() != GetFirstSessionRef)
+    {
+        LE_ERROR("ERROR: Called from different context than GetFirstAccessPoint");
+        return NULL;
+    }
+
+    while (le_ref_NextNode(IterRef) == LE_OK)
+    {
+        apRef = (le_wifiClient_AccessPointRef_t)le_ref_GetSafeRef(IterRef);
+        LE_DEBUG("AP ref = %p", apRef);
+        if (WasApFoundInLastScan(apRef))
+        {
+            found = true;
+            break;
+        }
+    }
+
+    if (found)
+    {
+        LE_DEBUG("AP ref = %p", apRef);
+        return apRef;
+    }
+    else
+    {
+        LE_DEBUG("AP not found");
+        GetFirstSessionRef = NULL;
+        return NULL;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the signal strength of the AccessPoint
+ *
+ * @return
+ *      - Signal strength in dBm. Example -30 = -30dBm
+ *      - If no signal available it will return LE_WIFICLIENT_NO_SIGNAL_STRENGTH
+ *
+ * @note The function returns the signal strength as reported at the time of the scan.
+ */
+//--------------------------------------------------------------------------------------------------
+int16_t le_wifiClient_GetSignalStrength
+(
+    le_wifiClient_AccessPointRef_t apRef
+        ///< [IN]
+        ///< WiFi Access Point reference.
+)
+{
+    FoundAccessPoint_t *apPtr = le_ref_Lookup(ScanApRefMap, apRef);
+
+    LE_DEBUG("Get signal strength");
+    if (NULL == apPtr)
+    {
+        LE_ERROR("Invalid access point reference.");
+        return LE_WIFICLIENT_NO_SIGNAL_STRENGTH;
+    }
+
+    return apPtr->accessPoint.signalStrength;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the Basic Service set identifier (BSSID) of the AccessPoint
+ *
+ * @return
+ *         LE_OK            Function succeeded.
+ *         LE_FAULT         Function failed.
+ *         LE_BAD_PARAMETER Invalid parameter.
+ *         LE_OVERFLOW      bssid buffer is too small to contain the BSSID.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_wifiClient_GetBssid
+(
+    le_wifiClient_AccessPointRef_t apRef,
+        ///< [IN]
+        ///< WiFi Access Point reference.
+
+    char *bssidPtr,
+        ///< [OUT]
+        ///< The BSSID
+
+    size_t bssidSize
+        ///< [IN]
+)
+{
+    FoundAccessPoint_t *apPtr = le_ref_Lookup(ScanApRefMap, apRef);
+
+    LE_DEBUG("AP ref %p", apRef);
+    if (NULL == apPtr)
+    {
+        LE_ERROR("Invalid access point reference.");
+        return LE_BAD_PARAMETER;
+    }
+
+    if (NULL == bssidPtr)
+    {
+        LE_ERROR("Invalid parameter BSSID = %p", bssidPtr);
+        return LE_BAD_PARAMETER;
+    }
+
+    if (strnlen(apPtr->accessPoint.bssid, LE_WIFIDEFS_MAX_BSSID_BYTES) > bssidSize)
+    {
+        return LE_OVERFLOW;
+    }
+    strncpy(bssidPtr, apPtr->accessPoint.bssid, LE_WIFIDEFS_MAX_BSSID_BYTES);
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the Service set identification (SSID) of the AccessPoint
+ *
+ * @return
+ *        LE_OK            Function succeeded.
+ *        LE_FAULT         Function failed.
+ *        LE_BAD_PARAMETER Invalid parameter.
+ *        LE_OVERFLOW      ssid buffer is too small to contain the SSID.
+ *
+ * @note The SSID does not have to be human readable ASCII values, but often is.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_wifiClient_GetSsid
+(
+    le_wifiClient_AccessPointRef_t apRef,
+        ///< [IN]
+        ///< WiFi Access Point reference.
+
+    uint8_t *ssidPtr,
+        ///< [OUT]
+        ///< The SSID returned as a octet array.
+
+    size_t *ssidNumElementsPtr
+        ///< [INOUT]
+        ///< SSID length in octets.
+)
+{
+    FoundAccessPoint_t *apPtr = le_ref_Lookup(ScanApRefMap, apRef);
+
+    LE_DEBUG("AP ref %p", apRef);
+    if (NULL == apPtr)
+    {
+        LE_ERROR("Invalid access point reference.");
+        return LE_BAD_PARAMETER;
+    }
+
+    if ((NULL == ssidPtr) || (NULL == ssidNumElementsPtr))
+    {
+        LE_ERROR("Invalid parameter SSID = %p, SSID length = %p", ssidPtr, ssidNumElementsPtr);
+        return LE_BAD_PARAMETER;
+    }
+
+    if (*ssidNumElementsPtr < apPtr->accessPoint.ssidLength) {
+        LE_ERROR("SSID buffer length (%zu) is too small to contain SSID of length (%d)",
+                 *ssidNumElementsPtr, apPtr->accessPoint.ssidLength);
+        return LE_OVERFLOW;
+    }
+
+    *ssidNumElementsPtr = apPtr->accessPoint.ssidLength;
+    LE_DEBUG("apPtr->AccessPoint.ssidLength %d", apPtr->accessPoint.ssidLength);
+
+    memcpy(&ssidPtr[0], &apPtr->accessPoint.ssidBytes[0], apPtr->accessPoint.ssidLength);
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the currently selected connection to be established. The output will be Null if none is
+ * selected
+ *
+ * @return
+ *      - LE_OK            Function succeeded.
+ *      - LE_FAULT         Function failed.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_wifiClient_GetCurrentConnection
+(
+    le_wifiClient_AccessPointRef_t *apRef  ///< [OUT] currently selected connection's AP reference
+)
+{
+    LE_DEBUG("AP reference of currently selected connection: %p", CurrentConnection);
+    if (!apRef)
+    {
+        return;
+    }
+    *apRef = CurrentConnection;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the passphrase used to generate the PSK.
+ *
+ * @return
+ *      - LE_OK            Function succeeded.
+ *      - LE_FAULT         Function failed.
+ *      - LE_BAD_PARAMETER Invalid parameter.
+ *
+ * @note The difference between le_wifiClient_SetPreSharedKey() and this function
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_wifiClient_SetPassphrase
+(
+    le_wifiClient_AccessPointRef_t apRef,
+        ///< [IN]
+        ///< WiFi Access Point reference.
+
+    const char *passPhrasePtr
+        ///< [IN]
+        ///< pass-phrase for PSK
+)
+{
+    le_result_t result = LE_BAD_PARAMETER;
+
+    LE_DEBUG("Set passphrase");
+
+    if (NULL == le_ref_Lookup(ScanApRefMap, apRef))
+    {
+        LE_ERROR("Invalid access point reference.");
+        return LE_BAD_PARAMETER;
+    }
+
+    if (NULL != passPhrasePtr)
+    {
+        result = pa_wifiClient_SetPassphrase(passPhrasePtr);
+    }
+
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the Pre Shared Key, PSK.
+ *
+ * @return
+ *      - LE_OK             Function succeeded.
+ *      - LE_FAULT          Function failed.
+ *      - LE_BAD_PARAMETER  Invalid parameter.
+ *
+ * @note This is one way to authenticate against the access point. The other one is provided by the
+ * le_wifiClient_SetPassPhrase() function. Both ways are exclusive and are effective only when used
+ * with WPA-personal authentication.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_wifiClient_SetPreSharedKey
+(
+    le_wifiClient_AccessPointRef_t apRef,
+        ///< [IN]
+        ///< WiFi Access Point reference.
+
+    const char *preSharedKeyPtr
+        ///< [IN]
+        ///< Pre-shared key used to authenticate against the access point.
+)
+{
+    le_result_t result = LE_BAD_PARAMETER;
+
+    LE_DEBUG("Set PSK");
+    if (NULL == le_ref_Lookup(ScanApRefMap, apRef))
+    {
+        LE_ERROR("Invalid access point reference.");
+        return LE_BAD_PARAMETER;
+    }
+
+    if (NULL != preSharedKeyPtr)
+    {
+        result = pa_wifiClient_SetPreSharedKey(preSharedKeyPtr);
+    }
+
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function specifies whether the target Access Point is hiding its presence from clients or
+ * not. When an Access Point is hidden, it cannot be discovered by a scan process.
+ *
+ * @return
+ *      - LE_OK             Function succeeded.
+ *      - LE_BAD_PARAMETER  Invalid parameter.
+ *
+ * @note By default, this attribute is not set which means that the client is unable to connect to
+ * a hidden access point. When enabled, the client will be able to connect to the access point
+ * whether it is hidden or not.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_wifiClient_SetHiddenNetworkAttribute
+(
+    le_wifiClient_AccessPointRef_t apRef,
+        ///< [IN]
+        ///< WiFi Access Point reference.
+
+    bool hidden
+        ///< [IN]
+        ///< If TRUE, the WIFI client will be able to connect to a hidden access point.
+)
+{
+    LE_DEBUG("Set whether access point is hidden or not: %d", hidden);
+    if (NULL == le_ref_Lookup(ScanApRefMap, apRef))
+    {
+        LE_ERROR("Invalid access point reference.");
+        return LE_BAD_PARAMETER;
+    }
+
+    pa_wifiClient_SetHiddenNetworkAttribute(hidden);
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function specifies whether IEEE 802.11r fast BSS transition is negotiated with the target
+ * Access Point. It is effective only with WPA2-PSK (FT-PSK) and WPA2-EAP (FT-EAP).
+ *
+ * @return
+ *      - LE_OK             Function succeeded.
+ *      - LE_BAD_PARAMETER  Invalid parameter.
+ *
+ * @note By default, this attribute is not set. When enabled, the client is still able to connect
+ * to access points which do not support fast BSS transition.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_wifiClient_SetFastTransition
+(
+    le_wifiClient_AccessPointRef_t apRef,
+        ///< [IN]
+        ///< WiFi Access Point reference.
+
+    bool enable
+        ///< [IN]
+        ///< If TRUE, fast BSS transition is negotiated with the access point.
+)
+{
+    LE_DEBUG("Set whether fast BSS transition is used or not: %d", enable);
+    if (NULL == le_ref_Lookup(ScanApRefMap, apRef))
+    {
+        LE_ERROR("Invalid access point reference.");
+        return LE_BAD_PARAMETER;
+    }
+
+    pa_wifiClient_SetFastTransition(enable);
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * WPA-Enterprise requires a username and password to authenticate.
+ * This function sets these parameters.
+ *
+ * @return
+ *      - LE_OK             Function succeeded.
+ *      - LE_FAULT          Function failed.
+ *      - LE_BAD_PARAMETER  Invalid parameter.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_wifiClient_SetUserCredentials
+(
+    le_wifiClient_AccessPointRef_t apRef,
+        ///< [IN]
+        ///< WiFi Access Point reference.
+
+    const char *userNamePtr,
+        ///< [IN]
+        ///< UserName used for WPA-Enterprise authentication protocol.
+
+    const char *passwordPtr
+        ///< [IN]
+        ///< Password used for WPA-Enterprise authentication protocol.
+)
+{
+    le_result_t result = LE_BAD_PARAMETER;
+
+    LE_DEBUG("Set user credentials");
+    if (NULL == le_ref_Lookup(ScanApRefMap, apRef))
+    {
+        LE_ERROR("Invalid access point reference.");
+        return LE_BAD_PARAMETER;
+    }
+
+    if ((NULL != userNamePtr) && (NULL != passwordPtr))
+    {
+        result = pa_wifiClient_SetUserCredentials(userNamePtr, passwordPtr);
+    }
+
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the WEP key (WEP)
+ *
+ * @return
+ *      - LE_OK     Function succeeded.
+ *      - LE_FAULT  Function failed.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_wifiClient_SetWepKey
+(
+    le_wifiClient_AccessPointRef_t apRef,
+        ///< [IN]
+        ///< WiFi Access Point reference.
+
+    const char *wepKeyPtr
+        ///< [IN]
+        ///< Wired Equivalent Privacy (WEP) key used for authentication
+)
+{
+    le_result_t result = LE_BAD_PARAMETER;
+
+    LE_DEBUG("Set WEP key");
+    if (NULL == le_ref_Lookup(ScanApRefMap, apRef))
+    {
+        LE_ERROR("Invalid access point reference.");
+        return LE_BAD_PARAMETER;
+    }
+
+    if (NULL != wepKeyPtr)
+    {
+        result = pa_wifiClient_SetWepKey(wepKeyPtr);
+    }
+
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the security protocol for connection
+ *
+ * @return
+ *      - LE_OK             Function succeeded.
+ *      - LE_FAULT          Function failed.
+ *      - LE_BAD_PARAMETER  Invalid parameter.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_wifiClient_SetSecurityProtocol
+(
+    le_wifiClient_AccessPointRef_t apRef,
+        ///< [IN]
+        ///< WiFi Access Point reference.
+
+    le_wifiClient_SecurityProtocol_t securityProtocol
+        ///< [IN]
+        ///< Security Mode
+)
+{
+    LE_DEBUG("Set security protocol");
+    if (NULL == le_ref_Lookup(ScanApRefMap, apRef))
+    {
+        LE_ERROR("Invalid access point reference.");
+        return LE_BAD_PARAMETER;
+    }
+
+    return pa_wifiClient_SetSecurityProtocol(securityProtocol);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function creates a reference to an Access Point given its SSID.
+ * If an Access Point is hidden, it will not show up in the scan. So, its SSID must be known
+ * in advance in order to create a reference.
+ *
+ * @return
+ *      - AccessPoint reference to the current Access Point.
+ *
+ * @note This function fails if called while scan is running.
+ */
+//--------------------------------------------------------------------------------------------------
+le_wifiClient_AccessPointRef_t le_wifiClient_Create
+(
+    const uint8_t *ssidPtr,
+        ///< [IN]
+        ///< The SSID as a octet array.
+
+    size_t ssidNumElements
+        ///< [IN]
+        ///< Length of the SSID in octets.
+)
+{
+    le_wifiClient_AccessPointRef_t returnedRef = NULL;
+
+    if (IsScanRunning())
+    {
+        LE_ERROR("ERROR: Scan is running");
+        return NULL;
+    }
+
+    if (NULL == ssidPtr)
+    {
+        LE_ERROR("ERROR: ssidPtr is NULL");
+        return NULL;
+    }
+
+    returnedRef = FindAccessPointRefFromSsid(ssidPtr, ssidNumElements);
+
+    // if the access point does not already exist, then create it.
+    if (returnedRef == NULL)
+    {
+        FoundAccessPoint_t* createdAccessPointPtr = le_mem_ForceAlloc(AccessPointPool);
+
+        if (createdAccessPointPtr)
+        {
+            createdAccessPointPtr->foundInLatestScan = false;
+            createdAccessPointPtr->autoReconnect = false;
+
+            createdAccessPointPtr->accessPoint.signalStrength = LE_WIFICLIENT_NO_SIGNAL_STRENGTH;
+            createdAccessPointPtr->accessPoint.frequency = 0;
+            createdAccessPointPtr->accessPoint.bssid[0] = '\0';
+            createdAccessPointPtr->accessPoint.ssidLength = ssidNumElements;
+            memcpy(&createdAccessPointPtr->accessPoint.ssidBytes[0],
+                ssidPtr,
+                ssidNumElements);
+
+            // Create a Safe Reference for this object.
+            returnedRef = le_ref_CreateRef(ScanApRefMap, createdAccessPointPtr);
+
+            LE_DEBUG("AP[%p %p] signal strength %d | SSID length %d | SSID: \"%.*s\"",
+                createdAccessPointPtr,
+                returnedRef,
+                createdAccessPointPtr->accessPoint.signalStrength,
+                createdAccessPointPtr->accessPoint.ssidLength,
+                createdAccessPointPtr->accessPoint.ssidLength,
+                (char *)createdAccessPointPtr->accessPoint.ssidBytes);
+        }
+        else
+        {
+            LE_ERROR("le_wifiClient_Create le_mem_ForceAlloc failed.");
+        }
     }
+
+    return returnedRef;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Get the first WiFi Access Point found.
+ * Get the best access point of an SSID found in the latest scan. All the access points of the SSID
+ * are ranked by signal strength, with a preference for the 5 GHz band when its signal is good
+ * enough, and a penalty for those which failed or were slow to connect in the past. The same
+ * access point is preferred on connection to this SSID.
  *
  * @return
- *      - WiFi  Access Point reference if ok.
- *      - NULL  If no Access Point reference available.
+ *      - LE_OK             Function succeeded.
+ *      - LE_BAD_PARAMETER  Invalid parameter.
+ *      - LE_NOT_FOUND      No access point of this SSID found in the latest scan.
+ *      - LE_BUSY           Function called during scan.
  */
 //--------------------------------------------------------------------------------------------------
-le_wifiClient_AccessPointRef_t le_wifiClient_GetFirstAccessPoint
+le_result_t le_wifiClient_GetBestAccessPoint
 (
-    void
+    const uint8_t *ssidPtr,
+        ///< [IN]
+        ///< The SSID as a octet array.
+
+    size_t ssidNumElements,
+        ///< [IN]
+        ///< Length of the SSID in octets.
+
+    le_wifiClient_AccessPointRef_t *apRefPtr
+        ///< [OUT]
+        ///< Best access point reference.
 )
 {
-    le_wifiClient_AccessPointRef_t apRef = NULL;
-    bool                           found = false;
+    le_wifiClient_AccessPointRef_t apRef;
 
-    if (IsScanRunning())
+    if ((NULL == ssidPtr) || (NULL == apRefPtr) || (0 == ssidNumElements) ||
+        (ssidNumElements > LE_WIFIDEFS_MAX_SSID_LENGTH))
     {
-        LE_ERROR("ERROR: Scan is running.");
-        return NULL;
+        LE_ERROR("Invalid parameter");
+        return LE_BAD_PARAMETER;
     }
-    IterRef = le_ref_GetIterator(ScanApRefMap);
-    GetFirstSessionRef = le_wifiClient_GetClientSessionRef();
-
-    LE_DEBUG("Get first AP");
 
-    while (le_ref_NextNode(IterRef) == LE_OK)
+    if (IsScanRunning())
     {
-        apRef = (le_wifiClient_AccessPointRef_t)le_ref_GetSafeRef(IterRef);
-        if (WasApFoundInLastScan(apRef))
-        {
-            found = true;
-            break;
-        }
+        LE_ERROR("Scan is running");
+        return LE_BUSY;
     }
 
-    if (found)
-    {
-        LE_DEBUG("AP ref = %p", apRef);
-        return apRef;
-    }
-    else
+    apRef = SelectBestAccessPoint(ssidPtr, ssidNumElements);
+    if ((NULL == apRef) ||
+        (BSS_SCORE_UNKNOWN == ScoreAccessPoint(le_ref_Lookup(ScanApRefMap, apRef))))
     {
-        LE_DEBUG("AP not found");
-        return NULL;
+        LE_DEBUG("No access point found for SSID \"%.*s\"", (int)ssidNumElements,
+                 (const char *)ssidPtr);
+        return LE_NOT_FOUND;
     }
+
+    *apRefPtr = apRef;
+    return LE_OK;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Get the next WiFi Access Point.
- * Will return the Access Points in the order of found.
- * This function must be called in the same context as the GetFirstAccessPoint
+ * Deletes an accessPointRef.
  *
  * @return
- *      - WiFi  Access Point reference if ok.
- *      - NULL  If no Access Point reference available.
-*/
+ *      - LE_OK             Function succeeded.
+ *      - LE_BAD_PARAMETER  Invalid parameter.
+ *      - LE_BUSY           Function called during scan.
+ *
+ * @note The handle becomes invalid after it has been deleted.
+ */
 //--------------------------------------------------------------------------------------------------
-le_wifiClient_AccessPointRef_t le_wifiClient_GetNextAccessPoint
+le_result_t le_wifiClient_Delete
 (
-    void
+    le_wifiClient_AccessPointRef_t apRef
+        ///< [IN]
+        ///< WiFi Access Point reference.
 )
 {
-    le_wifiClient_AccessPointRef_t apRef = NULL;
-    bool                           found = false;
+    le_result_t         result = LE_BAD_PARAMETER;
+    FoundAccessPoint_t *apPtr  = le_ref_Lookup(ScanApRefMap, apRef);
+
+    LE_DEBUG("Delete client called");
 
-    LE_DEBUG("Get next AP");
     if (IsScanRunning())
     {
-        LE_ERROR("ERROR: Scan is running.");
-        return NULL;
+        LE_ERROR("ERROR: Scan is running");
+        return LE_BUSY;
     }
 
-    /* This check to protect the variable IterRef that shouldn't be called from different contexts*/
-    if (le_wifiClient_GetClientSessionRef() != GetFirstSessionRef)
+    // verify le_ref_Lookup
+    if (NULL != apPtr)
     {
-        LE_ERROR("ERROR: Called from different context than GetFirstAccessPoint");
-        return NULL;
+        RemoveAccessPoint(apRef);
+        result = LE_OK;
     }
+    return result;
+}
 
-    while (le_ref_NextNode(IterRef) == LE_OK)
-    {
-        apRef = (le_wifiClient_AccessPointRef_t)le_ref_GetSafeRef(IterRef);
-        LE_DEBUG("AP ref = %p", apRef);
-        if (WasApFoundInLastScan(apRef))
-        {
-            found = true;
-            break;
-        }
-    }
 
-    if (found)
-    {
-        LE_DEBUG("AP ref = %p", apRef);
-        return apRef;
-    }
-    else
+//--------------------------------------------------------------------------------------------------
+/**
+ * Connect to the WiFi Access Point.
+ * All authentication must be set prior to calling this function.
+ *
+ * @return
+ *      - LE_OK             Function succeeded.
+ *      - LE_BAD_PARAMETER  Invalid parameter.
+ *      - LE_DUPLICATE      Duplicated request.
+ *      - LE_TIMEOUT        Connection request time out.
+ *      - LE_FAULT          The function failed.
+ *
+ * @note For PSK credentials see le_wifiClient_SetPassphrase() or le_wifiClient_SetPreSharedKey() .
+ * @note For WPA-Enterprise credentials see le_wifiClient_SetUserCredentials()
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_wifiClient_Connect
+(
+    le_wifiClient_AccessPointRef_t apRef
+        ///< [IN]
+        ///< WiFi access point reference.
+)
+{
+    // The application takes over any ongoing auto-reconnect
+    if (NULL != le_ref_Lookup(ScanApRefMap, apRef))
     {
-        LE_DEBUG("AP not found");
-        GetFirstSessionRef = NULL;
-        return NULL;
+        StopReconnect();
     }
+    return ConnectAccessPoint(apRef);
 }
 
+
 //--------------------------------------------------------------------------------------------------
 /**
- * Get the signal strength of the AccessPoint
+ * Enable or disable the automatic reconnection to the given access point.
+ * When enabled and the connection to this access point is lost, the WiFi client service retries
+ * to connect with a jittered exponential backoff, then falls back to the other SSIDs saved in the
+ * config tree, by decreasing priority. No reconnection is attempted when the disconnection has
+ * been requested by the client or the WiFi hardware has been stopped.
  *
  * @return
- *      - Signal strength in dBm. Example -30 = -30dBm
- *      - If no signal available it will return LE_WIFICLIENT_NO_SIGNAL_STRENGTH
+ *      - LE_OK             Function succeeded.
+ *      - LE_BAD_PARAMETER  Invalid parameter.
  *
- * @note The function returns the signal strength as reported at the time of the scan.
+ * @note See le_wifiClient_SetSsidPriority() to set the priority of a saved SSID.
  */
 //--------------------------------------------------------------------------------------------------
-int16_t le_wifiClient_GetSignalStrength
+le_result_t le_wifiClient_SetAutoReconnect
 (
-    le_wifiClient_AccessPointRef_t apRef
+    le_wifiClient_AccessPointRef_t apRef,
         ///< [IN]
         ///< WiFi Access Point reference.
+
+    bool enable
+        ///< [IN]
+        ///< true to reconnect automatically on connection loss.
 )
 {
     FoundAccessPoint_t *apPtr = le_ref_Lookup(ScanApRefMap, apRef);
 
-    LE_DEBUG("Get signal strength");
+    LE_DEBUG("Set auto-reconnect %d", enable);
     if (NULL == apPtr)
     {
         LE_ERROR("Invalid access point reference.");
-        return LE_WIFICLIENT_NO_SIGNAL_STRENGTH;
+        return LE_BAD_PARAMETER;
     }
 
-    return apPtr->accessPoint.signalStrength;
+    apPtr->autoReconnect = enable;
+    if (!enable && (apRef == Reconnect.apRef))
+    {
+        StopReconnect();
+    }
+    return LE_OK;
 }
 
+
 //--------------------------------------------------------------------------------------------------
 /**
- * Get the Basic Service set identifier (BSSID) of the AccessPoint
+ * Get the auto-reconnect statistics.
  *
  * @return
- *         LE_OK            Function succeeded.
- *         LE_FAULT         Function failed.
- *         LE_BAD_PARAMETER Invalid parameter.
- *         LE_OVERFLOW      bssid buffer is too small to contain the BSSID.
+ *      - LE_OK             Function succeeded.
+ *      - LE_BAD_PARAMETER  Invalid parameter.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t le_wifiClient_GetBssid
+le_result_t le_wifiClient_GetReconnectStats
 (
-    le_wifiClient_AccessPointRef_t apRef,
-        ///< [IN]
-        ///< WiFi Access Point reference.
+    uint32_t *attemptCountPtr,
+        ///< [OUT]
+        ///< Total number of reconnection attempts.
 
-    char *bssidPtr,
+    uint32_t *recoveryCountPtr,
         ///< [OUT]
-        ///< The BSSID
+        ///< Number of connections recovered.
 
-    size_t bssidSize
-        ///< [IN]
+    uint32_t *lastRecoveryMsPtr,
+        ///< [OUT]
+        ///< Time in ms between the last connection loss and its recovery.
+
+    uint32_t *maxRecoveryMsPtr
+        ///< [OUT]
+        ///< Highest time in ms to recover a connection.
 )
 {
-    FoundAccessPoint_t *apPtr = le_ref_Lookup(ScanApRefMap, apRef);
-
-    LE_DEBUG("AP ref %p", apRef);
-    if (NULL == apPtr)
+    if ((NULL == attemptCountPtr) || (NULL == recoveryCountPtr) || (NULL == lastRecoveryMsPtr) ||
+        (NULL == maxRecoveryMsPtr))
     {
-        LE_ERROR("Invalid access point reference.");
+        LE_ERROR("Invalid parameter");
         return LE_BAD_PARAMETER;
     }
 
-    if (NULL == bssidPtr)
+    *attemptCountPtr = Reconnect.attemptCount;
+    *recoveryCountPtr = Reconnect.recoveryCount;
+    *lastRecoveryMsPtr = Reconnect.lastRecoveryMs;
+    *maxRecoveryMsPtr = Reconnect.maxRecoveryMs;
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the duration of the phases of one of the last connection attempts. A phase not reached
+ * lasts 0 ms.
+ *
+ * @return
+ *      - LE_OK             Function succeeded.
+ *      - LE_BAD_PARAMETER  Invalid parameter.
+ *      - LE_NOT_FOUND      No connection attempt at this index.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_wifiClient_GetConnectTiming
+(
+    uint32_t index,
+        ///< [IN]
+        ///< Index of the connection attempt, 0 being the last one.
+
+    le_result_t *resultPtr,
+        ///< [OUT]
+        ///< Result of the connection attempt.
+
+    uint32_t *configMsPtr,
+        ///< [OUT]
+        ///< Time in ms to generate the wpa_supplicant configuration.
+
+    uint32_t *supplicantMsPtr,
+        ///< [OUT]
+        ///< Time in ms to start wpa_supplicant.
+
+    uint32_t *authMsPtr,
+        ///< [OUT]
+        ///< Time in ms to scan and authenticate.
+
+    uint32_t *assocMsPtr,
+        ///< [OUT]
+        ///< Time in ms to associate.
+
+    uint32_t *handshakeMsPtr,
+        ///< [OUT]
+        ///< Time in ms to complete the 4-way handshake or EAP.
+
+    uint32_t *dhcpMsPtr,
+        ///< [OUT]
+        ///< Time in ms to get an IP address.
+
+    uint32_t *totalMsPtr
+        ///< [OUT]
+        ///< Time in ms of the whole connection attempt.
+)
+{
+    uint32_t slot;
+
+    if ((NULL == resultPtr) || (NULL == configMsPtr) || (NULL == supplicantMsPtr) ||
+        (NULL == authMsPtr) || (NULL == assocMsPtr) || (NULL == handshakeMsPtr) ||
+        (NULL == dhcpMsPtr) || (NULL == totalMsPtr))
     {
-        LE_ERROR("Invalid parameter BSSID = %p", bssidPtr);
+        LE_ERROR("Invalid parameter");
         return LE_BAD_PARAMETER;
     }
 
-    if (strnlen(apPtr->accessPoint.bssid, LE_WIFIDEFS_MAX_BSSID_BYTES) > bssidSize)
+    if ((index >= CONNECT_TIMING_HISTORY) || (index >= ConnectTimingCount))
     {
-        return LE_OVERFLOW;
+        return LE_NOT_FOUND;
     }
-    strncpy(bssidPtr, apPtr->accessPoint.bssid, LE_WIFIDEFS_MAX_BSSID_BYTES);
 
+    slot = (ConnectTimingCount - 1 - index) % CONNECT_TIMING_HISTORY;
+    *resultPtr = ConnectTimings[slot].result;
+    *configMsPtr = ConnectTimings[slot].configMs;
+    *supplicantMsPtr = ConnectTimings[slot].supplicantMs;
+    *authMsPtr = ConnectTimings[slot].authMs;
+    *assocMsPtr = ConnectTimings[slot].assocMs;
+    *handshakeMsPtr = ConnectTimings[slot].handshakeMs;
+    *dhcpMsPtr = ConnectTimingsDhcpMs[slot];
+    *totalMsPtr = ConnectTimings[slot].totalMs + ConnectTimingsDhcpMs[slot];
     return LE_OK;
 }
 
+
 //--------------------------------------------------------------------------------------------------
 /**
- * Get the Service set identification (SSID) of the AccessPoint
+ * Roam to another WiFi Access Point of the currently connected network.
+ * The given reference must have been found by a scan, so that its BSSID is known, and share the
+ * SSID of the current connection. When fast BSS transition is enabled, the reassociation reuses
+ * the current security association instead of doing a full connection.
  *
  * @return
- *        LE_OK            Function succeeded.
- *        LE_FAULT         Function failed.
- *        LE_BAD_PARAMETER Invalid parameter.
- *        LE_OVERFLOW      ssid buffer is too small to contain the SSID.
+ *      - LE_OK             Function succeeded.
+ *      - LE_BAD_PARAMETER  Invalid parameter.
+ *      - LE_NOT_POSSIBLE   No connection established or access point of another network.
+ *      - LE_TIMEOUT        Reassociation request time out.
+ *      - LE_FAULT          The function failed.
  *
- * @note The SSID does not have to be human readable ASCII values, but often is.
+ * @note See le_wifiClient_SetFastTransition() to enable IEEE 802.11r fast BSS transition.
+ * @note Each reassociation attempt is reported by a roam event and accounted in the roam
+ *       statistics.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t le_wifiClient_GetSsid
+le_result_t le_wifiClient_Roam
 (
-    le_wifiClient_AccessPointRef_t apRef,
+    le_wifiClient_AccessPointRef_t apRef
         ///< [IN]
-        ///< WiFi Access Point reference.
-
-    uint8_t *ssidPtr,
-        ///< [OUT]
-        ///< The SSID returned as a octet array.
-
-    size_t *ssidNumElementsPtr
-        ///< [INOUT]
-        ///< SSID length in octets.
+        ///< WiFi access point reference of the target BSS.
 )
 {
-    FoundAccessPoint_t *apPtr = le_ref_Lookup(ScanApRefMap, apRef);
+    le_result_t         result;
+    FoundAccessPoint_t *apPtr  = le_ref_Lookup(ScanApRefMap, apRef);
+    FoundAccessPoint_t *curPtr = le_ref_Lookup(ScanApRefMap, CurrentConnection);
+    RoamEvent_t         roamEvent;
+    le_clk_Time_t       startTime;
+    le_clk_Time_t       roamTime;
 
-    LE_DEBUG("AP ref %p", apRef);
-    if (NULL == apPtr)
+    if ((NULL == apPtr) || ('\0' == apPtr->accessPoint.bssid[0]))
     {
         LE_ERROR("Invalid access point reference.");
         return LE_BAD_PARAMETER;
     }
 
-    if ((NULL == ssidPtr) || (NULL == ssidNumElementsPtr))
+    if (NULL == curPtr)
     {
-        LE_ERROR("Invalid parameter SSID = %p, SSID length = %p", ssidPtr, ssidNumElementsPtr);
-        return LE_BAD_PARAMETER;
+        LE_ERROR("No current connection to roam from.");
+        return LE_NOT_POSSIBLE;
     }
 
-    if (*ssidNumElementsPtr < apPtr->accessPoint.ssidLength) {
-        LE_ERROR("SSID buffer length (%zu) is too small to contain SSID of length (%d)",
-                 *ssidNumElementsPtr, apPtr->accessPoint.ssidLength);
-        return LE_OVERFLOW;
+    if ((apPtr->accessPoint.ssidLength != curPtr->accessPoint.ssidLength) ||
+        (0 != memcmp(apPtr->accessPoint.ssidBytes, curPtr->accessPoint.ssidBytes,
+                     apPtr->accessPoint.ssidLength)))
+    {
+        LE_ERROR("Access point %p does not belong to the current network.", apRef);
+        return LE_NOT_POSSIBLE;
+    }
+
+    memset(&roamEvent, 0, sizeof(roamEvent));
+    le_utf8_Copy(roamEvent.fromBssid, CurrentBssid, sizeof(roamEvent.fromBssid), NULL);
+    le_utf8_Copy(roamEvent.toBssid, apPtr->accessPoint.bssid, sizeof(roamEvent.toBssid), NULL);
+
+    startTime = le_clk_GetRelativeTime();
+    result = pa_wifiClient_Roam(apPtr->accessPoint.bssid);
+    roamTime = le_clk_Sub(le_clk_GetRelativeTime(), startTime);
+
+    roamEvent.result = result;
+    roamEvent.latencyMs = (uint32_t)((roamTime.sec * 1000) + (roamTime.usec / 1000));
+
+    Roaming.attemptCount++;
+    if (LE_OK == result)
+    {
+        CurrentConnection = apRef;
+        le_utf8_Copy(CurrentBssid, apPtr->accessPoint.bssid, sizeof(CurrentBssid), NULL);
+
+        Roaming.lastLatencyMs = roamEvent.latencyMs;
+        Roaming.totalLatencyMs += roamEvent.latencyMs;
+        if (roamEvent.latencyMs > Roaming.maxLatencyMs)
+        {
+            Roaming.maxLatencyMs = roamEvent.latencyMs;
+        }
+    }
+    else
+    {
+        Roaming.failureCount++;
     }
 
-    *ssidNumElementsPtr = apPtr->accessPoint.ssidLength;
-    LE_DEBUG("apPtr->AccessPoint.ssidLength %d", apPtr->accessPoint.ssidLength);
-
-    memcpy(&ssidPtr[0], &apPtr->accessPoint.ssidBytes[0], apPtr->accessPoint.ssidLength);
+    LE_INFO("Roam from '%s' to '%s': result %d in %u ms", roamEvent.fromBssid, roamEvent.toBssid,
+            result, roamEvent.latencyMs);
+    le_event_Report(RoamEventId, &roamEvent, sizeof(roamEvent));
 
-    return LE_OK;
+    return result;
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Get the currently selected connection to be established. The output will be Null if none is
- * selected
+ * Enable or disable the roaming engine.
+ * When enabled, the signal of the connected access point is monitored by the driver. When it drops
+ * below the roaming threshold, a scan of the current SSID is done and the client reassociates with
+ * the best access point found, provided that its signal exceeds the current one by the hysteresis.
+ * The driver monitors a single threshold: LE_WIFICLIENT_EVENT_RSSI_LOW and
+ * LE_WIFICLIENT_EVENT_RSSI_HIGH are reported for the roaming threshold while the roaming engine is
+ * enabled, and for the one set by le_wifiClient_SetRssiThreshold() otherwise.
  *
  * @return
- *      - LE_OK            Function succeeded.
- *      - LE_FAULT         Function failed.
+ *      - LE_OK             Function succeeded.
+ *
+ * @note See le_wifiClient_SetRoamingThreshold() for the threshold and hysteresis.
  */
 //--------------------------------------------------------------------------------------------------
-void le_wifiClient_GetCurrentConnection
+le_result_t le_wifiClient_SetRoaming
 (
-    le_wifiClient_AccessPointRef_t *apRef  ///< [OUT] currently selected connection's AP reference
+    bool enable
+        ///< [IN]
+        ///< true to enable the roaming engine, false to disable it.
 )
 {
-    LE_DEBUG("AP reference of currently selected connection: %p", CurrentConnection);
-    if (!apRef)
+    LE_DEBUG("Set roaming %d", enable);
+
+    Roaming.isEnabled = enable;
+    Roaming.isSignalLow = false;
+    le_timer_Stop(Roaming.monitorTimer);
+    if (LE_OK != ApplyRssiThreshold())
     {
-        return;
+        LE_WARN("Failed to set the signal threshold");
     }
-    *apRef = CurrentConnection;
+
+    return LE_OK;
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Set the passphrase used to generate the PSK.
+ * Set the signal strength threshold below which the roaming engine looks for another access point
+ * of the current network, and the minimum signal gain required to roam to it.
+ * Defaults are -75 dBm and 8 dB.
  *
  * @return
- *      - LE_OK            Function succeeded.
- *      - LE_FAULT         Function failed.
- *      - LE_BAD_PARAMETER Invalid parameter.
- *
- * @note The difference between le_wifiClient_SetPreSharedKey() and this function
+ *      - LE_OK             Function succeeded.
+ *      - LE_OUT_OF_RANGE   Threshold not within [-100..-30] dBm or hysteresis above 30 dB.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t le_wifiClient_SetPassphrase
+le_result_t le_wifiClient_SetRoamingThreshold
 (
-    le_wifiClient_AccessPointRef_t apRef,
+    int16_t threshold,
         ///< [IN]
-        ///< WiFi Access Point reference.
+        ///< Signal strength in dBm triggering the search of a roaming candidate.
 
-    const char *passPhrasePtr
+    uint8_t hysteresis
         ///< [IN]
-        ///< pass-phrase for PSK
+        ///< Minimum signal gain in dB of a candidate over the current access point.
 )
 {
-    le_result_t result = LE_BAD_PARAMETER;
-
-    LE_DEBUG("Set passphrase");
-
-    if (NULL == le_ref_Lookup(ScanApRefMap, apRef))
+    if ((threshold < ROAM_MIN_THRESHOLD) || (threshold > ROAM_MAX_THRESHOLD) ||
+        (hysteresis > ROAM_MAX_HYSTERESIS))
     {
-        LE_ERROR("Invalid access point reference.");
-        return LE_BAD_PARAMETER;
+        LE_ERROR("Invalid roaming threshold %d dBm or hysteresis %d dB", threshold, hysteresis);
+        return LE_OUT_OF_RANGE;
     }
 
-    if (NULL != passPhrasePtr)
+    Roaming.threshold = threshold;
+    Roaming.hysteresis = hysteresis;
+    if (Roaming.isEnabled && (LE_OK != ApplyRssiThreshold()))
     {
-        result = pa_wifiClient_SetPassphrase(passPhrasePtr);
+        LE_WARN("Failed to set the signal threshold %d dBm", threshold);
     }
-
-    return result;
+    return LE_OK;
 }
 
+
 //--------------------------------------------------------------------------------------------------
 /**
- * Set the Pre Shared Key, PSK.
+ * Get the roaming statistics, accounting both the reassociations requested by
+ * le_wifiClient_Roam() and the ones done by the roaming engine.
  *
  * @return
  *      - LE_OK             Function succeeded.
- *      - LE_FAULT          Function failed.
  *      - LE_BAD_PARAMETER  Invalid parameter.
  *
- * @note This is one way to authenticate against the access point. The other one is provided by the
- * le_wifiClient_SetPassPhrase() function. Both ways are exclusive and are effective only when used
- * with WPA-personal authentication.
+ * @note Latencies are those of the successful reassociations.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t le_wifiClient_SetPreSharedKey
+le_result_t le_wifiClient_GetRoamStats
 (
-    le_wifiClient_AccessPointRef_t apRef,
-        ///< [IN]
-        ///< WiFi Access Point reference.
+    uint32_t *attemptCountPtr,
+        ///< [OUT]
+        ///< Number of reassociations attempted.
 
-    const char *preSharedKeyPtr
-        ///< [IN]
-        ///< Pre-shared key used to authenticate against the access point.
+    uint32_t *failureCountPtr,
+        ///< [OUT]
+        ///< Number of reassociations failed.
+
+    uint32_t *lastLatencyMsPtr,
+        ///< [OUT]
+        ///< Latency in ms of the last successful reassociation.
+
+    uint32_t *avgLatencyMsPtr,
+        ///< [OUT]
+        ///< Average latency in ms of the successful reassociations.
+
+    uint32_t *maxLatencyMsPtr
+        ///< [OUT]
+        ///< Highest latency in ms of the successful reassociations.
 )
 {
-    le_result_t result = LE_BAD_PARAMETER;
+    uint32_t successCount;
 
-    LE_DEBUG("Set PSK");
-    if (NULL == le_ref_Lookup(ScanApRefMap, apRef))
+    if ((NULL == attemptCountPtr) || (NULL == failureCountPtr) || (NULL == lastLatencyMsPtr) ||
+        (NULL == avgLatencyMsPtr) || (NULL == maxLatencyMsPtr))
     {
-        LE_ERROR("Invalid access point reference.");
+        LE_ERROR("Invalid parameter");
         return LE_BAD_PARAMETER;
     }
 
-    if (NULL != preSharedKeyPtr)
-    {
-        result = pa_wifiClient_SetPreSharedKey(preSharedKeyPtr);
-    }
+    successCount = Roaming.attemptCount - Roaming.failureCount;
 
-    return result;
+    *attemptCountPtr = Roaming.attemptCount;
+    *failureCountPtr = Roaming.failureCount;
+    *lastLatencyMsPtr = Roaming.lastLatencyMs;
+    *avgLatencyMsPtr = successCount ? (uint32_t)(Roaming.totalLatencyMs / successCount) : 0;
+    *maxLatencyMsPtr = Roaming.maxLatencyMs;
+    return LE_OK;
 }
 
+
 //--------------------------------------------------------------------------------------------------
 /**
- * This function specifies whether the target Access Point is hiding its presence from clients or
- * not. When an Access Point is hidden, it cannot be discovered by a scan process.
+ * Get the live statistics of the link with the currently associated access point, unlike
+ * le_wifiClient_GetSignalStrength() which returns the signal strength found by the last scan.
  *
  * @return
  *      - LE_OK             Function succeeded.
  *      - LE_BAD_PARAMETER  Invalid parameter.
- *
- * @note By default, this attribute is not set which means that the client is unable to connect to
- * a hidden access point. When enabled, the client will be able to connect to the access point
- * whether it is hidden or not.
+ *      - LE_NOT_FOUND      Not associated.
+ *      - LE_FAULT          Function failed.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t le_wifiClient_SetHiddenNetworkAttribute
+le_result_t le_wifiClient_GetStationInfo
 (
-    le_wifiClient_AccessPointRef_t apRef,
-        ///< [IN]
-        ///< WiFi Access Point reference.
+    int16_t *rssiPtr,
+        ///< [OUT]
+        ///< Signal strength in dBm.
 
-    bool hidden
-        ///< [IN]
-        ///< If TRUE, the WIFI client will be able to connect to a hidden access point.
+    uint32_t *txBitrateKbpsPtr,
+        ///< [OUT]
+        ///< Bitrate of the last frame sent, in kbit/s.
+
+    uint32_t *rxBitrateKbpsPtr,
+        ///< [OUT]
+        ///< Bitrate of the last frame received, in kbit/s.
+
+    uint32_t *txRetriesPtr,
+        ///< [OUT]
+        ///< Number of retried transmissions.
+
+    uint32_t *txFailedPtr,
+        ///< [OUT]
+        ///< Number of failed transmissions.
+
+    uint32_t *beaconLossPtr
+        ///< [OUT]
+        ///< Number of beacon loss events since the connection.
 )
 {
-    LE_DEBUG("Set whether access point is hidden or not: %d", hidden);
-    if (NULL == le_ref_Lookup(ScanApRefMap, apRef))
+    pa_wifiClient_StationInfo_t info;
+    le_result_t                 result;
+
+    if ((NULL == rssiPtr) || (NULL == txBitrateKbpsPtr) || (NULL == rxBitrateKbpsPtr) ||
+        (NULL == txRetriesPtr) || (NULL == txFailedPtr) || (NULL == beaconLossPtr))
     {
-        LE_ERROR("Invalid access point reference.");
+        LE_ERROR("Invalid parameter");
         return LE_BAD_PARAMETER;
     }
 
-    pa_wifiClient_SetHiddenNetworkAttribute(hidden);
+    result = pa_wifiClient_GetStationInfo(&info);
+    if (LE_OK != result)
+    {
+        return result;
+    }
+
+    *rssiPtr = info.signal;
+    *txBitrateKbpsPtr = info.txBitrate;
+    *rxBitrateKbpsPtr = info.rxBitrate;
+    *txRetriesPtr = info.txRetries;
+    *txFailedPtr = info.txFailed;
+    *beaconLossPtr = info.beaconLoss;
     return LE_OK;
 }
 
+
 //--------------------------------------------------------------------------------------------------
 /**
- * WPA-Enterprise requires a username and password to authenticate.
- * This function sets these parameters.
+ * Set the signal strength threshold monitored by the driver. LE_WIFICLIENT_EVENT_RSSI_LOW and
+ * LE_WIFICLIENT_EVENT_RSSI_HIGH are reported to the connection event handlers when the signal
+ * goes below or above it, by more than the hysteresis. If the station is not connected, the
+ * threshold is set into the driver on the next connection.
+ * While the roaming engine is enabled, the driver monitors the roaming threshold instead, see
+ * le_wifiClient_SetRoaming().
  *
  * @return
  *      - LE_OK             Function succeeded.
+ *      - LE_OUT_OF_RANGE   Threshold not within [-100..-30] dBm or hysteresis above 30 dB.
  *      - LE_FAULT          Function failed.
- *      - LE_BAD_PARAMETER  Invalid parameter.
+ *
+ * @note A threshold of 0 disables the monitoring.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t le_wifiClient_SetUserCredentials
+le_result_t le_wifiClient_SetRssiThreshold
 (
-    le_wifiClient_AccessPointRef_t apRef,
-        ///< [IN]
-        ///< WiFi Access Point reference.
-
-    const char *userNamePtr,
+    int16_t threshold,
         ///< [IN]
-        ///< UserName used for WPA-Enterprise authentication protocol.
+        ///< Signal strength threshold in dBm.
 
-    const char *passwordPtr
+    uint8_t hysteresis
         ///< [IN]
-        ///< Password used for WPA-Enterprise authentication protocol.
+        ///< Hysteresis in dB around the threshold.
 )
 {
-    le_result_t result = LE_BAD_PARAMETER;
-
-    LE_DEBUG("Set user credentials");
-    if (NULL == le_ref_Lookup(ScanApRefMap, apRef))
-    {
-        LE_ERROR("Invalid access point reference.");
-        return LE_BAD_PARAMETER;
-    }
-
-    if ((NULL != userNamePtr) && (NULL != passwordPtr))
+    if ((0 != threshold) &&
+        ((threshold < ROAM_MIN_THRESHOLD) || (threshold > ROAM_MAX_THRESHOLD) ||
+         (hysteresis > ROAM_MAX_HYSTERESIS)))
     {
-        result = pa_wifiClient_SetUserCredentials(userNamePtr, passwordPtr);
+        LE_ERROR("Invalid signal threshold %d dBm or hysteresis %d dB", threshold, hysteresis);
+        return LE_OUT_OF_RANGE;
     }
 
-    return result;
+    RssiThreshold = threshold;
+    RssiHysteresis = hysteresis;
+    return ApplyRssiThreshold();
 }
 
+
 //--------------------------------------------------------------------------------------------------
 /**
- * Set the WEP key (WEP)
+ * Enable or disable the integrated DHCP client. When enabled, an IP address is requested on each
+ * connection, and LE_WIFICLIENT_EVENT_IP_READY is reported to the connection event handlers once
+ * it is set. The lease is cached per SSID and BSSID to be requested again directly on
+ * reconnection. Disabled by default.
  *
  * @return
- *      - LE_OK     Function succeeded.
- *      - LE_FAULT  Function failed.
+ *      - LE_OK             Function succeeded.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t le_wifiClient_SetWepKey
+le_result_t le_wifiClient_SetDhcp
 (
-    le_wifiClient_AccessPointRef_t apRef,
+    bool enable
         ///< [IN]
-        ///< WiFi Access Point reference.
-
-    const char *wepKeyPtr
-        ///< [IN]
-        ///< Wired Equivalent Privacy (WEP) key used for authentication
+        ///< True to get the IP address from the integrated DHCP client.
 )
 {
-    le_result_t result = LE_BAD_PARAMETER;
-
-    LE_DEBUG("Set WEP key");
-    if (NULL == le_ref_Lookup(ScanApRefMap, apRef))
-    {
-        LE_ERROR("Invalid access point reference.");
-        return LE_BAD_PARAMETER;
-    }
-
-    if (NULL != wepKeyPtr)
+    Dhcp.isEnabled = enable;
+    if (!enable)
     {
-        result = pa_wifiClient_SetWepKey(wepKeyPtr);
+        StopDhcp();
     }
-
-    return result;
+    return LE_OK;
 }
 
+
 //--------------------------------------------------------------------------------------------------
 /**
- * Set the security protocol for connection
+ * Get the network interface of the station. It shares the radio with the virtual interface of the
+ * access point in concurrent mode, see le_wifiAp_SetConcurrentMode().
  *
  * @return
  *      - LE_OK             Function succeeded.
- *      - LE_FAULT          Function failed.
  *      - LE_BAD_PARAMETER  Invalid parameter.
+ *      - LE_OVERFLOW       Buffer too small.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t le_wifiClient_SetSecurityProtocol
+le_result_t le_wifiClient_GetInterfaceName
 (
-    le_wifiClient_AccessPointRef_t apRef,
-        ///< [IN]
-        ///< WiFi Access Point reference.
+    char *ifNamePtr,
+        ///< [OUT]
+        ///< Network interface of the station.
 
-    le_wifiClient_SecurityProtocol_t securityProtocol
+    size_t ifNameSize
         ///< [IN]
-        ///< Security Mode
+        ///< Size of the interface name buffer.
 )
 {
-    LE_DEBUG("Set security protocol");
-    if (NULL == le_ref_Lookup(ScanApRefMap, apRef))
+    if (NULL == ifNamePtr)
     {
-        LE_ERROR("Invalid access point reference.");
+        LE_ERROR("Invalid parameter");
         return LE_BAD_PARAMETER;
     }
 
-    return pa_wifiClient_SetSecurityProtocol(securityProtocol);
+    return pa_wifiClient_GetInterface(ifNamePtr, ifNameSize);
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * This function creates a reference to an Access Point given its SSID.
- * If an Access Point is hidden, it will not show up in the scan. So, its SSID must be known
- * in advance in order to create a reference.
+ * Select the network interface of the station, among the ones returned by
+ * le_wifiClient_GetInterfaces(), for a module with several radios. The selection applies to all
+ * the clients of the service, on the next start of the WiFi client.
  *
- * @return
- *      - AccessPoint reference to the current Access Point.
+ * @note The service runs a single station: the interface is not bound to a client session, and
+ * the scans and connections of all the sessions run on the selected interface only. Two radios
+ * cannot be used as stations at the same time; a second radio may run the access point.
  *
- * @note This function fails if called while scan is running.
+ * @return
+ *      - LE_OK             Function succeeded.
+ *      - LE_BAD_PARAMETER  Invalid interface name.
+ *      - LE_BUSY           The WiFi client is started.
  */
 //--------------------------------------------------------------------------------------------------
-le_wifiClient_AccessPointRef_t le_wifiClient_Create
+le_result_t le_wifiClient_SetInterface
 (
-    const uint8_t *ssidPtr,
-        ///< [IN]
-        ///< The SSID as a octet array.
-
-    size_t ssidNumElements
+    const char *ifNamePtr
         ///< [IN]
-        ///< Length of the SSID in octets.
+        ///< Network interface of the station.
 )
 {
-    le_wifiClient_AccessPointRef_t returnedRef = NULL;
-
-    if (IsScanRunning())
-    {
-        LE_ERROR("ERROR: Scan is running");
-        return NULL;
-    }
-
-    if (NULL == ssidPtr)
+    if (ClientStartCount)
     {
-        LE_ERROR("ERROR: ssidPtr is NULL");
-        return NULL;
+        LE_ERROR("WiFi client is started");
+        return LE_BUSY;
     }
 
-    returnedRef = FindAccessPointRefFromSsid(ssidPtr, ssidNumElements);
-
-    // if the access point does not already exist, then create it.
-    if (returnedRef == NULL)
-    {
-        FoundAccessPoint_t* createdAccessPointPtr = le_mem_ForceAlloc(AccessPointPool);
-
-        if (createdAccessPointPtr)
-        {
-            createdAccessPointPtr->foundInLatestScan = false;
-
-            createdAccessPointPtr->accessPoint.signalStrength = LE_WIFICLIENT_NO_SIGNAL_STRENGTH;
-            createdAccessPointPtr->accessPoint.ssidLength = ssidNumElements;
-            memcpy(&createdAccessPointPtr->accessPoint.ssidBytes[0],
-                ssidPtr,
-                ssidNumElements);
+    return pa_wifiClient_SetInterface(ifNamePtr);
+}
 
-            // Create a Safe Reference for this object.
-            returnedRef = le_ref_CreateRef(ScanApRefMap, createdAccessPointPtr);
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the WiFi interfaces of the module and the index of their radio. The interfaces sharing a
+ * radio index share the same channel.
+ *
+ * @return
+ *      - LE_OK             Function succeeded.
+ *      - LE_BAD_PARAMETER  Invalid parameter.
+ *      - LE_FAULT          The interfaces could not be listed.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_wifiClient_GetInterfaces
+(
+    le_wifiClient_InterfaceInfo_t *interfacesPtr,
+        ///< [OUT]
+        ///< WiFi interfaces and their radio.
 
-            LE_DEBUG("AP[%p %p] signal strength %d | SSID length %d | SSID: \"%.*s\"",
-                createdAccessPointPtr,
-                returnedRef,
-                createdAccessPointPtr->accessPoint.signalStrength,
-                createdAccessPointPtr->accessPoint.ssidLength,
-                createdAccessPointPtr->accessPoint.ssidLength,
-                (char *)createdAccessPointPtr->accessPoint.ssidBytes);
-        }
-        else
-        {
-            LE_ERROR("le_wifiClient_Create le_mem_ForceAlloc failed.");
-        }
+    size_t *interfacesNumElementsPtr
+        ///< [INOUT]
+        ///< In: size of the array. Out: number of interfaces returned.
+)
+{
+    if ((NULL == interfacesPtr) || (NULL == interfacesNumElementsPtr))
+    {
+        LE_KILL_CLIENT("Invalid parameter");
+        return LE_BAD_PARAMETER;
     }
 
-    return returnedRef;
+    return pa_wifiClient_GetInterfaces(interfacesPtr, interfacesNumElementsPtr);
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Deletes an accessPointRef.
+ * Get the IP address leased by the integrated DHCP client.
  *
  * @return
  *      - LE_OK             Function succeeded.
  *      - LE_BAD_PARAMETER  Invalid parameter.
- *      - LE_BUSY           Function called during scan.
- *
- * @note The handle becomes invalid after it has been deleted.
+ *      - LE_NOT_FOUND      No lease in use.
+ *      - LE_OVERFLOW       Buffer too small.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t le_wifiClient_Delete
+le_result_t le_wifiClient_GetIpAddress
 (
-    le_wifiClient_AccessPointRef_t apRef
+    char *addressPtr,
+        ///< [OUT]
+        ///< IPv4 address, in dotted-decimal notation.
+
+    size_t addressSize
         ///< [IN]
-        ///< WiFi Access Point reference.
+        ///< Size of the address buffer.
 )
 {
-    le_result_t         result = LE_BAD_PARAMETER;
-    FoundAccessPoint_t *apPtr  = le_ref_Lookup(ScanApRefMap, apRef);
-
-    LE_DEBUG("Delete client called");
+    if (NULL == addressPtr)
+    {
+        LE_ERROR("Invalid parameter");
+        return LE_BAD_PARAMETER;
+    }
 
-    if (IsScanRunning())
+    if (!Dhcp.hasLease)
     {
-        LE_ERROR("ERROR: Scan is running");
-        return LE_BUSY;
+        return LE_NOT_FOUND;
     }
 
-    // verify le_ref_Lookup
-    if (NULL != apPtr)
+    if (NULL == inet_ntop(AF_INET, &Dhcp.lease.address, addressPtr, addressSize))
     {
-        RemoveAccessPoint(apRef);
-        result = LE_OK;
+        return LE_OVERFLOW;
     }
-    return result;
+    return LE_OK;
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Connect to the WiFi Access Point.
- * All authentication must be set prior to calling this function.
+ * Disconnect from the current connected WiFi Access Point.
  *
  * @return
- *      - LE_OK             Function succeeded.
- *      - LE_BAD_PARAMETER  Invalid parameter.
- *      - LE_DUPLICATE      Duplicated request.
- *      - LE_TIMEOUT        Connection request time out.
- *      - LE_FAULT          The function failed.
+ *      - LE_OK     Function succeeded.
+ *      - LE_FAULT  Function failed.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_wifiClient_Disconnect
+(
+    void
+)
+{
+    LE_DEBUG("Disconnect");
+    StopReconnect();
+    StopDhcp();
+    CurrentConnection = NULL;
+    CurrentBssid[0] = '\0';
+    return pa_wifiClient_Disconnect();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Look up the cached profile of the given SSID.
  *
- * @note For PSK credentials see le_wifiClient_SetPassphrase() or le_wifiClient_SetPreSharedKey() .
- * @note For WPA-Enterprise credentials see le_wifiClient_SetUserCredentials()
+ * @return The cached profile, NULL if not found.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t le_wifiClient_Connect
+static CachedProfile_t *GetCachedProfile
 (
-    le_wifiClient_AccessPointRef_t apRef
-        ///< [IN]
-        ///< WiFi access point reference.
+    const char *ssidPtr
 )
 {
-    le_result_t         result = LE_BAD_PARAMETER;
-    FoundAccessPoint_t *apPtr  = le_ref_Lookup(ScanApRefMap, apRef);
-    uint16_t ssidLen;
+    int i;
 
-    // verify le_ref_Lookup
-    if (NULL !=  apPtr)
+    for (i = 0; i < PROFILE_CACHE_MAX; i++)
     {
-        ssidLen = apPtr->accessPoint.ssidLength;
-        LE_DEBUG("SSID length %d | SSID: \"%.*s\"", ssidLen, ssidLen,
-                 (char *)apPtr->accessPoint.ssidBytes);
-        result = pa_wifiClient_Connect(apPtr->accessPoint.ssidBytes, ssidLen);
-        if (LE_OK == result)
+        if ((0 != ProfileCache[i].ssid[0]) && (0 == strcmp(ProfileCache[i].ssid, ssidPtr)))
         {
-            CurrentConnection = apRef;
+            ProfileCache[i].lastUse = ++ProfileCacheTick;
+            return &ProfileCache[i];
         }
     }
-    return result;
+    return NULL;
 }
 
-
 //--------------------------------------------------------------------------------------------------
 /**
- * Disconnect from the current connected WiFi Access Point.
+ * Get a cache entry for the given SSID, replacing the least recently used one if the cache is full.
  *
- * @return
- *      - LE_OK     Function succeeded.
- *      - LE_FAULT  Function failed.
+ * @return The cache entry, with only the SSID set.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t le_wifiClient_Disconnect
+static CachedProfile_t *NewCachedProfile
 (
-    void
+    const char *ssidPtr
 )
 {
-    LE_DEBUG("Disconnect");
-    CurrentConnection = NULL;
-    return pa_wifiClient_Disconnect();
+    CachedProfile_t *profilePtr = GetCachedProfile(ssidPtr);
+    int i;
+
+    if (NULL == profilePtr)
+    {
+        profilePtr = &ProfileCache[0];
+        for (i = 1; i < PROFILE_CACHE_MAX; i++)
+        {
+            if (ProfileCache[i].lastUse < profilePtr->lastUse)
+            {
+                profilePtr = &ProfileCache[i];
+            }
+        }
+    }
+
+    memset(profilePtr, 0, sizeof(CachedProfile_t));
+    le_utf8_Copy(profilePtr->ssid, ssidPtr, sizeof(profilePtr->ssid), NULL);
+    profilePtr->lastUse = ++ProfileCacheTick;
+    return profilePtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Drop the cached profile of the given SSID, wiping its credentials.
+ */
+//--------------------------------------------------------------------------------------------------
+static void InvalidateCachedProfile
+(
+    const char *ssidPtr
+)
+{
+    CachedProfile_t *profilePtr = GetCachedProfile(ssidPtr);
+
+    if (NULL != profilePtr)
+    {
+        LE_DEBUG("Profile of SSID %s invalidated", ssidPtr);
+        memset(profilePtr, 0, sizeof(CachedProfile_t));
+    }
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handler for changes in the config tree under CFG_PATH_WIFI: drop all the cached profiles, as the
+ * secStore credentials may have been changed along by another tool.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ProfileConfigChangeHandler
+(
+    void *contextPtr
+)
+{
+    LE_DEBUG("WiFi config changed, profile cache invalidated");
+    memset(ProfileCache, 0, sizeof(ProfileCache));
+}
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -1835,10 +4594,21 @@ static le_result_t WifiClient_LoadSecurityConfigs
         uint8_t password[LE_WIFIDEFS_MAX_PASSWORD_BYTES];
     } u2;
     size_t size1 = 0, size2 = 0;
+    CachedProfile_t *profilePtr = GetCachedProfile(ssidPtr);
 
     memset(&u1, 0x0, sizeof(u1));
     memset(&u2, 0x0, sizeof(u2));
 
+    if ((NULL != profilePtr) && (profilePtr->secProtocol == secProtocol))
+    {
+        LE_DEBUG("Security parameters of SSID %s found in cache", ssidPtr);
+        memcpy(&u1, &profilePtr->u1, sizeof(u1));
+        memcpy(&u2, &profilePtr->u2, sizeof(u2));
+        size1 = profilePtr->size1;
+        size2 = profilePtr->size2;
+        goto SET_CONFIGS;
+    }
+
     // Load security parameters from configs
     switch (secProtocol)
     {
@@ -1881,6 +4651,14 @@ static le_result_t WifiClient_LoadSecurityConfigs
     LE_DEBUG("Successfully retrieved security parameters for protocol %d over SSID %s",
              secProtocol, ssidPtr);
 
+    profilePtr = NewCachedProfile(ssidPtr);
+    profilePtr->secProtocol = secProtocol;
+    memcpy(&profilePtr->u1, &u1, sizeof(u1));
+    memcpy(&profilePtr->u2, &u2, sizeof(u2));
+    profilePtr->size1 = size1;
+    profilePtr->size2 = size2;
+
+SET_CONFIGS:
     // Create the Access Point to connect to
     *apRefPtr = le_wifiClient_Create((const uint8_t *)ssidPtr, strlen(ssidPtr));
     if (!*apRefPtr)
@@ -1933,6 +4711,10 @@ static le_result_t WifiClient_LoadSecurityConfigs
             break;
     }
 
+    // Wipe the local copies of the credentials
+    memset(&u1, 0x0, sizeof(u1));
+    memset(&u2, 0x0, sizeof(u2));
+
     if (ret != LE_OK)
     {
         (void)le_wifiClient_Delete(*apRefPtr);
@@ -1970,6 +4752,8 @@ le_result_t le_wifiClient_LoadSsid
     le_wifiClient_SecurityProtocol_t secProtocol;
     le_result_t ret;
     bool is_hidden = false;
+    bool is_fastTransition = false;
+    CachedProfile_t *profilePtr;
 
     if (!apRefPtr)
     {
@@ -1989,6 +4773,20 @@ le_result_t le_wifiClient_LoadSsid
     // to set it there
     memcpy(ssid, ssidPtr, ssidPtrSize);
 
+    // A profile already loaded is taken from the cache, without config tree nor secStore access
+    profilePtr = GetCachedProfile(ssid);
+    if ((NULL != profilePtr) && profilePtr->hasAttributes)
+    {
+        is_hidden = profilePtr->isHidden;
+        is_fastTransition = profilePtr->isFastTransition;
+        ret = WifiClient_LoadSecurityConfigs(ssid, apRefPtr, profilePtr->secProtocol);
+        if (ret != LE_OK)
+        {
+            return ret;
+        }
+        goto SET_ATTRIBUTES;
+    }
+
     snprintf(configPath, sizeof(configPath), "%s/%s/%s", CFG_TREE_ROOT_DIR, CFG_PATH_WIFI, ssid);
     cfg = le_cfg_CreateReadTxn(configPath);
     if (!cfg)
@@ -1997,41 +4795,279 @@ le_result_t le_wifiClient_LoadSsid
         return LE_BAD_PARAMETER;
     }
 
-    // Security protocol
-    if (!le_cfg_NodeExists(cfg, CFG_NODE_SECPROTOCOL))
+    // Security protocol
+    if (!le_cfg_NodeExists(cfg, CFG_NODE_SECPROTOCOL))
+    {
+        LE_DEBUG("No wifi security protocol set at %s/%s", configPath, CFG_NODE_SECPROTOCOL);
+        secProtocol = LE_WIFICLIENT_SECURITY_NONE;
+    }
+    else
+    {
+        secProtocol = le_cfg_GetInt(cfg, CFG_NODE_SECPROTOCOL,
+                                    LE_WIFICLIENT_SECURITY_WPA2_PSK_PERSONAL);
+    }
+    ret = WifiClient_LoadSecurityConfigs(ssid, apRefPtr, secProtocol);
+    if (ret != LE_OK)
+    {
+        le_cfg_CancelTxn(cfg);
+        return ret;
+    }
+
+    // Hidden SSID or not
+    if (le_cfg_NodeExists(cfg, CFG_NODE_HIDDEN_SSID))
+    {
+        is_hidden = le_cfg_GetBool(cfg, CFG_NODE_HIDDEN_SSID, false);
+    }
+
+    // IEEE 802.11r fast BSS transition or not
+    if (le_cfg_NodeExists(cfg, CFG_NODE_FAST_TRANSITION))
+    {
+        is_fastTransition = le_cfg_GetBool(cfg, CFG_NODE_FAST_TRANSITION, false);
+    }
+
+    le_cfg_CancelTxn(cfg);
+
+    // Complete the profile cached along with the security parameters
+    profilePtr = GetCachedProfile(ssid);
+    if (NULL != profilePtr)
+    {
+        profilePtr->isHidden = is_hidden;
+        profilePtr->isFastTransition = is_fastTransition;
+        profilePtr->hasAttributes = true;
+    }
+
+SET_ATTRIBUTES:
+
+    if (is_hidden && (LE_OK != le_wifiClient_SetHiddenNetworkAttribute(*apRefPtr, true)))
+    {
+        LE_ERROR("Failed to set as hidden SSID %s with AP reference %p", ssid, *apRefPtr);
+        (void)le_wifiClient_Delete(*apRefPtr);
+        *apRefPtr = 0;
+        return LE_FAULT;
+    }
+
+    if (LE_OK != le_wifiClient_SetFastTransition(*apRefPtr, is_fastTransition))
+    {
+        LE_ERROR("Failed to set fast transition for SSID %s with AP reference %p", ssid, *apRefPtr);
+        (void)le_wifiClient_Delete(*apRefPtr);
+        *apRefPtr = 0;
+        return LE_FAULT;
+    }
+
+    LE_INFO("Succeeded to create AP reference %p for SSID %s", *apRefPtr, ssid);
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the settings of the given known network into the WiFi client, for it to be added as a
+ * network to connect to.
+ *
+ * @return
+ *      - LE_OK     Function succeeded.
+ *      - LE_FAULT  Function failed.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t SetKnownNetwork
+(
+    const KnownNetwork_t *networkPtr
+)
+{
+    le_wifiClient_AccessPointRef_t apRef = NULL;
+    le_result_t ret;
+
+    ret = WifiClient_LoadSecurityConfigs(networkPtr->ssid, &apRef, networkPtr->secProtocol);
+    if (LE_OK != ret)
+    {
+        return ret;
+    }
+
+    if ((LE_OK != le_wifiClient_SetHiddenNetworkAttribute(apRef, networkPtr->isHidden)) ||
+        (LE_OK != le_wifiClient_SetFastTransition(apRef, networkPtr->isFastTransition)))
+    {
+        LE_ERROR("Failed to set the attributes of SSID %s", networkPtr->ssid);
+        return LE_FAULT;
+    }
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Tell whether a known network found in the latest scan scores better than another one: the
+ * highest priority wins, then the best scored access point.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsBetterKnownNetwork
+(
+    const KnownNetwork_t *networkPtr,
+    const KnownNetwork_t *otherPtr
+)
+{
+    if (networkPtr->priority != otherPtr->priority)
+    {
+        return (networkPtr->priority > otherPtr->priority);
+    }
+    return (networkPtr->score > otherPtr->score);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Connect to the best known network: all the SSIDs saved in the config tree are matched against
+ * the access points found in the latest scan, and those in range are given to wpa_supplicant at
+ * once, by decreasing score. The score favors the priority set by le_wifiClient_SetSsidPriority(),
+ * then the score of the best access point of each SSID, which accounts for the signal strength, the
+ * band and the past connections. wpa_supplicant then falls back by itself to the next network in range
+ * if the best one cannot be joined.
+ *
+ * @note le_wifiClient_Scan() must have been called before.
+ *
+ * @return
+ *      - LE_OK             Function succeeded.
+ *      - LE_BAD_PARAMETER  Invalid parameter.
+ *      - LE_BUSY           Function called during scan.
+ *      - LE_NOT_FOUND      No known network found in the latest scan.
+ *      - LE_DUPLICATE      Duplicated request.
+ *      - LE_TIMEOUT        Connection request time out.
+ *      - LE_FAULT          The function failed.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_wifiClient_ConnectKnownNetwork
+(
+    le_wifiClient_AccessPointRef_t *apRefPtr
+        ///< [OUT]
+        ///< Access point connected to.
+)
+{
+    KnownNetwork_t      networks[KNOWN_NETWORKS_MAX];
+    KnownNetwork_t      network;
+    FoundAccessPoint_t *apPtr;
+    le_ref_IterRef_t    iter;
+    char                bssid[LE_WIFIDEFS_MAX_BSSID_BYTES] = {0};
+    int16_t             signal;
+    size_t              count, visibleCount = 0, addedCount = 0;
+    size_t              i, j;
+    uint32_t            connectMs;
+    le_wifiClient_AccessPointRef_t apRef = NULL;
+    le_result_t         result;
+
+    if (NULL == apRefPtr)
+    {
+        LE_ERROR("Invalid parameter");
+        return LE_BAD_PARAMETER;
+    }
+    *apRefPtr = NULL;
+
+    if (IsScanRunning())
+    {
+        LE_ERROR("Scan is running");
+        return LE_BUSY;
+    }
+
+    count = LoadKnownNetworks(networks, KNOWN_NETWORKS_MAX);
+
+    // Match the known networks against the latest scan in a single pass
+    iter = le_ref_GetIterator(ScanApRefMap);
+    while ((count > 0) && (LE_OK == le_ref_NextNode(iter)))
+    {
+        apPtr = (FoundAccessPoint_t *)le_ref_GetValue(iter);
+        if ((NULL == apPtr) || !apPtr->foundInLatestScan)
+        {
+            continue;
+        }
+        for (i = 0; i < count; i++)
+        {
+            if ((apPtr->accessPoint.ssidLength == strlen(networks[i].ssid)) &&
+                (0 == memcmp(apPtr->accessPoint.ssidBytes, networks[i].ssid,
+                             apPtr->accessPoint.ssidLength)))
+            {
+                int32_t score = ScoreAccessPoint(apPtr);
+                if ((NULL == networks[i].apRef) || (score > networks[i].score))
+                {
+                    networks[i].signalStrength = apPtr->accessPoint.signalStrength;
+                    networks[i].score = score;
+                    networks[i].apRef = (le_wifiClient_AccessPointRef_t)le_ref_GetSafeRef(iter);
+                }
+                break;
+            }
+        }
+    }
+
+    // Keep the networks in range, by decreasing score
+    for (i = 0; i < count; i++)
+    {
+        if (NULL == networks[i].apRef)
+        {
+            continue;
+        }
+        network = networks[i];
+        j = visibleCount++;
+        while ((j > 0) && IsBetterKnownNetwork(&network, &networks[j - 1]))
+        {
+            networks[j] = networks[j - 1];
+            j--;
+        }
+        networks[j] = network;
+    }
+
+    if (0 == visibleCount)
     {
-        LE_DEBUG("No wifi security protocol set at %s/%s", configPath, CFG_NODE_SECPROTOCOL);
-        secProtocol = LE_WIFICLIENT_SECURITY_NONE;
+        LE_WARN("No known network found in the latest scan");
+        return LE_NOT_FOUND;
     }
-    else
+
+    // The application takes over any ongoing auto-reconnect
+    StopReconnect();
+
+    for (i = 0; (i < visibleCount) && (addedCount < PA_WIFICLIENT_MAX_NETWORKS); i++)
     {
-        secProtocol = le_cfg_GetInt(cfg, CFG_NODE_SECPROTOCOL,
-                                    LE_WIFICLIENT_SECURITY_WPA2_PSK_PERSONAL);
+        apPtr = le_ref_Lookup(ScanApRefMap, networks[i].apRef);
+        pa_wifiClient_SetBssidHint((NULL != apPtr) ? apPtr->accessPoint.bssid : NULL);
+        if ((LE_OK != SetKnownNetwork(&networks[i])) ||
+            (LE_OK != pa_wifiClient_AddNetwork((const uint8_t *)networks[i].ssid,
+                                               strlen(networks[i].ssid),
+                                               (int32_t)(visibleCount - i))))
+        {
+            LE_WARN("Unable to add SSID %s, skipped", networks[i].ssid);
+            continue;
+        }
+        LE_INFO("Known network %s: priority %d, signal %d, score %d", networks[i].ssid,
+                (int)networks[i].priority, networks[i].signalStrength, (int)networks[i].score);
+        if (NULL == apRef)
+        {
+            apRef = networks[i].apRef;
+        }
+        addedCount++;
     }
-    ret = WifiClient_LoadSecurityConfigs(ssid, apRefPtr, secProtocol);
-    if (ret != LE_OK)
+
+    if (0 == addedCount)
     {
-        le_cfg_CancelTxn(cfg);
-        return ret;
+        return LE_FAULT;
     }
 
-    // Hidden SSID or not
-    if (le_cfg_NodeExists(cfg, CFG_NODE_HIDDEN_SSID))
+    result = pa_wifiClient_ConnectNetworks();
+    connectMs = RecordConnectTiming();
+    if (LE_OK != result)
     {
-        is_hidden = le_cfg_GetBool(cfg, CFG_NODE_HIDDEN_SSID, false);
+        apPtr = le_ref_Lookup(ScanApRefMap, apRef);
+        RecordBssConnect((NULL != apPtr) ? apPtr->accessPoint.bssid : NULL, result, 0);
+        return result;
     }
 
-    le_cfg_CancelTxn(cfg);
-
-    if (is_hidden && (LE_OK != le_wifiClient_SetHiddenNetworkAttribute(*apRefPtr, true)))
+    // wpa_supplicant may have joined another network than the best scored one
+    if (LE_OK == pa_wifiClient_GetLinkSignal(bssid, sizeof(bssid), &signal))
     {
-        LE_ERROR("Failed to set as hidden SSID %s with AP reference %p", ssid, *apRefPtr);
-        (void)le_wifiClient_Delete(*apRefPtr);
-        *apRefPtr = 0;
-        return LE_FAULT;
+        le_wifiClient_AccessPointRef_t linkRef = FindAccessPointRefFromBssid(bssid);
+        if (NULL != linkRef)
+        {
+            apRef = linkRef;
+        }
+        RecordBssConnect(bssid, LE_OK, connectMs);
     }
 
-    LE_INFO("Succeeded to create AP reference %p for SSID %s", *apRefPtr, ssid);
+    CurrentConnection = apRef;
+    *apRefPtr = apRef;
+    LE_INFO("Connected to known network with AP reference %p", apRef);
     return LE_OK;
 }
 
@@ -2074,6 +5110,7 @@ le_result_t le_wifiClient_ConfigureWep
     // Copy the ssidPtr input over, in case it's not null terminated and has no extra space behind
     // to set it there
     memcpy(ssid, ssidPtr, ssidPtrSize);
+    InvalidateCachedProfile(ssid);
 
     // Write secProtocol into config tree
     snprintf(configPath, sizeof(configPath), "%s/%s/%s", CFG_TREE_ROOT_DIR, CFG_PATH_WIFI, ssid);
@@ -2150,6 +5187,7 @@ le_result_t le_wifiClient_ConfigurePsk
     // Copy the ssidPtr input over, in case it's not null terminated and has no extra space behind
     // to set it there
     memcpy(ssid, ssidPtr, ssidPtrSize);
+    InvalidateCachedProfile(ssid);
 
     // Write secProtocol into config tree
     snprintf(configPath, sizeof(configPath), "%s/%s/%s", CFG_TREE_ROOT_DIR, CFG_PATH_WIFI, ssid);
@@ -2286,6 +5324,7 @@ le_result_t le_wifiClient_ConfigureEap
     // Copy the ssidPtr input over, in case it's not null terminated and has no extra space behind
     // to set it there
     memcpy(ssid, ssidPtr, ssidPtrSize);
+    InvalidateCachedProfile(ssid);
 
     // Write secProtocol into config tree
     snprintf(configPath, sizeof(configPath), "%s/%s/%s", CFG_TREE_ROOT_DIR, CFG_PATH_WIFI, ssid);
@@ -2351,6 +5390,7 @@ le_result_t le_wifiClient_RemoveSsidSecurityConfigs
     // Copy the ssidPtr input over, in case it's not null terminated and has no extra space behind
     // to set it there
     memcpy(ssid, ssidPtr, ssidPtrSize);
+    InvalidateCachedProfile(ssid);
     snprintf(configPath, sizeof(configPath), "%s/%s", SECSTORE_WIFI_ITEM_ROOT, ssid);
     ret = le_secStore_Delete(configPath);
     if (ret == LE_NOT_FOUND)
@@ -2376,6 +5416,428 @@ le_result_t le_wifiClient_RemoveSsidSecurityConfigs
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the priority of the given saved SSID. When falling back to another saved SSID, those with
+ * the highest priority are tried first. Default priority is 0.
+ *
+ * @return
+ *      - LE_OK             Function succeeded.
+ *      - LE_BAD_PARAMETER  Invalid parameter.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_wifiClient_SetSsidPriority
+(
+    const uint8_t *ssidPtr,         ///< [IN] SSID which priority is to be set
+    size_t ssidPtrSize,             ///< [IN] Length of the SSID in octets
+    int32_t priority                ///< [IN] Priority of the SSID
+)
+{
+    char ssid[LE_WIFIDEFS_MAX_SSID_BYTES] = {0};
+    char configPath[LE_CFG_STR_LEN_BYTES] = {0};
+    le_cfg_IteratorRef_t cfg;
+
+    if (!ssidPtr || (ssidPtrSize == 0) || (ssidPtrSize > LE_WIFIDEFS_MAX_SSID_LENGTH))
+    {
+        LE_ERROR("Invalid inputs: SSID size %d", (int)ssidPtrSize);
+        return LE_BAD_PARAMETER;
+    }
+
+    // Copy the ssidPtr input over, in case it's not null terminated and has no extra space behind
+    // to set it there
+    memcpy(ssid, ssidPtr, ssidPtrSize);
+    snprintf(configPath, sizeof(configPath), "%s/%s/%s", CFG_TREE_ROOT_DIR, CFG_PATH_WIFI, ssid);
+    cfg = le_cfg_CreateWriteTxn(configPath);
+    le_cfg_SetInt(cfg, CFG_NODE_PRIORITY, priority);
+    le_cfg_CommitTxn(cfg);
+
+    LE_INFO("Priority of SSID %s set to %d", ssid, (int)priority);
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Parse a line of a profile file, applying the same checks as le_wifiClient_ConfigureWep(),
+ * le_wifiClient_ConfigurePsk() and le_wifiClient_ConfigureEap().
+ *
+ * @return
+ *      - LE_OK             A profile has been read.
+ *      - LE_NOT_FOUND      Empty or comment line.
+ *      - LE_FORMAT_ERROR   Invalid line.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ParseImportLine
+(
+    char *linePtr,
+    ImportedProfile_t *profilePtr
+)
+{
+    char         *savePtr = NULL;
+    char         *ssidPtr, *protocolPtr, *secret1Ptr, *secret2Ptr;
+    unsigned int  protocol;
+    size_t        length, i;
+
+    memset(profilePtr, 0, sizeof(ImportedProfile_t));
+    linePtr[strcspn(linePtr, "\r\n")] = '\0';
+    if (('\0' == linePtr[0]) || ('#' == linePtr[0]))
+    {
+        return LE_NOT_FOUND;
+    }
+
+    ssidPtr = strtok_r(linePtr, IMPORT_FIELD_SEPARATOR, &savePtr);
+    protocolPtr = strtok_r(NULL, IMPORT_FIELD_SEPARATOR, &savePtr);
+    secret1Ptr = strtok_r(NULL, IMPORT_FIELD_SEPARATOR, &savePtr);
+    secret2Ptr = strtok_r(NULL, IMPORT_FIELD_SEPARATOR, &savePtr);
+
+    // The SSID is a node name of the config tree
+    if ((NULL == ssidPtr) || (strlen(ssidPtr) > LE_WIFIDEFS_MAX_SSID_LENGTH) ||
+        (NULL != strchr(ssidPtr, '/')) || (NULL == protocolPtr) ||
+        (1 != sscanf(protocolPtr, "%u", &protocol)))
+    {
+        return LE_FORMAT_ERROR;
+    }
+    le_utf8_Copy(profilePtr->ssid, ssidPtr, sizeof(profilePtr->ssid), NULL);
+    profilePtr->secProtocol = (le_wifiClient_SecurityProtocol_t)protocol;
+
+    switch (profilePtr->secProtocol)
+    {
+        case LE_WIFICLIENT_SECURITY_NONE:
+            return (NULL == secret1Ptr) ? LE_OK : LE_FORMAT_ERROR;
+
+        case LE_WIFICLIENT_SECURITY_WEP:
+            if ((NULL == secret1Ptr) || (NULL != secret2Ptr) ||
+                (strlen(secret1Ptr) > LE_WIFIDEFS_MAX_WEPKEY_LENGTH))
+            {
+                return LE_FORMAT_ERROR;
+            }
+            profilePtr->secret1NodePtr = SECSTORE_NODE_WEP_KEY;
+            break;
+
+        case LE_WIFICLIENT_SECURITY_WPA_PSK_PERSONAL:
+        case LE_WIFICLIENT_SECURITY_WPA2_PSK_PERSONAL:
+            if ((NULL == secret1Ptr) || (NULL != secret2Ptr))
+            {
+                return LE_FORMAT_ERROR;
+            }
+            // A 64 hexadecimal digits secret is a pre-shared key, otherwise a passphrase
+            length = strlen(secret1Ptr);
+            for (i = 0; (i < length) && isxdigit((unsigned char)secret1Ptr[i]); i++);
+            if ((LE_WIFIDEFS_MAX_PSK_LENGTH == length) && (length == i))
+            {
+                profilePtr->secret1NodePtr = SECSTORE_NODE_PSK;
+            }
+            else if ((length >= LE_WIFIDEFS_MIN_PASSPHRASE_LENGTH) &&
+                     (length <= LE_WIFIDEFS_MAX_PASSPHRASE_LENGTH))
+            {
+                profilePtr->secret1NodePtr = SECSTORE_NODE_PASSPHRASE;
+            }
+            else
+            {
+                return LE_FORMAT_ERROR;
+            }
+            break;
+
+        case LE_WIFICLIENT_SECURITY_WPA_EAP_PEAP0_ENTERPRISE:
+        case LE_WIFICLIENT_SECURITY_WPA2_EAP_PEAP0_ENTERPRISE:
+            if ((NULL == secret1Ptr) || (NULL == secret2Ptr) ||
+                (strlen(secret1Ptr) > LE_WIFIDEFS_MAX_USERNAME_LENGTH) ||
+                (strlen(secret2Ptr) > LE_WIFIDEFS_MAX_PASSWORD_LENGTH))
+            {
+                return LE_FORMAT_ERROR;
+            }
+            profilePtr->secret1NodePtr = SECSTORE_NODE_USERNAME;
+            profilePtr->secret2NodePtr = SECSTORE_NODE_USERPWD;
+            le_utf8_Copy(profilePtr->secret2, secret2Ptr, sizeof(profilePtr->secret2), NULL);
+            break;
+
+        default:
+            return LE_FORMAT_ERROR;
+    }
+
+    le_utf8_Copy(profilePtr->secret1, secret1Ptr, sizeof(profilePtr->secret1), NULL);
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Save the credentials of an SSID from the secStore before an import replaces them.
+ *
+ * @return
+ *      - LE_OK     Function succeeded.
+ *      - LE_FAULT  Function failed.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t BackupImportedSsid
+(
+    const char *ssidPtr,
+    le_sls_List_t *backupListPtr
+)
+{
+    char            path[LE_CFG_STR_LEN_BYTES] = {0};
+    ImportBackup_t *backupPtr = le_mem_ForceAlloc(ImportBackupPool);
+    le_result_t     result;
+    int             i;
+
+    memset(backupPtr, 0, sizeof(ImportBackup_t));
+    backupPtr->link = LE_SLS_LINK_INIT;
+    le_utf8_Copy(backupPtr->ssid, ssidPtr, sizeof(backupPtr->ssid), NULL);
+    le_sls_Stack(backupListPtr, &backupPtr->link);
+
+    for (i = 0; i < IMPORT_SECRET_NODE_COUNT; i++)
+    {
+        snprintf(path, sizeof(path), "%s/%s/%s", SECSTORE_WIFI_ITEM_ROOT, ssidPtr,
+                 ImportSecretNodes[i]);
+        backupPtr->secretSize[i] = sizeof(backupPtr->secret[i]);
+        result = le_secStore_Read(path, backupPtr->secret[i], &backupPtr->secretSize[i]);
+        if (LE_NOT_FOUND == result)
+        {
+            backupPtr->secretSize[i] = 0;
+        }
+        else if (LE_OK != result)
+        {
+            LE_ERROR("Failed to read secStore path %s (%d)", path, result);
+            return LE_FAULT;
+        }
+    }
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Release the saved credentials, after restoring them into the secStore if requested. They are
+ * restored in the reverse order of the saves.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReleaseImportBackups
+(
+    le_sls_List_t *backupListPtr,
+    bool isRestoreNeeded
+)
+{
+    char           path[LE_CFG_STR_LEN_BYTES] = {0};
+    le_sls_Link_t *linkPtr;
+    int            i;
+
+    while (NULL != (linkPtr = le_sls_Pop(backupListPtr)))
+    {
+        ImportBackup_t *backupPtr = CONTAINER_OF(linkPtr, ImportBackup_t, link);
+
+        if (isRestoreNeeded)
+        {
+            snprintf(path, sizeof(path), "%s/%s", SECSTORE_WIFI_ITEM_ROOT, backupPtr->ssid);
+            (void)le_secStore_Delete(path);
+            for (i = 0; i < IMPORT_SECRET_NODE_COUNT; i++)
+            {
+                if (0 == backupPtr->secretSize[i])
+                {
+                    continue;
+                }
+                snprintf(path, sizeof(path), "%s/%s/%s", SECSTORE_WIFI_ITEM_ROOT,
+                         backupPtr->ssid, ImportSecretNodes[i]);
+                if (LE_OK != le_secStore_Write(path, backupPtr->secret[i],
+                                               backupPtr->secretSize[i]))
+                {
+                    LE_ERROR("Failed to restore secStore path %s", path);
+                }
+            }
+        }
+        memset(backupPtr, 0, sizeof(ImportBackup_t));
+        le_mem_Release(backupPtr);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write the credentials of an imported profile into the secStore, replacing the previous ones, and
+ * its security protocol into the given config tree transaction.
+ *
+ * @return
+ *      - LE_OK     Function succeeded.
+ *      - LE_FAULT  Function failed.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t WriteImportedProfile
+(
+    const ImportedProfile_t *profilePtr,
+    le_cfg_IteratorRef_t cfg
+)
+{
+    char path[LE_CFG_STR_LEN_BYTES] = {0};
+
+    snprintf(path, sizeof(path), "%s/%s", SECSTORE_WIFI_ITEM_ROOT, profilePtr->ssid);
+    (void)le_secStore_Delete(path);
+
+    if (NULL != profilePtr->secret1NodePtr)
+    {
+        snprintf(path, sizeof(path), "%s/%s/%s", SECSTORE_WIFI_ITEM_ROOT, profilePtr->ssid,
+                 profilePtr->secret1NodePtr);
+        if (LE_OK != le_secStore_Write(path, (const uint8_t *)profilePtr->secret1,
+                                       strlen(profilePtr->secret1)))
+        {
+            LE_ERROR("Failed to write into secStore path %s", path);
+            return LE_FAULT;
+        }
+    }
+
+    if (NULL != profilePtr->secret2NodePtr)
+    {
+        snprintf(path, sizeof(path), "%s/%s/%s", SECSTORE_WIFI_ITEM_ROOT, profilePtr->ssid,
+                 profilePtr->secret2NodePtr);
+        if (LE_OK != le_secStore_Write(path, (const uint8_t *)profilePtr->secret2,
+                                       strlen(profilePtr->secret2)))
+        {
+            LE_ERROR("Failed to write into secStore path %s", path);
+            return LE_FAULT;
+        }
+    }
+
+    snprintf(path, sizeof(path), "%s/%s", profilePtr->ssid, CFG_NODE_SECPROTOCOL);
+    le_cfg_SetInt(cfg, path, profilePtr->secProtocol);
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Import SSID profiles from a file, one per line, with tab separated fields:
+ *
+ * @verbatim
+   SSID<TAB>protocol[<TAB>secret[<TAB>password]]
+   @endverbatim
+ *
+ * The protocol is the value of le_wifiClient_SecurityProtocol_t. The secret is the WEP key, the
+ * WPA passphrase or 64 hexadecimal digits pre-shared key, or the EAP user name followed by the
+ * password. Empty lines and lines starting with '#' are ignored.
+ *
+ * The whole file is validated and the credentials in the secStore of its SSIDs are saved before
+ * anything is written. The profiles are then written in a single config tree transaction,
+ * committed once all the credentials are in the secStore. If a secStore write fails, the
+ * transaction is cancelled and the saved credentials are restored, so that the profiles are left
+ * as before the import.
+ *
+ * @return
+ *      - LE_OK             Function succeeded.
+ *      - LE_BAD_PARAMETER  Invalid parameter.
+ *      - LE_FORMAT_ERROR   Invalid line, its number is returned in countPtr.
+ *      - LE_FAULT          The function failed.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_wifiClient_ImportProfiles
+(
+    int fd,
+        ///< [IN]
+        ///< File descriptor of the profile file.
+
+    uint32_t *countPtr
+        ///< [OUT]
+        ///< Number of profiles imported, or line number of the first invalid line.
+)
+{
+    char                 line[IMPORT_LINE_MAX_BYTES];
+    char                 path[LE_CFG_STR_LEN_BYTES] = {0};
+    ImportedProfile_t    profile;
+    FILE                *filePtr;
+    le_cfg_IteratorRef_t cfg;
+    le_sls_List_t        backupList = LE_SLS_LIST_INIT;
+    le_result_t          result = LE_OK;
+    uint32_t             lineCount = 0, count = 0, written = 0;
+
+    if ((fd < 0) || (NULL == countPtr))
+    {
+        LE_ERROR("Invalid parameter");
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+        return LE_BAD_PARAMETER;
+    }
+    *countPtr = 0;
+
+    filePtr = fdopen(fd, "r");
+    if (NULL == filePtr)
+    {
+        LE_ERROR("Unable to read profile file: %m");
+        close(fd);
+        return LE_FAULT;
+    }
+
+    // Validate the whole file before writing anything
+    while (NULL != fgets(line, sizeof(line), filePtr))
+    {
+        lineCount++;
+        result = ParseImportLine(line, &profile);
+        if (LE_OK == result)
+        {
+            count++;
+        }
+        else if (LE_NOT_FOUND != result)
+        {
+            LE_ERROR("Invalid profile at line %u", lineCount);
+            *countPtr = lineCount;
+            memset(&profile, 0, sizeof(profile));
+            fclose(filePtr);
+            return LE_FORMAT_ERROR;
+        }
+    }
+
+    // Save the credentials to be replaced
+    rewind(filePtr);
+    result = LE_OK;
+    while ((LE_OK == result) && (NULL != fgets(line, sizeof(line), filePtr)))
+    {
+        if (LE_OK == ParseImportLine(line, &profile))
+        {
+            result = BackupImportedSsid(profile.ssid, &backupList);
+        }
+    }
+    if (LE_OK != result)
+    {
+        ReleaseImportBackups(&backupList, false);
+        memset(&profile, 0, sizeof(profile));
+        memset(line, 0, sizeof(line));
+        fclose(filePtr);
+        return LE_FAULT;
+    }
+
+    // Write the credentials, the profiles only take effect with the config tree commit
+    rewind(filePtr);
+    snprintf(path, sizeof(path), "%s/%s", CFG_TREE_ROOT_DIR, CFG_PATH_WIFI);
+    cfg = le_cfg_CreateWriteTxn(path);
+    while ((LE_OK == result) && (NULL != fgets(line, sizeof(line), filePtr)))
+    {
+        if (LE_OK == ParseImportLine(line, &profile))
+        {
+            result = WriteImportedProfile(&profile, cfg);
+            written++;
+        }
+    }
+
+    if (LE_OK != result)
+    {
+        // Leave the config tree and the credentials as they were
+        LE_ERROR("Import failed at profile %u, rolling back", written);
+        le_cfg_CancelTxn(cfg);
+        ReleaseImportBackups(&backupList, true);
+        result = LE_FAULT;
+    }
+    else
+    {
+        le_cfg_CommitTxn(cfg);
+        ReleaseImportBackups(&backupList, false);
+        *countPtr = count;
+        LE_INFO("%u profiles imported", count);
+    }
+
+    memset(&profile, 0, sizeof(profile));
+    memset(line, 0, sizeof(line));
+    fclose(filePtr);
+
+    // All the profiles may have changed
+    memset(ProfileCache, 0, sizeof(ProfileCache));
+    return result;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  *  WiFi Client COMPONENT Init
@@ -2400,6 +5862,7 @@ void le_wifiClient_Init
     // Create an event indication Id for WiFi Events
     WifiEventIndicationId = le_event_CreateIdWithRefCounting("WifiConnectState");
     WifiEventPool = le_mem_CreatePool("WifiConnectStatePool", sizeof(le_wifiClient_EventInd_t));
+    ImportBackupPool = le_mem_CreatePool("WifiImportBackupPool", sizeof(ImportBackup_t));
     // register for events from PA.
     pa_wifiClient_AddEventIndHandler(PaEventIndicationHandler, NULL);
 
@@ -2408,6 +5871,26 @@ void le_wifiClient_Init
     // register for events from PA.
     pa_wifiClient_AddEventHandler(PaEventHandler, NULL);
 
+    // Create an event Id for roam events
+    RoamEventId = le_event_CreateId("WifiClientRoamEvent", sizeof(RoamEvent_t));
+
+    // Roaming decisions are taken in this thread
+    MainThreadRef = le_thread_GetCurrent();
+    Roaming.monitorTimer = le_timer_Create("WifiClientRoamMonitor");
+    le_timer_SetMsInterval(Roaming.monitorTimer, ROAM_HOLDOFF_MS);
+    le_timer_SetRepeat(Roaming.monitorTimer, 1);
+    le_timer_SetHandler(Roaming.monitorTimer, RoamMonitorTimerHandler);
+
+    // Cached profiles are dropped whenever the WiFi config tree changes
+    le_cfg_AddChangeHandler(CFG_TREE_ROOT_DIR "/" CFG_PATH_WIFI, ProfileConfigChangeHandler, NULL);
+
+    Dhcp.renewTimer = le_timer_Create("WifiClientDhcpRenew");
+    le_timer_SetHandler(Dhcp.renewTimer, DhcpRenewTimerHandler);
+
+    Reconnect.timer = le_timer_Create("WifiClientReconnect");
+    le_timer_SetHandler(Reconnect.timer, ReconnectTimerHandler);
+    srand((unsigned int)le_clk_GetRelativeTime().usec);
+
     // Add a handler to handle the close
     le_msg_AddServiceCloseHandler(le_wifiClient_GetServiceRef(), CloseSessionEventHandler, NULL);
 }
@@ -0,0 +1,1232 @@
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Embedded DHCPv4 server of the WiFi access point
+ *
+ *  Minimal DHCPv4 server (RFC 2131) run in the event loop of the WiFi service, with one instance
+ *  per interface of the access point. The leases are kept in a table hashed by client hardware
+ *  address and by IP address, and saved in the config tree, so that the clients keep their address
+ *  across a change of the range or a restart of the service.
+ *
+ *  Copyright (C) Sierra Wireless Inc.
+ *
+ */
+// -------------------------------------------------------------------------------------------------
+#include <sys/types.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <net/if.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <poll.h>
+#include <stdio.h>
+
+#include "legato.h"
+
+#include "interfaces.h"
+
+#include "wifiApDhcp.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Config tree path and nodes of the saved leases, one node per client hardware address.
+ */
+//--------------------------------------------------------------------------------------------------
+#define CFG_TREE_ROOT_DIR           "wifiService:"
+#define CFG_PATH_AP_LEASE           "wifi/ap/lease"
+#define CFG_NODE_LEASE_ADDRESS      "address"
+#define CFG_NODE_LEASE_EXPIRY       "expiry"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * DHCP protocol values (RFC 2131 and RFC 2132).
+ */
+//--------------------------------------------------------------------------------------------------
+#define DHCP_SERVER_PORT            67
+#define DHCP_CLIENT_PORT            68
+#define DHCP_OP_REQUEST             1
+#define DHCP_OP_REPLY               2
+#define DHCP_HTYPE_ETHERNET         1
+#define DHCP_HLEN_ETHERNET          6
+#define DHCP_MAGIC_COOKIE           0x63825363
+#define DHCP_OPTIONS_MAX_BYTES      312
+
+#define DHCP_OPTION_PAD             0
+#define DHCP_OPTION_SUBNET_MASK     1
+#define DHCP_OPTION_ROUTER          3
+#define DHCP_OPTION_DNS             6
+#define DHCP_OPTION_REQUESTED_IP    50
+#define DHCP_OPTION_LEASE_TIME      51
+#define DHCP_OPTION_MESSAGE_TYPE    53
+#define DHCP_OPTION_SERVER_ID       54
+#define DHCP_OPTION_RENEWAL_TIME    58
+#define DHCP_OPTION_REBINDING_TIME  59
+#define DHCP_OPTION_END             255
+
+#define DHCP_DISCOVER               1
+#define DHCP_OFFER                  2
+#define DHCP_REQUEST                3
+#define DHCP_DECLINE                4
+#define DHCP_ACK                    5
+#define DHCP_NAK                    6
+#define DHCP_RELEASE                7
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of leases, time an address is leased for, time an offered address is kept for
+ * the client before it is requested, and time an address declined by a client as already in use
+ * is not offered again.
+ */
+//--------------------------------------------------------------------------------------------------
+#define DHCPD_MAX_LEASES            64
+#define DHCPD_LEASE_TIME_SEC        (24 * 60 * 60)
+#define DHCPD_OFFER_HOLD_SEC        60
+#define DHCPD_DECLINE_HOLD_SEC      (10 * 60)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Resolver configuration giving the DNS servers advertised to the clients, and their maximum
+ * number.
+ */
+//--------------------------------------------------------------------------------------------------
+#define DHCPD_RESOLV_CONF           "/etc/resolv.conf"
+#define DHCPD_MAX_DNS_SERVERS       3
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of interfaces served, one per BSS of the access point.
+ */
+//--------------------------------------------------------------------------------------------------
+#define DHCPD_MAX_SERVERS           4
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Netmask given to the clients if the one of the interface cannot be read.
+ */
+//--------------------------------------------------------------------------------------------------
+#define DHCPD_DEFAULT_NETMASK       0xFFFFFF00
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Length of a hardware address formatted as a string, with the null terminator.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAC_STR_BYTES               18
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * DHCP message, as sent over UDP.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct __attribute__((packed))
+{
+    uint8_t  op;                                ///< Message op code.
+    uint8_t  htype;                             ///< Hardware address type.
+    uint8_t  hlen;                              ///< Hardware address length.
+    uint8_t  hops;                              ///< Relay agent hops.
+    uint32_t xid;                               ///< Transaction ID.
+    uint16_t secs;                              ///< Seconds elapsed since the start.
+    uint16_t flags;                             ///< Flags.
+    uint32_t ciaddr;                            ///< Client IP address.
+    uint32_t yiaddr;                            ///< 'your' (client) IP address.
+    uint32_t siaddr;                            ///< Next server IP address.
+    uint32_t giaddr;                            ///< Relay agent IP address.
+    uint8_t  chaddr[16];                        ///< Client hardware address.
+    uint8_t  sname[64];                         ///< Server host name.
+    uint8_t  file[128];                         ///< Boot file name.
+    uint32_t magic;                             ///< Magic cookie.
+    uint8_t  options[DHCP_OPTIONS_MAX_BYTES];   ///< Options.
+}
+DhcpMessage_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Options of a received DHCP message used by the server.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint8_t  type;              ///< Message type, 0 if absent.
+    uint32_t requestedAddress;  ///< Requested IP address in host byte order, 0 if absent.
+    uint32_t serverId;          ///< Selected server in host byte order, 0 if absent.
+}
+DhcpOptions_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Lease of an address to a client. An address declined by a client is held by a lease without
+ * client until its expiry.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    char     mac[MAC_STR_BYTES];    ///< Client hardware address, key of the lease, empty if
+                                    ///< declined.
+    uint32_t address;               ///< Leased address in host byte order.
+    time_t   expiry;                ///< Expiry, absolute time.
+    bool     isBound;               ///< Acknowledged to the client, otherwise only offered.
+}
+Lease_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * DHCP server state. The addresses are in host byte order.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    int                fd;                      ///< UDP socket bound to the server port.
+    le_fdMonitor_Ref_t monitor;                 ///< Monitor of the socket in the event loop.
+    char               ifName[IFNAMSIZ];        ///< Interface served.
+    uint32_t           serverAddress;           ///< Address of the access point.
+    uint32_t           netmask;                 ///< Netmask of the interface.
+    uint32_t           startAddress;            ///< First address of the range.
+    uint32_t           stopAddress;             ///< Last address of the range.
+}
+DhcpServer_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Lease table, hashed by client hardware address and by address.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t LeasePool;
+static le_hashmap_Ref_t LeasesByMac;
+static le_hashmap_Ref_t LeasesByAddress;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * DHCP servers, one per interface. A server is unused while its interface name is empty, and
+ * stopped as long as its socket is not open.
+ */
+//--------------------------------------------------------------------------------------------------
+static DhcpServer_t Servers[DHCPD_MAX_SERVERS];
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the current absolute time in seconds.
+ */
+//--------------------------------------------------------------------------------------------------
+static time_t GetNow
+(
+    void
+)
+{
+    return (time_t)le_clk_GetAbsoluteTime().sec;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Build the config tree path of the lease of a client: ':' is not allowed in a node name.
+ */
+//--------------------------------------------------------------------------------------------------
+static void GetLeasePath
+(
+    const char *macPtr,
+    char       *pathPtr,
+    size_t      pathSize
+)
+{
+    char   node[MAC_STR_BYTES];
+    size_t i, j = 0;
+
+    for (i = 0; ('\0' != macPtr[i]) && (j < (sizeof(node) - 1)); i++)
+    {
+        if (':' != macPtr[i])
+        {
+            node[j++] = macPtr[i];
+        }
+    }
+    node[j] = '\0';
+
+    snprintf(pathPtr, pathSize, CFG_TREE_ROOT_DIR "/" CFG_PATH_AP_LEASE "/%s", node);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Save a bound lease in the config tree, or delete it.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SaveLease
+(
+    const Lease_t *leasePtr,
+    bool           isValid
+)
+{
+    char                 path[LE_CFG_STR_LEN_BYTES];
+    char                 addressStr[INET_ADDRSTRLEN];
+    char                 expiryStr[24];
+    struct in_addr       address;
+    le_cfg_IteratorRef_t cfg;
+
+    GetLeasePath(leasePtr->mac, path, sizeof(path));
+    cfg = le_cfg_CreateWriteTxn(path);
+    if (!isValid)
+    {
+        le_cfg_DeleteNode(cfg, "");
+    }
+    else
+    {
+        address.s_addr = htonl(leasePtr->address);
+        inet_ntop(AF_INET, &address, addressStr, sizeof(addressStr));
+        le_cfg_SetString(cfg, CFG_NODE_LEASE_ADDRESS, addressStr);
+        snprintf(expiryStr, sizeof(expiryStr), "%lld", (long long)leasePtr->expiry);
+        le_cfg_SetString(cfg, CFG_NODE_LEASE_EXPIRY, expiryStr);
+    }
+    le_cfg_CommitTxn(cfg);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove a lease from the table, and from the config tree if it was bound.
+ */
+//--------------------------------------------------------------------------------------------------
+static void DeleteLease
+(
+    Lease_t *leasePtr
+)
+{
+    LE_DEBUG("Lease of %s deleted", leasePtr->mac);
+    if (leasePtr->isBound)
+    {
+        SaveLease(leasePtr, false);
+    }
+    if ('\0' != leasePtr->mac[0])
+    {
+        le_hashmap_Remove(LeasesByMac, leasePtr->mac);
+    }
+    le_hashmap_Remove(LeasesByAddress, &leasePtr->address);
+    le_mem_Release(leasePtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete the expired leases. If the table is still full, the oldest offer is deleted as well, so
+ * that a flood of DISCOVER messages cannot prevent the other clients from being served.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SweepLeases
+(
+    time_t now
+)
+{
+    Lease_t            *expired[DHCPD_MAX_LEASES];
+    Lease_t            *oldestOfferPtr = NULL;
+    size_t              count = 0;
+    size_t              i;
+    le_hashmap_It_Ref_t iter = le_hashmap_GetIterator(LeasesByAddress);
+
+    // The table cannot be changed while iterated
+    while ((LE_OK == le_hashmap_NextNode(iter)) && (count < DHCPD_MAX_LEASES))
+    {
+        Lease_t *leasePtr = le_hashmap_GetValue(iter);
+
+        if (leasePtr->expiry <= now)
+        {
+            expired[count++] = leasePtr;
+        }
+        else if ((!leasePtr->isBound) && ('\0' != leasePtr->mac[0]) &&
+                 ((NULL == oldestOfferPtr) || (leasePtr->expiry < oldestOfferPtr->expiry)))
+        {
+            oldestOfferPtr = leasePtr;
+        }
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        DeleteLease(expired[i]);
+    }
+
+    if ((le_hashmap_Size(LeasesByAddress) >= DHCPD_MAX_LEASES) && (NULL != oldestOfferPtr))
+    {
+        LE_WARN("Lease table full, offer to %s withdrawn", oldestOfferPtr->mac);
+        DeleteLease(oldestOfferPtr);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a lease to the table, once the expired leases have been deleted.
+ *
+ * @return The lease, NULL if the table is full.
+ */
+//--------------------------------------------------------------------------------------------------
+static Lease_t *AddLease
+(
+    const char *macPtr,
+    uint32_t    address,
+    time_t      expiry,
+    bool        isBound
+)
+{
+    Lease_t *leasePtr;
+
+    SweepLeases(GetNow());
+    leasePtr = le_mem_TryAlloc(LeasePool);
+    if (NULL == leasePtr)
+    {
+        LE_WARN("Lease table full, %s not served", macPtr);
+        return NULL;
+    }
+
+    le_utf8_Copy(leasePtr->mac, macPtr, sizeof(leasePtr->mac), NULL);
+    leasePtr->address = address;
+    leasePtr->expiry = expiry;
+    leasePtr->isBound = isBound;
+    le_hashmap_Put(LeasesByMac, leasePtr->mac, leasePtr);
+    le_hashmap_Put(LeasesByAddress, &leasePtr->address, leasePtr);
+    return leasePtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Quarantine the address of a lease declined by its client as already in use: the lease is
+ * detached from the client and the address is not offered again until the hold-down expires.
+ */
+//--------------------------------------------------------------------------------------------------
+static void DeclineLease
+(
+    Lease_t *leasePtr
+)
+{
+    LE_WARN("Address 0x%08x declined by %s, held for %d s", leasePtr->address, leasePtr->mac,
+            DHCPD_DECLINE_HOLD_SEC);
+    if (leasePtr->isBound)
+    {
+        SaveLease(leasePtr, false);
+        leasePtr->isBound = false;
+    }
+    le_hashmap_Remove(LeasesByMac, leasePtr->mac);
+    leasePtr->mac[0] = '\0';
+    leasePtr->expiry = GetNow() + DHCPD_DECLINE_HOLD_SEC;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Load the leases saved in the config tree which have not expired yet.
+ */
+//--------------------------------------------------------------------------------------------------
+static void LoadLeases
+(
+    void
+)
+{
+    char                 node[MAC_STR_BYTES];
+    char                 mac[MAC_STR_BYTES];
+    char                 addressStr[INET_ADDRSTRLEN];
+    char                 expiryStr[24];
+    struct in_addr       address;
+    time_t               now = GetNow();
+    time_t               expiry;
+    le_cfg_IteratorRef_t cfg;
+    size_t               count = 0;
+
+    cfg = le_cfg_CreateReadTxn(CFG_TREE_ROOT_DIR "/" CFG_PATH_AP_LEASE);
+    if (LE_OK == le_cfg_GoToFirstChild(cfg))
+    {
+        do
+        {
+            if ((LE_OK != le_cfg_GetNodeName(cfg, "", node, sizeof(node))) ||
+                (12 != strlen(node)) ||
+                (LE_OK != le_cfg_GetString(cfg, CFG_NODE_LEASE_ADDRESS, addressStr,
+                                           sizeof(addressStr), "")) ||
+                (1 != inet_pton(AF_INET, addressStr, &address)))
+            {
+                continue;
+            }
+            le_cfg_GetString(cfg, CFG_NODE_LEASE_EXPIRY, expiryStr, sizeof(expiryStr), "0");
+            expiry = (time_t)strtoll(expiryStr, NULL, 10);
+            if (expiry <= now)
+            {
+                continue;
+            }
+
+            snprintf(mac, sizeof(mac), "%.2s:%.2s:%.2s:%.2s:%.2s:%.2s", &node[0], &node[2],
+                     &node[4], &node[6], &node[8], &node[10]);
+            if (NULL != AddLease(mac, ntohl(address.s_addr), expiry, true))
+            {
+                count++;
+            }
+        }
+        while (LE_OK == le_cfg_GoToNextSibling(cfg));
+    }
+    le_cfg_CancelTxn(cfg);
+
+    LE_INFO("%zu DHCP leases loaded", count);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Tell whether an address belongs to the range served.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsInRange
+(
+    const DhcpServer_t *serverPtr,
+    uint32_t            address
+)
+{
+    return ((address >= serverPtr->startAddress) && (address <= serverPtr->stopAddress) &&
+            (address != serverPtr->serverAddress));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Tell whether an address belongs to the range of one of the interfaces, served or not.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsInAnyRange
+(
+    uint32_t address
+)
+{
+    size_t i;
+
+    for (i = 0; i < NUM_ARRAY_MEMBERS(Servers); i++)
+    {
+        if (('\0' != Servers[i].ifName[0]) && IsInRange(&Servers[i], address))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Tell whether an address can be leased. The expired lease of this address, if any, is deleted.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsAddressFree
+(
+    uint32_t address,
+    time_t   now
+)
+{
+    Lease_t *leasePtr = le_hashmap_Get(LeasesByAddress, &address);
+
+    if (NULL == leasePtr)
+    {
+        return true;
+    }
+    if (leasePtr->expiry <= now)
+    {
+        DeleteLease(leasePtr);
+        return true;
+    }
+    return false;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Find a free address in the range of a server.
+ *
+ * @return The address in host byte order, 0 if none is left.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t FindFreeAddress
+(
+    const DhcpServer_t *serverPtr,
+    time_t              now
+)
+{
+    uint32_t address;
+
+    for (address = serverPtr->startAddress; address <= serverPtr->stopAddress; address++)
+    {
+        if ((address != serverPtr->serverAddress) && IsAddressFree(address, now))
+        {
+            return address;
+        }
+        if (UINT32_MAX == address)
+        {
+            break;
+        }
+    }
+    return 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete the leases out of the ranges of all the interfaces.
+ */
+//--------------------------------------------------------------------------------------------------
+static void PurgeLeases
+(
+    void
+)
+{
+    Lease_t            *purged[DHCPD_MAX_LEASES];
+    size_t              count = 0;
+    size_t              i;
+    le_hashmap_It_Ref_t iter = le_hashmap_GetIterator(LeasesByAddress);
+
+    // The table cannot be changed while iterated
+    while ((LE_OK == le_hashmap_NextNode(iter)) && (count < DHCPD_MAX_LEASES))
+    {
+        Lease_t *leasePtr = le_hashmap_GetValue(iter);
+        if (!IsInAnyRange(leasePtr->address))
+        {
+            purged[count++] = leasePtr;
+        }
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        DeleteLease(purged[i]);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Append an option to a DHCP message.
+ *
+ * @return Offset of the next option.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t AddOption
+(
+    DhcpMessage_t *msgPtr,
+    size_t         offset,
+    uint8_t        code,
+    const void    *dataPtr,
+    uint8_t        length
+)
+{
+    msgPtr->options[offset++] = code;
+    msgPtr->options[offset++] = length;
+    memcpy(&msgPtr->options[offset], dataPtr, length);
+    return offset + length;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Append a 32-bit option, given in host byte order, to a DHCP message.
+ *
+ * @return Offset of the next option.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t AddOption32
+(
+    DhcpMessage_t *msgPtr,
+    size_t         offset,
+    uint8_t        code,
+    uint32_t       value
+)
+{
+    value = htonl(value);
+    return AddOption(msgPtr, offset, code, &value, sizeof(value));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Parse the options of a DHCP message sent by a client.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ParseOptions
+(
+    const DhcpMessage_t *msgPtr,
+    size_t               length,
+    DhcpOptions_t       *optionsPtr
+)
+{
+    size_t   optionsLen = length - offsetof(DhcpMessage_t, options);
+    size_t   offset = 0;
+    uint32_t value;
+
+    memset(optionsPtr, 0, sizeof(*optionsPtr));
+    while (offset < optionsLen)
+    {
+        uint8_t code = msgPtr->options[offset++];
+        uint8_t len;
+        const uint8_t *dataPtr;
+
+        if (DHCP_OPTION_END == code)
+        {
+            break;
+        }
+        if (DHCP_OPTION_PAD == code)
+        {
+            continue;
+        }
+        if (offset >= optionsLen)
+        {
+            break;
+        }
+        len = msgPtr->options[offset++];
+        if ((offset + len) > optionsLen)
+        {
+            break;
+        }
+        dataPtr = &msgPtr->options[offset];
+
+        switch (code)
+        {
+            case DHCP_OPTION_MESSAGE_TYPE:
+                optionsPtr->type = (len >= 1) ? dataPtr[0] : 0;
+                break;
+            case DHCP_OPTION_REQUESTED_IP:
+                if (len >= 4)
+                {
+                    memcpy(&value, dataPtr, 4);
+                    optionsPtr->requestedAddress = ntohl(value);
+                }
+                break;
+            case DHCP_OPTION_SERVER_ID:
+                if (len >= 4)
+                {
+                    memcpy(&value, dataPtr, 4);
+                    optionsPtr->serverId = ntohl(value);
+                }
+                break;
+            default:
+                break;
+        }
+        offset += len;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the DNS servers of the resolver configuration, which the clients are given: the access
+ * point does not resolve names itself. The local addresses are skipped.
+ *
+ * @return The number of DNS servers, in network byte order.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t GetDnsServers
+(
+    uint32_t *serversPtr,
+    size_t    maxServers
+)
+{
+    char           line[128];
+    char           addressStr[INET_ADDRSTRLEN];
+    struct in_addr address;
+    size_t         count = 0;
+    FILE          *filePtr = fopen(DHCPD_RESOLV_CONF, "r");
+
+    if (NULL == filePtr)
+    {
+        return 0;
+    }
+
+    while ((count < maxServers) && (NULL != fgets(line, sizeof(line), filePtr)))
+    {
+        if ((1 == sscanf(line, " nameserver %15s", addressStr)) &&
+            (1 == inet_pton(AF_INET, addressStr, &address)) &&
+            (IN_LOOPBACKNET != (ntohl(address.s_addr) >> IN_CLASSA_NSHIFT)))
+        {
+            serversPtr[count++] = address.s_addr;
+        }
+    }
+    fclose(filePtr);
+    return count;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send a reply to a client. It is broadcast unless the client already has an address.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SendReply
+(
+    const DhcpServer_t  *serverPtr,
+    const DhcpMessage_t *requestPtr,
+    uint8_t              type,
+    uint32_t             address
+)
+{
+    DhcpMessage_t      reply;
+    struct sockaddr_in to;
+    size_t             offset = 0;
+    uint32_t           dnsServers[DHCPD_MAX_DNS_SERVERS];
+    size_t             dnsCount;
+
+    memset(&reply, 0, sizeof(reply));
+    reply.op = DHCP_OP_REPLY;
+    reply.htype = requestPtr->htype;
+    reply.hlen = requestPtr->hlen;
+    reply.xid = requestPtr->xid;
+    reply.flags = requestPtr->flags;
+    reply.giaddr = requestPtr->giaddr;
+    memcpy(reply.chaddr, requestPtr->chaddr, sizeof(reply.chaddr));
+    reply.magic = htonl(DHCP_MAGIC_COOKIE);
+
+    offset = AddOption(&reply, offset, DHCP_OPTION_MESSAGE_TYPE, &type, 1);
+    offset = AddOption32(&reply, offset, DHCP_OPTION_SERVER_ID, serverPtr->serverAddress);
+    if (DHCP_NAK != type)
+    {
+        reply.yiaddr = htonl(address);
+        offset = AddOption32(&reply, offset, DHCP_OPTION_LEASE_TIME, DHCPD_LEASE_TIME_SEC);
+        offset = AddOption32(&reply, offset, DHCP_OPTION_RENEWAL_TIME, DHCPD_LEASE_TIME_SEC / 2);
+        offset = AddOption32(&reply, offset, DHCP_OPTION_REBINDING_TIME,
+                             (DHCPD_LEASE_TIME_SEC / 8) * 7);
+        offset = AddOption32(&reply, offset, DHCP_OPTION_SUBNET_MASK, serverPtr->netmask);
+        offset = AddOption32(&reply, offset, DHCP_OPTION_ROUTER, serverPtr->serverAddress);
+        dnsCount = GetDnsServers(dnsServers, NUM_ARRAY_MEMBERS(dnsServers));
+        if (0 != dnsCount)
+        {
+            offset = AddOption(&reply, offset, DHCP_OPTION_DNS, dnsServers,
+                               dnsCount * sizeof(dnsServers[0]));
+        }
+    }
+    reply.options[offset++] = DHCP_OPTION_END;
+
+    memset(&to, 0, sizeof(to));
+    to.sin_family = AF_INET;
+    to.sin_port = htons(DHCP_CLIENT_PORT);
+    to.sin_addr.s_addr = ((DHCP_NAK == type) || (0 == requestPtr->ciaddr)) ?
+                         htonl(INADDR_BROADCAST) : requestPtr->ciaddr;
+
+    if (sendto(serverPtr->fd, &reply, offsetof(DhcpMessage_t, options) + offset, 0,
+               (struct sockaddr *)&to, sizeof(to)) < 0)
+    {
+        LE_ERROR("Failed to send DHCP reply: errno:%d %s", errno, strerror(errno));
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Offer an address to a client: its current lease, else the address it asks for if free, else the
+ * first free address of the range.
+ */
+//--------------------------------------------------------------------------------------------------
+static void HandleDiscover
+(
+    const DhcpServer_t  *serverPtr,
+    const DhcpMessage_t *msgPtr,
+    const char          *macPtr,
+    const DhcpOptions_t *optionsPtr
+)
+{
+    Lease_t  *leasePtr = le_hashmap_Get(LeasesByMac, macPtr);
+    time_t    now = GetNow();
+    uint32_t  address;
+
+    if ((NULL != leasePtr) && !IsInRange(serverPtr, leasePtr->address))
+    {
+        DeleteLease(leasePtr);
+        leasePtr = NULL;
+    }
+
+    if (NULL == leasePtr)
+    {
+        if ((0 != optionsPtr->requestedAddress) &&
+            IsInRange(serverPtr, optionsPtr->requestedAddress) &&
+            IsAddressFree(optionsPtr->requestedAddress, now))
+        {
+            address = optionsPtr->requestedAddress;
+        }
+        else
+        {
+            address = FindFreeAddress(serverPtr, now);
+        }
+
+        if (0 == address)
+        {
+            LE_WARN("No address left for %s", macPtr);
+            return;
+        }
+        leasePtr = AddLease(macPtr, address, now + DHCPD_OFFER_HOLD_SEC, false);
+        if (NULL == leasePtr)
+        {
+            return;
+        }
+    }
+    else if (!leasePtr->isBound)
+    {
+        leasePtr->expiry = now + DHCPD_OFFER_HOLD_SEC;
+    }
+
+    SendReply(serverPtr, msgPtr, DHCP_OFFER, leasePtr->address);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Acknowledge the address requested by a client if it is leased to it or free, otherwise refuse
+ * it.
+ */
+//--------------------------------------------------------------------------------------------------
+static void HandleRequest
+(
+    const DhcpServer_t  *serverPtr,
+    const DhcpMessage_t *msgPtr,
+    const char          *macPtr,
+    const DhcpOptions_t *optionsPtr
+)
+{
+    Lease_t  *leasePtr = le_hashmap_Get(LeasesByMac, macPtr);
+    time_t    now = GetNow();
+    uint32_t  address = (0 != optionsPtr->requestedAddress) ?
+                        optionsPtr->requestedAddress : ntohl(msgPtr->ciaddr);
+
+    if ((0 != optionsPtr->serverId) && (serverPtr->serverAddress != optionsPtr->serverId))
+    {
+        // The client selected another server: release the offer
+        if ((NULL != leasePtr) && !leasePtr->isBound)
+        {
+            DeleteLease(leasePtr);
+        }
+        return;
+    }
+
+    if ((NULL != leasePtr) && (leasePtr->address != address))
+    {
+        DeleteLease(leasePtr);
+        leasePtr = NULL;
+    }
+
+    if (NULL == leasePtr)
+    {
+        // Unknown client asking for an address, e.g. after the lease table was lost
+        if ((!IsInRange(serverPtr, address)) || (!IsAddressFree(address, now)) ||
+            (NULL == (leasePtr = AddLease(macPtr, address, now, false))))
+        {
+            LE_INFO("Address refused to %s", macPtr);
+            SendReply(serverPtr, msgPtr, DHCP_NAK, 0);
+            return;
+        }
+    }
+    else if (!IsInRange(serverPtr, address))
+    {
+        DeleteLease(leasePtr);
+        SendReply(serverPtr, msgPtr, DHCP_NAK, 0);
+        return;
+    }
+
+    leasePtr->isBound = true;
+    leasePtr->expiry = now + DHCPD_LEASE_TIME_SEC;
+    SaveLease(leasePtr, true);
+
+    LE_INFO("Address 0x%08x leased to %s", leasePtr->address, macPtr);
+    SendReply(serverPtr, msgPtr, DHCP_ACK, leasePtr->address);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handler of the DHCP messages received on the socket of a server, given as context.
+ */
+//--------------------------------------------------------------------------------------------------
+static void MessageHandler
+(
+    int   fd,
+    short events
+)
+{
+    DhcpServer_t *serverPtr = le_fdMonitor_GetContextPtr();
+    DhcpMessage_t msg;
+    DhcpOptions_t options;
+    char          mac[MAC_STR_BYTES];
+    Lease_t      *leasePtr;
+    ssize_t       len;
+
+    if (0 == (events & POLLIN))
+    {
+        return;
+    }
+
+    len = recv(fd, &msg, sizeof(msg), 0);
+    if ((len < (ssize_t)offsetof(DhcpMessage_t, options)) || (DHCP_OP_REQUEST != msg.op) ||
+        (DHCP_HTYPE_ETHERNET != msg.htype) || (DHCP_HLEN_ETHERNET != msg.hlen) ||
+        (htonl(DHCP_MAGIC_COOKIE) != msg.magic))
+    {
+        return;
+    }
+
+    ParseOptions(&msg, len, &options);
+    snprintf(mac, sizeof(mac), "%02x:%02x:%02x:%02x:%02x:%02x", msg.chaddr[0], msg.chaddr[1],
+             msg.chaddr[2], msg.chaddr[3], msg.chaddr[4], msg.chaddr[5]);
+    LE_DEBUG("DHCP message %d from %s on %s", options.type, mac, serverPtr->ifName);
+
+    switch (options.type)
+    {
+        case DHCP_DISCOVER:
+            HandleDiscover(serverPtr, &msg, mac, &options);
+            break;
+
+        case DHCP_REQUEST:
+            HandleRequest(serverPtr, &msg, mac, &options);
+            break;
+
+        case DHCP_RELEASE:
+            leasePtr = le_hashmap_Get(LeasesByMac, mac);
+            if (NULL != leasePtr)
+            {
+                DeleteLease(leasePtr);
+            }
+            break;
+
+        case DHCP_DECLINE:
+            // The address is in use by another host: it must not be offered again for a while
+            leasePtr = le_hashmap_Get(LeasesByMac, mac);
+            if ((NULL != leasePtr) &&
+                ((0 == options.requestedAddress) || (leasePtr->address == options.requestedAddress)))
+            {
+                DeclineLease(leasePtr);
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Open the UDP socket of a server on its interface, and monitor it in the event loop.
+ *
+ * @return LE_OK     The function succeeded.
+ * @return LE_FAULT  The function failed.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t OpenServer
+(
+    DhcpServer_t *serverPtr
+)
+{
+    const char        *ifNamePtr = serverPtr->ifName;
+    struct sockaddr_in addr;
+    struct ifreq       ifr;
+    int                on = 1;
+
+    serverPtr->fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (serverPtr->fd < 0)
+    {
+        LE_ERROR("Failed to open DHCP socket: errno:%d %s", errno, strerror(errno));
+        return LE_FAULT;
+    }
+
+    memset(&ifr, 0, sizeof(ifr));
+    le_utf8_Copy(ifr.ifr_name, ifNamePtr, sizeof(ifr.ifr_name), NULL);
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(DHCP_SERVER_PORT);
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+
+    if ((setsockopt(serverPtr->fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on)) < 0) ||
+        (setsockopt(serverPtr->fd, SOL_SOCKET, SO_BROADCAST, &on, sizeof(on)) < 0) ||
+        (setsockopt(serverPtr->fd, SOL_SOCKET, SO_BINDTODEVICE, &ifr, sizeof(ifr)) < 0) ||
+        (bind(serverPtr->fd, (struct sockaddr *)&addr, sizeof(addr)) < 0))
+    {
+        LE_ERROR("Failed to set up DHCP socket on %s: errno:%d %s", ifNamePtr, errno,
+                 strerror(errno));
+        close(serverPtr->fd);
+        serverPtr->fd = -1;
+        return LE_FAULT;
+    }
+
+    serverPtr->monitor = le_fdMonitor_Create("WifiApDhcp", serverPtr->fd, MessageHandler, POLLIN);
+    le_fdMonitor_SetContextPtr(serverPtr->monitor, serverPtr);
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the netmask of the interface of a server.
+ *
+ * @return The netmask in host byte order.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t GetNetmask
+(
+    const DhcpServer_t *serverPtr
+)
+{
+    struct ifreq ifr;
+
+    memset(&ifr, 0, sizeof(ifr));
+    le_utf8_Copy(ifr.ifr_name, serverPtr->ifName, sizeof(ifr.ifr_name), NULL);
+    if (ioctl(serverPtr->fd, SIOCGIFNETMASK, &ifr) < 0)
+    {
+        LE_WARN("Unable to get the netmask of %s", serverPtr->ifName);
+        return DHCPD_DEFAULT_NETMASK;
+    }
+    return ntohl(((struct sockaddr_in *)&ifr.ifr_netmask)->sin_addr.s_addr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the DHCP server and load the leases saved in the config tree.
+ */
+//--------------------------------------------------------------------------------------------------
+void wifiApDhcp_Init
+(
+    void
+)
+{
+    size_t i;
+
+    for (i = 0; i < NUM_ARRAY_MEMBERS(Servers); i++)
+    {
+        Servers[i].fd = -1;
+    }
+
+    LeasePool = le_mem_CreatePool("WifiApDhcpLeasePool", sizeof(Lease_t));
+    le_mem_ExpandPool(LeasePool, DHCPD_MAX_LEASES);
+    LeasesByMac = le_hashmap_Create("WifiApDhcpLeasesByMac", DHCPD_MAX_LEASES,
+                                    le_hashmap_HashString, le_hashmap_EqualsString);
+    LeasesByAddress = le_hashmap_Create("WifiApDhcpLeasesByAddress", DHCPD_MAX_LEASES,
+                                        le_hashmap_HashUInt32, le_hashmap_EqualsUInt32);
+    LoadLeases();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Find the server of an interface, or an unused server if the interface name is empty.
+ *
+ * @return The server, NULL if none is found.
+ */
+//--------------------------------------------------------------------------------------------------
+static DhcpServer_t *FindServer
+(
+    const char *ifNamePtr
+)
+{
+    size_t i;
+
+    for (i = 0; i < NUM_ARRAY_MEMBERS(Servers); i++)
+    {
+        if (0 == strcmp(Servers[i].ifName, ifNamePtr))
+        {
+            return &Servers[i];
+        }
+    }
+    return NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Close the socket of a server. Its range is kept.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CloseServer
+(
+    DhcpServer_t *serverPtr
+)
+{
+    if (serverPtr->fd < 0)
+    {
+        return;
+    }
+
+    le_fdMonitor_Delete(serverPtr->monitor);
+    close(serverPtr->fd);
+    serverPtr->fd = -1;
+    LE_INFO("DHCP server on %s stopped", serverPtr->ifName);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start serving the given address range on the interface, or update the range if already started.
+ * The leases within the ranges of all the interfaces are kept.
+ *
+ * @return LE_BAD_PARAMETER At least, one of the given IP addresses is invalid.
+ * @return LE_FAULT         The server could not be started.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t wifiApDhcp_Start
+(
+    const char *ifNamePtr,
+        ///< [IN]
+        ///< Network interface of the access point.
+    const char *ipApPtr,
+        ///< [IN]
+        ///< IP address of the access point, given as router.
+    const char *ipStartPtr,
+        ///< [IN]
+        ///< First IP address of the range.
+    const char *ipStopPtr
+        ///< [IN]
+        ///< Last IP address of the range.
+)
+{
+    struct in_addr ap, start, stop;
+    uint32_t       startAddress, stopAddress;
+    DhcpServer_t  *serverPtr;
+
+    if ((NULL == ifNamePtr) || (NULL == ipApPtr) || (NULL == ipStartPtr) || (NULL == ipStopPtr) ||
+        (1 != inet_pton(AF_INET, ipApPtr, &ap)) ||
+        (1 != inet_pton(AF_INET, ipStartPtr, &start)) ||
+        (1 != inet_pton(AF_INET, ipStopPtr, &stop)))
+    {
+        return LE_BAD_PARAMETER;
+    }
+
+    startAddress = ntohl(start.s_addr);
+    stopAddress = ntohl(stop.s_addr);
+    if (startAddress > stopAddress)
+    {
+        uint32_t swap = startAddress;
+        startAddress = stopAddress;
+        stopAddress = swap;
+    }
+
+    serverPtr = FindServer(ifNamePtr);
+    if (NULL == serverPtr)
+    {
+        // Take an unused server
+        serverPtr = FindServer("");
+        if (NULL == serverPtr)
+        {
+            LE_ERROR("No DHCP server left for %s", ifNamePtr);
+            return LE_FAULT;
+        }
+        le_utf8_Copy(serverPtr->ifName, ifNamePtr, sizeof(serverPtr->ifName), NULL);
+    }
+    if ((serverPtr->fd < 0) && (LE_OK != OpenServer(serverPtr)))
+    {
+        serverPtr->ifName[0] = '\0';
+        return LE_FAULT;
+    }
+
+    serverPtr->serverAddress = ntohl(ap.s_addr);
+    serverPtr->startAddress = startAddress;
+    serverPtr->stopAddress = stopAddress;
+    serverPtr->netmask = GetNetmask(serverPtr);
+    PurgeLeases();
+
+    LE_INFO("DHCP server on %s: %s - %s, %zu leases", ifNamePtr, ipStartPtr, ipStopPtr,
+            le_hashmap_Size(LeasesByMac));
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stop the DHCP server on all the interfaces. The leases are kept for the next start.
+ */
+//--------------------------------------------------------------------------------------------------
+void wifiApDhcp_Stop
+(
+    void
+)
+{
+    size_t i;
+
+    for (i = 0; i < NUM_ARRAY_MEMBERS(Servers); i++)
+    {
+        CloseServer(&Servers[i]);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stop serving an interface which is removed. Its leases are deleted on the next start of the
+ * server.
+ */
+//--------------------------------------------------------------------------------------------------
+void wifiApDhcp_Remove
+(
+    const char *ifNamePtr
+        ///< [IN]
+        ///< Network interface removed.
+)
+{
+    DhcpServer_t *serverPtr = FindServer(ifNamePtr);
+
+    if (NULL != serverPtr)
+    {
+        CloseServer(serverPtr);
+        serverPtr->ifName[0] = '\0';
+    }
+}
@@ -0,0 +1,73 @@
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Embedded DHCPv4 server of the WiFi access point.
+ *
+ *  Copyright (C) Sierra Wireless Inc.
+ *
+ */
+// -------------------------------------------------------------------------------------------------
+#ifndef WIFI_AP_DHCP_H
+#define WIFI_AP_DHCP_H
+
+#include "legato.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the DHCP server and load the leases saved in the config tree.
+ */
+//--------------------------------------------------------------------------------------------------
+void wifiApDhcp_Init
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start serving the given address range on the interface, or update the range if already started.
+ * The leases within the ranges of all the interfaces are kept.
+ *
+ * @return LE_BAD_PARAMETER At least, one of the given IP addresses is invalid.
+ * @return LE_FAULT         The server could not be started.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t wifiApDhcp_Start
+(
+    const char *ifNamePtr,
+        ///< [IN]
+        ///< Network interface of the access point.
+    const char *ipApPtr,
+        ///< [IN]
+        ///< IP address of the access point, given as router.
+    const char *ipStartPtr,
+        ///< [IN]
+        ///< First IP address of the range.
+    const char *ipStopPtr
+        ///< [IN]
+        ///< Last IP address of the range.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stop the DHCP server on all the interfaces. The leases are kept for the next start.
+ */
+//--------------------------------------------------------------------------------------------------
+void wifiApDhcp_Stop
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stop serving an interface which is removed. Its leases are deleted on the next start of the
+ * server.
+ */
+//--------------------------------------------------------------------------------------------------
+void wifiApDhcp_Remove
+(
+    const char *ifNamePtr
+        ///< [IN]
+        ///< Network interface removed.
+);
+
+#endif //WIFI_AP_DHCP_H
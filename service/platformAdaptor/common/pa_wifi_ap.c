@@ -8,7 +8,12 @@
 // -------------------------------------------------------------------------------------------------
 #include <sys/types.h>
 #include <sys/wait.h>
+#include <sys/socket.h>
+#include <sys/un.h>
 #include <arpa/inet.h>
+#include <net/if.h>
+#include <ctype.h>
+#include <poll.h>
 #include <stdlib.h>
 #include <unistd.h>
 #include "legato.h"
@@ -16,45 +21,84 @@
 #include "pa_wifi_ap.h"
 
 // Set of commands to drive the WiFi features.
-#define COMMAND_WIFI_HW_START        "WIFI_START"
-#define COMMAND_WIFI_HW_STOP         "WIFI_STOP"
-#define COMMAND_WIFI_SET_EVENT       "WIFI_SET_EVENT"
-#define COMMAND_WIFI_UNSET_EVENT     "WIFI_UNSET_EVENT"
+// The radio and its events are shared with the WiFi client, the access point being their AP user.
+#define COMMAND_WIFI_HW_START        "WIFI_START AP"
+#define COMMAND_WIFI_HW_STOP         "WIFI_STOP AP"
+#define COMMAND_WIFI_SET_EVENT       "WIFI_SET_EVENT AP"
+#define COMMAND_WIFI_UNSET_EVENT     "WIFI_UNSET_EVENT AP"
 #define COMMAND_WIFIAP_HOSTAPD_START "WIFIAP_HOSTAPD_START"
 #define COMMAND_WIFIAP_HOSTAPD_STOP  "WIFIAP_HOSTAPD_STOP"
 #define COMMAND_WIFIAP_WLAN_UP       "WIFIAP_WLAN_UP"
+#define COMMAND_WIFIAP_GET_STATIONS  "WIFIAP_GET_STATIONS"
+#define COMMAND_WIFIAP_GET_PHY_INFO  "WIFIAP_GET_PHY_INFO"
+#define COMMAND_WIFIAP_CHANNEL_SURVEY "WIFIAP_CHANNEL_SURVEY"
+#define COMMAND_WIFIAP_SET_ANTENNA   "WIFIAP_SET_ANTENNA"
+#define COMMAND_WIFIAP_BRIDGE_START  "WIFIAP_BRIDGE_START"
+#define COMMAND_WIFIAP_BRIDGE_STOP   "WIFIAP_BRIDGE_STOP"
+#define COMMAND_WIFIAP_NAT_START     "WIFIAP_NAT_START"
+#define COMMAND_WIFIAP_NAT_STOP      "WIFIAP_NAT_STOP"
+#define COMMAND_WIFIAP_NAT_OFFLOAD_START "WIFIAP_NAT_OFFLOAD_START"
+#define COMMAND_WIFIAP_NAT_OFFLOAD_STOP  "WIFIAP_NAT_OFFLOAD_STOP"
+#define COMMAND_WIFIAP_NAT_STATS     "WIFIAP_NAT_STATS"
+#define COMMAND_WIFIAP_VIF_ADD       "WIFIAP_VIF_ADD"
+#define COMMAND_WIFIAP_VIF_DEL       "WIFIAP_VIF_DEL"
+#define COMMAND_WIFIAP_GET_STA_FREQUENCY "WIFIAP_GET_STA_FREQUENCY"
+#define COMMAND_WIFIAP_SHAPING_START "WIFIAP_SHAPING_START"
+#define COMMAND_WIFIAP_SHAPING_STOP  "WIFIAP_SHAPING_STOP"
+#define COMMAND_WIFIAP_SET_STA_RATE  "WIFIAP_SET_STA_RATE"
+#define COMMAND_WIFIAP_GET_STA_SHAPING_STATS "WIFIAP_GET_STA_SHAPING_STATS"
+#define COMMAND_WIFIAP_SET_AIRTIME_FAIRNESS  "WIFIAP_SET_AIRTIME_FAIRNESS"
 
 // iptables rule to allow/disallow the DHCP port on WLAN interface
 #define COMMAND_IPTABLE_DHCP_INSERT  "IPTABLE_DHCP_INSERT"
 #define COMMAND_IPTABLE_DHCP_DELETE  "IPTABLE_DHCP_DELETE"
-#define COMMAND_DNSMASQ_RESTART       "DNSMASQ_RESTART"
 
 //--------------------------------------------------------------------------------------------------
 /**
  * WiFi platform adaptor shell script
  */
 //--------------------------------------------------------------------------------------------------
-#define WIFI_SCRIPT_PATH "/legato/systems/current/apps/wifiService/read-only/pa_wifi "
+#define WIFI_SCRIPT_FILE "/legato/systems/current/apps/wifiService/read-only/pa_wifi"
+#define WIFI_SCRIPT_PATH WIFI_SCRIPT_FILE " "
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Link to the dnsmasq related configuration file
+ * Maximum number of arguments of a command of the WiFi platform adaptor shell script
  */
 //--------------------------------------------------------------------------------------------------
-#define DNSMASQ_CFG_LINK "/etc/dnsmasq.d/dnsmasq.wlan.conf"
+#define SCRIPT_MAX_ARGS 8
+
 //--------------------------------------------------------------------------------------------------
 /**
- * dnsmasq related configuration file
+ * WiFi access point configuration file
  */
 //--------------------------------------------------------------------------------------------------
-#define DNSMASQ_CFG_FILE "/tmp/dnsmasq.wlan.conf"
+#define WIFI_HOSTAPD_FILE "/tmp/hostapd.conf"
 
 //--------------------------------------------------------------------------------------------------
 /**
- * WiFi access point configuration file
+ * Bridge of the WiFi interface with the uplink interface, created by the script in bridge mode
  */
 //--------------------------------------------------------------------------------------------------
-#define WIFI_HOSTAPD_FILE "/tmp/hostapd.conf"
+#define WIFIAP_BRIDGE_INTERFACE "br-wlan"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * hostapd control interface of the WiFi interface, in the ctrl_interface directory set in
+ * hostapd.conf, and local socket bound to receive its replies.
+ */
+//--------------------------------------------------------------------------------------------------
+#define HOSTAPD_CTRL_DIR        "/var/run/hostapd/"
+#define HOSTAPD_CTRL_LOCAL_PATH "/tmp/wifiap_ctrl_%d"
+#define HOSTAPD_CTRL_TIMEOUT_MS 2000
+#define HOSTAPD_REPLY_MAX_BYTES 256
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Default number of beacons announcing a channel switch (CSA) before it occurs.
+ */
+//--------------------------------------------------------------------------------------------------
+#define HOSTAPD_CSA_BEACON_COUNT 5
 
 // WiFi access point configuration.
 //--------------------------------------------------------------------------------------------------
@@ -64,11 +108,6 @@
 //--------------------------------------------------------------------------------------------------
 #define HOSTAPD_CONFIG_COMMON \
     "driver=nl80211\n"\
-    "wmm_enabled=1\n"\
-    "beacon_int=100\n"\
-    "dtim_period=2\n"\
-    "rts_threshold=2347\n"\
-    "fragm_threshold=2346\n"\
     "ctrl_interface=/var/run/hostapd\n"\
     "ctrl_interface_group=0\n"
 //--------------------------------------------------------------------------------------------------
@@ -94,11 +133,69 @@
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Maximum numbers of WiFi connections for the TI chip
+ * Default maximum number of WiFi connections
  */
 //--------------------------------------------------------------------------------------------------
 #define WIFI_MAX_USERS 10
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Highest maximum number of WiFi connections accepted by hostapd, used when the driver does not
+ * report its capability
+ */
+//--------------------------------------------------------------------------------------------------
+#define HOSTAPD_MAX_STA_COUNT 2007
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Admission control: default inactivity timeout of hostapd in seconds, maximum number of stations
+ * among which the most idle is evicted, time a station must have been idle to be evicted for a new
+ * one, and IEEE 802.11 reasons given to the station evicted or refused
+ */
+//--------------------------------------------------------------------------------------------------
+#define HOSTAPD_MAX_INACTIVITY_SEC    300
+#define ADMISSION_MAX_STA             64
+#define ADMISSION_MIN_IDLE_MS         30000
+#define REASON_DISASSOC_INACTIVITY    4
+#define REASON_DISASSOC_AP_BUSY       5
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of channels of a channel survey
+ */
+//--------------------------------------------------------------------------------------------------
+#define AUTO_CHANNEL_MAX 64
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Load, in percent of the channel time, added to the score of a channel per access point seen on
+ * it
+ */
+//--------------------------------------------------------------------------------------------------
+#define AUTO_CHANNEL_AP_LOAD 10
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Noise floor in dBm above which each dB is added to the score of a channel
+ */
+//--------------------------------------------------------------------------------------------------
+#define AUTO_CHANNEL_NOISE_FLOOR -95
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Score by which another channel must be better than the current one to switch to it
+ */
+//--------------------------------------------------------------------------------------------------
+#define AUTO_CHANNEL_HYSTERESIS 10
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * First channel of the 4.9 GHz band in IEEE 802.11a: the channels from this one are numbered from
+ * 4 GHz instead of 5 GHz
+ */
+//--------------------------------------------------------------------------------------------------
+#define CHANNEL_4_9_GHZ_MIN 182
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Hardware mode mask
@@ -112,6 +209,179 @@
  */
 //--------------------------------------------------------------------------------------------------
 #define TEMP_STRING_MAX_BYTES 1024
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of tuning parameters and of tuning profiles
+ */
+//--------------------------------------------------------------------------------------------------
+#define TUNING_PARAM_COUNT   (LE_WIFIAP_TUNING_WMM_VO_TXOP + 1)
+#define TUNING_PROFILE_COUNT (LE_WIFIAP_PROFILE_DENSE + 1)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Value of a tuning parameter which is not overridden
+ */
+//--------------------------------------------------------------------------------------------------
+#define TUNING_NOT_OVERRIDDEN INT32_MIN
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Tuning parameter of the radio: hostapd key and range of values
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    const char *namePtr;   ///< hostapd configuration key
+    int32_t     min;       ///< Lowest value
+    int32_t     max;       ///< Highest value
+}
+TuningParam_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Tuning parameters, in the order of le_wifiAp_TuningParam_t. The WMM parameters are the EDCA
+ * parameters advertised to the stations per access category: best effort, background, video and
+ * voice. The contention windows are exponents: CW = 2^value - 1.
+ */
+//--------------------------------------------------------------------------------------------------
+static const TuningParam_t TuningParams[TUNING_PARAM_COUNT] =
+{
+    { "beacon_int",           15,  65535 },
+    { "dtim_period",          1,   255   },
+    { "rts_threshold",        -1,  65535 },
+    { "fragm_threshold",      -1,  2346  },
+    { "wmm_enabled",          0,   1     },
+    { "wmm_ac_be_aifs",       1,   15    },
+    { "wmm_ac_be_cwmin",      0,   15    },
+    { "wmm_ac_be_cwmax",      0,   15    },
+    { "wmm_ac_be_txop_limit", 0,   65535 },
+    { "wmm_ac_bk_aifs",       1,   15    },
+    { "wmm_ac_bk_cwmin",      0,   15    },
+    { "wmm_ac_bk_cwmax",      0,   15    },
+    { "wmm_ac_bk_txop_limit", 0,   65535 },
+    { "wmm_ac_vi_aifs",       1,   15    },
+    { "wmm_ac_vi_cwmin",      0,   15    },
+    { "wmm_ac_vi_cwmax",      0,   15    },
+    { "wmm_ac_vi_txop_limit", 0,   65535 },
+    { "wmm_ac_vo_aifs",       1,   15    },
+    { "wmm_ac_vo_cwmin",      0,   15    },
+    { "wmm_ac_vo_cwmax",      0,   15    },
+    { "wmm_ac_vo_txop_limit", 0,   65535 },
+};
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Values of the tuning parameters per profile, in the order of le_wifiAp_Profile_t:
+ * - default: the hostapd defaults.
+ * - low latency: DTIM every beacon, shorter contention for best effort and video.
+ * - high throughput: RTS protection and longer transmit opportunities for video and best effort.
+ * - power save: long DTIM period so that the stations sleep longer between wake-ups.
+ * - dense: fewer beacons, RTS protection against hidden stations and longer contention windows.
+ */
+//--------------------------------------------------------------------------------------------------
+static const int32_t TuningProfiles[TUNING_PROFILE_COUNT][TUNING_PARAM_COUNT] =
+{
+    //  beacon dtim  rts   frag  wmm  | BE: aifs cwmin cwmax txop | BK | VI | VO
+    {   100,   2,    2347, 2346, 1,     3, 4, 10, 0,    7, 4, 10, 0,    2, 3, 4, 94,   2, 2, 3, 47 },
+    {   100,   1,    2347, 2346, 1,     2, 3, 6,  0,    7, 4, 10, 0,    1, 2, 3, 94,   1, 2, 2, 47 },
+    {   100,   3,    500,  2346, 1,     3, 4, 10, 32,   7, 4, 10, 0,    2, 3, 4, 188,  2, 2, 3, 47 },
+    {   100,   10,   2347, 2346, 1,     3, 4, 10, 0,    7, 4, 10, 0,    2, 3, 4, 94,   2, 2, 3, 47 },
+    {   200,   2,    500,  2346, 1,     3, 5, 10, 0,    7, 5, 10, 0,    2, 3, 5, 94,   2, 2, 3, 47 },
+};
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Capabilities of the radio in one band, as reported by the driver
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    bool                      isKnown;        ///< The capabilities have been discovered
+    le_wifiAp_ChannelWidth_t  maxWidth;       ///< Widest channel supported
+    le_wifiAp_PhyCapBitMask_t htCapMask;      ///< Optional HT capabilities
+    le_wifiAp_PhyCapBitMask_t vhtCapMask;     ///< Optional VHT capabilities
+    uint8_t                   numStreams;     ///< Number of spatial streams
+    bool                      airtimeFairness; ///< Airtime fairness scheduling of the driver
+}
+PhyCapabilities_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * PHY settings of the access point once bounded by the capabilities of the radio
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_wifiAp_ChannelWidth_t width;                ///< Channel width
+    int                      secondaryOffset;      ///< Secondary 20 MHz channel: 1 above, -1 below
+    uint16_t                 centerChannel;        ///< Center channel of the whole width
+    char                     htCapab[64];          ///< Value of ht_capab
+    char                     vhtCapab[64];         ///< Value of vht_capab
+}
+PhyConfig_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Survey of a channel, for the automatic channel selection
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t frequency;  ///< Center frequency in MHz
+    uint32_t activeMs;   ///< Time the radio spent on the channel
+    uint32_t busyMs;     ///< Time the channel was sensed busy
+    uint32_t txMs;       ///< Time spent transmitting, by the access point itself
+    int32_t  noise;      ///< Noise floor in dBm, 0 if unknown
+    uint32_t numAps;     ///< Number of access points seen on the channel
+}
+ChannelSurvey_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Survey of the channels run by the worker thread of the periodic channel re-evaluation
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    ChannelSurvey_t surveys[AUTO_CHANNEL_MAX];  ///< Surveys of the channels
+    size_t          numSurveys;                 ///< Number of channels surveyed
+    le_result_t     result;                     ///< Outcome of the survey
+}
+AutoChannelContext_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Additional BSS sharing the radio of the access point, with its own interface
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    bool                         isCreated;                                   ///< BSS in use
+    char                         ifName[LE_WIFIDEFS_MAX_IFNAME_BYTES];        ///< Interface
+    char                         ssid[LE_WIFIDEFS_MAX_SSID_BYTES];            ///< SSID
+    le_wifiAp_SecurityProtocol_t securityProtocol;                            ///< Security
+    char                         passphrase[LE_WIFIDEFS_MAX_PASSPHRASE_BYTES]; ///< WPA2 passphrase
+    char                         preSharedKey[LE_WIFIDEFS_MAX_PSK_BYTES];     ///< WPA2 PSK
+    uint32_t                     maxNumClients;                               ///< Client limit
+    bool                         isIpRangeSet;                                ///< DHCP ports open
+}
+Bss_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Rate limit of a station, shaped on the interface of the access point. Each slot has its own
+ * traffic control class and filters, numbered from 1 after the slot.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    bool     isSet;                                ///< Slot in use
+    char     macAddr[LE_WIFIDEFS_MAX_BSSID_BYTES]; ///< MAC address of the station, lower case
+    uint32_t downlinkKbps;                         ///< Rate to the station, 0 for no limit
+    uint32_t uplinkKbps;                           ///< Rate from the station, 0 for no limit
+}
+RateLimit_t;
 //--------------------------------------------------------------------------------------------------
 /**
  * The current security protocol
@@ -167,6 +437,132 @@ static uint16_t                     SavedChannelNumber                    = 6;
  */
 //--------------------------------------------------------------------------------------------------
 static uint32_t                     SavedMaxNumClients                    = WIFI_MAX_USERS;
+//--------------------------------------------------------------------------------------------------
+/**
+ * The maximum number of clients supported by the driver, 0 until discovered. It is the default
+ * maximum number of clients if the driver does not report it.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t                     MaxNumClientsCapability               = 0;
+static bool                         IsMaxNumClientsReported               = false;
+//--------------------------------------------------------------------------------------------------
+/**
+ * Admission policy: time in seconds after which an idle station is disconnected, whether the most
+ * idle station is evicted for a new one when the access point is full, and the signal strength in
+ * dBm under which the association is rejected (0 to accept all the stations)
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t                     SavedInactivitySec              = HOSTAPD_MAX_INACTIVITY_SEC;
+static bool                         IsEvictIdleWhenFull                   = false;
+static int16_t                      SavedMinAssocRssi                     = 0;
+//--------------------------------------------------------------------------------------------------
+/**
+ * The channel width, the optional HT/VHT capabilities and the number of spatial streams (0 for all
+ * the streams of the radio)
+ */
+//--------------------------------------------------------------------------------------------------
+static le_wifiAp_ChannelWidth_t     SavedChannelWidth               = LE_WIFIAP_CHANNEL_WIDTH_20_MHZ;
+static le_wifiAp_PhyCapBitMask_t    SavedPhyCapMask                       = 0;
+static uint8_t                      SavedNumSpatialStreams                = 0;
+//--------------------------------------------------------------------------------------------------
+/**
+ * The tuning profile and the overridden tuning parameters
+ */
+//--------------------------------------------------------------------------------------------------
+static le_wifiAp_Profile_t          SavedProfile                      = LE_WIFIAP_PROFILE_DEFAULT;
+static int32_t                      SavedTuningOverrides[TUNING_PARAM_COUNT];
+//--------------------------------------------------------------------------------------------------
+/**
+ * The capabilities of the radio in the band of the hardware mode, discovered from the driver
+ */
+//--------------------------------------------------------------------------------------------------
+static PhyCapabilities_t            PhyCaps;
+//--------------------------------------------------------------------------------------------------
+/**
+ * Automatic channel selection: whether it is enabled, the period in seconds of the re-evaluation
+ * while started (0 to select on start only) and the load in percent of the current channel above
+ * which it is re-evaluated
+ */
+//--------------------------------------------------------------------------------------------------
+static bool                         IsAutoChannel                         = false;
+static uint32_t                     AutoChannelPeriodSec                  = 0;
+static uint8_t                      AutoChannelThreshold                  = 0;
+static le_timer_Ref_t               AutoChannelTimer                      = NULL;
+//--------------------------------------------------------------------------------------------------
+/**
+ * Previous sample of the survey of each channel. The counters of the driver are cumulative, so the
+ * load of a channel is measured over the time elapsed since its previous sample.
+ */
+//--------------------------------------------------------------------------------------------------
+static ChannelSurvey_t              PreviousSurveys[AUTO_CHANNEL_MAX];
+static size_t                       NumPreviousSurveys                    = 0;
+//--------------------------------------------------------------------------------------------------
+/**
+ * Worker thread of the periodic channel re-evaluation, NULL if none is running, and its survey
+ */
+//--------------------------------------------------------------------------------------------------
+static le_thread_Ref_t              AutoChannelThreadRef                  = NULL;
+static AutoChannelContext_t         AutoChannelContext;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Additional BSS of the access point, hostapd bss= sections of the main one
+ */
+//--------------------------------------------------------------------------------------------------
+static Bss_t                        BssList[PA_WIFIAP_MAX_BSS];
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Uplink of the access point: interface bridged with the WiFi interface or routed to with NAT
+ */
+//--------------------------------------------------------------------------------------------------
+static le_wifiAp_UplinkMode_t       SavedUplinkMode                       = LE_WIFIAP_UPLINK_NONE;
+static char                         SavedUplinkIfName[LE_WIFIDEFS_MAX_IFNAME_BYTES] = "";
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Fast path of the NAT uplink: whether it is requested and whether its flowtable is installed
+ */
+//--------------------------------------------------------------------------------------------------
+static bool                         IsNatOffloadEnabled                   = false;
+static bool                         IsNatOffloaded                        = false;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Byte counters of the WiFi interface at the previous statistics request, to compute the
+ * throughput since then
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t                     UplinkStatsRxBytes                    = 0;
+static uint64_t                     UplinkStatsTxBytes                    = 0;
+static le_clk_Time_t                UplinkStatsTime                       = { 0, 0 };
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Concurrent mode: the access point runs on a virtual interface next to the station interface
+ */
+//--------------------------------------------------------------------------------------------------
+static bool                         IsConcurrent                          = false;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Network interface of the radio of the access point, and the WiFi platform adaptor shell script
+ * with the option selecting it. Trailing space is needed to pass the command.
+ */
+//--------------------------------------------------------------------------------------------------
+static char ApIfName[LE_WIFIDEFS_MAX_IFNAME_BYTES] = PA_WIFIAP_INTERFACE;
+static char ScriptPath[sizeof(WIFI_SCRIPT_PATH "-i ") + LE_WIFIDEFS_MAX_IFNAME_BYTES] =
+    WIFI_SCRIPT_PATH "-i " PA_WIFIAP_INTERFACE " ";
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Rate limits of the stations, whether the traffic control of the interface is installed, and
+ * whether the airtime is shared fairly between the stations by the driver
+ */
+//--------------------------------------------------------------------------------------------------
+static RateLimit_t                  RateLimits[PA_WIFIAP_MAX_RATE_LIMITS];
+static bool                         IsShapingStarted                      = false;
+static bool                         IsAirtimeFairness                     = false;
 
 // WPA-Personal
 //--------------------------------------------------------------------------------------------------
@@ -182,6 +578,14 @@ static char SavedPassphrase[LE_WIFIDEFS_MAX_PASSPHRASE_BYTES] = "";
 //--------------------------------------------------------------------------------------------------
 static char SavedPreSharedKey[LE_WIFIDEFS_MAX_PSK_BYTES]      = "";
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Whether hostapd is running, so that the settings are applied at once through its control
+ * interface.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsHostapdStarted = false;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * The main thread running the WiFi service
@@ -195,6 +599,12 @@ static void            *WifiApPaThreadMain(void *contextPtr);
 //--------------------------------------------------------------------------------------------------
 static le_thread_Ref_t  WifiApPaThread  = NULL;
 //--------------------------------------------------------------------------------------------------
+/**
+ * The thread of the WiFi service calling the platform adaptor, which owns its settings
+ */
+//--------------------------------------------------------------------------------------------------
+static le_thread_Ref_t  MainThreadRef   = NULL;
+//--------------------------------------------------------------------------------------------------
 /**
  * The handle of the input pipe used to be notified of the WiFi related events.
  */
@@ -208,6 +618,56 @@ static FILE            *IwThreadPipePtr = NULL;
 //--------------------------------------------------------------------------------------------------
 static le_event_Id_t    WifiApPaEvent;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the network interface of the access point: the virtual one in concurrent mode.
+ */
+//--------------------------------------------------------------------------------------------------
+static const char *GetApInterface
+(
+    void
+)
+{
+    return IsConcurrent ? PA_WIFIAP_CONCURRENT_INTERFACE : ApIfName;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Run a command of the WiFi platform adaptor shell script on the radio of the access point.
+ *
+ * @return The status of the command, as returned by system().
+ */
+//--------------------------------------------------------------------------------------------------
+static int RunScript
+(
+    const char *commandPtr
+)
+{
+    char cmd[256];
+
+    snprintf(cmd, sizeof(cmd), "%s%s", ScriptPath, commandPtr);
+    return system(cmd);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Run a command of the WiFi platform adaptor shell script on the radio of the access point, to
+ * read its output.
+ *
+ * @return The pipe of the command output, NULL on failure.
+ */
+//--------------------------------------------------------------------------------------------------
+static FILE *OpenScript
+(
+    const char *commandPtr
+)
+{
+    char cmd[256];
+
+    snprintf(cmd, sizeof(cmd), "%s%s", ScriptPath, commandPtr);
+    return popen(cmd, "r");
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Thread destructor
@@ -221,7 +681,7 @@ static void ThreadDestructor
     int status;
 
     // Kill the script launched by popen() in PA thread
-    status = system(WIFI_SCRIPT_PATH COMMAND_WIFI_UNSET_EVENT);
+    status = RunScript(COMMAND_WIFI_UNSET_EVENT);
 
     if ((!WIFEXITED(status)) || (0 != WEXITSTATUS(status)))
     {
@@ -249,12 +709,12 @@ static void FirstLayerWifiApEventHandler
 )
 {
     pa_wifiAp_NewEventHandlerFunc_t  ApHandlerFunc = secondLayerHandlerFunc;
-    le_wifiAp_Event_t               *wifiEventPtr  = (le_wifiAp_Event_t *)reportPtr;
+    le_wifiAp_EventInd_t            *wifiEventPtr  = (le_wifiAp_EventInd_t *)reportPtr;
 
     if (NULL != wifiEventPtr)
     {
-        LE_INFO("Event: %d", *wifiEventPtr);
-        ApHandlerFunc(*wifiEventPtr, le_event_GetContextPtr());
+        LE_INFO("Event: %d", wifiEventPtr->event);
+        ApHandlerFunc(wifiEventPtr->event, le_event_GetContextPtr());
     }
     else
     {
@@ -264,50 +724,122 @@ static void FirstLayerWifiApEventHandler
 
 //--------------------------------------------------------------------------------------------------
 /**
- * WiFi access point platform adaptor thread
+ * The first-layer WiFi access point event handler, with the MAC address of the station.
  *
  */
 //--------------------------------------------------------------------------------------------------
-static void *WifiApPaThreadMain
+static void FirstLayerWifiApEventIndHandler
 (
-    void *contextPtr
+    void *reportPtr,
+    void *secondLayerHandlerFunc
 )
 {
-    char path[1024];
-
-    LE_INFO("Wifi event report thread started!");
-
-    // Open the command "iw events" for reading.
-    IwThreadPipePtr = popen(WIFI_SCRIPT_PATH COMMAND_WIFI_SET_EVENT, "r");
+    pa_wifiAp_EventIndHandlerFunc_t  ApHandlerFunc = secondLayerHandlerFunc;
+    le_wifiAp_EventInd_t            *wifiEventPtr  = (le_wifiAp_EventInd_t *)reportPtr;
 
-    if (NULL == IwThreadPipePtr)
+    if (NULL != wifiEventPtr)
     {
-        LE_ERROR("Failed to run command:\"%s\" errno:%d %s",
-                COMMAND_WIFI_SET_EVENT,
-                errno,
-                strerror(errno));
-        return NULL;
+        LE_INFO("Event: %d, station: %s", wifiEventPtr->event, wifiEventPtr->macAddr);
+        ApHandlerFunc(wifiEventPtr, le_event_GetContextPtr());
     }
-
-    // Read the output a line at a time - output it.
-    while (NULL != fgets(path, sizeof(path)-1, IwThreadPipePtr))
+    else
     {
-        LE_INFO("PARSING:%s: len:%d", path, (int) strnlen(path, sizeof(path)-1));
-        if (NULL != strstr(path, "new station"))
-        {
-            LE_INFO("FOUND new station");
-            // Report event: LE_WIFIAP_EVENT_CONNECTED
-            le_wifiAp_Event_t event = LE_WIFIAP_EVENT_CLIENT_CONNECTED;
-            LE_INFO( "InternalWifiApStateEvent event: %d ", event);
-            le_event_Report(WifiApPaEvent , (void *)&event, sizeof(le_wifiAp_Event_t));
-        }
+        LE_ERROR("Event is NULL");
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Report a station event, the MAC address of the station following the given keyword in the line
+ * of "iw event", e.g. "wlan0: new station 12:34:56:78:9a:bc".
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReportStationEvent
+(
+    le_wifiAp_Event_t event,
+    const char *linePtr,
+    const char *keywordPtr
+)
+{
+    le_wifiAp_EventInd_t  wifiEvent;
+    const char           *macPtr = strstr(linePtr, keywordPtr);
+
+    memset(&wifiEvent, 0, sizeof(wifiEvent));
+    wifiEvent.event = event;
+    if (NULL != macPtr)
+    {
+        macPtr += strlen(keywordPtr);
+        while (' ' == *macPtr)
+        {
+            macPtr++;
+        }
+        strncpy(wifiEvent.macAddr, macPtr, LE_WIFIDEFS_MAX_BSSID_LENGTH);
+        wifiEvent.macAddr[strcspn(wifiEvent.macAddr, " \r\n")] = '\0';
+    }
+    LE_INFO("InternalWifiApStateEvent event: %d, station: %s", event, wifiEvent.macAddr);
+    le_event_Report(WifiApPaEvent, &wifiEvent, sizeof(wifiEvent));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * WiFi access point platform adaptor thread
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void *WifiApPaThreadMain
+(
+    void *contextPtr
+)
+{
+    char path[1024];
+
+    LE_INFO("Wifi event report thread started!");
+
+    // Open the command "iw events" for reading.
+    IwThreadPipePtr = OpenScript(COMMAND_WIFI_SET_EVENT);
+
+    if (NULL == IwThreadPipePtr)
+    {
+        LE_ERROR("Failed to run command:\"%s\" errno:%d %s",
+                COMMAND_WIFI_SET_EVENT,
+                errno,
+                strerror(errno));
+        return NULL;
+    }
+
+    // Read the output a line at a time - output it.
+    while (NULL != fgets(path, sizeof(path)-1, IwThreadPipePtr))
+    {
+        LE_INFO("PARSING:%s: len:%d", path, (int) strnlen(path, sizeof(path)-1));
+        // Skip the events of the station interface, which shares the radio in concurrent mode.
+        // The interface of the access point prefixes the ones of its additional BSS.
+        if (0 != strncmp(path, GetApInterface(), strlen(GetApInterface())))
+        {
+            continue;
+        }
+        if (NULL != strstr(path, "new station"))
+        {
+            LE_INFO("FOUND new station");
+            // Report event: LE_WIFIAP_EVENT_CONNECTED
+            ReportStationEvent(LE_WIFIAP_EVENT_CLIENT_CONNECTED, path, "new station");
+        }
         else if (NULL != strstr(path, "del station"))
         {
             LE_INFO("FOUND del station");
             // Report event: LE_WIFIAP_EVENT_DISCONNECTED
-            le_wifiAp_Event_t event = LE_WIFIAP_EVENT_CLIENT_DISCONNECTED;
-            LE_INFO("InternalWifiApStateEvent event: %d ", event);
-            le_event_Report(WifiApPaEvent , (void *)&event, sizeof(le_wifiAp_Event_t));
+            ReportStationEvent(LE_WIFIAP_EVENT_CLIENT_DISCONNECTED, path, "del station");
+        }
+        else if ((NULL != strstr(path, "channel switch")) && (NULL == strstr(path, "started")) &&
+                 ('_' != path[strlen(GetApInterface())]))
+        {
+            le_wifiAp_EventInd_t wifiEvent;
+
+            // The switch is reported once by the interface of the access point, not by the ones
+            // of its additional BSS.
+            LE_INFO("FOUND channel switch");
+            memset(&wifiEvent, 0, sizeof(wifiEvent));
+            wifiEvent.event = LE_WIFIAP_EVENT_CHANNEL_SWITCHED;
+            le_event_Report(WifiApPaEvent, &wifiEvent, sizeof(wifiEvent));
         }
     }
     // Run the event loop
@@ -349,48 +881,149 @@ static le_result_t WriteApCfgFile
 
 //--------------------------------------------------------------------------------------------------
 /**
- * This function writes configuration to hostapd.conf.
- *
- * @return LE_FAULT  The function failed.
- * @return LE_OK     The function succeeded.
+ * Get the value of a tuning parameter: its override, or else its value in the profile.
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t GenerateHostapdConf
+static int32_t GetTuningValue
 (
-    void
+    le_wifiAp_TuningParam_t param
 )
 {
-    char        tmpConfig[TEMP_STRING_MAX_BYTES];
-    le_result_t result = LE_FAULT;
-    FILE        *configFilePtr  = NULL;
+    if (TUNING_NOT_OVERRIDDEN != SavedTuningOverrides[param])
+    {
+        return SavedTuningOverrides[param];
+    }
+    return TuningProfiles[SavedProfile][param];
+}
 
-    configFilePtr = fopen(WIFI_HOSTAPD_FILE, "w");
-    if (NULL ==  configFilePtr)
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the PHY settings of the access point on its channel, bounded by the capabilities of the radio
+ * if they are known: the 40 MHz width requires IEEE 802.11n and the 80 MHz width IEEE 802.11ac in
+ * the 5 GHz band.
+ */
+//--------------------------------------------------------------------------------------------------
+static void BuildPhyConfig
+(
+    PhyConfig_t *configPtr
+)
+{
+    le_wifiAp_PhyCapBitMask_t htCapMask  = SavedPhyCapMask;
+    le_wifiAp_PhyCapBitMask_t vhtCapMask = SavedPhyCapMask;
+    uint16_t                  channel    = SavedChannelNumber;
+    bool                      isBandA    = ((SavedIeeeStdMask & HARDWARE_MODE_MASK) ==
+                                            LE_WIFIAP_BITMASK_IEEE_STD_A);
+
+    memset(configPtr, 0, sizeof(*configPtr));
+    configPtr->width = SavedChannelWidth;
+    if (PhyCaps.isKnown)
     {
-        LE_ERROR("Unable to create hostapd.conf file.");
-        return LE_FAULT;
+        htCapMask &= PhyCaps.htCapMask;
+        vhtCapMask &= PhyCaps.vhtCapMask;
+        if (configPtr->width > PhyCaps.maxWidth)
+        {
+            configPtr->width = PhyCaps.maxWidth;
+        }
+    }
+    if ((LE_WIFIAP_CHANNEL_WIDTH_80_MHZ == configPtr->width) &&
+        ((!isBandA) || (!(SavedIeeeStdMask & LE_WIFIAP_BITMASK_IEEE_STD_AC)) ||
+         (channel < 36) || (165 <= channel)))
+    {
+        configPtr->width = LE_WIFIAP_CHANNEL_WIDTH_40_MHZ;
+    }
+    if ((LE_WIFIAP_CHANNEL_WIDTH_40_MHZ == configPtr->width) &&
+        ((!(SavedIeeeStdMask & LE_WIFIAP_BITMASK_IEEE_STD_N)) || (165 <= channel) ||
+         ((isBandA) && (channel < 36)) ||
+         (LE_WIFIAP_BITMASK_IEEE_STD_AD == (SavedIeeeStdMask & HARDWARE_MODE_MASK))))
+    {
+        configPtr->width = LE_WIFIAP_CHANNEL_WIDTH_20_MHZ;
+    }
+    if (configPtr->width != SavedChannelWidth)
+    {
+        LE_WARN("Channel width %d not supported on channel %d, using %d",
+                SavedChannelWidth, channel, configPtr->width);
     }
 
-    memset(tmpConfig, '\0', sizeof(tmpConfig));
-    // prepare SSID, channel, country code etc in hostapd.conf
-    snprintf(tmpConfig, sizeof(tmpConfig), (HOSTAPD_CONFIG_COMMON
-            "ssid=%s\nchannel=%d\nmax_num_sta=%d\ncountry_code=%s\nignore_broadcast_ssid=%d\n"),
-            (char *)SavedSsid,
-            SavedChannelNumber,
-            SavedMaxNumClients,
-            (char *)SavedCountryCode,
-            !SavedDiscoverable);
-    // Write common config such as SSID, channel, country code, etc in hostapd.conf
-    tmpConfig[TEMP_STRING_MAX_BYTES - 1] = '\0';
-    if (LE_OK != WriteApCfgFile(tmpConfig, configFilePtr))
+    configPtr->centerChannel = channel;
+    if (LE_WIFIAP_CHANNEL_WIDTH_20_MHZ != configPtr->width)
     {
-        LE_ERROR("Unable to set SSID, channel, etc in hostapd.conf");
-        goto error;
+        // The 40 MHz pairs are 36+40, 44+48, ... and 149+153, ... in the 5 GHz band. In the
+        // 2.4 GHz band, the secondary channel is above up to channel 7 and below from channel 8.
+        if (isBandA)
+        {
+            configPtr->secondaryOffset = (0 == (((channel >= 149) ? channel - 149 :
+                                                                    channel - 36) / 4) % 2) ? 1 : -1;
+        }
+        else
+        {
+            configPtr->secondaryOffset = (channel <= 7) ? 1 : -1;
+        }
+        configPtr->centerChannel = channel + (2 * configPtr->secondaryOffset);
+    }
+    if (LE_WIFIAP_CHANNEL_WIDTH_80_MHZ == configPtr->width)
+    {
+        // The 80 MHz blocks are 36-48, 52-64, ... and 149-161
+        configPtr->centerChannel = (channel >= 149) ? 155 : 36 + (((channel - 36) / 16) * 16) + 6;
     }
 
-    memset(tmpConfig, '\0', sizeof(tmpConfig));
-    // Write security parameters in hostapd.conf
-    switch (SavedSecurityProtocol)
+    if (LE_WIFIAP_CHANNEL_WIDTH_20_MHZ != configPtr->width)
+    {
+        le_utf8_Append(configPtr->htCapab, (configPtr->secondaryOffset > 0) ? "[HT40+]" : "[HT40-]",
+                       sizeof(configPtr->htCapab), NULL);
+    }
+    if (htCapMask & LE_WIFIAP_PHY_CAP_SHORT_GI)
+    {
+        le_utf8_Append(configPtr->htCapab, "[SHORT-GI-20]", sizeof(configPtr->htCapab), NULL);
+        if (LE_WIFIAP_CHANNEL_WIDTH_20_MHZ != configPtr->width)
+        {
+            le_utf8_Append(configPtr->htCapab, "[SHORT-GI-40]", sizeof(configPtr->htCapab), NULL);
+        }
+    }
+    if (htCapMask & LE_WIFIAP_PHY_CAP_LDPC)
+    {
+        le_utf8_Append(configPtr->htCapab, "[LDPC]", sizeof(configPtr->htCapab), NULL);
+    }
+    if (htCapMask & LE_WIFIAP_PHY_CAP_STBC)
+    {
+        le_utf8_Append(configPtr->htCapab, "[TX-STBC][RX-STBC1]", sizeof(configPtr->htCapab), NULL);
+    }
+
+    if ((vhtCapMask & LE_WIFIAP_PHY_CAP_SHORT_GI) &&
+        (LE_WIFIAP_CHANNEL_WIDTH_80_MHZ == configPtr->width))
+    {
+        le_utf8_Append(configPtr->vhtCapab, "[SHORT-GI-80]", sizeof(configPtr->vhtCapab), NULL);
+    }
+    if (vhtCapMask & LE_WIFIAP_PHY_CAP_LDPC)
+    {
+        le_utf8_Append(configPtr->vhtCapab, "[RXLDPC]", sizeof(configPtr->vhtCapab), NULL);
+    }
+    if (vhtCapMask & LE_WIFIAP_PHY_CAP_STBC)
+    {
+        le_utf8_Append(configPtr->vhtCapab, "[TX-STBC-2BY1][RX-STBC-1]",
+                       sizeof(configPtr->vhtCapab), NULL);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write the security parameters of a BSS in hostapd.conf.
+ *
+ * @return LE_FAULT  The function failed.
+ * @return LE_OK     The function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t WriteSecurityConf
+(
+    FILE                         *configFilePtr,
+    le_wifiAp_SecurityProtocol_t  securityProtocol,
+    const char                   *passphrasePtr,
+    const char                   *preSharedKeyPtr
+)
+{
+    char        tmpConfig[TEMP_STRING_MAX_BYTES];
+    le_result_t result;
+
+    switch (securityProtocol)
     {
         case LE_WIFIAP_SECURITY_NONE:
             LE_DEBUG("LE_WIFIAP_SECURITY_NONE");
@@ -399,17 +1032,17 @@ static le_result_t GenerateHostapdConf
 
         case LE_WIFIAP_SECURITY_WPA2:
             LE_DEBUG("LE_WIFIAP_SECURITY_WPA2");
-            if ('\0' != SavedPassphrase[0])
+            if ('\0' != passphrasePtr[0])
             {
                 snprintf(tmpConfig, sizeof(tmpConfig), (HOSTAPD_CONFIG_SECURITY_WPA2
-                        "wpa_passphrase=%s\n"), SavedPassphrase);
+                        "wpa_passphrase=%s\n"), passphrasePtr);
                 tmpConfig[TEMP_STRING_MAX_BYTES - 1] = '\0';
                 result = WriteApCfgFile(tmpConfig, configFilePtr);
             }
-            else if ('\0' != SavedPreSharedKey[0])
+            else if ('\0' != preSharedKeyPtr[0])
             {
                 snprintf(tmpConfig, sizeof(tmpConfig), (HOSTAPD_CONFIG_SECURITY_WPA2
-                        "wpa_psk=%s\n"), SavedPreSharedKey);
+                        "wpa_psk=%s\n"), preSharedKeyPtr);
                 tmpConfig[TEMP_STRING_MAX_BYTES - 1] = '\0';
                 result = WriteApCfgFile(tmpConfig, configFilePtr);
             }
@@ -426,6 +1059,110 @@ static le_result_t GenerateHostapdConf
             break;
     }
 
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the maximum number of stations accepted by hostapd: one more than the clients allowed when
+ * the most idle station is evicted for a new one, so that the new one can associate.
+ *
+ * @return The maximum number of stations.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t GetMaxNumSta
+(
+    void
+)
+{
+    uint32_t maxCapability = (0 != MaxNumClientsCapability) ? MaxNumClientsCapability :
+                                                               HOSTAPD_MAX_STA_COUNT;
+
+    if ((IsEvictIdleWhenFull) && (SavedMaxNumClients < maxCapability))
+    {
+        return SavedMaxNumClients + 1;
+    }
+    return SavedMaxNumClients;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function writes configuration to hostapd.conf.
+ *
+ * @return LE_FAULT  The function failed.
+ * @return LE_OK     The function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t GenerateHostapdConf
+(
+    void
+)
+{
+    char        tmpConfig[TEMP_STRING_MAX_BYTES];
+    char        admissionLines[64];
+    le_result_t result = LE_FAULT;
+    FILE        *configFilePtr  = NULL;
+    int         param;
+    int         bss;
+
+    configFilePtr = fopen(WIFI_HOSTAPD_FILE, "w");
+    if (NULL ==  configFilePtr)
+    {
+        LE_ERROR("Unable to create hostapd.conf file.");
+        return LE_FAULT;
+    }
+
+    memset(tmpConfig, '\0', sizeof(tmpConfig));
+    // prepare SSID, channel, country code etc in hostapd.conf
+    snprintf(tmpConfig, sizeof(tmpConfig), (HOSTAPD_CONFIG_COMMON
+            "ssid=%s\nchannel=%d\nmax_num_sta=%d\ncountry_code=%s\nignore_broadcast_ssid=%d\n"),
+            (char *)SavedSsid,
+            SavedChannelNumber,
+            (int)GetMaxNumSta(),
+            (char *)SavedCountryCode,
+            !SavedDiscoverable);
+    // Admission policy
+    snprintf(admissionLines, sizeof(admissionLines), "ap_max_inactivity=%" PRIu32 "\n",
+             SavedInactivitySec);
+    le_utf8_Append(tmpConfig, admissionLines, sizeof(tmpConfig), NULL);
+    if (0 != SavedMinAssocRssi)
+    {
+        snprintf(admissionLines, sizeof(admissionLines), "rssi_reject_assoc_rssi=%d\n",
+                 SavedMinAssocRssi);
+        le_utf8_Append(tmpConfig, admissionLines, sizeof(tmpConfig), NULL);
+    }
+    if (LE_WIFIAP_UPLINK_BRIDGE == SavedUplinkMode)
+    {
+        // hostapd adds the WiFi interface to the bridge
+        le_utf8_Append(tmpConfig, "bridge=" WIFIAP_BRIDGE_INTERFACE "\n", sizeof(tmpConfig), NULL);
+    }
+    // Write common config such as SSID, channel, country code, etc in hostapd.conf
+    tmpConfig[TEMP_STRING_MAX_BYTES - 1] = '\0';
+    if (LE_OK != WriteApCfgFile(tmpConfig, configFilePtr))
+    {
+        LE_ERROR("Unable to set SSID, channel, etc in hostapd.conf");
+        goto error;
+    }
+
+    // Write the tuning parameters of the profile, or their overrides, in hostapd.conf
+    memset(tmpConfig, '\0', sizeof(tmpConfig));
+    for (param = 0; param < TUNING_PARAM_COUNT; param++)
+    {
+        char paramLine[64];
+
+        snprintf(paramLine, sizeof(paramLine), "%s=%" PRId32 "\n",
+                 TuningParams[param].namePtr, GetTuningValue(param));
+        le_utf8_Append(tmpConfig, paramLine, sizeof(tmpConfig), NULL);
+    }
+    if (LE_OK != WriteApCfgFile(tmpConfig, configFilePtr))
+    {
+        LE_ERROR("Unable to set tuning parameters in hostapd.conf");
+        goto error;
+    }
+
+    // Write security parameters in hostapd.conf
+    result = WriteSecurityConf(configFilePtr, SavedSecurityProtocol, SavedPassphrase,
+                               SavedPreSharedKey);
     // Write security parameters in hostapd.conf
     if (LE_OK != result)
     {
@@ -479,6 +1216,33 @@ static le_result_t GenerateHostapdConf
     {
         le_utf8_Append(tmpConfig, "ieee80211w=1\n", sizeof(tmpConfig), NULL);
     }
+    if ( SavedIeeeStdMask & (LE_WIFIAP_BITMASK_IEEE_STD_N | LE_WIFIAP_BITMASK_IEEE_STD_AC |
+                             LE_WIFIAP_BITMASK_IEEE_STD_AX) )
+    {
+        PhyConfig_t phyConfig;
+        char        phyLines[TEMP_STRING_MAX_BYTES];
+        int         operWidth;
+
+        BuildPhyConfig(&phyConfig);
+        // The operating width of VHT and HE: 0 for 20 or 40 MHz, 1 for 80 MHz
+        operWidth = (LE_WIFIAP_CHANNEL_WIDTH_80_MHZ == phyConfig.width) ? 1 : 0;
+        snprintf(phyLines, sizeof(phyLines), "ht_capab=%s\n", phyConfig.htCapab);
+        le_utf8_Append(tmpConfig, phyLines, sizeof(tmpConfig), NULL);
+        if ( SavedIeeeStdMask & LE_WIFIAP_BITMASK_IEEE_STD_AC )
+        {
+            snprintf(phyLines, sizeof(phyLines),
+                     "vht_capab=%s\nvht_oper_chwidth=%d\nvht_oper_centr_freq_seg0_idx=%d\n",
+                     phyConfig.vhtCapab, operWidth, phyConfig.centerChannel);
+            le_utf8_Append(tmpConfig, phyLines, sizeof(tmpConfig), NULL);
+        }
+        if ( SavedIeeeStdMask & LE_WIFIAP_BITMASK_IEEE_STD_AX )
+        {
+            snprintf(phyLines, sizeof(phyLines),
+                     "he_oper_chwidth=%d\nhe_oper_centr_freq_seg0_idx=%d\n",
+                     operWidth, phyConfig.centerChannel);
+            le_utf8_Append(tmpConfig, phyLines, sizeof(tmpConfig), NULL);
+        }
+    }
     // Write IEEE std in hostapd.conf
     tmpConfig[TEMP_STRING_MAX_BYTES - 1] = '\0';
     if (LE_OK != WriteApCfgFile(tmpConfig, configFilePtr))
@@ -486,6 +1250,31 @@ static le_result_t GenerateHostapdConf
         LE_ERROR("Unable to set IEEE std in hostapd.conf");
         goto error;
     }
+
+    // Write the additional BSS, sharing the radio settings above
+    for (bss = 0; bss < PA_WIFIAP_MAX_BSS; bss++)
+    {
+        const Bss_t *bssPtr = &BssList[bss];
+
+        if (!bssPtr->isCreated)
+        {
+            continue;
+        }
+        snprintf(tmpConfig, sizeof(tmpConfig), "bss=%s\nssid=%s\nmax_num_sta=%" PRIu32 "\n",
+                 bssPtr->ifName, bssPtr->ssid, bssPtr->maxNumClients);
+        if (LE_WIFIAP_UPLINK_BRIDGE == SavedUplinkMode)
+        {
+            le_utf8_Append(tmpConfig, "bridge=" WIFIAP_BRIDGE_INTERFACE "\n", sizeof(tmpConfig),
+                           NULL);
+        }
+        if ((LE_OK != WriteApCfgFile(tmpConfig, configFilePtr)) ||
+            (LE_OK != WriteSecurityConf(configFilePtr, bssPtr->securityProtocol,
+                                        bssPtr->passphrase, bssPtr->preSharedKey)))
+        {
+            LE_ERROR("Unable to set BSS %s in hostapd.conf", bssPtr->ifName);
+            goto error;
+        }
+    }
     fclose(configFilePtr);
     return LE_OK;
 
@@ -496,856 +1285,4551 @@ error:
     return LE_FAULT;
 }
 
-#ifdef SIMU
-// SIMU variable for timers
-static le_timer_Ref_t SimuClientConnectTimer = NULL;
-
 //--------------------------------------------------------------------------------------------------
 /**
- * This function generates a WiFi Access Point Event if callback event handler is set.
+ * Send a request to hostapd through the control interface of a BSS and wait for the reply.
+ *
+ * @return LE_FAULT  The function failed.
+ * @return LE_OK     The function succeeded.
  */
 //--------------------------------------------------------------------------------------------------
-static void GenerateApEvent
+static le_result_t HostapdRequest
 (
-    le_wifiAp_Event_t wifiApEvent
+    const char *ifNamePtr,
+    const char *cmdPtr,
+    char       *replyPtr,
+    size_t      replySize
 )
 {
-    if (NULL != CallBackHandlerFuncPtr)
+    struct sockaddr_un localAddr = { .sun_family = AF_UNIX };
+    struct sockaddr_un ctrlAddr  = { .sun_family = AF_UNIX };
+    struct pollfd      pfd;
+    le_result_t        result    = LE_FAULT;
+    ssize_t            length;
+    int                fd;
+
+    fd = socket(AF_UNIX, SOCK_DGRAM, 0);
+    if (fd < 0)
     {
-        CallBackHandlerFuncPtr(wifiApEvent);
+        LE_ERROR("Unable to create the control socket: %m");
+        return LE_FAULT;
     }
-}
 
-//--------------------------------------------------------------------------------------------------
-/**
- * SIMULATION! Simulates a LE_WIFIAP_EVENT_CLIENT_CONNECTED event
- */
-//--------------------------------------------------------------------------------------------------
-static void SimuClientConnectTimeCallBack
-(
-    le_timer_Ref_t timerRef
-)
-{
-    GenerateApEvent(LE_WIFIAP_EVENT_CLIENT_CONNECTED);
+    snprintf(localAddr.sun_path, sizeof(localAddr.sun_path), HOSTAPD_CTRL_LOCAL_PATH,
+             (int)getpid());
+    unlink(localAddr.sun_path);
+    snprintf(ctrlAddr.sun_path, sizeof(ctrlAddr.sun_path), HOSTAPD_CTRL_DIR "%s", ifNamePtr);
+
+    if ((0 != bind(fd, (struct sockaddr *)&localAddr, sizeof(localAddr))) ||
+        (0 != connect(fd, (struct sockaddr *)&ctrlAddr, sizeof(ctrlAddr))))
+    {
+        LE_ERROR("Unable to reach hostapd at %s: %m", ctrlAddr.sun_path);
+        goto end;
+    }
+
+    if (send(fd, cmdPtr, strlen(cmdPtr), 0) < 0)
+    {
+        LE_ERROR("Unable to send the request to hostapd: %m");
+        goto end;
+    }
+
+    pfd.fd = fd;
+    pfd.events = POLLIN;
+    while (poll(&pfd, 1, HOSTAPD_CTRL_TIMEOUT_MS) > 0)
+    {
+        length = recv(fd, replyPtr, replySize - 1, 0);
+        if (length < 0)
+        {
+            break;
+        }
+        replyPtr[length] = '\0';
+        // Skip the unsolicited event messages, starting with their level
+        if ('<' != replyPtr[0])
+        {
+            result = LE_OK;
+            break;
+        }
+    }
+
+    if (LE_OK != result)
+    {
+        LE_ERROR("No reply from hostapd");
+    }
+
+end:
+    close(fd);
+    unlink(localAddr.sun_path);
+    return result;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * This function activates some timers to simulate client connect/disconnect events.
+ * Send a command to hostapd through the control interface of a BSS.
+ *
+ * @return LE_FAULT  The command failed.
+ * @return LE_OK     The command succeeded.
  */
 //--------------------------------------------------------------------------------------------------
-
-static void StartApSimulation(void)
+static le_result_t HostapdBssCommand
+(
+    const char *ifNamePtr,
+    const char *cmdPtr
+)
 {
-    // once every 10 seconds...
-    le_clk_Time_t interval = { 10, 0 };
-    SimuClientConnectTimer = le_timer_Create("WiFi Simu AP Connect Timer");
-
-    LE_INFO("Timer: %p", SimuClientConnectTimer);
+    char reply[HOSTAPD_REPLY_MAX_BYTES];
 
-    if (LE_OK != le_timer_SetHandler(SimuClientConnectTimer, SimuClientConnectTimeCallBack))
+    if (LE_OK != HostapdRequest(ifNamePtr, cmdPtr, reply, sizeof(reply)))
     {
-        LE_ERROR("ERROR: StartApSimulation le_timer_SetHandler failed.");
+        return LE_FAULT;
     }
-    if (LE_OK != le_timer_SetInterval(SimuClientConnectTimer, interval))
+    if (0 != strncmp(reply, "OK", 2))
     {
-        LE_ERROR("ERROR: StartApSimulation le_timer_SetInterval failed.");
+        LE_ERROR("hostapd rejected the command: %s", reply);
+        return LE_FAULT;
     }
+    return LE_OK;
+}
 
-    //repeat 5 times
-    if (LE_OK != le_timer_SetRepeat(SimuClientConnectTimer, 5))
-    {
-        LE_ERROR("ERROR: StartApSimulation le_timer_SetInterval failed.");
-    }
-    if (LE_OK != le_timer_Start(SimuClientConnectTimer))
-    {
-        LE_ERROR("ERROR: StartApSimulation le_timer_SetInterval failed.");
-    }
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send a command to hostapd through the control interface of the access point.
+ *
+ * @return LE_FAULT  The command failed.
+ * @return LE_OK     The command succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t HostapdCommand
+(
+    const char *cmdPtr
+)
+{
+    return HostapdBssCommand(GetApInterface(), cmdPtr);
 }
-#endif
 
 //--------------------------------------------------------------------------------------------------
-// Public declarations
+/**
+ * Set a configuration parameter of a BSS of the running hostapd. The value is not logged as it
+ * may be a secret.
+ *
+ * @return LE_FAULT  The function failed.
+ * @return LE_OK     The function succeeded.
+ */
 //--------------------------------------------------------------------------------------------------
+static le_result_t HostapdBssSet
+(
+    const char *ifNamePtr,
+    const char *namePtr,
+    const char *valuePtr
+)
+{
+    char cmd[TEMP_STRING_MAX_BYTES];
+
+    LE_DEBUG("hostapd SET %s on %s", namePtr, ifNamePtr);
+    snprintf(cmd, sizeof(cmd), "SET %s %s", namePtr, valuePtr);
+    return HostapdBssCommand(ifNamePtr, cmd);
+}
 
 //--------------------------------------------------------------------------------------------------
 /**
- * This function must be called to initialize the WiFi module platform adapter (PA).
+ * Set a configuration parameter of the access point in the running hostapd. The value is not
+ * logged as it may be a secret.
  *
  * @return LE_FAULT  The function failed.
  * @return LE_OK     The function succeeded.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t pa_wifiAp_Init
+static le_result_t HostapdSet
 (
-    void
+    const char *namePtr,
+    const char *valuePtr
 )
 {
-    le_result_t result       = LE_FAULT;
-    int         systemResult;
+    return HostapdBssSet(GetApInterface(), namePtr, valuePtr);
+}
 
-    LE_INFO("pa_wifiAp_Init() called");
-    // Create the event for signaling user handlers.
-    WifiApPaEvent = le_event_CreateId("WifiApPaEvent", sizeof(le_wifiAp_Event_t));
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the security parameters of a BSS of the running hostapd. A WPA2 passphrase or PSK must be
+ * known.
+ *
+ * @return LE_FAULT  The function failed.
+ * @return LE_OK     The function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t HostapdSetSecurity
+(
+    const char                   *ifNamePtr,
+    le_wifiAp_SecurityProtocol_t  securityProtocol,
+    const char                   *passphrasePtr,
+    const char                   *preSharedKeyPtr
+)
+{
+    le_result_t result;
 
-    systemResult = system("chmod 755 " WIFI_SCRIPT_PATH);
+    if (LE_WIFIAP_SECURITY_WPA2 != securityProtocol)
+    {
+        return HostapdBssSet(ifNamePtr, "wpa", "0");
+    }
 
-    if (0 == WEXITSTATUS (systemResult))
+    if ('\0' != passphrasePtr[0])
     {
-        LE_INFO("WiFi Access Point Command OK: chmod");
-        result = LE_OK;
+        result = HostapdBssSet(ifNamePtr, "wpa_passphrase", passphrasePtr);
     }
     else
     {
-        LE_ERROR("WiFi Access Point Command Failed: chmod (%d)", systemResult);
-        result = LE_FAULT;
+        result = HostapdBssSet(ifNamePtr, "wpa_psk", preSharedKeyPtr);
     }
 
-    return result;
+    if ((LE_OK != result) ||
+        (LE_OK != HostapdBssSet(ifNamePtr, "wpa_key_mgmt", "WPA-PSK")) ||
+        (LE_OK != HostapdBssSet(ifNamePtr, "wpa_pairwise", "CCMP")) ||
+        (LE_OK != HostapdBssSet(ifNamePtr, "rsn_pairwise", "CCMP")) ||
+        (LE_OK != HostapdBssSet(ifNamePtr, "wpa", "2")))
+    {
+        return LE_FAULT;
+    }
+    return LE_OK;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * This function must be called to release the WiFi module platform adapter (PA).
+ * Apply the parameters set into the running hostapd. hostapd.conf is generated again so that a
+ * later start uses them as well.
  *
+ * @return LE_FAULT  The function failed.
  * @return LE_OK     The function succeeded.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t pa_wifiAp_Release
+static le_result_t ReloadHostapd
 (
-    void
+    bool isReloadNeeded
+        ///< [IN]
+        ///< The access point must be restarted by hostapd for the parameters to take effect.
 )
 {
-    LE_INFO("AP release called");
-    return LE_OK;
+    if (LE_OK != GenerateHostapdConf())
+    {
+        LE_WARN("Unable to keep hostapd.conf up to date");
+    }
+    return (isReloadNeeded ? HostapdCommand("RELOAD") : LE_OK);
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * This function starts the WiFi access point.
- * Note that all settings, if to be used, such as security, username, password must set prior to
- * starting the access point.
- *
- * @return LE_FAULT         The function failed.
- * @return LE_OK            The function succeeded.
- * @return LE_NOT_FOUND     The WiFi card is absent.
- * @return LE_NOT_POSSIBLE  The WiFi card may not work.
+ * Apply a configuration parameter to the access point if started.
  *
+ * @return LE_FAULT  The function failed.
+ * @return LE_OK     The function succeeded, or the access point is not started.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t pa_wifiAp_Start
+static le_result_t ApplyHostapdParameter
 (
-    void
+    const char *namePtr,
+    const char *valuePtr,
+    bool        isReloadNeeded
 )
 {
-    int     systemResult;
-
-    // Check that an SSID is provided before starting
-    if ('\0' == SavedSsid[0])
+    if (!IsHostapdStarted)
+    {
+        return LE_OK;
+    }
+    if (LE_OK != HostapdSet(namePtr, valuePtr))
     {
-        LE_ERROR("Unable to start AP because no valid SSID provided");
         return LE_FAULT;
     }
+    return ReloadHostapd(isReloadNeeded);
+}
 
-    // Check channel number is properly set before starting
-    if ((SavedChannelNumber < MIN_CHANNEL_VALUE) ||
-            (SavedChannelNumber > MAX_CHANNEL_VALUE))
+//--------------------------------------------------------------------------------------------------
+/**
+ * Restore the previous value of a configuration parameter the started access point failed to
+ * apply. hostapd has not been restarted with the new value: the previous one is set back into it
+ * and into hostapd.conf.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RestoreHostapdParameter
+(
+    const char *namePtr,
+    const char *valuePtr
+)
+{
+    if (LE_OK != ApplyHostapdParameter(namePtr, valuePtr, false))
     {
-        LE_ERROR("Unable to start AP because no valid channel number provided");
-        return LE_FAULT;
+        LE_WARN("Unable to restore %s", namePtr);
     }
+}
 
-    LE_DEBUG("Starting AP, SSID: %s", SavedSsid);
+//--------------------------------------------------------------------------------------------------
+/**
+ * Apply the security parameters to the access point if started. WPA2 is applied only once a
+ * passphrase or a PSK is known.
+ *
+ * @return LE_FAULT  The function failed.
+ * @return LE_OK     The function succeeded, or the access point is not started.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ApplyHostapdSecurity
+(
+    bool isReloadNeeded
+        ///< [IN]
+        ///< The access point must be restarted by hostapd, false to only restore the parameters.
+)
+{
+    if (!IsHostapdStarted)
+    {
+        return LE_OK;
+    }
+    if ((LE_WIFIAP_SECURITY_WPA2 == SavedSecurityProtocol) &&
+        ('\0' == SavedPassphrase[0]) && ('\0' == SavedPreSharedKey[0]))
+    {
+        LE_INFO("WPA2 applied once the passphrase or the PSK is set");
+        return LE_OK;
+    }
 
-    // Create hostapd.conf file in /tmp
-    if ( LE_OK != GenerateHostapdConf())
+    if (LE_OK != HostapdSetSecurity(GetApInterface(), SavedSecurityProtocol, SavedPassphrase,
+                                    SavedPreSharedKey))
     {
-        LE_ERROR("Failed to generate hostapd.conf");
         return LE_FAULT;
     }
 
-    systemResult = system(WIFI_SCRIPT_PATH COMMAND_WIFI_HW_START);
-    /**
-     * Returned values:
-     *   0: if the interface is correctly moutned
-     *  50: if WiFi card is not inserted
-     * 100: if WiFi card may not work
-     * 127: if driver can not be installed
-     *  -1: if the fork() has failed (see man system)
-     */
+    return ReloadHostapd(isReloadNeeded);
+}
 
-    if (0 == WEXITSTATUS(systemResult))
+//--------------------------------------------------------------------------------------------------
+/**
+ * Restore the previous security parameters once the started access point failed to apply new
+ * ones, into hostapd and into hostapd.conf.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RestoreHostapdSecurity
+(
+    void
+)
+{
+    if (LE_OK != ApplyHostapdSecurity(false))
     {
-        LE_DEBUG("WiFi hardware started correctly");
-        // Create WiFi AP PA Thread
-        WifiApPaThread = le_thread_Create("WifiApPaThread", WifiApPaThreadMain, NULL);
-        le_thread_SetJoinable(WifiApPaThread);
-        le_thread_AddChildDestructor(WifiApPaThread, ThreadDestructor, NULL);
-        le_thread_Start(WifiApPaThread);
+        LE_WARN("Unable to restore the security parameters");
     }
-    // Return value of 50 means WiFi card is not inserted.
-    else if ( PA_NOT_FOUND == WEXITSTATUS(systemResult))
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the center frequency of a channel in the current hardware mode.
+ *
+ * @return The frequency in MHz.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t ChannelToFrequency
+(
+    uint16_t channelNumber
+)
+{
+    switch (SavedIeeeStdMask & HARDWARE_MODE_MASK)
     {
-        LE_ERROR("WiFi card is not inserted");
-        return LE_NOT_FOUND;
+        case LE_WIFIAP_BITMASK_IEEE_STD_A:
+            if (channelNumber >= CHANNEL_4_9_GHZ_MIN)
+            {
+                // Public safety band, from 4.91 GHz
+                return 4000 + (5 * channelNumber);
+            }
+            return 5000 + (5 * channelNumber);
+        case LE_WIFIAP_BITMASK_IEEE_STD_AD:
+            return 56160 + (2160 * channelNumber);
+        default:
+            return (14 == channelNumber) ? 2484 : 2407 + (5 * channelNumber);
     }
-    // Return value of 100 means WiFi card may not work.
-    else if ( PA_NOT_POSSIBLE == WEXITSTATUS(systemResult))
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Announce a channel switch (CSA) to the stations of the started access point in the given number
+ * of beacons, so that they follow without being disconnected. LE_WIFIAP_EVENT_CHANNEL_SWITCHED is
+ * reported once the access point is on the new channel.
+ *
+ * @return LE_UNSUPPORTED  The driver does not support the channel switch.
+ * @return LE_FAULT        The function failed.
+ * @return LE_OK           The function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t SwitchHostapdChannel
+(
+    uint16_t channelNumber,
+    uint8_t  beaconCount
+)
+{
+    char        cmd[TEMP_STRING_MAX_BYTES];
+    PhyConfig_t phyConfig;
+
+    BuildPhyConfig(&phyConfig);
+    snprintf(cmd, sizeof(cmd), "CHAN_SWITCH %u %u", beaconCount,
+             ChannelToFrequency(channelNumber));
+    if (LE_WIFIAP_CHANNEL_WIDTH_20_MHZ != phyConfig.width)
     {
-        LE_ERROR("Unable to reset WiFi card");
-        return LE_NOT_POSSIBLE;
+        char widthParams[64];
+
+        snprintf(widthParams, sizeof(widthParams),
+                 " sec_channel_offset=%d center_freq1=%u bandwidth=%d",
+                 phyConfig.secondaryOffset, ChannelToFrequency(phyConfig.centerChannel),
+                 (LE_WIFIAP_CHANNEL_WIDTH_80_MHZ == phyConfig.width) ? 80 : 40);
+        le_utf8_Append(cmd, widthParams, sizeof(cmd), NULL);
     }
-    // WiFi card failed to start.
-    else
+    le_utf8_Append(cmd, (SavedIeeeStdMask & LE_WIFIAP_BITMASK_IEEE_STD_N) ? " ht" : "",
+                   sizeof(cmd), NULL);
+    le_utf8_Append(cmd, (SavedIeeeStdMask & LE_WIFIAP_BITMASK_IEEE_STD_AC) ? " vht" : "",
+                   sizeof(cmd), NULL);
+    if (LE_OK != HostapdCommand(cmd))
     {
-        LE_WARN("Failed to start WiFi AP command \"%s\" systemResult (%d)",
-                COMMAND_WIFI_HW_START, systemResult);
-        return LE_FAULT;
+        return LE_UNSUPPORTED;
     }
 
-    // Start Access Point cmd: /bin/hostapd /etc/hostapd.conf
-    systemResult = system(WIFI_SCRIPT_PATH COMMAND_WIFIAP_HOSTAPD_START);
-    if ((!WIFEXITED(systemResult)) || (0 != WEXITSTATUS(systemResult)))
+    LE_INFO("Switching to channel %d in %u beacons", channelNumber, beaconCount);
+    return ReloadHostapd(false);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Move the access point to another channel, which becomes the saved channel. If started, the
+ * switch is announced to the stations in the beacons (CSA) so that they follow without being
+ * disconnected. If the driver does not support it, the access point is restarted by hostapd on the
+ * new channel. The previous channel is kept on failure.
+ *
+ * @return LE_FAULT  The function failed.
+ * @return LE_OK     The function succeeded, or the access point is not started.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ApplyHostapdChannel
+(
+    uint16_t channelNumber
+)
+{
+    uint16_t    previousChannel = SavedChannelNumber;
+    char        channel[8];
+    le_result_t result;
+
+    // The PHY configuration of the new channel is derived from the saved one
+    SavedChannelNumber = channelNumber;
+    if (!IsHostapdStarted)
     {
-        LE_ERROR("WiFi Client Command \"%s\" Failed: (%d)",
-                COMMAND_WIFIAP_HOSTAPD_START,
-                systemResult);
-        // Remove generated hostapd.conf file
-        remove(WIFI_HOSTAPD_FILE);
-        goto error;
+        return LE_OK;
     }
 
-    LE_INFO("WiFi AP started correclty");
-    return LE_OK;
+    result = SwitchHostapdChannel(channelNumber, HOSTAPD_CSA_BEACON_COUNT);
+    if (LE_UNSUPPORTED == result)
+    {
+        LE_WARN("Channel switch announcement failed, restarting the access point");
+        snprintf(channel, sizeof(channel), "%d", channelNumber);
+        result = ApplyHostapdParameter("channel", channel, true);
+    }
+    if (LE_OK != result)
+    {
+        SavedChannelNumber = previousChannel;
+        snprintf(channel, sizeof(channel), "%d", previousChannel);
+        RestoreHostapdParameter("channel", channel);
+    }
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the channel of a center frequency in the current hardware mode.
+ *
+ * @return The channel number, 0 if the frequency is not in the band of the hardware mode.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint16_t FrequencyToChannel
+(
+    uint32_t frequency
+)
+{
+    switch (SavedIeeeStdMask & HARDWARE_MODE_MASK)
+    {
+        case LE_WIFIAP_BITMASK_IEEE_STD_A:
+            if ((frequency >= (4000 + (5 * CHANNEL_4_9_GHZ_MIN))) && (frequency < 5000))
+            {
+                return (frequency - 4000) / 5;
+            }
+            return ((frequency > 5000) && (frequency < 5900)) ? (frequency - 5000) / 5 : 0;
+        case LE_WIFIAP_BITMASK_IEEE_STD_AD:
+            return (frequency > 56160) ? (frequency - 56160) / 2160 : 0;
+        default:
+            if (2484 == frequency)
+            {
+                return 14;
+            }
+            return ((frequency > 2407) && (frequency < 2484)) ? (frequency - 2407) / 5 : 0;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether the automatic channel selection may pick a channel: the non-overlapping channels
+ * in the 2.4 GHz band and the channels without radar detection (DFS) in the 5 GHz band.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsAutoChannelCandidate
+(
+    uint16_t channelNumber
+)
+{
+    switch (SavedIeeeStdMask & HARDWARE_MODE_MASK)
+    {
+        case LE_WIFIAP_BITMASK_IEEE_STD_A:
+            return ((channelNumber >= 36) && (channelNumber <= 48)) ||
+                   ((channelNumber >= 149) && (channelNumber <= 165));
+        case LE_WIFIAP_BITMASK_IEEE_STD_AD:
+            return (channelNumber >= LE_WIFIDEFS_MIN_CHANNEL_STD_AD) &&
+                   (channelNumber <= LE_WIFIDEFS_MAX_CHANNEL_STD_AD);
+        default:
+            return (1 == channelNumber) || (6 == channelNumber) || (11 == channelNumber);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the survey of a frequency, added if not known yet.
+ *
+ * @return The survey, NULL if the array is full.
+ */
+//--------------------------------------------------------------------------------------------------
+static ChannelSurvey_t *GetChannelSurvey
+(
+    ChannelSurvey_t *surveysPtr,
+    size_t *numSurveysPtr,
+    uint32_t frequency
+)
+{
+    size_t i;
+
+    for (i = 0; i < *numSurveysPtr; i++)
+    {
+        if (frequency == surveysPtr[i].frequency)
+        {
+            return &surveysPtr[i];
+        }
+    }
+    if (AUTO_CHANNEL_MAX <= *numSurveysPtr)
+    {
+        return NULL;
+    }
+    memset(&surveysPtr[*numSurveysPtr], 0, sizeof(ChannelSurvey_t));
+    surveysPtr[*numSurveysPtr].frequency = frequency;
+    return &surveysPtr[(*numSurveysPtr)++];
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Scan for the access points around and dump the survey of the channels: the time each channel
+ * was sensed busy and its noise floor.
+ *
+ * @return LE_FAULT The function failed.
+ * @return LE_OK    The function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t SurveyChannels
+(
+    ChannelSurvey_t *surveysPtr,
+    size_t *numSurveysPtr
+)
+{
+    const char freqPrefix[]      = "\tfreq:";
+    const char frequencyPrefix[] = "\tfrequency:";
+    const char noisePrefix[]     = "\tnoise:";
+    const char activePrefix[]    = "\tchannel active time:";
+    const char busyPrefix[]      = "\tchannel busy time:";
+    const char txPrefix[]        = "\tchannel transmit time:";
+    char             path[TEMP_STRING_MAX_BYTES];
+    FILE            *surveyPipePtr;
+    ChannelSurvey_t *surveyPtr = NULL;
+    int              st;
+
+    *numSurveysPtr = 0;
+    surveyPipePtr = OpenScript(COMMAND_WIFIAP_CHANNEL_SURVEY);
+    if (NULL == surveyPipePtr)
+    {
+        LE_ERROR("Failed to run command \"%s\": errno:%d: \"%s\" ",
+                COMMAND_WIFIAP_CHANNEL_SURVEY,
+                errno,
+                strerror(errno));
+        return LE_FAULT;
+    }
+
+    while (NULL != fgets(path, sizeof(path), surveyPipePtr))
+    {
+        if (0 == strncmp(freqPrefix, path, sizeof(freqPrefix) - 1))
+        {
+            // Frequency of an access point found by the scan
+            ChannelSurvey_t *apSurveyPtr = GetChannelSurvey(surveysPtr, numSurveysPtr,
+                                               strtoul(&path[sizeof(freqPrefix) - 1], NULL, 10));
+            if (NULL != apSurveyPtr)
+            {
+                apSurveyPtr->numAps++;
+            }
+        }
+        else if (0 == strncmp(frequencyPrefix, path, sizeof(frequencyPrefix) - 1))
+        {
+            surveyPtr = GetChannelSurvey(surveysPtr, numSurveysPtr,
+                                         strtoul(&path[sizeof(frequencyPrefix) - 1], NULL, 10));
+        }
+        else if (NULL == surveyPtr)
+        {
+            continue;
+        }
+        else if (0 == strncmp(noisePrefix, path, sizeof(noisePrefix) - 1))
+        {
+            surveyPtr->noise = strtol(&path[sizeof(noisePrefix) - 1], NULL, 10);
+        }
+        else if (0 == strncmp(activePrefix, path, sizeof(activePrefix) - 1))
+        {
+            surveyPtr->activeMs = strtoul(&path[sizeof(activePrefix) - 1], NULL, 10);
+        }
+        else if (0 == strncmp(busyPrefix, path, sizeof(busyPrefix) - 1))
+        {
+            surveyPtr->busyMs = strtoul(&path[sizeof(busyPrefix) - 1], NULL, 10);
+        }
+        else if (0 == strncmp(txPrefix, path, sizeof(txPrefix) - 1))
+        {
+            surveyPtr->txMs = strtoul(&path[sizeof(txPrefix) - 1], NULL, 10);
+        }
+    }
+
+    st = pclose(surveyPipePtr);
+    if (!WIFEXITED(st) || (0 != WEXITSTATUS(st)))
+    {
+        LE_ERROR("WiFi AP Command \"%s\" Failed: (%d)", COMMAND_WIFIAP_CHANNEL_SURVEY, st);
+        return LE_FAULT;
+    }
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the load of a surveyed channel, in percent of the time it was sensed busy by others than
+ * the access point itself since its previous sample.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t GetChannelLoad
+(
+    const ChannelSurvey_t *surveyPtr
+)
+{
+    uint32_t busyMs = surveyPtr->busyMs;
+
+    if (0 == surveyPtr->activeMs)
+    {
+        return 0;
+    }
+    busyMs = (busyMs > surveyPtr->txMs) ? busyMs - surveyPtr->txMs : 0;
+    return (busyMs >= surveyPtr->activeMs) ? 100 : (busyMs * 100) / surveyPtr->activeMs;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Score a surveyed channel: its load, the access points seen on it and its noise above the floor.
+ * The lower, the better.
+ */
+//--------------------------------------------------------------------------------------------------
+static int32_t ScoreChannel
+(
+    const ChannelSurvey_t *surveyPtr
+)
+{
+    int32_t score = GetChannelLoad(surveyPtr) + (AUTO_CHANNEL_AP_LOAD * surveyPtr->numAps);
+
+    if ((0 != surveyPtr->noise) && (surveyPtr->noise > AUTO_CHANNEL_NOISE_FLOOR))
+    {
+        score += surveyPtr->noise - AUTO_CHANNEL_NOISE_FLOOR;
+    }
+    return score;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Turn the cumulative counters of a survey into the ones elapsed since the previous sample of each
+ * channel, and save the new samples. The whole counters are kept for a channel without a previous
+ * sample, or whose counters were reset by the driver.
+ */
+//--------------------------------------------------------------------------------------------------
+static void UpdateSurveyDeltas
+(
+    ChannelSurvey_t *surveysPtr,
+    size_t numSurveys
+)
+{
+    size_t i;
+
+    for (i = 0; i < numSurveys; i++)
+    {
+        ChannelSurvey_t  sample = surveysPtr[i];
+        ChannelSurvey_t *previousPtr;
+
+        // Only the access points of the channel were seen by the scan
+        if (0 == sample.activeMs)
+        {
+            continue;
+        }
+        previousPtr = GetChannelSurvey(PreviousSurveys, &NumPreviousSurveys, sample.frequency);
+        if (NULL == previousPtr)
+        {
+            continue;
+        }
+        if ((sample.activeMs > previousPtr->activeMs) && (sample.busyMs >= previousPtr->busyMs) &&
+            (sample.txMs >= previousPtr->txMs))
+        {
+            surveysPtr[i].activeMs -= previousPtr->activeMs;
+            surveysPtr[i].busyMs -= previousPtr->busyMs;
+            surveysPtr[i].txMs -= previousPtr->txMs;
+        }
+        previousPtr->activeMs = sample.activeMs;
+        previousPtr->busyMs = sample.busyMs;
+        previousPtr->txMs = sample.txMs;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Select the least loaded channel from a survey of the channels, measured since the previous
+ * survey.
+ *
+ * @return LE_NOT_FOUND No channel could be surveyed.
+ * @return LE_OK        The function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t EvaluateChannels
+(
+    ChannelSurvey_t *surveysPtr,
+        ///< [IN] Surveys of the channels, with cumulative counters
+    size_t numSurveys,
+        ///< [IN] Number of channels surveyed
+    uint16_t *channelPtr,
+        ///< [OUT] The least loaded channel
+    int32_t *scorePtr,
+        ///< [OUT] Score of the least loaded channel
+    int32_t *currentScorePtr,
+        ///< [OUT] Score of the current channel, INT32_MAX if not surveyed
+    uint32_t *currentLoadPtr
+        ///< [OUT] Load in percent of the current channel, 0 if not surveyed
+)
+{
+    size_t i;
+
+    UpdateSurveyDeltas(surveysPtr, numSurveys);
+
+    *channelPtr = 0;
+    *scorePtr = INT32_MAX;
+    *currentScorePtr = INT32_MAX;
+    *currentLoadPtr = 0;
+    for (i = 0; i < numSurveys; i++)
+    {
+        uint16_t channelNumber = FrequencyToChannel(surveysPtr[i].frequency);
+        int32_t  score;
+
+        // Only the channels reported by the survey are allowed in the regulatory domain
+        if ((0 == surveysPtr[i].activeMs) || (!IsAutoChannelCandidate(channelNumber)))
+        {
+            continue;
+        }
+        score = ScoreChannel(&surveysPtr[i]);
+        LE_DEBUG("Channel %d: load %" PRIu32 "%%, %" PRIu32 " APs, noise %" PRId32 " dBm, score %"
+                 PRId32, channelNumber, GetChannelLoad(&surveysPtr[i]), surveysPtr[i].numAps,
+                 surveysPtr[i].noise, score);
+        if (channelNumber == SavedChannelNumber)
+        {
+            *currentScorePtr = score;
+            *currentLoadPtr = GetChannelLoad(&surveysPtr[i]);
+        }
+        if (score < *scorePtr)
+        {
+            *channelPtr = channelNumber;
+            *scorePtr = score;
+        }
+    }
+
+    return (0 == *channelPtr) ? LE_NOT_FOUND : LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Survey the channels and select the least loaded one.
+ *
+ * @return LE_NOT_FOUND No channel could be surveyed.
+ * @return LE_FAULT     The function failed.
+ * @return LE_OK        The function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t SelectAutoChannel
+(
+    uint16_t *channelPtr,
+        ///< [OUT] The least loaded channel
+    int32_t *scorePtr,
+        ///< [OUT] Score of the least loaded channel
+    int32_t *currentScorePtr,
+        ///< [OUT] Score of the current channel, INT32_MAX if not surveyed
+    uint32_t *currentLoadPtr
+        ///< [OUT] Load in percent of the current channel, 0 if not surveyed
+)
+{
+    static ChannelSurvey_t surveys[AUTO_CHANNEL_MAX];
+    size_t                 numSurveys;
+
+    if (LE_OK != SurveyChannels(surveys, &numSurveys))
+    {
+        return LE_FAULT;
+    }
+
+    return EvaluateChannels(surveys, numSurveys, channelPtr, scorePtr, currentScorePtr,
+                            currentLoadPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Worker thread of the periodic channel re-evaluation: run the scan and the survey of the
+ * channels, which block for seconds.
+ */
+//--------------------------------------------------------------------------------------------------
+static void *AutoChannelThread
+(
+    void *contextPtr
+)
+{
+    AutoChannelContext_t *autoChannelContextPtr = contextPtr;
+
+    autoChannelContextPtr->result = SurveyChannels(autoChannelContextPtr->surveys,
+                                                   &autoChannelContextPtr->numSurveys);
+    return NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Re-evaluate the channel of the started access point from the survey of the worker thread, and
+ * switch to the least loaded channel if the load of the current one crosses the threshold.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AutoChannelSurveyDone
+(
+    void *param1Ptr,
+    void *param2Ptr
+)
+{
+    AutoChannelContext_t *autoChannelContextPtr = param1Ptr;
+    uint16_t              channelNumber;
+    int32_t               score;
+    int32_t               currentScore;
+    uint32_t              currentLoad;
+
+    AutoChannelThreadRef = NULL;
+    if ((LE_OK != autoChannelContextPtr->result) || (!IsHostapdStarted) || (!IsAutoChannel) ||
+        (LE_OK != EvaluateChannels(autoChannelContextPtr->surveys,
+                                   autoChannelContextPtr->numSurveys,
+                                   &channelNumber, &score, &currentScore, &currentLoad)))
+    {
+        return;
+    }
+
+    if ((currentLoad < AutoChannelThreshold) || (channelNumber == SavedChannelNumber) ||
+        ((INT32_MAX != currentScore) && (score + AUTO_CHANNEL_HYSTERESIS >= currentScore)))
+    {
+        LE_DEBUG("Staying on channel %d, load %" PRIu32 "%%", SavedChannelNumber, currentLoad);
+        return;
+    }
+
+    LE_INFO("Channel %d loaded at %" PRIu32 "%%, moving to channel %d",
+            SavedChannelNumber, currentLoad, channelNumber);
+    if (LE_OK != ApplyHostapdChannel(channelNumber))
+    {
+        LE_ERROR("Unable to move to channel %d", channelNumber);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Thread destructor of the channel re-evaluation worker: the survey is evaluated by the thread of
+ * the WiFi service, which owns the settings of the access point.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AutoChannelThreadDestructor
+(
+    void *contextPtr
+)
+{
+    le_event_QueueFunctionToThread(MainThreadRef, AutoChannelSurveyDone, contextPtr, NULL);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start the periodic re-evaluation of the channel of the started access point in the worker
+ * thread, unless the previous one is still running.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AutoChannelTimerHandler
+(
+    le_timer_Ref_t timerRef
+)
+{
+    if ((!IsHostapdStarted) || (NULL != AutoChannelThreadRef))
+    {
+        return;
+    }
+
+    memset(&AutoChannelContext, 0, sizeof(AutoChannelContext));
+    AutoChannelContext.result = LE_FAULT;
+    AutoChannelThreadRef = le_thread_Create("WifiApAutoChannel", AutoChannelThread,
+                                            &AutoChannelContext);
+    le_thread_AddChildDestructor(AutoChannelThreadRef, AutoChannelThreadDestructor,
+                                 &AutoChannelContext);
+    le_thread_Start(AutoChannelThreadRef);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start or stop the periodic re-evaluation of the channel according to the settings.
+ */
+//--------------------------------------------------------------------------------------------------
+static void UpdateAutoChannelTimer
+(
+    void
+)
+{
+    if (NULL == AutoChannelTimer)
+    {
+        AutoChannelTimer = le_timer_Create("WifiApAutoChannel");
+        le_timer_SetRepeat(AutoChannelTimer, 0);
+        le_timer_SetHandler(AutoChannelTimer, AutoChannelTimerHandler);
+    }
+
+    le_timer_Stop(AutoChannelTimer);
+    if (IsHostapdStarted && IsAutoChannel && (0 != AutoChannelPeriodSec))
+    {
+        le_timer_SetMsInterval(AutoChannelTimer, AutoChannelPeriodSec * 1000);
+        le_timer_Start(AutoChannelTimer);
+    }
+}
+
+#ifdef SIMU
+// SIMU variable for timers
+static le_timer_Ref_t SimuClientConnectTimer = NULL;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function generates a WiFi Access Point Event if callback event handler is set.
+ */
+//--------------------------------------------------------------------------------------------------
+static void GenerateApEvent
+(
+    le_wifiAp_Event_t wifiApEvent
+)
+{
+    if (NULL != CallBackHandlerFuncPtr)
+    {
+        CallBackHandlerFuncPtr(wifiApEvent);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * SIMULATION! Simulates a LE_WIFIAP_EVENT_CLIENT_CONNECTED event
+ */
+//--------------------------------------------------------------------------------------------------
+static void SimuClientConnectTimeCallBack
+(
+    le_timer_Ref_t timerRef
+)
+{
+    GenerateApEvent(LE_WIFIAP_EVENT_CLIENT_CONNECTED);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function activates some timers to simulate client connect/disconnect events.
+ */
+//--------------------------------------------------------------------------------------------------
+
+static void StartApSimulation(void)
+{
+    // once every 10 seconds...
+    le_clk_Time_t interval = { 10, 0 };
+    SimuClientConnectTimer = le_timer_Create("WiFi Simu AP Connect Timer");
+
+    LE_INFO("Timer: %p", SimuClientConnectTimer);
+
+    if (LE_OK != le_timer_SetHandler(SimuClientConnectTimer, SimuClientConnectTimeCallBack))
+    {
+        LE_ERROR("ERROR: StartApSimulation le_timer_SetHandler failed.");
+    }
+    if (LE_OK != le_timer_SetInterval(SimuClientConnectTimer, interval))
+    {
+        LE_ERROR("ERROR: StartApSimulation le_timer_SetInterval failed.");
+    }
+
+    //repeat 5 times
+    if (LE_OK != le_timer_SetRepeat(SimuClientConnectTimer, 5))
+    {
+        LE_ERROR("ERROR: StartApSimulation le_timer_SetInterval failed.");
+    }
+    if (LE_OK != le_timer_Start(SimuClientConnectTimer))
+    {
+        LE_ERROR("ERROR: StartApSimulation le_timer_SetInterval failed.");
+    }
+}
+#endif
+
+//--------------------------------------------------------------------------------------------------
+// Public declarations
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function must be called to initialize the WiFi module platform adapter (PA).
+ *
+ * @return LE_FAULT  The function failed.
+ * @return LE_OK     The function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_Init
+(
+    void
+)
+{
+    le_result_t result       = LE_FAULT;
+    int         systemResult;
+    int         param;
+
+    LE_INFO("pa_wifiAp_Init() called");
+    MainThreadRef = le_thread_GetCurrent();
+    // Create the event for signaling user handlers.
+    WifiApPaEvent = le_event_CreateId("WifiApPaEvent", sizeof(le_wifiAp_EventInd_t));
+
+    for (param = 0; param < TUNING_PARAM_COUNT; param++)
+    {
+        SavedTuningOverrides[param] = TUNING_NOT_OVERRIDDEN;
+    }
+
+    systemResult = system("chmod 755 " WIFI_SCRIPT_PATH);
+
+    if (0 == WEXITSTATUS (systemResult))
+    {
+        LE_INFO("WiFi Access Point Command OK: chmod");
+        result = LE_OK;
+    }
+    else
+    {
+        LE_ERROR("WiFi Access Point Command Failed: chmod (%d)", systemResult);
+        result = LE_FAULT;
+    }
+
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function must be called to release the WiFi module platform adapter (PA).
+ *
+ * @return LE_OK     The function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_Release
+(
+    void
+)
+{
+    LE_INFO("AP release called");
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Parse a capability of the radio from a line of the wiphy information, indented by depth tabs.
+ * The capabilities are listed per band, in sections: HT capabilities, VHT capabilities and the VHT
+ * MCS set.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ParsePhyCapability
+(
+    const char *linePtr,
+    int depth,
+    char *sectionPtr,
+        ///< [INOUT] Section of the band: 'h' for HT, 'v' for VHT, 'm' for VHT MCS, '\0' for none
+    PhyCapabilities_t *capsPtr
+)
+{
+    const char *valuePtr = linePtr + depth;
+
+    if (2 == depth)
+    {
+        const char *mcsPtr = strstr(valuePtr, "MCS rate indexes supported:");
+
+        *sectionPtr = '\0';
+        if (0 == strncmp(valuePtr, "Capabilities:", strlen("Capabilities:")))
+        {
+            *sectionPtr = 'h';
+        }
+        else if (0 == strncmp(valuePtr, "VHT Capabilities", strlen("VHT Capabilities")))
+        {
+            *sectionPtr = 'v';
+            if (capsPtr->maxWidth < LE_WIFIAP_CHANNEL_WIDTH_80_MHZ)
+            {
+                // 80 MHz is mandatory for VHT
+                capsPtr->maxWidth = LE_WIFIAP_CHANNEL_WIDTH_80_MHZ;
+            }
+        }
+        else if (0 == strncmp(valuePtr, "VHT RX MCS set:", strlen("VHT RX MCS set:")))
+        {
+            *sectionPtr = 'm';
+        }
+        else if ((NULL != mcsPtr) && (NULL != strchr(mcsPtr, '-')))
+        {
+            // "HT TX/RX MCS rate indexes supported: 0-15": 8 indexes per spatial stream
+            uint8_t numStreams = (strtoul(strchr(mcsPtr, '-') + 1, NULL, 10) + 1) / 8;
+
+            if (numStreams > capsPtr->numStreams)
+            {
+                capsPtr->numStreams = numStreams;
+            }
+        }
+    }
+    else if ((3 == depth) && (('h' == *sectionPtr) || ('v' == *sectionPtr)))
+    {
+        le_wifiAp_PhyCapBitMask_t *capMaskPtr = ('h' == *sectionPtr) ? &capsPtr->htCapMask :
+                                                                        &capsPtr->vhtCapMask;
+
+        if ((NULL != strstr(valuePtr, "HT20/HT40")) &&
+            (capsPtr->maxWidth < LE_WIFIAP_CHANNEL_WIDTH_40_MHZ))
+        {
+            capsPtr->maxWidth = LE_WIFIAP_CHANNEL_WIDTH_40_MHZ;
+        }
+        else if ((NULL != strstr(valuePtr, "SGI")) || (NULL != strstr(valuePtr, "short GI")))
+        {
+            *capMaskPtr |= LE_WIFIAP_PHY_CAP_SHORT_GI;
+        }
+        else if (NULL != strstr(valuePtr, "RX LDPC"))
+        {
+            *capMaskPtr |= LE_WIFIAP_PHY_CAP_LDPC;
+        }
+        else if (0 == strncmp(valuePtr, "TX STBC", strlen("TX STBC")))
+        {
+            *capMaskPtr |= LE_WIFIAP_PHY_CAP_STBC;
+        }
+    }
+    else if ((3 == depth) && ('m' == *sectionPtr) && (NULL == strstr(valuePtr, "not supported")))
+    {
+        // "2 streams: MCS 0-9"
+        uint8_t numStreams = strtoul(valuePtr, NULL, 10);
+
+        if (numStreams > capsPtr->numStreams)
+        {
+            capsPtr->numStreams = numStreams;
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Discover the capabilities of the radio from the information of the wiphy of the interface: the
+ * maximum number of stations it supports in access point mode, and its channel widths, HT/VHT
+ * capabilities and spatial streams in the band of the hardware mode. A driver which does not
+ * report its maximum number of stations is limited to the default maximum number of clients.
+ *
+ * @return LE_FAULT The wiphy information could not be read: the WiFi hardware is not started.
+ * @return LE_OK    Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t DiscoverPhyInfo
+(
+    void
+)
+{
+    const char        maxStaPrefix[] = "\tMaximum associated stations in AP mode:";
+    const char        bandPrefix[]   = "\tBand ";
+    char              path[TEMP_STRING_MAX_BYTES];
+    FILE             *phyPipePtr;
+    uint32_t          maxNumClients = 0;
+    PhyCapabilities_t caps;
+    int               band;
+    bool              isInBand = false;
+    char              section = '\0';
+    int               st;
+
+    // The bands are numbered from 1 for 2.4 GHz, 2 for 5 GHz and 3 for 60 GHz
+    switch (SavedIeeeStdMask & HARDWARE_MODE_MASK)
+    {
+        case LE_WIFIAP_BITMASK_IEEE_STD_A:
+            band = 2;
+            break;
+        case LE_WIFIAP_BITMASK_IEEE_STD_AD:
+            band = 3;
+            break;
+        default:
+            band = 1;
+            break;
+    }
+
+    phyPipePtr = OpenScript(COMMAND_WIFIAP_GET_PHY_INFO);
+    if (NULL == phyPipePtr)
+    {
+        LE_ERROR("Failed to run command \"%s\": errno:%d: \"%s\" ",
+                COMMAND_WIFIAP_GET_PHY_INFO,
+                errno,
+                strerror(errno));
+        return LE_FAULT;
+    }
+
+    memset(&caps, 0, sizeof(caps));
+    caps.numStreams = 1;
+    while (NULL != fgets(path, sizeof(path), phyPipePtr))
+    {
+        int depth = strspn(path, "\t");
+
+        if (NULL != strstr(path, "[ AIRTIME_FAIRNESS ]"))
+        {
+            // Supported extended feature, listed apart from the bands
+            caps.airtimeFairness = true;
+        }
+        else if (0 == strncmp(maxStaPrefix, path, sizeof(maxStaPrefix) - 1))
+        {
+            uint32_t driverMax = strtoul(&path[sizeof(maxStaPrefix) - 1], NULL, 10);
+
+            if (0 != driverMax)
+            {
+                maxNumClients = (driverMax < HOSTAPD_MAX_STA_COUNT) ? driverMax :
+                                                                      HOSTAPD_MAX_STA_COUNT;
+            }
+        }
+        else if (0 == strncmp(bandPrefix, path, sizeof(bandPrefix) - 1))
+        {
+            isInBand = (band == strtol(&path[sizeof(bandPrefix) - 1], NULL, 10));
+            section = '\0';
+        }
+        else if (depth <= 1)
+        {
+            isInBand = false;
+        }
+        else if (isInBand)
+        {
+            ParsePhyCapability(path, depth, &section, &caps);
+        }
+    }
+
+    st = pclose(phyPipePtr);
+    if (!WIFEXITED(st) || (0 != WEXITSTATUS(st)))
+    {
+        LE_ERROR("WiFi AP Command \"%s\" Failed: (%d)", COMMAND_WIFIAP_GET_PHY_INFO, st);
+        return LE_FAULT;
+    }
+
+    IsMaxNumClientsReported = (0 != maxNumClients);
+    if (IsMaxNumClientsReported)
+    {
+        LE_INFO("Driver supports %" PRIu32 " stations", maxNumClients);
+        MaxNumClientsCapability = maxNumClients;
+    }
+    else
+    {
+        LE_WARN("Driver does not report its maximum number of stations, limited to %d",
+                WIFI_MAX_USERS);
+        MaxNumClientsCapability = WIFI_MAX_USERS;
+    }
+    LE_INFO("Radio supports width %d, HT caps 0x%" PRIx32 ", VHT caps 0x%" PRIx32 ", %d streams",
+            caps.maxWidth, (uint32_t)caps.htCapMask, (uint32_t)caps.vhtCapMask, caps.numStreams);
+    LE_INFO("Airtime fairness %ssupported", caps.airtimeFairness ? "" : "not ");
+    caps.isKnown = true;
+    PhyCaps = caps;
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Limit the spatial streams of the radio, through its antennas, to the saved number. It is applied
+ * before hostapd starts only, as the interface must be down.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ApplySpatialStreams
+(
+    void
+)
+{
+    char    cmd[TEMP_STRING_MAX_BYTES];
+    uint8_t numStreams = SavedNumSpatialStreams;
+    int     st;
+
+    if ((PhyCaps.isKnown) && (numStreams > PhyCaps.numStreams))
+    {
+        numStreams = PhyCaps.numStreams;
+    }
+
+    if (0 == numStreams)
+    {
+        snprintf(cmd, sizeof(cmd), "%s" COMMAND_WIFIAP_SET_ANTENNA " all", ScriptPath);
+    }
+    else
+    {
+        // One antenna per stream
+        snprintf(cmd, sizeof(cmd), "%s" COMMAND_WIFIAP_SET_ANTENNA " %u", ScriptPath,
+                 (1U << numStreams) - 1);
+    }
+
+    st = system(cmd);
+    if (!WIFEXITED(st) || (0 != WEXITSTATUS(st)))
+    {
+        LE_WARN("Unable to set %d spatial streams, all used", numStreams);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether a network interface name only has the characters allowed in the names of the
+ * interfaces: letters, digits, '_', '.' and '-'.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsValidInterfaceName
+(
+    const char *ifNamePtr
+)
+{
+    const char *charPtr;
+
+    if ((NULL == ifNamePtr) || ('\0' == ifNamePtr[0]))
+    {
+        return false;
+    }
+    for (charPtr = ifNamePtr; '\0' != *charPtr; charPtr++)
+    {
+        if ((!isalnum((unsigned char)*charPtr)) && ('_' != *charPtr) && ('.' != *charPtr) &&
+            ('-' != *charPtr))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Run a command of the WiFi platform adaptor shell script on the radio of the access point, with
+ * its arguments. The script is executed directly, without a shell interpreting the arguments.
+ *
+ * @return LE_FAULT  The function failed.
+ * @return LE_OK     The function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ExecScript
+(
+    const char *commandPtr,
+        ///< [IN] Command of the script
+    const char *const argsPtr[]
+        ///< [IN] Arguments of the command, NULL terminated
+)
+{
+    char  *argv[SCRIPT_MAX_ARGS + 5];
+    size_t numArgs = 0;
+    size_t arg;
+    pid_t  pid;
+    int    status;
+
+    argv[numArgs++] = WIFI_SCRIPT_FILE;
+    argv[numArgs++] = "-i";
+    argv[numArgs++] = ApIfName;
+    argv[numArgs++] = (char *)commandPtr;
+    for (arg = 0; (arg < SCRIPT_MAX_ARGS) && (NULL != argsPtr[arg]); arg++)
+    {
+        argv[numArgs++] = (char *)argsPtr[arg];
+    }
+    argv[numArgs] = NULL;
+
+    pid = fork();
+    if (-1 == pid)
+    {
+        LE_ERROR("WiFi AP Command \"%s\": fork failed: errno:%d: \"%s\"", commandPtr, errno,
+                 strerror(errno));
+        return LE_FAULT;
+    }
+    if (0 == pid)
+    {
+        execv(WIFI_SCRIPT_FILE, argv);
+        _exit(127);
+    }
+
+    while (-1 == waitpid(pid, &status, 0))
+    {
+        if (EINTR != errno)
+        {
+            LE_ERROR("WiFi AP Command \"%s\": waitpid failed: errno:%d", commandPtr, errno);
+            return LE_FAULT;
+        }
+    }
+    if ((!WIFEXITED(status)) || (0 != WEXITSTATUS(status)))
+    {
+        LE_ERROR("WiFi AP Command \"%s\" Failed: (%d)", commandPtr, status);
+        return LE_FAULT;
+    }
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Run a script command taking an interface, e.g. the uplink interface or the one of a BSS. The
+ * script is executed with its arguments, without a shell interpreting the interface name.
+ *
+ * @return LE_FAULT  The function failed.
+ * @return LE_OK     The function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t RunInterfaceCommand
+(
+    const char *commandPtr,
+    const char *ifNamePtr
+)
+{
+    const char *const argsPtr[] = { ifNamePtr, NULL };
+
+    if (!IsValidInterfaceName(ifNamePtr))
+    {
+        LE_ERROR("WiFi AP Command \"%s\": invalid interface name", commandPtr);
+        return LE_FAULT;
+    }
+    return ExecScript(commandPtr, argsPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Install the flowtable of the NAT uplink: once established, the flows between the WiFi interface
+ * and the uplink interface bypass the netfilter hooks. The NAT rules keep handling the first
+ * packets of each flow, or all of them if the kernel does not support flowtables.
+ *
+ * @return LE_FAULT  The function failed.
+ * @return LE_OK     The function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t StartNatOffload
+(
+    void
+)
+{
+    if (IsNatOffloaded)
+    {
+        return LE_OK;
+    }
+    if (LE_OK != RunInterfaceCommand(COMMAND_WIFIAP_NAT_OFFLOAD_START, SavedUplinkIfName))
+    {
+        LE_WARN("NAT fast path unavailable, flows stay on the netfilter path");
+        // Remove what may have been partially installed
+        RunInterfaceCommand(COMMAND_WIFIAP_NAT_OFFLOAD_STOP, SavedUplinkIfName);
+        return LE_FAULT;
+    }
+    IsNatOffloaded = true;
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove the flowtable of the NAT uplink. The offloaded flows are back on the netfilter path.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StopNatOffload
+(
+    void
+)
+{
+    if ((IsNatOffloaded) && (LE_OK != RunInterfaceCommand(COMMAND_WIFIAP_NAT_OFFLOAD_STOP, SavedUplinkIfName)))
+    {
+        LE_WARN("Unable to remove the NAT fast path");
+    }
+    IsNatOffloaded = false;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Apply the rate limit of a slot to the interface of the access point: the downlink is shaped in a
+ * queue of its own under each queue of the WMM access categories, which are kept, and the excess
+ * of the uplink is dropped, so that the station backs off. The previous limits of the slot are
+ * replaced.
+ *
+ * @return LE_FAULT  The function failed.
+ * @return LE_OK     The function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ApplyRateLimit
+(
+    int slot
+)
+{
+    const char *const noArgsPtr[] = { NULL };
+    char              slotArg[8];
+    char              downlinkArg[16];
+    char              uplinkArg[16];
+
+    if (!IsShapingStarted)
+    {
+        if (LE_OK != ExecScript(COMMAND_WIFIAP_SHAPING_START, noArgsPtr))
+        {
+            return LE_FAULT;
+        }
+        IsShapingStarted = true;
+    }
+
+    // A cleared slot removes the limits
+    snprintf(slotArg, sizeof(slotArg), "%d", slot + 1);
+    snprintf(downlinkArg, sizeof(downlinkArg), "%" PRIu32,
+             RateLimits[slot].isSet ? RateLimits[slot].downlinkKbps : 0);
+    snprintf(uplinkArg, sizeof(uplinkArg), "%" PRIu32,
+             RateLimits[slot].isSet ? RateLimits[slot].uplinkKbps : 0);
+    {
+        const char *const argsPtr[] = { slotArg, RateLimits[slot].macAddr, downlinkArg, uplinkArg,
+                                        NULL };
+
+        if (LE_OK != ExecScript(COMMAND_WIFIAP_SET_STA_RATE, argsPtr))
+        {
+            LE_ERROR("Unable to limit the rate of %s", RateLimits[slot].macAddr);
+            return LE_FAULT;
+        }
+    }
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Enable or disable the airtime fairness scheduling of the driver, as saved.
+ *
+ * @return LE_UNSUPPORTED The driver does not schedule the airtime fairly.
+ * @return LE_FAULT       The function failed.
+ * @return LE_OK          The function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ApplyAirtimeFairness
+(
+    void
+)
+{
+    char cmd[256];
+    int  systemResult;
+
+    if ((!PhyCaps.isKnown) && (LE_OK != DiscoverPhyInfo()))
+    {
+        return LE_FAULT;
+    }
+    if (!PhyCaps.airtimeFairness)
+    {
+        return IsAirtimeFairness ? LE_UNSUPPORTED : LE_OK;
+    }
+
+    snprintf(cmd, sizeof(cmd), "%s%s %d", ScriptPath, COMMAND_WIFIAP_SET_AIRTIME_FAIRNESS,
+             IsAirtimeFairness);
+    systemResult = system(cmd);
+    if ((!WIFEXITED(systemResult)) || (0 != WEXITSTATUS(systemResult)))
+    {
+        LE_ERROR("WiFi AP Command \"%s\" Failed: (%d)", cmd, systemResult);
+        return LE_FAULT;
+    }
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Install the rate limits of the stations and the airtime fairness once the interface of the
+ * access point is up. A failure leaves the traffic unshaped but does not prevent the start.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StartTrafficControl
+(
+    void
+)
+{
+    int slot;
+
+    for (slot = 0; slot < PA_WIFIAP_MAX_RATE_LIMITS; slot++)
+    {
+        if ((RateLimits[slot].isSet) && (LE_OK != ApplyRateLimit(slot)))
+        {
+            LE_WARN("Rate of %s not limited", RateLimits[slot].macAddr);
+        }
+    }
+    if ((IsAirtimeFairness) && (LE_OK != ApplyAirtimeFairness()))
+    {
+        LE_WARN("Airtime fairness unavailable");
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove the rate limits of the stations from the interface of the access point.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StopTrafficControl
+(
+    void
+)
+{
+    const char *const noArgsPtr[] = { NULL };
+
+    if (!IsShapingStarted)
+    {
+        return;
+    }
+    if (LE_OK != ExecScript(COMMAND_WIFIAP_SHAPING_STOP, noArgsPtr))
+    {
+        LE_WARN("Unable to remove the rate limits");
+    }
+    IsShapingStarted = false;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create the virtual interface of the access point in concurrent mode. A radio operates on a
+ * single channel at a time, so the access point follows the channel of the station if connected.
+ *
+ * @return LE_FAULT  The function failed.
+ * @return LE_OK     The function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t StartConcurrentInterface
+(
+    void
+)
+{
+    char         path[TEMP_STRING_MAX_BYTES];
+    FILE        *freqPipePtr;
+    const char  *freqPtr;
+    unsigned int frequency = 0;
+    uint16_t     channelNumber;
+    int          systemResult;
+
+    systemResult = RunScript(COMMAND_WIFIAP_VIF_ADD);
+    if ((!WIFEXITED(systemResult)) || (0 != WEXITSTATUS(systemResult)))
+    {
+        LE_ERROR("Unable to create the interface %s", PA_WIFIAP_CONCURRENT_INTERFACE);
+        return LE_FAULT;
+    }
+
+    freqPipePtr = OpenScript(COMMAND_WIFIAP_GET_STA_FREQUENCY);
+    if (NULL == freqPipePtr)
+    {
+        LE_ERROR("Failed to run command \"%s\": errno:%d: \"%s\" ",
+                COMMAND_WIFIAP_GET_STA_FREQUENCY,
+                errno,
+                strerror(errno));
+        return LE_FAULT;
+    }
+    // e.g. "\tfreq: 2437"
+    while (NULL != fgets(path, sizeof(path), freqPipePtr))
+    {
+        if (NULL != (freqPtr = strstr(path, "freq:")))
+        {
+            sscanf(freqPtr, "freq: %u", &frequency);
+        }
+    }
+    pclose(freqPipePtr);
+
+    if (0 == frequency)
+    {
+        LE_INFO("Station not connected, access point on channel %d", SavedChannelNumber);
+        return LE_OK;
+    }
+    channelNumber = FrequencyToChannel(frequency);
+    if (0 == channelNumber)
+    {
+        LE_ERROR("Station on %u MHz, out of the band of the access point", frequency);
+        return LE_FAULT;
+    }
+    if (channelNumber != SavedChannelNumber)
+    {
+        LE_INFO("Access point moved to the channel %d of the station", channelNumber);
+        SavedChannelNumber = channelNumber;
+    }
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete the virtual interface of the access point in concurrent mode.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StopConcurrentInterface
+(
+    void
+)
+{
+    int systemResult;
+
+    if (!IsConcurrent)
+    {
+        return;
+    }
+    systemResult = RunScript(COMMAND_WIFIAP_VIF_DEL);
+    if ((!WIFEXITED(systemResult)) || (0 != WEXITSTATUS(systemResult)))
+    {
+        LE_WARN("Unable to delete the interface %s", PA_WIFIAP_CONCURRENT_INTERFACE);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set up the uplink of the access point: create the bridge before hostapd adds the WiFi interface
+ * to it, or enable the forwarding and the NAT rules towards the uplink interface.
+ *
+ * @return LE_FAULT  The function failed.
+ * @return LE_OK     The function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t StartUplink
+(
+    void
+)
+{
+    // The station interface is a valid uplink in concurrent mode only
+    if ((LE_WIFIAP_UPLINK_NONE != SavedUplinkMode) &&
+        (0 == strcmp(SavedUplinkIfName, GetApInterface())))
+    {
+        LE_ERROR("Uplink %s is the interface of the access point", SavedUplinkIfName);
+        return LE_FAULT;
+    }
+
+    switch (SavedUplinkMode)
+    {
+        case LE_WIFIAP_UPLINK_BRIDGE:
+            return RunInterfaceCommand(COMMAND_WIFIAP_BRIDGE_START, SavedUplinkIfName);
+        case LE_WIFIAP_UPLINK_NAT:
+            if (LE_OK != RunInterfaceCommand(COMMAND_WIFIAP_NAT_START, SavedUplinkIfName))
+            {
+                return LE_FAULT;
+            }
+            if (IsNatOffloadEnabled)
+            {
+                StartNatOffload();
+            }
+            return LE_OK;
+        default:
+            return LE_OK;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Tear down the uplink of the access point. Failures are only logged.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StopUplink
+(
+    void
+)
+{
+    le_result_t result = LE_OK;
+
+    switch (SavedUplinkMode)
+    {
+        case LE_WIFIAP_UPLINK_BRIDGE:
+            result = RunInterfaceCommand(COMMAND_WIFIAP_BRIDGE_STOP, SavedUplinkIfName);
+            break;
+        case LE_WIFIAP_UPLINK_NAT:
+            StopNatOffload();
+            result = RunInterfaceCommand(COMMAND_WIFIAP_NAT_STOP, SavedUplinkIfName);
+            break;
+        default:
+            break;
+    }
+    if (LE_OK != result)
+    {
+        LE_WARN("Unable to tear down the uplink %s", SavedUplinkIfName);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function starts the WiFi access point.
+ * Note that all settings, if to be used, such as security, username, password must set prior to
+ * starting the access point.
+ *
+ * @return LE_FAULT         The function failed.
+ * @return LE_OK            The function succeeded.
+ * @return LE_NOT_FOUND     The WiFi card is absent.
+ * @return LE_NOT_POSSIBLE  The WiFi card may not work.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_Start
+(
+    void
+)
+{
+    int     systemResult;
+    int     bss;
+
+    // Check that an SSID is provided before starting
+    if ('\0' == SavedSsid[0])
+    {
+        LE_ERROR("Unable to start AP because no valid SSID provided");
+        return LE_FAULT;
+    }
+    for (bss = 0; bss < PA_WIFIAP_MAX_BSS; bss++)
+    {
+        if ((BssList[bss].isCreated) && ('\0' == BssList[bss].ssid[0]))
+        {
+            LE_ERROR("Unable to start AP because no SSID provided for %s", BssList[bss].ifName);
+            return LE_FAULT;
+        }
+    }
+
+    // Check channel number is properly set before starting
+    if ((SavedChannelNumber < MIN_CHANNEL_VALUE) ||
+            (SavedChannelNumber > MAX_CHANNEL_VALUE))
+    {
+        LE_ERROR("Unable to start AP because no valid channel number provided");
+        return LE_FAULT;
+    }
+
+    LE_DEBUG("Starting AP, SSID: %s", SavedSsid);
+
+    // Create hostapd.conf file in /tmp
+    if ( LE_OK != GenerateHostapdConf())
+    {
+        LE_ERROR("Failed to generate hostapd.conf");
+        return LE_FAULT;
+    }
+
+    systemResult = RunScript(COMMAND_WIFI_HW_START);
+    /**
+     * Returned values:
+     *   0: if the interface is correctly moutned
+     *  50: if WiFi card is not inserted
+     * 100: if WiFi card may not work
+     * 127: if driver can not be installed
+     *  -1: if the fork() has failed (see man system)
+     */
+
+    if (0 == WEXITSTATUS(systemResult))
+    {
+        bool     isConfChanged = false;
+        uint16_t channelNumber;
+        int32_t  score;
+        int32_t  currentScore;
+        uint32_t currentLoad;
+
+        LE_DEBUG("WiFi hardware started correctly");
+        if (IsConcurrent)
+        {
+            uint16_t savedChannelNumber = SavedChannelNumber;
+
+            if (LE_OK != StartConcurrentInterface())
+            {
+                goto stopRadio;
+            }
+            isConfChanged = (savedChannelNumber != SavedChannelNumber);
+        }
+        if (LE_OK == DiscoverPhyInfo())
+        {
+            // The PHY settings are bounded by the discovered capabilities
+            isConfChanged = true;
+            if (SavedMaxNumClients > MaxNumClientsCapability)
+            {
+                LE_WARN("Max number of clients %" PRIu32 " limited to the driver capability %"
+                        PRIu32, SavedMaxNumClients, MaxNumClientsCapability);
+                SavedMaxNumClients = MaxNumClientsCapability;
+            }
+        }
+        // In concurrent mode, the channel and the antennas are the ones of the station. The
+        // counters of the survey restart with the driver.
+        NumPreviousSurveys = 0;
+        if ((IsAutoChannel) && (!IsConcurrent) &&
+            (LE_OK == SelectAutoChannel(&channelNumber, &score, &currentScore, &currentLoad)) &&
+            (channelNumber != SavedChannelNumber))
+        {
+            LE_INFO("Least loaded channel: %d", channelNumber);
+            SavedChannelNumber = channelNumber;
+            isConfChanged = true;
+        }
+        if ((!IsConcurrent) && ((0 != SavedNumSpatialStreams) || (PhyCaps.numStreams > 1)))
+        {
+            ApplySpatialStreams();
+        }
+        if ((isConfChanged) && (LE_OK != GenerateHostapdConf()))
+        {
+            LE_ERROR("Failed to generate hostapd.conf");
+            goto stopRadio;
+        }
+        // Create WiFi AP PA Thread
+        WifiApPaThread = le_thread_Create("WifiApPaThread", WifiApPaThreadMain, NULL);
+        le_thread_SetJoinable(WifiApPaThread);
+        le_thread_AddChildDestructor(WifiApPaThread, ThreadDestructor, NULL);
+        le_thread_Start(WifiApPaThread);
+
+        if (LE_OK != StartUplink())
+        {
+            LE_ERROR("Unable to set up the uplink %s", SavedUplinkIfName);
+            goto stopUplink;
+        }
+    }
+    // Return value of 50 means WiFi card is not inserted.
+    else if ( PA_NOT_FOUND == WEXITSTATUS(systemResult))
+    {
+        LE_ERROR("WiFi card is not inserted");
+        return LE_NOT_FOUND;
+    }
+    // Return value of 100 means WiFi card may not work.
+    else if ( PA_NOT_POSSIBLE == WEXITSTATUS(systemResult))
+    {
+        LE_ERROR("Unable to reset WiFi card");
+        return LE_NOT_POSSIBLE;
+    }
+    // WiFi card failed to start.
+    else
+    {
+        LE_WARN("Failed to start WiFi AP command \"%s\" systemResult (%d)",
+                COMMAND_WIFI_HW_START, systemResult);
+        return LE_FAULT;
+    }
+
+    // Start Access Point cmd: /bin/hostapd /etc/hostapd.conf
+    systemResult = RunScript(COMMAND_WIFIAP_HOSTAPD_START);
+    if ((!WIFEXITED(systemResult)) || (0 != WEXITSTATUS(systemResult)))
+    {
+        LE_ERROR("WiFi Client Command \"%s\" Failed: (%d)",
+                COMMAND_WIFIAP_HOSTAPD_START,
+                systemResult);
+        goto stopHostapd;
+    }
+
+    IsHostapdStarted = true;
+    UpdateAutoChannelTimer();
+    StartTrafficControl();
+    LE_INFO("WiFi AP started correclty");
+    return LE_OK;
+
+    // Unwind in the reverse order of the start, as pa_wifiAp_Stop() does
+stopHostapd:
+    // hostapd may have been started before failing
+    systemResult = RunScript(COMMAND_WIFIAP_HOSTAPD_STOP);
+    if ((!WIFEXITED(systemResult)) || (0 != WEXITSTATUS(systemResult)))
+    {
+        LE_DEBUG("WiFi AP Command \"%s\" Failed: (%d)", COMMAND_WIFIAP_HOSTAPD_STOP,
+                 systemResult);
+    }
+    // Remove generated hostapd.conf file
+    remove(WIFI_HOSTAPD_FILE);
+stopUplink:
+    StopUplink();
+    le_thread_Cancel(WifiApPaThread);
+    le_thread_Join(WifiApPaThread, NULL);
+stopRadio:
+    StopConcurrentInterface();
+    // Release the radio, and its user marker, the station may still use it
+    systemResult = RunScript(COMMAND_WIFI_HW_STOP);
+    if ((!WIFEXITED(systemResult)) || (0 != WEXITSTATUS(systemResult)))
+    {
+        LE_WARN("WiFi AP Command \"%s\" Failed: (%d)", COMMAND_WIFI_HW_STOP, systemResult);
+    }
+    return LE_FAULT;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function stops the WiFi access point.
+ *
+ * @return LE_FAULT         The function failed.
+ * @return LE_OK            The function succeeded.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_Stop
+(
+    void
+)
+{
+    int status;
+    int bss;
+
+    IsHostapdStarted = false;
+    UpdateAutoChannelTimer();
+
+    // Try to delete the rule allowing the DHCP ports on WLAN. Ignore if it fails
+    status = RunScript(COMMAND_IPTABLE_DHCP_DELETE);
+    if ((!WIFEXITED(status)) || (0 != WEXITSTATUS(status)))
+    {
+        LE_WARN("Deleting rule for DHCP port fails");
+    }
+    for (bss = 0; bss < PA_WIFIAP_MAX_BSS; bss++)
+    {
+        if ((BssList[bss].isIpRangeSet) &&
+            (LE_OK != RunInterfaceCommand(COMMAND_IPTABLE_DHCP_DELETE, BssList[bss].ifName)))
+        {
+            LE_WARN("Deleting rule for DHCP port of %s fails", BssList[bss].ifName);
+        }
+        BssList[bss].isIpRangeSet = false;
+    }
+
+    StopUplink();
+    StopTrafficControl();
+
+    status = RunScript(COMMAND_WIFIAP_HOSTAPD_STOP);
+    if ((!WIFEXITED(status)) || (0 != WEXITSTATUS(status)))
+    {
+        LE_ERROR("WiFi AP Command \"%s\" Failed: (%d)",
+                COMMAND_WIFIAP_HOSTAPD_STOP,
+                status);
+        return LE_FAULT;
+    }
+
+    StopConcurrentInterface();
+
+    status = RunScript(COMMAND_WIFI_HW_STOP);
+    if ((!WIFEXITED(status)) || (0 != WEXITSTATUS(status)))
+    {
+        LE_ERROR("WiFi AP Command \"%s\" Failed: (%d)", COMMAND_WIFI_HW_STOP, status);
+        return LE_FAULT;
+    }
+
+    // Cancel the previously created thread
+    le_thread_Cancel(WifiApPaThread);
+    if (LE_OK != le_thread_Join(WifiApPaThread, NULL))
+    {
+        return LE_FAULT;
+    }
+
+    // Remove the previously created hostapd.conf file in /tmp
+    remove(WIFI_HOSTAPD_FILE);
+
+    LE_INFO("WiFi AP stopped correclty");
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add handler function for WiFi related events.
+ *
+ * These events provide information on WiFi access point status.
+ *
+ * @return LE_BAD_PARAMETER Some parameter is invalid.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t  pa_wifiAp_AddEventHandler
+(
+    pa_wifiAp_NewEventHandlerFunc_t handlerPtr,
+        ///< [IN]
+        ///< Event handler function pointer
+
+    void *contextPtr
+        ///< [IN]
+        ///< Associated event context
+)
+{
+    le_event_HandlerRef_t handlerRef;
+
+    handlerRef = le_event_AddLayeredHandler("WifiApPaHandler",
+                                            WifiApPaEvent,
+                                            FirstLayerWifiApEventHandler,
+                                            (le_event_HandlerFunc_t)handlerPtr);
+    if (NULL == handlerRef)
+    {
+        LE_ERROR("ERROR: le_event_AddLayeredHandler returned NULL");
+        return LE_BAD_PARAMETER;
+    }
+
+    le_event_SetContextPtr(handlerRef, contextPtr);
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add handler function for WiFi related events, with the MAC address of the station concerned.
+ *
+ * @return LE_BAD_PARAMETER Some parameter is invalid.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_AddEventIndHandler
+(
+    pa_wifiAp_EventIndHandlerFunc_t handlerPtr,
+        ///< [IN]
+        ///< Event handler function pointer
+
+    void *contextPtr
+        ///< [IN]
+        ///< Associated event context
+)
+{
+    le_event_HandlerRef_t handlerRef;
+
+    handlerRef = le_event_AddLayeredHandler("WifiApPaIndHandler",
+                                            WifiApPaEvent,
+                                            FirstLayerWifiApEventIndHandler,
+                                            (le_event_HandlerFunc_t)handlerPtr);
+    if (NULL == handlerRef)
+    {
+        LE_ERROR("ERROR: le_event_AddLayeredHandler returned NULL");
+        return LE_BAD_PARAMETER;
+    }
+
+    le_event_SetContextPtr(handlerRef, contextPtr);
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Parse a bitrate of the station dump, e.g. "65.0 MBit/s MCS 7", into kbit/s.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t ParseBitrate
+(
+    const char *valuePtr
+)
+{
+    return (uint32_t)(strtod(valuePtr, NULL) * 1000);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the statistics of the stations associated with the access point, as dumped by the driver.
+ *
+ * @return LE_BAD_PARAMETER Some parameter is invalid.
+ * @return LE_FAULT         The function failed.
+ * @return LE_OK            The function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_GetStations
+(
+    le_wifiAp_StationInfo_t *stationsPtr,
+        ///< [OUT]
+        ///< Statistics of the stations
+    size_t *numStationsPtr
+        ///< [INOUT]
+        ///< In: size of the stations array. Out: number of stations returned.
+)
+{
+    const char stationPrefix[]    = "Station ";
+    const char inactivePrefix[]   = "\tinactive time:";
+    const char rxBytesPrefix[]    = "\trx bytes:";
+    const char rxPacketsPrefix[]  = "\trx packets:";
+    const char txBytesPrefix[]    = "\ttx bytes:";
+    const char txPacketsPrefix[]  = "\ttx packets:";
+    const char signalPrefix[]     = "\tsignal:";
+    const char txBitratePrefix[]  = "\ttx bitrate:";
+    const char rxBitratePrefix[]  = "\trx bitrate:";
+    const char connectedPrefix[]  = "\tconnected time:";
+    char                     path[TEMP_STRING_MAX_BYTES];
+    FILE                    *stationPipePtr;
+    le_wifiAp_StationInfo_t *infoPtr = NULL;
+    size_t                   numStations = 0;
+    int                      st;
+
+    if ((NULL == stationsPtr) || (NULL == numStationsPtr))
+    {
+        LE_ERROR("Invalid parameter");
+        return LE_BAD_PARAMETER;
+    }
+
+    stationPipePtr = OpenScript(COMMAND_WIFIAP_GET_STATIONS);
+    if (NULL == stationPipePtr)
+    {
+        LE_ERROR("Failed to run command \"%s\": errno:%d: \"%s\" ",
+                COMMAND_WIFIAP_GET_STATIONS,
+                errno,
+                strerror(errno));
+        return LE_FAULT;
+    }
+
+    while (NULL != fgets(path, sizeof(path), stationPipePtr))
+    {
+        if (0 == strncmp(stationPrefix, path, sizeof(stationPrefix) - 1))
+        {
+            // "Station 12:34:56:78:9a:bc (on wlan0)": the stations beyond the array are skipped
+            infoPtr = NULL;
+            if (numStations < *numStationsPtr)
+            {
+                infoPtr = &stationsPtr[numStations++];
+                memset(infoPtr, 0, sizeof(*infoPtr));
+                le_utf8_Copy(infoPtr->macAddr, &path[sizeof(stationPrefix) - 1],
+                             LE_WIFIDEFS_MAX_BSSID_BYTES, NULL);
+            }
+        }
+        else if (NULL == infoPtr)
+        {
+            continue;
+        }
+        else if (0 == strncmp(inactivePrefix, path, sizeof(inactivePrefix) - 1))
+        {
+            infoPtr->inactiveMs = strtoul(&path[sizeof(inactivePrefix) - 1], NULL, 10);
+        }
+        else if (0 == strncmp(rxBytesPrefix, path, sizeof(rxBytesPrefix) - 1))
+        {
+            infoPtr->rxBytes = strtoull(&path[sizeof(rxBytesPrefix) - 1], NULL, 10);
+        }
+        else if (0 == strncmp(rxPacketsPrefix, path, sizeof(rxPacketsPrefix) - 1))
+        {
+            infoPtr->rxPackets = strtoul(&path[sizeof(rxPacketsPrefix) - 1], NULL, 10);
+        }
+        else if (0 == strncmp(txBytesPrefix, path, sizeof(txBytesPrefix) - 1))
+        {
+            infoPtr->txBytes = strtoull(&path[sizeof(txBytesPrefix) - 1], NULL, 10);
+        }
+        else if (0 == strncmp(txPacketsPrefix, path, sizeof(txPacketsPrefix) - 1))
+        {
+            infoPtr->txPackets = strtoul(&path[sizeof(txPacketsPrefix) - 1], NULL, 10);
+        }
+        else if (0 == strncmp(signalPrefix, path, sizeof(signalPrefix) - 1))
+        {
+            infoPtr->signal = strtol(&path[sizeof(signalPrefix) - 1], NULL, 10);
+        }
+        else if (0 == strncmp(txBitratePrefix, path, sizeof(txBitratePrefix) - 1))
+        {
+            infoPtr->txBitrate = ParseBitrate(&path[sizeof(txBitratePrefix) - 1]);
+        }
+        else if (0 == strncmp(rxBitratePrefix, path, sizeof(rxBitratePrefix) - 1))
+        {
+            infoPtr->rxBitrate = ParseBitrate(&path[sizeof(rxBitratePrefix) - 1]);
+        }
+        else if (0 == strncmp(connectedPrefix, path, sizeof(connectedPrefix) - 1))
+        {
+            infoPtr->connectedSec = strtoul(&path[sizeof(connectedPrefix) - 1], NULL, 10);
+        }
+    }
+
+    st = pclose(stationPipePtr);
+    if (!WIFEXITED(st) || (0 != WEXITSTATUS(st)))
+    {
+        LE_ERROR("WiFi AP Command \"%s\" Failed: (%d)", COMMAND_WIFIAP_GET_STATIONS, st);
+        return LE_FAULT;
+    }
+
+    *numStationsPtr = numStations;
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the Service Set IDentification (SSID) of the access point
+ * If the access point is started, the setting is applied at once without a restart.
+ *
+ * @note The SSID does not have to be human readable ASCII values, but often is.
+ *
+ * @return LE_BAD_PARAMETER Some parameter is invalid.
+ * @return LE_FAULT         The started access point could not be reconfigured.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_SetSsid
+(
+    const uint8_t *ssidPtr,
+        ///< [IN]
+        ///< The SSID to set as an octet array.
+
+    size_t ssidNumElements
+        ///< [IN]
+        ///< The length of the SSID in bytes.
+)
+{
+    le_result_t result = LE_BAD_PARAMETER;
+
+    LE_INFO("SSID length %d | SSID: \"%.*s\"",
+            (int)ssidNumElements,
+            (int)ssidNumElements,
+            (char *)ssidPtr);
+
+    if ((0 < ssidNumElements) && (ssidNumElements <= LE_WIFIDEFS_MAX_SSID_LENGTH))
+    {
+        char previousSsid[sizeof(SavedSsid)];
+
+        memcpy(previousSsid, SavedSsid, sizeof(previousSsid));
+        // Store SSID to be used later during startup procedure
+        memcpy(&SavedSsid[0], (const char *)&ssidPtr[0], ssidNumElements);
+        // Make sure there is a null termination
+        SavedSsid[ssidNumElements] = '\0';
+        result = ApplyHostapdParameter("ssid", SavedSsid, true);
+        if (LE_OK != result)
+        {
+            memcpy(SavedSsid, previousSsid, sizeof(SavedSsid));
+            RestoreHostapdParameter("ssid", SavedSsid);
+        }
+    }
+    else
+    {
+        LE_ERROR("ERROR: SSID length exceeds %d bytes\n", LE_WIFIDEFS_MAX_SSID_LENGTH);
+    }
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the security protocol used to communicate.
+ * If the access point is started, the setting is applied at once without a restart.
+ *
+ * @note WEP is not supported as it is unsecure and has been deprecated in favor of WPA/WPA2.
+ * This limitation applies to access point mode only.
+ *
+ * @return LE_BAD_PARAMETER Some parameter is invalid.
+ * @return LE_FAULT         The started access point could not be reconfigured.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_SetSecurityProtocol
+(
+    le_wifiAp_SecurityProtocol_t securityProtocol
+        ///< [IN]
+        ///< The security protocol used to communicate with the access point.
+)
+{
+    le_result_t result;
+
+    LE_INFO("Security protocol : %d", securityProtocol);
+    switch (securityProtocol)
+    {
+        case LE_WIFIAP_SECURITY_NONE:
+        case LE_WIFIAP_SECURITY_WPA2:
+        {
+            le_wifiAp_SecurityProtocol_t previousProtocol = SavedSecurityProtocol;
+
+            SavedSecurityProtocol = securityProtocol;
+            result = ApplyHostapdSecurity(true);
+            if (LE_OK != result)
+            {
+                SavedSecurityProtocol = previousProtocol;
+                RestoreHostapdSecurity();
+            }
+            break;
+        }
+
+        default:
+            result = LE_BAD_PARAMETER;
+            break;
+    }
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the passphrase used to generate the PSK.
+ * If the access point is started, the setting is applied at once without a restart.
+ *
+ * @note This is one way to authenticate against the access point. The other one is provided by the
+ * pa_wifiAp_SetPreSharedKey() function. Both ways are exclusive and are effective only when used
+ * with WPA-personal authentication.
+ *
+ * @return LE_BAD_PARAMETER Parameter is invalid.
+ * @return LE_FAULT         The started access point could not be reconfigured.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_SetPassPhrase
+(
+    const char *passphrasePtr
+        ///< [IN]
+        ///< Passphrase to authenticate against the access point.
+)
+{
+    le_result_t result = LE_BAD_PARAMETER;
+
+    LE_INFO("Set passphrase");
+    if (NULL != passphrasePtr)
+    {
+        uint32_t length = strlen(passphrasePtr);
+
+        if ((length >= LE_WIFIDEFS_MIN_PASSPHRASE_LENGTH) &&
+            (length <= LE_WIFIDEFS_MAX_PASSPHRASE_LENGTH))
+        {
+            char previousPassphrase[sizeof(SavedPassphrase)];
+
+            memcpy(previousPassphrase, SavedPassphrase, sizeof(previousPassphrase));
+            // Store Passphrase to be used later during startup procedure
+            le_utf8_Copy(SavedPassphrase, passphrasePtr, sizeof(SavedPassphrase), NULL);
+            result = ApplyHostapdSecurity(true);
+            if (LE_OK != result)
+            {
+                memcpy(SavedPassphrase, previousPassphrase, sizeof(SavedPassphrase));
+                RestoreHostapdSecurity();
+            }
+            memset(previousPassphrase, 0, sizeof(previousPassphrase));
+        }
+        else
+        {
+            LE_ERROR("Invalid passphrase length (%d) [%d..%d]",
+                    length,
+                    LE_WIFIDEFS_MIN_PASSPHRASE_LENGTH,
+                    LE_WIFIDEFS_MAX_PASSPHRASE_LENGTH);
+        }
+    }
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the pre-shared key (PSK).
+ * If the access point is started, the setting is applied at once without a restart.
+ *
+ * @note This is one way to authenticate against the access point. The other one is provided by the
+ * pa_wifiAp_SetPassPhrase() function. Both ways are exclusive and are effective only when used
+ * with WPA-personal authentication.
+ *
+ * @return LE_BAD_PARAMETER Parameter is invalid.
+ * @return LE_FAULT         The started access point could not be reconfigured.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_SetPreSharedKey
+(
+    const char *preSharedKeyPtr
+        ///< [IN]
+        ///< Pre-shared key used to authenticate against the access point.
+)
+{
+    le_result_t result = LE_BAD_PARAMETER;
+
+    LE_INFO("Set PSK");
+    if (NULL != preSharedKeyPtr)
+    {
+        uint32_t length = strlen(preSharedKeyPtr);
+
+        if (length <= LE_WIFIDEFS_MAX_PSK_LENGTH)
+        {
+            char previousPreSharedKey[sizeof(SavedPreSharedKey)];
+
+            memcpy(previousPreSharedKey, SavedPreSharedKey, sizeof(previousPreSharedKey));
+            // Store PSK to be used later during startup procedure
+            le_utf8_Copy(SavedPreSharedKey, preSharedKeyPtr, sizeof(SavedPreSharedKey), NULL);
+            result = ApplyHostapdSecurity(true);
+            if (LE_OK != result)
+            {
+                memcpy(SavedPreSharedKey, previousPreSharedKey, sizeof(SavedPreSharedKey));
+                RestoreHostapdSecurity();
+            }
+            memset(previousPreSharedKey, 0, sizeof(previousPreSharedKey));
+        }
+    }
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set if the access point should announce its presence.
+ * Default value is TRUE.
+ * If the value is set to FALSE, the access point will be hidden.
+ * If the access point is started, the setting is applied at once without a restart.
+ *
+ * @return LE_FAULT         The started access point could not be reconfigured.
+ * @return LE_OK            Function succeeded.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_SetDiscoverable
+(
+    bool isDiscoverable
+        ///< [IN]
+        ///< If TRUE, the access point SSID is visible by the clients otherwise it is hidden.
+)
+{
+    bool        previousDiscoverable = SavedDiscoverable;
+    le_result_t result;
+
+    // Store Discoverable to be used later during startup procedure
+    LE_INFO("Set discoverability");
+    SavedDiscoverable = isDiscoverable;
+    result = ApplyHostapdParameter("ignore_broadcast_ssid", isDiscoverable ? "0" : "1", true);
+    if (LE_OK != result)
+    {
+        SavedDiscoverable = previousDiscoverable;
+        RestoreHostapdParameter("ignore_broadcast_ssid", previousDiscoverable ? "0" : "1");
+    }
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check that a channel number is valid for the hardware mode of the IEEE standard.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsChannelInRange
+(
+    uint16_t channelNumber
+)
+{
+    int8_t hwMode = SavedIeeeStdMask & 0x0F;
+
+    switch (hwMode)
+    {
+        case LE_WIFIAP_BITMASK_IEEE_STD_A:
+            MIN_CHANNEL_VALUE = LE_WIFIDEFS_MIN_CHANNEL_STD_A;
+            MAX_CHANNEL_VALUE = LE_WIFIDEFS_MAX_CHANNEL_STD_A;
+            break;
+        case LE_WIFIAP_BITMASK_IEEE_STD_B:
+        case LE_WIFIAP_BITMASK_IEEE_STD_G:
+            MIN_CHANNEL_VALUE = LE_WIFIDEFS_MIN_CHANNEL_VALUE;
+            MAX_CHANNEL_VALUE = LE_WIFIDEFS_MAX_CHANNEL_VALUE;
+            break;
+        case LE_WIFIAP_BITMASK_IEEE_STD_AD:
+            MIN_CHANNEL_VALUE = LE_WIFIDEFS_MIN_CHANNEL_STD_AD;
+            MAX_CHANNEL_VALUE = LE_WIFIDEFS_MAX_CHANNEL_STD_AD;
+            break;
+        default:
+            LE_WARN("Invalid hardware mode");
+    }
+
+    return ((channelNumber >= MIN_CHANNEL_VALUE) && (channelNumber <= MAX_CHANNEL_VALUE));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set which WiFi channel to use.
+ * Default number is 7.
+ * Some legal restrictions might apply for your region.
+ * The channel number must be between 1 and 14 for IEEE 802.11b/g.
+ * The channel number must be between 7 and 196 for IEEE 802.11a.
+ * The channel number must be between 1 and 6 for IEEE 802.11ad.
+ * If the access point is started, the setting is applied at once without a restart.
+ * The automatic channel selection is disabled.
+ * @return
+ *      - LE_OUT_OF_RANGE if requested channel number is out of range.
+ *      - LE_FAULT if the started access point could not be reconfigured.
+ *      - LE_OK if the function succeeded.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_SetChannel
+(
+    uint16_t channelNumber
+        ///< [IN]
+        ///< the channel number.
+)
+{
+    le_result_t result = LE_OUT_OF_RANGE;
+
+    LE_INFO("Set channel");
+    if (IsChannelInRange(channelNumber))
+    {
+       result = ApplyHostapdChannel(channelNumber);
+       if (LE_OK == result)
+       {
+           IsAutoChannel = false;
+           UpdateAutoChannelTimer();
+       }
+    }
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Move the started access point to another channel without disconnecting the stations. The switch
+ * is announced in the given number of beacons (CSA), and LE_WIFIAP_EVENT_CHANNEL_SWITCHED is
+ * reported once it has occurred. The channel must be valid for the IEEE standard, as for
+ * pa_wifiAp_SetChannel(). The automatic channel selection is disabled.
+ *
+ * @return LE_OUT_OF_RANGE  The channel number is out of range, or the number of beacons is 0.
+ * @return LE_UNAVAILABLE   The access point is not started.
+ * @return LE_UNSUPPORTED   The driver does not support the channel switch: the channel is kept.
+ * @return LE_FAULT         The function failed.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_SwitchChannel
+(
+    uint16_t channelNumber,
+        ///< [IN]
+        ///< The channel number.
+    uint8_t beaconCount
+        ///< [IN]
+        ///< Number of beacons announcing the switch before it occurs.
+)
+{
+    uint16_t    previousChannel = SavedChannelNumber;
+    le_result_t result;
+
+    if ((0 == beaconCount) || !IsChannelInRange(channelNumber))
+    {
+        return LE_OUT_OF_RANGE;
+    }
+    if (!IsHostapdStarted)
+    {
+        LE_ERROR("Access point not started");
+        return LE_UNAVAILABLE;
+    }
+
+    // The PHY configuration of the new channel is derived from the saved one
+    SavedChannelNumber = channelNumber;
+    result = SwitchHostapdChannel(channelNumber, beaconCount);
+    if (LE_UNSUPPORTED == result)
+    {
+        LE_ERROR("Channel switch not supported by the driver");
+        SavedChannelNumber = previousChannel;
+        return result;
+    }
+    IsAutoChannel = false;
+    UpdateAutoChannelTimer();
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Enable or disable the automatic channel selection. When enabled, the least loaded channel is
+ * selected from a scan and a survey of the channels before the access point starts. While started,
+ * the channel is re-evaluated periodically and switched live if the load of the current channel
+ * crosses the threshold.
+ *
+ * @return LE_BAD_PARAMETER Some parameter is invalid.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_SetAutoChannel
+(
+    bool isEnabled,
+        ///< [IN]
+        ///< Whether the channel is selected automatically.
+    uint32_t periodSec,
+        ///< [IN]
+        ///< Period in seconds of the re-evaluation while started, 0 to select on start only.
+    uint8_t loadThreshold
+        ///< [IN]
+        ///< Load in percent of the current channel above which another channel is selected.
+)
+{
+    if (loadThreshold > 100)
+    {
+        LE_ERROR("Invalid load threshold %d%%", loadThreshold);
+        return LE_BAD_PARAMETER;
+    }
+
+    IsAutoChannel = isEnabled;
+    AutoChannelPeriodSec = periodSec;
+    AutoChannelThreshold = loadThreshold;
+    UpdateAutoChannelTimer();
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the channel of the access point, as set or as selected automatically.
+ *
+ * @return LE_BAD_PARAMETER Some parameter is invalid.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_GetChannel
+(
+    uint16_t *channelNumberPtr
+        ///< [OUT]
+        ///< The channel number.
+)
+{
+    if (NULL == channelNumberPtr)
+    {
+        LE_ERROR("Invalid parameter");
+        return LE_BAD_PARAMETER;
+    }
+    *channelNumberPtr = SavedChannelNumber;
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Apply the PHY settings to the started access point, which is restarted by hostapd.
+ *
+ * @return LE_FAULT  The function failed.
+ * @return LE_OK     The function succeeded, or the access point is not started.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ApplyHostapdPhyConfig
+(
+    bool isReloadNeeded
+        ///< [IN]
+        ///< The access point must be restarted by hostapd, false to only restore the parameters.
+)
+{
+    PhyConfig_t phyConfig;
+    char        value[8];
+
+    if (!IsHostapdStarted)
+    {
+        return LE_OK;
+    }
+
+    BuildPhyConfig(&phyConfig);
+    if (LE_OK != HostapdSet("ht_capab", phyConfig.htCapab))
+    {
+        return LE_FAULT;
+    }
+    if (SavedIeeeStdMask & (LE_WIFIAP_BITMASK_IEEE_STD_AC | LE_WIFIAP_BITMASK_IEEE_STD_AX))
+    {
+        const char *prefixPtr = (SavedIeeeStdMask & LE_WIFIAP_BITMASK_IEEE_STD_AC) ? "vht" : "he";
+        char        name[32];
+
+        snprintf(value, sizeof(value), "%d",
+                 (LE_WIFIAP_CHANNEL_WIDTH_80_MHZ == phyConfig.width) ? 1 : 0);
+        snprintf(name, sizeof(name), "%s_oper_chwidth", prefixPtr);
+        if (LE_OK != HostapdSet(name, value))
+        {
+            return LE_FAULT;
+        }
+        snprintf(value, sizeof(value), "%d", phyConfig.centerChannel);
+        snprintf(name, sizeof(name), "%s_oper_centr_freq_seg0_idx", prefixPtr);
+        if (LE_OK != HostapdSet(name, value))
+        {
+            return LE_FAULT;
+        }
+    }
+    if ((SavedIeeeStdMask & LE_WIFIAP_BITMASK_IEEE_STD_AC) &&
+        (LE_OK != HostapdSet("vht_capab", phyConfig.vhtCapab)))
+    {
+        return LE_FAULT;
+    }
+    return ReloadHostapd(isReloadNeeded);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Restore the previous PHY settings once the started access point failed to apply new ones, into
+ * hostapd and into hostapd.conf.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RestoreHostapdPhyConfig
+(
+    void
+)
+{
+    if (LE_OK != ApplyHostapdPhyConfig(false))
+    {
+        LE_WARN("Unable to restore the PHY settings");
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the channel width. The 40 MHz width requires IEEE 802.11n, the 80 MHz width IEEE 802.11ac in
+ * the 5 GHz band: the width is narrowed on a channel or a hardware mode which does not allow it.
+ * If the access point is started, the setting is applied by a restart of hostapd.
+ *
+ * @return LE_BAD_PARAMETER Some parameter is invalid.
+ * @return LE_UNSUPPORTED   The radio does not support the width.
+ * @return LE_FAULT         The started access point could not be reconfigured.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_SetChannelWidth
+(
+    le_wifiAp_ChannelWidth_t width
+        ///< [IN]
+        ///< The channel width.
+)
+{
+    if ((width < LE_WIFIAP_CHANNEL_WIDTH_20_MHZ) || (width > LE_WIFIAP_CHANNEL_WIDTH_80_MHZ))
+    {
+        LE_ERROR("Invalid channel width %d", width);
+        return LE_BAD_PARAMETER;
+    }
+    if ((PhyCaps.isKnown) && (width > PhyCaps.maxWidth))
+    {
+        LE_ERROR("Channel width %d not supported by the radio", width);
+        return LE_UNSUPPORTED;
+    }
+
+    le_wifiAp_ChannelWidth_t previousWidth = SavedChannelWidth;
+    le_result_t              result;
+
+    SavedChannelWidth = width;
+    result = ApplyHostapdPhyConfig(true);
+    if (LE_OK != result)
+    {
+        SavedChannelWidth = previousWidth;
+        RestoreHostapdPhyConfig();
+    }
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the optional HT/VHT capabilities of the access point and its number of spatial streams. Each
+ * capability is enabled in HT and in VHT as far as the radio supports it. The number of spatial
+ * streams takes effect on the next start of the access point.
+ * If the access point is started, the capabilities are applied by a restart of hostapd.
+ *
+ * @return LE_BAD_PARAMETER Some parameter is invalid.
+ * @return LE_UNSUPPORTED   The radio does not support a capability or the number of streams.
+ * @return LE_FAULT         The started access point could not be reconfigured.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_SetPhyCapabilities
+(
+    le_wifiAp_PhyCapBitMask_t capMask,
+        ///< [IN]
+        ///< The optional capabilities to enable.
+    uint8_t numSpatialStreams
+        ///< [IN]
+        ///< The number of spatial streams, 0 for all the streams of the radio.
+)
+{
+    if (capMask & ~(LE_WIFIAP_PHY_CAP_SHORT_GI | LE_WIFIAP_PHY_CAP_LDPC | LE_WIFIAP_PHY_CAP_STBC))
+    {
+        LE_ERROR("Invalid capabilities 0x%" PRIx32, (uint32_t)capMask);
+        return LE_BAD_PARAMETER;
+    }
+    if ((PhyCaps.isKnown) &&
+        ((capMask & ~(PhyCaps.htCapMask | PhyCaps.vhtCapMask)) ||
+         (numSpatialStreams > PhyCaps.numStreams)))
+    {
+        LE_ERROR("Capabilities 0x%" PRIx32 " or %d streams not supported by the radio",
+                 (uint32_t)capMask, numSpatialStreams);
+        return LE_UNSUPPORTED;
+    }
+
+    le_wifiAp_PhyCapBitMask_t previousCapMask = SavedPhyCapMask;
+    uint8_t                   previousNumStreams = SavedNumSpatialStreams;
+    le_result_t               result;
+
+    SavedPhyCapMask = capMask;
+    SavedNumSpatialStreams = numSpatialStreams;
+    result = ApplyHostapdPhyConfig(true);
+    if (LE_OK != result)
+    {
+        SavedPhyCapMask = previousCapMask;
+        SavedNumSpatialStreams = previousNumStreams;
+        RestoreHostapdPhyConfig();
+    }
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the capabilities of the radio in the band of the hardware mode: the widest channel, the
+ * optional HT/VHT capabilities and the number of spatial streams. They are discovered when the
+ * access point starts, or else on this call if the WiFi hardware is started.
+ *
+ * @return LE_BAD_PARAMETER Some parameter is invalid.
+ * @return LE_UNAVAILABLE   The WiFi hardware is not started: the capabilities are unknown.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_GetPhyCapabilities
+(
+    le_wifiAp_ChannelWidth_t *maxWidthPtr,
+        ///< [OUT]
+        ///< The widest channel supported.
+    le_wifiAp_PhyCapBitMask_t *capMaskPtr,
+        ///< [OUT]
+        ///< The optional capabilities supported, in HT or in VHT.
+    uint8_t *numSpatialStreamsPtr
+        ///< [OUT]
+        ///< The number of spatial streams.
+)
+{
+    if ((NULL == maxWidthPtr) || (NULL == capMaskPtr) || (NULL == numSpatialStreamsPtr))
+    {
+        LE_ERROR("Invalid parameter");
+        return LE_BAD_PARAMETER;
+    }
+
+    if ((!PhyCaps.isKnown) && (LE_OK != DiscoverPhyInfo()))
+    {
+        return LE_UNAVAILABLE;
+    }
+
+    *maxWidthPtr = PhyCaps.maxWidth;
+    *capMaskPtr = PhyCaps.htCapMask | PhyCaps.vhtCapMask;
+    *numSpatialStreamsPtr = PhyCaps.numStreams;
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Apply the tuning parameters to the started access point, which is restarted by hostapd.
+ *
+ * @return LE_FAULT  The function failed.
+ * @return LE_OK     The function succeeded, or the access point is not started.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ApplyHostapdTuning
+(
+    bool isReloadNeeded
+        ///< [IN]
+        ///< The access point must be restarted by hostapd, false to only restore the parameters.
+)
+{
+    int param;
+
+    if (!IsHostapdStarted)
+    {
+        return LE_OK;
+    }
+
+    for (param = 0; param < TUNING_PARAM_COUNT; param++)
+    {
+        char value[12];
+
+        snprintf(value, sizeof(value), "%" PRId32, GetTuningValue(param));
+        if (LE_OK != HostapdSet(TuningParams[param].namePtr, value))
+        {
+            return LE_FAULT;
+        }
+    }
+    return ReloadHostapd(isReloadNeeded);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the tuning profile of the radio. The overridden tuning parameters are reset to the values of
+ * the profile.
+ * If the access point is started, the setting is applied by a restart of hostapd.
+ *
+ * @return LE_BAD_PARAMETER Some parameter is invalid.
+ * @return LE_FAULT         The started access point could not be reconfigured.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_SetProfile
+(
+    le_wifiAp_Profile_t profile
+        ///< [IN]
+        ///< The tuning profile.
+)
+{
+    int param;
+
+    if ((profile < LE_WIFIAP_PROFILE_DEFAULT) || (profile >= TUNING_PROFILE_COUNT))
+    {
+        LE_ERROR("Invalid profile %d", profile);
+        return LE_BAD_PARAMETER;
+    }
+
+    le_wifiAp_Profile_t previousProfile = SavedProfile;
+    int32_t             previousOverrides[TUNING_PARAM_COUNT];
+    le_result_t         result;
+
+    memcpy(previousOverrides, SavedTuningOverrides, sizeof(previousOverrides));
+    SavedProfile = profile;
+    for (param = 0; param < TUNING_PARAM_COUNT; param++)
+    {
+        SavedTuningOverrides[param] = TUNING_NOT_OVERRIDDEN;
+    }
+    result = ApplyHostapdTuning(true);
+    if (LE_OK != result)
+    {
+        SavedProfile = previousProfile;
+        memcpy(SavedTuningOverrides, previousOverrides, sizeof(SavedTuningOverrides));
+        if (LE_OK != ApplyHostapdTuning(false))
+        {
+            LE_WARN("Unable to restore the tuning parameters");
+        }
+    }
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Override a tuning parameter of the profile.
+ * If the access point is started, the setting is applied by a restart of hostapd.
+ *
+ * @return LE_BAD_PARAMETER Some parameter is invalid.
+ * @return LE_OUT_OF_RANGE  The value is out of the range of the parameter.
+ * @return LE_FAULT         The started access point could not be reconfigured.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_SetTuningParameter
+(
+    le_wifiAp_TuningParam_t param,
+        ///< [IN]
+        ///< The tuning parameter.
+    int32_t value
+        ///< [IN]
+        ///< The value of the parameter.
+)
+{
+    char valueStr[12];
+
+    if ((param < LE_WIFIAP_TUNING_BEACON_INTERVAL) || (param >= TUNING_PARAM_COUNT))
+    {
+        LE_ERROR("Invalid tuning parameter %d", param);
+        return LE_BAD_PARAMETER;
+    }
+    if ((value < TuningParams[param].min) || (value > TuningParams[param].max))
+    {
+        LE_ERROR("%s out of range: %" PRId32, TuningParams[param].namePtr, value);
+        return LE_OUT_OF_RANGE;
+    }
+    if (param >= LE_WIFIAP_TUNING_WMM_BE_AIFS)
+    {
+        // The WMM parameters are grouped by access category: AIFS, CWmin, CWmax and TXOP
+        int offset = (param - LE_WIFIAP_TUNING_WMM_BE_AIFS) % 4;
+
+        if (((1 == offset) && (value > GetTuningValue(param + 1))) ||
+            ((2 == offset) && (value < GetTuningValue(param - 1))))
+        {
+            LE_ERROR("%s out of range: CWmin above CWmax", TuningParams[param].namePtr);
+            return LE_OUT_OF_RANGE;
+        }
+    }
+
+    int32_t     previousOverride = SavedTuningOverrides[param];
+    le_result_t result;
+
+    SavedTuningOverrides[param] = value;
+    snprintf(valueStr, sizeof(valueStr), "%" PRId32, value);
+    result = ApplyHostapdParameter(TuningParams[param].namePtr, valueStr, true);
+    if (LE_OK != result)
+    {
+        SavedTuningOverrides[param] = previousOverride;
+        snprintf(valueStr, sizeof(valueStr), "%" PRId32, GetTuningValue(param));
+        RestoreHostapdParameter(TuningParams[param].namePtr, valueStr);
+    }
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the value of a tuning parameter: its override, or else its value in the profile.
+ *
+ * @return LE_BAD_PARAMETER Some parameter is invalid.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_GetTuningParameter
+(
+    le_wifiAp_TuningParam_t param,
+        ///< [IN]
+        ///< The tuning parameter.
+    int32_t *valuePtr
+        ///< [OUT]
+        ///< The value of the parameter.
+)
+{
+    if ((param < LE_WIFIAP_TUNING_BEACON_INTERVAL) || (param >= TUNING_PARAM_COUNT) ||
+        (NULL == valuePtr))
+    {
+        LE_ERROR("Invalid parameter");
+        return LE_BAD_PARAMETER;
+    }
+
+    *valuePtr = GetTuningValue(param);
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set which IEEE standard to use.
+ * Default hardware mode is IEEE 802.11g.
+ *
+ * @return
+ *      - LE_BAD_PARAMETER if invalid IEEE standard is set.
+ *      - LE_OK if the function succeeded.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_SetIeeeStandard
+(
+    le_wifiAp_IeeeStdBitMask_t stdMask
+        ///< [IN]
+        ///< Bit mask for the IEEE standard.
+)
+{
+    int8_t hwMode = stdMask & 0x0F;
+    int8_t numCheck = (hwMode & 0x1) + ((hwMode >> 1) & 0x1) +
+                       ((hwMode >> 2) & 0x1) + ((hwMode >> 3) & 0x1);
+
+    LE_INFO("Set IeeeStdBitMask : 0x%X", stdMask);
+    //Hardware mode should be set.
+    if ( 0 == numCheck )
+    {
+        LE_WARN("No hardware mode is set.");
+        return LE_BAD_PARAMETER;
+    }
+    //Hardware mode should be exclusive.
+    if ( numCheck > 1 )
+    {
+        LE_WARN("Only one hardware mode can be set.");
+        return LE_BAD_PARAMETER;
+    }
+
+    if ( stdMask & LE_WIFIAP_BITMASK_IEEE_STD_AC )
+    {
+        // ieee80211ac=1 only works with hw_mode=a
+        if ( 0 == (stdMask & LE_WIFIAP_BITMASK_IEEE_STD_A) )
+        {
+            LE_WARN("ieee80211ac=1 only works with hw_mode=a.");
+            return LE_BAD_PARAMETER;
+        }
+    }
+
+    if ( stdMask & LE_WIFIAP_BITMASK_IEEE_STD_H )
+    {
+        // ieee80211h=1 can be used only with ieee80211d=1
+        if ( 0 == (stdMask & LE_WIFIAP_BITMASK_IEEE_STD_D) )
+        {
+            LE_WARN("ieee80211h=1 only works with ieee80211d=1.");
+            return LE_BAD_PARAMETER;
+        }
+    }
+
+    if ((SavedIeeeStdMask & HARDWARE_MODE_MASK) != (stdMask & HARDWARE_MODE_MASK))
+    {
+        // The capabilities of the radio are discovered again in the new band
+        PhyCaps.isKnown = false;
+    }
+    SavedIeeeStdMask = stdMask;
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get which IEEE standard was set.
+ * Default hardware mode is IEEE 802.11g.
+ *
+ * @return
+ *      - LE_FAULT if the function failed.
+ *      - LE_OK if the function succeeded.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_GetIeeeStandard
+(
+    le_wifiAp_IeeeStdBitMask_t *stdMaskPtr
+        ///< [OUT]
+        ///< Bit mask for the IEEE standard.
+)
+{
+    if ( NULL == stdMaskPtr )
+    {
+        LE_WARN("stdMaskPtr == NULL");
+        return LE_FAULT;
+    }
+
+    *stdMaskPtr = SavedIeeeStdMask;
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set what country code to use for regulatory domain.
+ * ISO/IEC 3166-1 Alpha-2 code is used.
+ * Default country code is US.
+ * @return
+ *      - LE_FAULT if the function failed.
+ *      - LE_OK if the function succeeded.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_SetCountryCode
+(
+    const char *countryCodePtr
+        /// [IN]
+        ///< the country code.
+)
+{
+    le_result_t result = LE_FAULT;
+
+    LE_INFO("Set countryCode");
+    if (NULL != countryCodePtr)
+    {
+        uint32_t length = strlen(countryCodePtr);
+
+        if (length == LE_WIFIDEFS_ISO_COUNTRYCODE_LENGTH)
+        {
+            strncpy(&SavedCountryCode[0], &countryCodePtr[0], length );
+            SavedCountryCode[length] = '\0';
+            result = LE_OK;
+        }
+    }
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the maximum number of clients allowed to be connected to WiFi access point at the same time.
+ * Default value is 10.
+ * If the access point is started, the setting is applied at once without a restart.
+ *
+ * @note This value depends on the hardware/software capabilities of the WiFi module used. They are
+ * discovered from the driver when the access point starts; before, up to 2007 clients are accepted
+ * and the value is lowered to the capability on start. If the driver does not report its
+ * capability, up to 10 clients are accepted.
+ *
+ * @return LE_OUT_OF_RANGE  Requested number of users exceeds the capabilities of the Access Point.
+ * @return LE_FAULT         The started access point could not be reconfigured.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_SetMaxNumberClients
+(
+    int maxNumberClients
+        ///< [IN]
+        ///< The maximum number of clients. This depends on the hardware/software capabilities.
+)
+{
+    // Store maxNumberClients to be used later during startup procedure
+    le_result_t result = LE_OUT_OF_RANGE;
+    uint32_t    maxCapability = (0 != MaxNumClientsCapability) ? MaxNumClientsCapability :
+                                                                  HOSTAPD_MAX_STA_COUNT;
+
+    LE_INFO("Set max clients");
+    if ((maxNumberClients >= 1) && ((uint32_t)maxNumberClients <= maxCapability))
+    {
+       char     maxNumClients[12];
+       uint32_t previousMaxNumClients = SavedMaxNumClients;
+
+       SavedMaxNumClients = maxNumberClients;
+       snprintf(maxNumClients, sizeof(maxNumClients), "%" PRIu32, GetMaxNumSta());
+       // New stations are refused above the limit, no need to restart the access point
+       result = ApplyHostapdParameter("max_num_sta", maxNumClients, false);
+       if (LE_OK != result)
+       {
+           SavedMaxNumClients = previousMaxNumClients;
+           snprintf(maxNumClients, sizeof(maxNumClients), "%" PRIu32, GetMaxNumSta());
+           RestoreHostapdParameter("max_num_sta", maxNumClients);
+       }
+    }
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the maximum number of clients the driver supports in access point mode. It is discovered
+ * when the access point starts, or else on this call if the WiFi hardware is started.
+ *
+ * @return LE_BAD_PARAMETER Some parameter is invalid.
+ * @return LE_UNAVAILABLE   The WiFi hardware is not started or the driver does not report the
+ *                          capability: the capability is unknown.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_GetMaxNumberClientsCapability
+(
+    uint32_t *maxNumberClientsPtr
+        ///< [OUT]
+        ///< The maximum number of clients supported by the driver.
+)
+{
+    if (NULL == maxNumberClientsPtr)
+    {
+        LE_ERROR("Invalid parameter");
+        return LE_BAD_PARAMETER;
+    }
+
+    if ((0 == MaxNumClientsCapability) && (LE_OK != DiscoverPhyInfo()))
+    {
+        return LE_UNAVAILABLE;
+    }
+    if (!IsMaxNumClientsReported)
+    {
+        LE_WARN("Maximum number of stations not reported by the driver");
+        return LE_UNAVAILABLE;
+    }
+
+    *maxNumberClientsPtr = MaxNumClientsCapability;
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Define the IP address of an interface of the access point and the client IP addresses range,
+ * and open the DHCP ports on the interface.
+ *
+ * @return LE_BAD_PARAMETER At least, one of the given IP addresses is invalid.
+ * @return LE_NOT_PERMITTED The access point is bridged with its uplink.
+ * @return LE_FAULT         A system call has failed.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t SetInterfaceIpRange
+(
+    const char *ifNamePtr,
+        ///< [IN]
+        ///< the interface of the Access Point.
+    const char *ipApPtr,
+        ///< [IN]
+        ///< the IP address of the Access Point.
+    const char *ipStartPtr,
+        ///< [IN]
+        ///< the start IP address of the Access Point.
+    const char *ipStopPtr
+        ///< [IN]
+        ///< the stop IP address of the Access Point.
+)
+{
+    struct sockaddr_in  saApPtr;
+    struct sockaddr_in  saStartPtr;
+    struct sockaddr_in  saStopPtr;
+    const char         *parameterPtr = 0;
+
+    // Check the parameters
+    if ((NULL == ipApPtr) || (NULL == ipStartPtr) || (NULL == ipStopPtr))
+    {
+        return LE_BAD_PARAMETER;
+    }
+
+    // The clients of a bridged access point are addressed by the network of the uplink
+    if (LE_WIFIAP_UPLINK_BRIDGE == SavedUplinkMode)
+    {
+        LE_ERROR("IP range not used in bridge mode");
+        return LE_NOT_PERMITTED;
+    }
+
+    if ((!strlen(ipApPtr)) || (!strlen(ipStartPtr)) || (!strlen(ipStopPtr)))
+    {
+        return LE_BAD_PARAMETER;
+    }
+
+    if (inet_pton(AF_INET, ipApPtr, &(saApPtr.sin_addr)) <= 0)
+    {
+        parameterPtr = "AP";
+    }
+    else if (inet_pton(AF_INET, ipStartPtr, &(saStartPtr.sin_addr)) <= 0)
+    {
+        parameterPtr = "start";
+    }
+    else if (inet_pton(AF_INET, ipStopPtr, &(saStopPtr.sin_addr)) <= 0)
+    {
+        parameterPtr = "stop";
+    }
+
+    if (NULL != parameterPtr)
+    {
+        LE_ERROR("Invalid %s IP address", parameterPtr);
+        return LE_BAD_PARAMETER;
+    }
+    else
+    {
+        unsigned int ap = ntohl(saApPtr.sin_addr.s_addr);
+        unsigned int start = ntohl(saStartPtr.sin_addr.s_addr);
+        unsigned int stop = ntohl(saStopPtr.sin_addr.s_addr);
+
+        LE_INFO("@AP=%x, @APstart=%x, @APstop=%x",
+                ap, start, stop);
+
+        if (start > stop)
+        {
+            LE_INFO("Need to swap start & stop IP addresses.");
+            start = start ^ stop;
+            stop = stop ^ start;
+            start = start ^ stop;
+        }
+
+        if ((ap >= start) && (ap <= stop))
+        {
+            LE_ERROR("AP IP address is within the range.");
+            return LE_BAD_PARAMETER;
+        }
+    }
+
+    putenv("PATH=/legato/systems/current/bin:/usr/local/bin:"
+        "/usr/bin:/bin:/usr/local/sbin:/usr/sbin:/sbin");
+
+    {
+        char cmd[256];
+        int  systemResult;
+
+        snprintf((char *)&cmd, sizeof(cmd), "%s%s %s %s",
+                ScriptPath,
+                COMMAND_WIFIAP_WLAN_UP,
+                ipApPtr,
+                ifNamePtr);
+
+        systemResult = system(cmd);
+        if (0 != WEXITSTATUS (systemResult))
+        {
+            LE_ERROR("Unable to mount the network interface.");
+            return LE_FAULT;
+        }
+        else
+        {
+            LE_INFO("%s: @AP=%s, @APstart=%s, @APstop=%s", ifNamePtr, ipApPtr, ipStartPtr,
+                    ipStopPtr);
+
+            // Insert the rule allowing the DHCP ports on WLAN
+            if (LE_OK != RunInterfaceCommand(COMMAND_IPTABLE_DHCP_INSERT, ifNamePtr))
+            {
+                LE_ERROR("Unable to allow DHCP ports.");
+                return LE_FAULT;
+            }
+        }
+    }
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Define the access point IP address and the client IP addresses range.
+ *
+ * @note The access point IP address must be defined outside the client IP addresses range. The
+ * addresses are served by the DHCP server of the WiFi service.
+ *
+ * @return LE_BAD_PARAMETER At least, one of the given IP addresses is invalid.
+ * @return LE_NOT_PERMITTED The access point is bridged with its uplink.
+ * @return LE_FAULT         A system call has failed.
+ * @return LE_OK            Function succeeded.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_SetIpRange
+(
+    const char *ipApPtr,
+        ///< [IN]
+        ///< the IP address of the Access Point.
+    const char *ipStartPtr,
+        ///< [IN]
+        ///< the start IP address of the Access Point.
+    const char *ipStopPtr
+        ///< [IN]
+        ///< the stop IP address of the Access Point.
+)
+{
+    return SetInterfaceIpRange(GetApInterface(), ipApPtr, ipStartPtr, ipStopPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the uplink of the access point: the WiFi interface is either bridged at layer 2 with the
+ * uplink interface, or routed to it with NAT. Default is no uplink.
+ * If the access point is started, a NAT uplink is applied at once without a restart.
+ *
+ * @return LE_BAD_PARAMETER Some parameter is invalid, or the uplink interface does not exist.
+ * @return LE_BUSY          The access point is started and the bridge mode is set or requested.
+ * @return LE_FAULT         The uplink could not be set up.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_SetUplink
+(
+    le_wifiAp_UplinkMode_t mode,
+        ///< [IN]
+        ///< The uplink mode.
+    const char *ifNamePtr
+        ///< [IN]
+        ///< The uplink interface, ignored without uplink.
+)
+{
+    char ifName[LE_WIFIDEFS_MAX_IFNAME_BYTES] = "";
+
+    if ((LE_WIFIAP_UPLINK_NONE != mode) && (LE_WIFIAP_UPLINK_BRIDGE != mode) &&
+        (LE_WIFIAP_UPLINK_NAT != mode))
+    {
+        LE_ERROR("Invalid uplink mode %d", mode);
+        return LE_BAD_PARAMETER;
+    }
+    if (LE_WIFIAP_UPLINK_NONE != mode)
+    {
+        if ((!IsValidInterfaceName(ifNamePtr)) || (0 == strcmp(ifNamePtr, GetApInterface())) ||
+            (LE_OK != le_utf8_Copy(ifName, ifNamePtr, sizeof(ifName), NULL)))
+        {
+            LE_ERROR("Invalid uplink interface");
+            return LE_BAD_PARAMETER;
+        }
+        if (0 == if_nametoindex(ifName))
+        {
+            LE_ERROR("Uplink interface %s not found", ifName);
+            return LE_BAD_PARAMETER;
+        }
+    }
+
+    if (IsHostapdStarted)
+    {
+        // hostapd adds the WiFi interface to the bridge only when it starts
+        if ((LE_WIFIAP_UPLINK_BRIDGE == SavedUplinkMode) || (LE_WIFIAP_UPLINK_BRIDGE == mode))
+        {
+            LE_ERROR("Bridge mode changed while the access point is started");
+            return LE_BUSY;
+        }
+        StopUplink();
+    }
+
+    SavedUplinkMode = mode;
+    le_utf8_Copy(SavedUplinkIfName, ifName, sizeof(SavedUplinkIfName), NULL);
+    LE_INFO("Uplink mode %d, interface %s", SavedUplinkMode, SavedUplinkIfName);
+
+    return IsHostapdStarted ? StartUplink() : LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the uplink of the access point.
+ *
+ * @return LE_BAD_PARAMETER Some parameter is invalid.
+ * @return LE_OVERFLOW      The interface name does not fit in the buffer.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_GetUplink
+(
+    le_wifiAp_UplinkMode_t *modePtr,
+        ///< [OUT]
+        ///< The uplink mode.
+    char *ifNamePtr,
+        ///< [OUT]
+        ///< The uplink interface, empty without uplink.
+    size_t ifNameSize
+        ///< [IN]
+        ///< The size in bytes of the interface name buffer.
+)
+{
+    if ((NULL == modePtr) || (NULL == ifNamePtr))
+    {
+        LE_ERROR("Invalid parameter");
+        return LE_BAD_PARAMETER;
+    }
+
+    *modePtr = SavedUplinkMode;
+    return le_utf8_Copy(ifNamePtr, SavedUplinkIfName, ifNameSize, NULL);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Enable or disable the fast path of the NAT uplink, which offloads the established flows to a
+ * flowtable. Default is disabled.
+ * If the access point is started with a NAT uplink, the setting is applied at once.
+ *
+ * @return LE_FAULT  The flowtable could not be installed: the flows stay on the netfilter path.
+ * @return LE_OK     Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_SetNatOffload
+(
+    bool enable
+        ///< [IN]
+        ///< True to offload the established flows.
+)
+{
+    IsNatOffloadEnabled = enable;
+    if ((!IsHostapdStarted) || (LE_WIFIAP_UPLINK_NAT != SavedUplinkMode))
+    {
+        return LE_OK;
+    }
+
+    if (enable)
+    {
+        return StartNatOffload();
+    }
+    StopNatOffload();
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the traffic statistics of the access point: byte counters of the WiFi interface, throughput
+ * since the previous call and number of flows offloaded to the fast path of the NAT uplink.
+ *
+ * @return LE_BAD_PARAMETER Some parameter is invalid.
+ * @return LE_FAULT         The function failed.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_GetUplinkStats
+(
+    le_wifiAp_UplinkStats_t *statsPtr
+        ///< [OUT]
+        ///< Statistics of the uplink.
+)
+{
+    const char    rxBytesPrefix[]   = "rx bytes:";
+    const char    txBytesPrefix[]   = "tx bytes:";
+    const char    offloadedPrefix[] = "offloaded flows:";
+    char          path[TEMP_STRING_MAX_BYTES];
+    FILE         *statsPipePtr;
+    le_clk_Time_t now;
+    le_clk_Time_t elapsed;
+    uint64_t      elapsedMs;
+    int           st;
+
+    if (NULL == statsPtr)
+    {
+        LE_ERROR("Invalid parameter");
+        return LE_BAD_PARAMETER;
+    }
+
+    statsPipePtr = OpenScript(COMMAND_WIFIAP_NAT_STATS);
+    if (NULL == statsPipePtr)
+    {
+        LE_ERROR("Failed to run command \"%s\": errno:%d: \"%s\" ",
+                COMMAND_WIFIAP_NAT_STATS,
+                errno,
+                strerror(errno));
+        return LE_FAULT;
+    }
+
+    memset(statsPtr, 0, sizeof(*statsPtr));
+    while (NULL != fgets(path, sizeof(path), statsPipePtr))
+    {
+        if (0 == strncmp(rxBytesPrefix, path, sizeof(rxBytesPrefix) - 1))
+        {
+            statsPtr->rxBytes = strtoull(&path[sizeof(rxBytesPrefix) - 1], NULL, 10);
+        }
+        else if (0 == strncmp(txBytesPrefix, path, sizeof(txBytesPrefix) - 1))
+        {
+            statsPtr->txBytes = strtoull(&path[sizeof(txBytesPrefix) - 1], NULL, 10);
+        }
+        else if (0 == strncmp(offloadedPrefix, path, sizeof(offloadedPrefix) - 1))
+        {
+            statsPtr->offloadedFlows = strtoul(&path[sizeof(offloadedPrefix) - 1], NULL, 10);
+        }
+    }
+
+    st = pclose(statsPipePtr);
+    if (!WIFEXITED(st) || (0 != WEXITSTATUS(st)))
+    {
+        LE_ERROR("WiFi AP Command \"%s\" Failed: (%d)", COMMAND_WIFIAP_NAT_STATS, st);
+        return LE_FAULT;
+    }
+
+    // Throughput in kbit/s since the previous call, unless the counters were reset meanwhile
+    now = le_clk_GetRelativeTime();
+    elapsed = le_clk_Sub(now, UplinkStatsTime);
+    elapsedMs = ((uint64_t)elapsed.sec * 1000) + (elapsed.usec / 1000);
+    if ((0 != UplinkStatsTime.sec) && (0 != elapsedMs) &&
+        (statsPtr->rxBytes >= UplinkStatsRxBytes) && (statsPtr->txBytes >= UplinkStatsTxBytes))
+    {
+        statsPtr->rxKbps = (uint32_t)(((statsPtr->rxBytes - UplinkStatsRxBytes) * 8) / elapsedMs);
+        statsPtr->txKbps = (uint32_t)(((statsPtr->txBytes - UplinkStatsTxBytes) * 8) / elapsedMs);
+    }
+    UplinkStatsRxBytes = statsPtr->rxBytes;
+    UplinkStatsTxBytes = statsPtr->txBytes;
+    UplinkStatsTime = now;
+
+    statsPtr->isOffloaded = IsNatOffloaded;
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get an additional BSS of the access point.
+ *
+ * @return The BSS, NULL if the index is invalid or the BSS is not created.
+ */
+//--------------------------------------------------------------------------------------------------
+static Bss_t *GetBss
+(
+    uint8_t bssIndex
+)
+{
+    if ((bssIndex >= PA_WIFIAP_MAX_BSS) || (!BssList[bssIndex].isCreated))
+    {
+        LE_ERROR("Invalid BSS index %d", bssIndex);
+        return NULL;
+    }
+    return &BssList[bssIndex];
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Apply the settings of an additional BSS to the access point if started. hostapd.conf is generated
+ * again and the BSS alone reloads it with RELOAD_BSS: the radio, the access point and the other BSS
+ * keep running. A hostapd without RELOAD_BSS reloads the whole interface instead, which restarts
+ * the radio and disconnects the stations of every BSS. WPA2 is applied only once a passphrase or a
+ * PSK is known.
+ *
+ * @return LE_FAULT  The function failed.
+ * @return LE_OK     The function succeeded, or the access point is not started.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ApplyBss
+(
+    const Bss_t *bssPtr
+)
+{
+    if (!IsHostapdStarted)
+    {
+        return LE_OK;
+    }
+    if ((LE_WIFIAP_SECURITY_WPA2 == bssPtr->securityProtocol) &&
+        ('\0' == bssPtr->passphrase[0]) && ('\0' == bssPtr->preSharedKey[0]))
+    {
+        LE_INFO("WPA2 applied once the passphrase or the PSK is set");
+        return LE_OK;
+    }
+
+    if (LE_OK != GenerateHostapdConf())
+    {
+        LE_ERROR("Unable to apply the settings of BSS %s", bssPtr->ifName);
+        return LE_FAULT;
+    }
+    if (LE_OK == HostapdBssCommand(bssPtr->ifName, "RELOAD_BSS"))
+    {
+        return LE_OK;
+    }
+    LE_WARN("BSS %s not reloaded alone, restarting the radio", bssPtr->ifName);
+    return HostapdCommand("RELOAD");
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create an additional BSS sharing the radio of the access point, with its own interface. It is
+ * started with the access point, once given an SSID. Its security is disabled and its client
+ * limit is the default one.
+ *
+ * @return LE_BAD_PARAMETER Some parameter is invalid.
+ * @return LE_BUSY          The access point is started.
+ * @return LE_NO_MEMORY     The maximum number of BSS is reached.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_CreateBss
+(
+    uint8_t *bssIndexPtr
+        ///< [OUT]
+        ///< Index of the BSS.
+)
+{
+    uint8_t bssIndex;
+
+    if (NULL == bssIndexPtr)
+    {
+        LE_ERROR("Invalid parameter");
+        return LE_BAD_PARAMETER;
+    }
+    // hostapd does not add a BSS on reload
+    if (IsHostapdStarted)
+    {
+        LE_ERROR("BSS created while the access point is started");
+        return LE_BUSY;
+    }
+
+    for (bssIndex = 0; bssIndex < PA_WIFIAP_MAX_BSS; bssIndex++)
+    {
+        Bss_t *bssPtr = &BssList[bssIndex];
+
+        if (!bssPtr->isCreated)
+        {
+            memset(bssPtr, 0, sizeof(*bssPtr));
+            bssPtr->isCreated = true;
+            snprintf(bssPtr->ifName, sizeof(bssPtr->ifName), "%s_%d", GetApInterface(),
+                     bssIndex + 1);
+            bssPtr->securityProtocol = LE_WIFIAP_SECURITY_NONE;
+            bssPtr->maxNumClients = WIFI_MAX_USERS;
+            *bssIndexPtr = bssIndex;
+            LE_INFO("BSS %s created", bssPtr->ifName);
+            return LE_OK;
+        }
+    }
+
+    LE_ERROR("No BSS left");
+    return LE_NO_MEMORY;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete an additional BSS of the access point.
+ *
+ * @return LE_BAD_PARAMETER Some parameter is invalid.
+ * @return LE_BUSY          The access point is started.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_DeleteBss
+(
+    uint8_t bssIndex
+        ///< [IN]
+        ///< Index of the BSS.
+)
+{
+    Bss_t *bssPtr = GetBss(bssIndex);
+
+    if (NULL == bssPtr)
+    {
+        return LE_BAD_PARAMETER;
+    }
+    if (IsHostapdStarted)
+    {
+        LE_ERROR("BSS deleted while the access point is started");
+        return LE_BUSY;
+    }
+
+    LE_INFO("BSS %s deleted", bssPtr->ifName);
+    bssPtr->isCreated = false;
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the network interface of an additional BSS of the access point.
+ *
+ * @return LE_BAD_PARAMETER Some parameter is invalid.
+ * @return LE_OVERFLOW      The interface name does not fit in the buffer.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_GetBssInterface
+(
+    uint8_t bssIndex,
+        ///< [IN]
+        ///< Index of the BSS.
+    char *ifNamePtr,
+        ///< [OUT]
+        ///< The network interface of the BSS.
+    size_t ifNameSize
+        ///< [IN]
+        ///< The size in bytes of the interface name buffer.
+)
+{
+    Bss_t *bssPtr = GetBss(bssIndex);
+
+    if ((NULL == bssPtr) || (NULL == ifNamePtr))
+    {
+        return LE_BAD_PARAMETER;
+    }
+    return le_utf8_Copy(ifNamePtr, bssPtr->ifName, ifNameSize, NULL);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the SSID of an additional BSS of the access point.
+ * If the access point is started, the setting is applied at once: the BSS alone is reloaded,
+ * or the whole radio if hostapd cannot reload a single BSS.
+ *
+ * @return LE_BAD_PARAMETER Some parameter is invalid.
+ * @return LE_FAULT         The started access point could not be reconfigured.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_SetBssSsid
+(
+    uint8_t bssIndex,
+        ///< [IN]
+        ///< Index of the BSS.
+    const uint8_t *ssidPtr,
+        ///< [IN]
+        ///< The SSID to set as an octet array.
+    size_t ssidNumElements
+        ///< [IN]
+        ///< The length of the SSID in bytes.
+)
+{
+    Bss_t *bssPtr = GetBss(bssIndex);
+
+    if ((NULL == bssPtr) || (NULL == ssidPtr) || (0 == ssidNumElements) ||
+        (ssidNumElements > LE_WIFIDEFS_MAX_SSID_LENGTH))
+    {
+        LE_ERROR("Invalid SSID");
+        return LE_BAD_PARAMETER;
+    }
 
-error:
-    le_thread_Cancel(WifiApPaThread);
-    le_thread_Join(WifiApPaThread, NULL);
-    return LE_FAULT;
+    memcpy(bssPtr->ssid, ssidPtr, ssidNumElements);
+    bssPtr->ssid[ssidNumElements] = '\0';
+    LE_INFO("BSS %s SSID: \"%s\"", bssPtr->ifName, bssPtr->ssid);
+    return ApplyBss(bssPtr);
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * This function stops the WiFi access point.
- *
- * @return LE_FAULT         The function failed.
- * @return LE_OK            The function succeeded.
+ * Set the security protocol of an additional BSS of the access point.
+ * If the access point is started, the setting is applied at once: the BSS alone is reloaded,
+ * or the whole radio if hostapd cannot reload a single BSS.
  *
+ * @return LE_BAD_PARAMETER Some parameter is invalid.
+ * @return LE_FAULT         The started access point could not be reconfigured.
+ * @return LE_OK            Function succeeded.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t pa_wifiAp_Stop
+le_result_t pa_wifiAp_SetBssSecurityProtocol
 (
-    void
+    uint8_t bssIndex,
+        ///< [IN]
+        ///< Index of the BSS.
+    le_wifiAp_SecurityProtocol_t securityProtocol
+        ///< [IN]
+        ///< The security protocol used to communicate with the BSS.
 )
 {
-    int status;
+    Bss_t *bssPtr = GetBss(bssIndex);
 
-    // Try to delete the rule allowing the DHCP ports on WLAN. Ignore if it fails
-    status = system(WIFI_SCRIPT_PATH COMMAND_IPTABLE_DHCP_DELETE);
-    if ((!WIFEXITED(status)) || (0 != WEXITSTATUS(status)))
+    if ((NULL == bssPtr) ||
+        ((LE_WIFIAP_SECURITY_NONE != securityProtocol) &&
+         (LE_WIFIAP_SECURITY_WPA2 != securityProtocol)))
     {
-        LE_WARN("Deleting rule for DHCP port fails");
+        return LE_BAD_PARAMETER;
     }
 
-    status = system(WIFI_SCRIPT_PATH COMMAND_WIFIAP_HOSTAPD_STOP);
-    if ((!WIFEXITED(status)) || (0 != WEXITSTATUS(status)))
-    {
-        LE_ERROR("WiFi AP Command \"%s\" Failed: (%d)",
-                COMMAND_WIFIAP_HOSTAPD_STOP,
-                status);
-        return LE_FAULT;
-    }
+    bssPtr->securityProtocol = securityProtocol;
+    return ApplyBss(bssPtr);
+}
 
-    status = system(WIFI_SCRIPT_PATH COMMAND_WIFI_HW_STOP);
-    if ((!WIFEXITED(status)) || (0 != WEXITSTATUS(status)))
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the passphrase used to generate the PSK of an additional BSS of the access point.
+ * If the access point is started, the setting is applied at once: the BSS alone is reloaded,
+ * or the whole radio if hostapd cannot reload a single BSS.
+ *
+ * @return LE_BAD_PARAMETER Some parameter is invalid.
+ * @return LE_FAULT         The started access point could not be reconfigured.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_SetBssPassPhrase
+(
+    uint8_t bssIndex,
+        ///< [IN]
+        ///< Index of the BSS.
+    const char *passphrasePtr
+        ///< [IN]
+        ///< Passphrase to authenticate against the BSS.
+)
+{
+    Bss_t *bssPtr = GetBss(bssIndex);
+    size_t length;
+
+    if ((NULL == bssPtr) || (NULL == passphrasePtr))
     {
-        LE_ERROR("WiFi AP Command \"%s\" Failed: (%d)", COMMAND_WIFI_HW_STOP, status);
-        return LE_FAULT;
+        return LE_BAD_PARAMETER;
     }
-
-    // Cancel the previously created thread
-    le_thread_Cancel(WifiApPaThread);
-    if (LE_OK != le_thread_Join(WifiApPaThread, NULL))
+    length = strlen(passphrasePtr);
+    if ((length < LE_WIFIDEFS_MIN_PASSPHRASE_LENGTH) ||
+        (length > LE_WIFIDEFS_MAX_PASSPHRASE_LENGTH))
     {
-        return LE_FAULT;
+        LE_ERROR("Invalid passphrase length (%zu) [%d..%d]", length,
+                 LE_WIFIDEFS_MIN_PASSPHRASE_LENGTH, LE_WIFIDEFS_MAX_PASSPHRASE_LENGTH);
+        return LE_BAD_PARAMETER;
     }
 
-    // Remove the previously created hostapd.conf file in /tmp
-    remove(WIFI_HOSTAPD_FILE);
-
-    LE_INFO("WiFi AP stopped correclty");
-    return LE_OK;
+    le_utf8_Copy(bssPtr->passphrase, passphrasePtr, sizeof(bssPtr->passphrase), NULL);
+    return ApplyBss(bssPtr);
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Add handler function for WiFi related events.
- *
- * These events provide information on WiFi access point status.
+ * Set the pre-shared key (PSK) of an additional BSS of the access point.
+ * If the access point is started, the setting is applied at once: the BSS alone is reloaded,
+ * or the whole radio if hostapd cannot reload a single BSS.
  *
  * @return LE_BAD_PARAMETER Some parameter is invalid.
+ * @return LE_FAULT         The started access point could not be reconfigured.
  * @return LE_OK            Function succeeded.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t  pa_wifiAp_AddEventHandler
+le_result_t pa_wifiAp_SetBssPreSharedKey
 (
-    pa_wifiAp_NewEventHandlerFunc_t handlerPtr,
+    uint8_t bssIndex,
         ///< [IN]
-        ///< Event handler function pointer
-
-    void *contextPtr
+        ///< Index of the BSS.
+    const char *preSharedKeyPtr
         ///< [IN]
-        ///< Associated event context
+        ///< Pre-shared key used to authenticate against the BSS.
 )
 {
-    le_event_HandlerRef_t handlerRef;
+    Bss_t *bssPtr = GetBss(bssIndex);
 
-    handlerRef = le_event_AddLayeredHandler("WifiApPaHandler",
-                                            WifiApPaEvent,
-                                            FirstLayerWifiApEventHandler,
-                                            (le_event_HandlerFunc_t)handlerPtr);
-    if (NULL == handlerRef)
+    if ((NULL == bssPtr) || (NULL == preSharedKeyPtr) ||
+        (strlen(preSharedKeyPtr) > LE_WIFIDEFS_MAX_PSK_LENGTH))
     {
-        LE_ERROR("ERROR: le_event_AddLayeredHandler returned NULL");
         return LE_BAD_PARAMETER;
     }
 
-    le_event_SetContextPtr(handlerRef, contextPtr);
-    return LE_OK;
+    le_utf8_Copy(bssPtr->preSharedKey, preSharedKeyPtr, sizeof(bssPtr->preSharedKey), NULL);
+    return ApplyBss(bssPtr);
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Set the Service Set IDentification (SSID) of the access point
- *
- * @note The SSID does not have to be human readable ASCII values, but often is.
+ * Set the maximum number of clients connected to an additional BSS of the access point at the
+ * same time. Default value is 10.
+ * If the access point is started, the setting is applied at once: the BSS alone is reloaded,
+ * or the whole radio if hostapd cannot reload a single BSS.
  *
  * @return LE_BAD_PARAMETER Some parameter is invalid.
+ * @return LE_OUT_OF_RANGE  Requested number of users exceeds the capabilities of the Access Point.
+ * @return LE_FAULT         The started access point could not be reconfigured.
  * @return LE_OK            Function succeeded.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t pa_wifiAp_SetSsid
+le_result_t pa_wifiAp_SetBssMaxNumberClients
 (
-    const uint8_t *ssidPtr,
+    uint8_t bssIndex,
         ///< [IN]
-        ///< The SSID to set as an octet array.
-
-    size_t ssidNumElements
+        ///< Index of the BSS.
+    int maxNumberClients
         ///< [IN]
-        ///< The length of the SSID in bytes.
+        ///< The maximum number of clients of the BSS.
 )
 {
-    le_result_t result = LE_BAD_PARAMETER;
-
-    LE_INFO("SSID length %d | SSID: \"%.*s\"",
-            (int)ssidNumElements,
-            (int)ssidNumElements,
-            (char *)ssidPtr);
+    Bss_t    *bssPtr = GetBss(bssIndex);
+    uint32_t  maxCapability = (0 != MaxNumClientsCapability) ? MaxNumClientsCapability :
+                                                                HOSTAPD_MAX_STA_COUNT;
 
-    if ((0 < ssidNumElements) && (ssidNumElements <= LE_WIFIDEFS_MAX_SSID_LENGTH))
+    if (NULL == bssPtr)
     {
-        // Store SSID to be used later during startup procedure
-        memcpy(&SavedSsid[0], (const char *)&ssidPtr[0], ssidNumElements);
-        // Make sure there is a null termination
-        SavedSsid[ssidNumElements] = '\0';
-        result = LE_OK;
+        return LE_BAD_PARAMETER;
     }
-    else
+    if ((maxNumberClients < 1) || ((uint32_t)maxNumberClients > maxCapability))
     {
-        LE_ERROR("ERROR: SSID length exceeds %d bytes\n", LE_WIFIDEFS_MAX_SSID_LENGTH);
+        return LE_OUT_OF_RANGE;
     }
-    return result;
+
+    bssPtr->maxNumClients = maxNumberClients;
+    return ApplyBss(bssPtr);
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Set the security protocol used to communicate.
- *
- * @note WEP is not supported as it is unsecure and has been deprecated in favor of WPA/WPA2.
- * This limitation applies to access point mode only.
+ * Define the IP address of an additional BSS of the access point and its client IP addresses
+ * range. The BSS interface exists only while the access point is started.
  *
- * @return LE_BAD_PARAMETER Some parameter is invalid.
+ * @return LE_BAD_PARAMETER At least, one of the given IP addresses is invalid.
+ * @return LE_NOT_PERMITTED The access point is bridged with its uplink.
+ * @return LE_FAULT         A system call has failed.
  * @return LE_OK            Function succeeded.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t pa_wifiAp_SetSecurityProtocol
+le_result_t pa_wifiAp_SetBssIpRange
 (
-    le_wifiAp_SecurityProtocol_t securityProtocol
+    uint8_t bssIndex,
         ///< [IN]
-        ///< The security protocol used to communicate with the access point.
+        ///< Index of the BSS.
+    const char *ipApPtr,
+        ///< [IN]
+        ///< the IP address of the BSS.
+    const char *ipStartPtr,
+        ///< [IN]
+        ///< the start IP address of the BSS clients.
+    const char *ipStopPtr
+        ///< [IN]
+        ///< the stop IP address of the BSS clients.
 )
 {
-    le_result_t result;
+    Bss_t       *bssPtr = GetBss(bssIndex);
+    le_result_t  result;
 
-    LE_INFO("Security protocol : %d", securityProtocol);
-    switch (securityProtocol)
+    if (NULL == bssPtr)
     {
-        case LE_WIFIAP_SECURITY_NONE:
-        case LE_WIFIAP_SECURITY_WPA2:
-            SavedSecurityProtocol = securityProtocol;
-            result = LE_OK;
-            break;
+        return LE_BAD_PARAMETER;
+    }
 
-        default:
-            result = LE_BAD_PARAMETER;
-            break;
+    // The DHCP ports are already open on the interface for a previous range
+    if ((bssPtr->isIpRangeSet) &&
+        (LE_OK != RunInterfaceCommand(COMMAND_IPTABLE_DHCP_DELETE, bssPtr->ifName)))
+    {
+        LE_WARN("Deleting rule for DHCP port of %s fails", bssPtr->ifName);
     }
+    bssPtr->isIpRangeSet = false;
+
+    result = SetInterfaceIpRange(bssPtr->ifName, ipApPtr, ipStartPtr, ipStopPtr);
+    bssPtr->isIpRangeSet = (LE_OK == result);
     return result;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Set the passphrase used to generate the PSK.
- *
- * @note This is one way to authenticate against the access point. The other one is provided by the
- * pa_wifiAp_SetPreSharedKey() function. Both ways are exclusive and are effective only when used
- * with WPA-personal authentication.
+ * Set the concurrent mode of the access point: it runs on a virtual interface next to the station
+ * interface of the WiFi client, on the channel of the station if connected. Default is disabled.
  *
- * @return LE_BAD_PARAMETER Parameter is invalid.
+ * @return LE_BUSY          The access point is started.
  * @return LE_OK            Function succeeded.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t pa_wifiAp_SetPassPhrase
+le_result_t pa_wifiAp_SetConcurrentMode
 (
-    const char *passphrasePtr
+    bool isConcurrent
         ///< [IN]
-        ///< Passphrase to authenticate against the access point.
+        ///< True to run the access point concurrently with the station.
 )
 {
-    le_result_t result = LE_BAD_PARAMETER;
+    int bss;
 
-    LE_INFO("Set passphrase");
-    if (NULL != passphrasePtr)
+    // The virtual interface is created and deleted with hostapd
+    if (IsHostapdStarted)
     {
-        uint32_t length = strlen(passphrasePtr);
+        LE_ERROR("Concurrent mode changed while the access point is started");
+        return LE_BUSY;
+    }
 
-        if ((length >= LE_WIFIDEFS_MIN_PASSPHRASE_LENGTH) &&
-            (length <= LE_WIFIDEFS_MAX_PASSPHRASE_LENGTH))
-        {
-            // Store Passphrase to be used later during startup procedure
-            le_utf8_Copy(SavedPassphrase, passphrasePtr, sizeof(SavedPassphrase), NULL);
-            result = LE_OK;
-        }
-        else
+    IsConcurrent = isConcurrent;
+    // The additional BSS are named after the interface of the access point
+    for (bss = 0; bss < PA_WIFIAP_MAX_BSS; bss++)
+    {
+        if (BssList[bss].isCreated)
         {
-            LE_ERROR("Invalid passphrase length (%d) [%d..%d]",
-                    length,
-                    LE_WIFIDEFS_MIN_PASSPHRASE_LENGTH,
-                    LE_WIFIDEFS_MAX_PASSPHRASE_LENGTH);
+            snprintf(BssList[bss].ifName, sizeof(BssList[bss].ifName), "%s_%d", GetApInterface(),
+                     bss + 1);
         }
     }
-    return result;
+    LE_INFO("Concurrent mode %s, interface %s", IsConcurrent ? "enabled" : "disabled",
+            GetApInterface());
+    return LE_OK;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Set the pre-shared key (PSK).
+ * Get the network interface of the access point, depending on the concurrent mode.
  *
- * @note This is one way to authenticate against the access point. The other one is provided by the
- * pa_wifiAp_SetPassPhrase() function. Both ways are exclusive and are effective only when used
- * with WPA-personal authentication.
+ * @return LE_OVERFLOW      The interface name is too long for the buffer.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_GetInterface
+(
+    char *ifNamePtr,
+        ///< [OUT]
+        ///< The network interface of the access point.
+    size_t ifNameSize
+        ///< [IN]
+        ///< Size of the interface name buffer.
+)
+{
+    return le_utf8_Copy(ifNamePtr, GetApInterface(), ifNameSize, NULL);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Select the network interface of the radio of the access point, for a module with several radios.
+ * In concurrent mode, it must be the station interface of the WiFi client. Default is
+ * PA_WIFIAP_INTERFACE.
  *
- * @return LE_BAD_PARAMETER Parameter is invalid.
+ * @return LE_BAD_PARAMETER The interface name is empty, too long for the names of the additional
+ *                          BSS, or has invalid characters.
+ * @return LE_BUSY          The access point is started.
  * @return LE_OK            Function succeeded.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t pa_wifiAp_SetPreSharedKey
+le_result_t pa_wifiAp_SetInterface
 (
-    const char *preSharedKeyPtr
+    const char *ifNamePtr
         ///< [IN]
-        ///< Pre-shared key used to authenticate against the access point.
+        ///< Network interface of the radio of the access point.
 )
 {
-    le_result_t result = LE_BAD_PARAMETER;
+    int bss;
 
-    LE_INFO("Set PSK");
-    if (NULL != preSharedKeyPtr)
+    // The additional BSS are named <interface>_<index>, which must fit as well
+    if ((NULL == ifNamePtr) ||
+        (LE_WIFIDEFS_MAX_IFNAME_LENGTH < strnlen(ifNamePtr, LE_WIFIDEFS_MAX_IFNAME_BYTES)) ||
+        (!IsValidInterfaceName(ifNamePtr)) ||
+        (snprintf(NULL, 0, "%s_%d", ifNamePtr, PA_WIFIAP_MAX_BSS) >= IFNAMSIZ))
     {
-        uint32_t length = strlen(preSharedKeyPtr);
+        LE_ERROR("Invalid interface name");
+        return LE_BAD_PARAMETER;
+    }
 
-        if (length <= LE_WIFIDEFS_MAX_PSK_LENGTH)
+    if (IsHostapdStarted)
+    {
+        LE_ERROR("Interface changed while the access point is started");
+        return LE_BUSY;
+    }
+
+    le_utf8_Copy(ApIfName, ifNamePtr, sizeof(ApIfName), NULL);
+    snprintf(ScriptPath, sizeof(ScriptPath), "%s-i %s ", WIFI_SCRIPT_PATH, ApIfName);
+    // The additional BSS are named after the interface of the access point
+    for (bss = 0; bss < PA_WIFIAP_MAX_BSS; bss++)
+    {
+        if (BssList[bss].isCreated)
         {
-            // Store PSK to be used later during startup procedure
-            le_utf8_Copy(SavedPreSharedKey, preSharedKeyPtr, sizeof(SavedPreSharedKey), NULL);
-            result = LE_OK;
+            snprintf(BssList[bss].ifName, sizeof(BssList[bss].ifName), "%s_%d", GetApInterface(),
+                     bss + 1);
         }
     }
-    return result;
+    LE_INFO("Access point radio interface set to %s", ApIfName);
+    return LE_OK;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Set if the access point should announce its presence.
- * Default value is TRUE.
- * If the value is set to FALSE, the access point will be hidden.
+ * Copy a MAC address in lower case, as reported by the driver, once checked: it is passed to the
+ * script.
  *
+ * @return LE_BAD_PARAMETER The MAC address is not of the form 12:34:56:78:9a:bc.
  * @return LE_OK            Function succeeded.
- *
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t pa_wifiAp_SetDiscoverable
+static le_result_t CopyMacAddress
 (
-    bool isDiscoverable
-        ///< [IN]
-        ///< If TRUE, the access point SSID is visible by the clients otherwise it is hidden.
+    char       *destPtr,
+    const char *macAddrPtr
 )
 {
-    // Store Discoverable to be used later during startup procedure
-    LE_INFO("Set discoverability");
-    SavedDiscoverable = isDiscoverable;
+    int i;
+
+    if ((NULL == macAddrPtr) || (LE_WIFIDEFS_MAX_BSSID_LENGTH != strlen(macAddrPtr)))
+    {
+        return LE_BAD_PARAMETER;
+    }
+    for (i = 0; i < LE_WIFIDEFS_MAX_BSSID_LENGTH; i++)
+    {
+        if ((2 == (i % 3)) ? (':' != macAddrPtr[i]) : (!isxdigit((unsigned char)macAddrPtr[i])))
+        {
+            return LE_BAD_PARAMETER;
+        }
+        destPtr[i] = tolower((unsigned char)macAddrPtr[i]);
+    }
+    destPtr[i] = '\0';
     return LE_OK;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Set which WiFi channel to use.
- * Default number is 7.
- * Some legal restrictions might apply for your region.
- * The channel number must be between 1 and 14 for IEEE 802.11b/g.
- * The channel number must be between 7 and 196 for IEEE 802.11a.
- * The channel number must be between 1 and 6 for IEEE 802.11ad.
- * @return
- *      - LE_OUT_OF_RANGE if requested channel number is out of range.
- *      - LE_OK if the function succeeded.
+ * Get the rate limit slot of a station.
  *
+ * @return The slot, -1 if the station has no rate limit.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t pa_wifiAp_SetChannel
+static int FindRateLimit
 (
-    uint16_t channelNumber
+    const char *macAddrPtr
         ///< [IN]
-        ///< the channel number.
+        ///< MAC address of the station, lower case.
 )
 {
-    le_result_t result = LE_OUT_OF_RANGE;
-    int8_t hwMode = SavedIeeeStdMask & 0x0F;
-
-    LE_INFO("Set channel");
-    switch (hwMode)
-    {
-        case LE_WIFIAP_BITMASK_IEEE_STD_A:
-            MIN_CHANNEL_VALUE = LE_WIFIDEFS_MIN_CHANNEL_STD_A;
-            MAX_CHANNEL_VALUE = LE_WIFIDEFS_MAX_CHANNEL_STD_A;
-            break;
-        case LE_WIFIAP_BITMASK_IEEE_STD_B:
-        case LE_WIFIAP_BITMASK_IEEE_STD_G:
-            MIN_CHANNEL_VALUE = LE_WIFIDEFS_MIN_CHANNEL_VALUE;
-            MAX_CHANNEL_VALUE = LE_WIFIDEFS_MAX_CHANNEL_VALUE;
-            break;
-        case LE_WIFIAP_BITMASK_IEEE_STD_AD:
-            MIN_CHANNEL_VALUE = LE_WIFIDEFS_MIN_CHANNEL_STD_AD;
-            MAX_CHANNEL_VALUE = LE_WIFIDEFS_MAX_CHANNEL_STD_AD;
-            break;
-        default:
-            LE_WARN("Invalid hardware mode");
-    }
+    int slot;
 
-    if ((channelNumber >= MIN_CHANNEL_VALUE) &&
-        (channelNumber <= MAX_CHANNEL_VALUE))
+    for (slot = 0; slot < PA_WIFIAP_MAX_RATE_LIMITS; slot++)
     {
-       SavedChannelNumber = channelNumber;
-       result = LE_OK;
+        if ((RateLimits[slot].isSet) && (0 == strcmp(RateLimits[slot].macAddr, macAddrPtr)))
+        {
+            return slot;
+        }
     }
-    return result;
+    return -1;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Set which IEEE standard to use.
- * Default hardware mode is IEEE 802.11g.
- *
- * @return
- *      - LE_BAD_PARAMETER if invalid IEEE standard is set.
- *      - LE_OK if the function succeeded.
+ * Limit the rates of a station of the access point, whether associated or not. The downlink is
+ * shaped in queues of its own, one per WMM access category each limited to the rate, and the
+ * excess of the uplink is dropped. A rate of 0 does not limit the direction, and both at 0 remove
+ * the limits of the station.
+ * If the access point is started, the limits are applied at once.
  *
+ * @return LE_BAD_PARAMETER The MAC address is invalid.
+ * @return LE_NO_MEMORY     PA_WIFIAP_MAX_RATE_LIMITS stations are already limited.
+ * @return LE_FAULT         The limits could not be applied to the started access point.
+ * @return LE_OK            Function succeeded.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t pa_wifiAp_SetIeeeStandard
+le_result_t pa_wifiAp_SetStationRateLimit
 (
-    le_wifiAp_IeeeStdBitMask_t stdMask
+    const char *macAddrPtr,
         ///< [IN]
-        ///< Bit mask for the IEEE standard.
+        ///< MAC address of the station.
+    uint32_t downlinkKbps,
+        ///< [IN]
+        ///< Rate to the station in kbit/s, 0 for no limit.
+    uint32_t uplinkKbps
+        ///< [IN]
+        ///< Rate from the station in kbit/s, 0 for no limit.
 )
 {
-    int8_t hwMode = stdMask & 0x0F;
-    int8_t numCheck = (hwMode & 0x1) + ((hwMode >> 1) & 0x1) +
-                       ((hwMode >> 2) & 0x1) + ((hwMode >> 3) & 0x1);
+    char macAddr[LE_WIFIDEFS_MAX_BSSID_BYTES];
+    int  slot;
+    int  freeSlot;
 
-    LE_INFO("Set IeeeStdBitMask : 0x%X", stdMask);
-    //Hardware mode should be set.
-    if ( 0 == numCheck )
-    {
-        LE_WARN("No hardware mode is set.");
-        return LE_BAD_PARAMETER;
-    }
-    //Hardware mode should be exclusive.
-    if ( numCheck > 1 )
+    if (LE_OK != CopyMacAddress(macAddr, macAddrPtr))
     {
-        LE_WARN("Only one hardware mode can be set.");
+        LE_ERROR("Invalid MAC address");
         return LE_BAD_PARAMETER;
     }
 
-    if ( stdMask & LE_WIFIAP_BITMASK_IEEE_STD_AC )
+    slot = FindRateLimit(macAddr);
+    if ((0 == downlinkKbps) && (0 == uplinkKbps))
     {
-        // ieee80211ac=1 only works with hw_mode=a
-        if ( 0 == (stdMask & LE_WIFIAP_BITMASK_IEEE_STD_A) )
+        if (slot < 0)
         {
-            LE_WARN("ieee80211ac=1 only works with hw_mode=a.");
-            return LE_BAD_PARAMETER;
+            return LE_OK;
         }
+        RateLimits[slot].isSet = false;
     }
-
-    if ( stdMask & LE_WIFIAP_BITMASK_IEEE_STD_H )
+    else
     {
-        // ieee80211h=1 can be used only with ieee80211d=1
-        if ( 0 == (stdMask & LE_WIFIAP_BITMASK_IEEE_STD_D) )
+        for (freeSlot = 0; (slot < 0) && (freeSlot < PA_WIFIAP_MAX_RATE_LIMITS); freeSlot++)
         {
-            LE_WARN("ieee80211h=1 only works with ieee80211d=1.");
-            return LE_BAD_PARAMETER;
+            if (!RateLimits[freeSlot].isSet)
+            {
+                slot = freeSlot;
+            }
+        }
+        if (slot < 0)
+        {
+            LE_ERROR("No rate limit left for %s", macAddr);
+            return LE_NO_MEMORY;
         }
+        RateLimits[slot].isSet = true;
+        le_utf8_Copy(RateLimits[slot].macAddr, macAddr, sizeof(RateLimits[slot].macAddr), NULL);
+        RateLimits[slot].downlinkKbps = downlinkKbps;
+        RateLimits[slot].uplinkKbps = uplinkKbps;
     }
 
-    SavedIeeeStdMask = stdMask;
-    return LE_OK;
+    LE_INFO("Station %s limited to %" PRIu32 " kbit/s down, %" PRIu32 " kbit/s up", macAddr,
+            downlinkKbps, uplinkKbps);
+    return IsHostapdStarted ? ApplyRateLimit(slot) : LE_OK;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Get which IEEE standard was set.
- * Default hardware mode is IEEE 802.11g.
- *
- * @return
- *      - LE_FAULT if the function failed.
- *      - LE_OK if the function succeeded.
+ * Get the rate limits of a station and the counters of its shaping: the downlink packets dropped
+ * and queued by its queue, and the uplink packets dropped. The counters are 0 while the access
+ * point is stopped.
  *
+ * @return LE_BAD_PARAMETER Some parameter is invalid.
+ * @return LE_NOT_FOUND     The station has no rate limit.
+ * @return LE_FAULT         The counters could not be read.
+ * @return LE_OK            Function succeeded.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t pa_wifiAp_GetIeeeStandard
+le_result_t pa_wifiAp_GetStationShapingStats
 (
-    le_wifiAp_IeeeStdBitMask_t *stdMaskPtr
+    const char *macAddrPtr,
+        ///< [IN]
+        ///< MAC address of the station.
+    le_wifiAp_StationShapingStats_t *statsPtr
         ///< [OUT]
-        ///< Bit mask for the IEEE standard.
+        ///< Rate limits and shaping counters of the station.
 )
 {
-    if ( NULL == stdMaskPtr )
+    const char txDroppedPrefix[] = "tx dropped:";
+    const char txBacklogPrefix[] = "tx backlog:";
+    const char rxDroppedPrefix[] = "rx dropped:";
+    char       macAddr[LE_WIFIDEFS_MAX_BSSID_BYTES];
+    char       cmd[64];
+    char       path[TEMP_STRING_MAX_BYTES];
+    FILE      *statsPipePtr;
+    int        slot;
+    int        st;
+
+    if ((NULL == statsPtr) || (LE_OK != CopyMacAddress(macAddr, macAddrPtr)))
     {
-        LE_WARN("stdMaskPtr == NULL");
+        LE_ERROR("Invalid parameter");
+        return LE_BAD_PARAMETER;
+    }
+
+    slot = FindRateLimit(macAddr);
+    if (slot < 0)
+    {
+        return LE_NOT_FOUND;
+    }
+
+    memset(statsPtr, 0, sizeof(*statsPtr));
+    statsPtr->downlinkKbps = RateLimits[slot].downlinkKbps;
+    statsPtr->uplinkKbps = RateLimits[slot].uplinkKbps;
+    if (!IsShapingStarted)
+    {
+        return LE_OK;
+    }
+
+    snprintf(cmd, sizeof(cmd), "%s %d", COMMAND_WIFIAP_GET_STA_SHAPING_STATS, slot + 1);
+    statsPipePtr = OpenScript(cmd);
+    if (NULL == statsPipePtr)
+    {
+        LE_ERROR("Failed to run command \"%s\": errno:%d: \"%s\" ",
+                cmd,
+                errno,
+                strerror(errno));
         return LE_FAULT;
     }
 
-    *stdMaskPtr = SavedIeeeStdMask;
+    while (NULL != fgets(path, sizeof(path), statsPipePtr))
+    {
+        if (0 == strncmp(txDroppedPrefix, path, sizeof(txDroppedPrefix) - 1))
+        {
+            statsPtr->txDropped = strtoul(&path[sizeof(txDroppedPrefix) - 1], NULL, 10);
+        }
+        else if (0 == strncmp(txBacklogPrefix, path, sizeof(txBacklogPrefix) - 1))
+        {
+            // "tx backlog: <bytes> <packets>"
+            char *endPtr;
+
+            statsPtr->txBacklogBytes = strtoul(&path[sizeof(txBacklogPrefix) - 1], &endPtr, 10);
+            statsPtr->txBacklogPackets = strtoul(endPtr, NULL, 10);
+        }
+        else if (0 == strncmp(rxDroppedPrefix, path, sizeof(rxDroppedPrefix) - 1))
+        {
+            statsPtr->rxDropped = strtoul(&path[sizeof(rxDroppedPrefix) - 1], NULL, 10);
+        }
+    }
+
+    st = pclose(statsPipePtr);
+    if (!WIFEXITED(st) || (0 != WEXITSTATUS(st)))
+    {
+        LE_ERROR("WiFi AP Command \"%s\" Failed: (%d)", cmd, st);
+        return LE_FAULT;
+    }
     return LE_OK;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Set what country code to use for regulatory domain.
- * ISO/IEC 3166-1 Alpha-2 code is used.
- * Default country code is US.
- * @return
- *      - LE_FAULT if the function failed.
- *      - LE_OK if the function succeeded.
+ * Enable or disable the airtime fairness scheduling of the driver: the stations get an equal share
+ * of the airtime whatever their rate, so that a slow or busy station does not starve the others.
+ * Default is disabled. If the access point is started, the setting is applied at once.
  *
+ * @return LE_UNSUPPORTED   The driver does not schedule the airtime fairly.
+ * @return LE_FAULT         The setting could not be applied to the started access point.
+ * @return LE_OK            Function succeeded.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t pa_wifiAp_SetCountryCode
+le_result_t pa_wifiAp_SetAirtimeFairness
 (
-    const char *countryCodePtr
-        /// [IN]
-        ///< the country code.
+    bool enable
+        ///< [IN]
+        ///< True to share the airtime fairly between the stations.
 )
 {
-    le_result_t result = LE_FAULT;
+    IsAirtimeFairness = enable;
+    return IsHostapdStarted ? ApplyAirtimeFairness() : LE_OK;
+}
 
-    LE_INFO("Set countryCode");
-    if (NULL != countryCodePtr)
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the time after which a station which sends nothing is disconnected by hostapd, freeing its
+ * slot. Default is 300 seconds. If the access point is started, the setting is applied at once.
+ *
+ * @return LE_OUT_OF_RANGE  The timeout is 0.
+ * @return LE_FAULT         The started access point could not be reconfigured.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_SetInactivityTimeout
+(
+    uint32_t timeoutSec
+        ///< [IN]
+        ///< Inactivity timeout in seconds.
+)
+{
+    char value[12];
+
+    if (0 == timeoutSec)
     {
-        uint32_t length = strlen(countryCodePtr);
+        LE_ERROR("Invalid inactivity timeout");
+        return LE_OUT_OF_RANGE;
+    }
 
-        if (length == LE_WIFIDEFS_ISO_COUNTRYCODE_LENGTH)
-        {
-            strncpy(&SavedCountryCode[0], &countryCodePtr[0], length );
-            SavedCountryCode[length] = '\0';
-            result = LE_OK;
-        }
+    uint32_t    previousTimeoutSec = SavedInactivitySec;
+    le_result_t result;
+
+    SavedInactivitySec = timeoutSec;
+    snprintf(value, sizeof(value), "%" PRIu32, timeoutSec);
+    result = ApplyHostapdParameter("ap_max_inactivity", value, false);
+    if (LE_OK != result)
+    {
+        SavedInactivitySec = previousTimeoutSec;
+        snprintf(value, sizeof(value), "%" PRIu32, previousTimeoutSec);
+        RestoreHostapdParameter("ap_max_inactivity", value);
     }
     return result;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Set the maximum number of clients allowed to be connected to WiFi access point at the same time.
- * Default value is 10.
+ * Enable or disable the eviction of the most idle station when a new one associates to the full
+ * access point. Default is disabled: the new stations are refused.
+ * If the access point is started, the setting is applied at once.
  *
- * @note This value depends on the hardware/software capabilities of the WiFi module used.
- *
- * @return LE_OUT_OF_RANGE  Requested number of users exceeds the capabilities of the Access Point.
+ * @return LE_FAULT         The started access point could not be reconfigured.
  * @return LE_OK            Function succeeded.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t pa_wifiAp_SetMaxNumberClients
+le_result_t pa_wifiAp_SetEvictIdleWhenFull
 (
-    int maxNumberClients
+    bool enable
         ///< [IN]
-        ///< The maximum number of clients. This depends on the hardware/software capabilities.
+        ///< True to evict the most idle station for a new one.
 )
 {
-    // Store maxNumberClients to be used later during startup procedure
-    le_result_t result = LE_OUT_OF_RANGE;
-    LE_INFO("Set max clients");
-    if ((maxNumberClients >= 1) && (maxNumberClients <= WIFI_MAX_USERS))
+    char        value[12];
+    bool        previousEnable = IsEvictIdleWhenFull;
+    le_result_t result;
+
+    IsEvictIdleWhenFull = enable;
+    snprintf(value, sizeof(value), "%" PRIu32, GetMaxNumSta());
+    result = ApplyHostapdParameter("max_num_sta", value, false);
+    if (LE_OK != result)
     {
-       SavedMaxNumClients = maxNumberClients;
-       result = LE_OK;
+        IsEvictIdleWhenFull = previousEnable;
+        snprintf(value, sizeof(value), "%" PRIu32, GetMaxNumSta());
+        RestoreHostapdParameter("max_num_sta", value);
     }
     return result;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Define the access point IP address and the client IP addresses range.
- *
- * @note The access point IP address must be defined outside the client IP addresses range.
+ * Set the signal strength under which the association of a station is rejected, so that slow and
+ * distant stations do not lower the rate of the others. 0 accepts all the stations, as by default.
+ * If the access point is started, the setting is applied at once.
  *
- * @return LE_BAD_PARAMETER At least, one of the given IP addresses is invalid.
- * @return LE_FAULT         A system call has failed.
+ * @return LE_OUT_OF_RANGE  The signal strength is not between -100 and -1 dBm, or 0.
+ * @return LE_FAULT         The started access point could not be reconfigured.
  * @return LE_OK            Function succeeded.
- *
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t pa_wifiAp_SetIpRange
+le_result_t pa_wifiAp_SetMinAssocRssi
 (
-    const char *ipApPtr,
-        ///< [IN]
-        ///< the IP address of the Access Point.
-    const char *ipStartPtr,
-        ///< [IN]
-        ///< the start IP address of the Access Point.
-    const char *ipStopPtr
+    int16_t rssi
         ///< [IN]
-        ///< the stop IP address of the Access Point.
+        ///< Signal strength in dBm, 0 for no minimum.
 )
 {
-    struct sockaddr_in  saApPtr;
-    struct sockaddr_in  saStartPtr;
-    struct sockaddr_in  saStopPtr;
-    const char         *parameterPtr = 0;
+    char value[12];
 
-    // Check the parameters
-    if ((NULL == ipApPtr) || (NULL == ipStartPtr) || (NULL == ipStopPtr))
+    if ((rssi > 0) || (rssi < -100))
     {
-        return LE_BAD_PARAMETER;
+        LE_ERROR("Invalid signal strength %d", rssi);
+        return LE_OUT_OF_RANGE;
     }
 
-    if ((!strlen(ipApPtr)) || (!strlen(ipStartPtr)) || (!strlen(ipStopPtr)))
-    {
-        return LE_BAD_PARAMETER;
-    }
+    int16_t     previousRssi = SavedMinAssocRssi;
+    le_result_t result;
 
-    if (inet_pton(AF_INET, ipApPtr, &(saApPtr.sin_addr)) <= 0)
+    SavedMinAssocRssi = rssi;
+    snprintf(value, sizeof(value), "%d", rssi);
+    result = ApplyHostapdParameter("rssi_reject_assoc_rssi", value, false);
+    if (LE_OK != result)
     {
-        parameterPtr = "AP";
+        SavedMinAssocRssi = previousRssi;
+        snprintf(value, sizeof(value), "%d", previousRssi);
+        RestoreHostapdParameter("rssi_reject_assoc_rssi", value);
     }
-    else if (inet_pton(AF_INET, ipStartPtr, &(saStartPtr.sin_addr)) <= 0)
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Apply the admission policy once a station has associated: above the maximum number of clients,
+ * the most idle station is disconnected if it has been idle long enough, else the new one is.
+ * It must be called from the thread which started the access point, which owns the control
+ * interface of hostapd.
+ *
+ * @return LE_BAD_PARAMETER The MAC address is invalid.
+ * @return LE_FAULT         The stations could not be dumped or disconnected.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_AdmitStation
+(
+    const char *macAddrPtr
+        ///< [IN]
+        ///< MAC address of the station which has associated.
+)
+{
+    static le_wifiAp_StationInfo_t stations[ADMISSION_MAX_STA];
+    size_t                         numStations = NUM_ARRAY_MEMBERS(stations);
+    char                           macAddr[LE_WIFIDEFS_MAX_BSSID_BYTES];
+    char                           cmd[64];
+    const le_wifiAp_StationInfo_t *idlePtr = NULL;
+    size_t                         i;
+
+    if (LE_OK != CopyMacAddress(macAddr, macAddrPtr))
     {
-        parameterPtr = "start";
+        LE_ERROR("Invalid MAC address");
+        return LE_BAD_PARAMETER;
     }
-    else if (inet_pton(AF_INET, ipStopPtr, &(saStopPtr.sin_addr)) <= 0)
+    if ((!IsEvictIdleWhenFull) || (!IsHostapdStarted))
     {
-        parameterPtr = "stop";
+        return LE_OK;
     }
 
-    if (NULL != parameterPtr)
+    if (LE_OK != pa_wifiAp_GetStations(stations, &numStations))
     {
-        LE_ERROR("Invalid %s IP address", parameterPtr);
-        return LE_BAD_PARAMETER;
+        return LE_FAULT;
     }
-    else
+    if (numStations <= SavedMaxNumClients)
     {
-        unsigned int ap = ntohl(saApPtr.sin_addr.s_addr);
-        unsigned int start = ntohl(saStartPtr.sin_addr.s_addr);
-        unsigned int stop = ntohl(saStopPtr.sin_addr.s_addr);
-
-        LE_INFO("@AP=%x, @APstart=%x, @APstop=%x",
-                ap, start, stop);
-
-        if (start > stop)
-        {
-            LE_INFO("Need to swap start & stop IP addresses.");
-            start = start ^ stop;
-            stop = stop ^ start;
-            start = start ^ stop;
-        }
-
-        if ((ap >= start) && (ap <= stop))
-        {
-            LE_ERROR("AP IP address is within the range.");
-            return LE_BAD_PARAMETER;
-        }
+        return LE_OK;
     }
 
-    putenv("PATH=/legato/systems/current/bin:/usr/local/bin:"
-        "/usr/bin:/bin:/usr/local/sbin:/usr/sbin:/sbin");
-
+    for (i = 0; i < numStations; i++)
     {
-        char cmd[256];
-        int  systemResult;
-
-        snprintf((char *)&cmd, sizeof(cmd), "%s %s %s",
-                WIFI_SCRIPT_PATH,
-                COMMAND_WIFIAP_WLAN_UP,
-                ipApPtr);
-
-        systemResult = system(cmd);
-        if (0 != WEXITSTATUS (systemResult))
-        {
-            LE_ERROR("Unable to mount the network interface.");
-            return LE_FAULT;
-        }
-        else
+        if ((0 != strcmp(stations[i].macAddr, macAddr)) &&
+            ((NULL == idlePtr) || (stations[i].inactiveMs > idlePtr->inactiveMs)))
         {
-            FILE *filePtr;
-
-            LE_INFO("Creation of dnsmasq configuration file (%s)", DNSMASQ_CFG_FILE);
-
-            if (symlink(DNSMASQ_CFG_FILE, DNSMASQ_CFG_LINK) && (EEXIST != errno))
-            {
-                LE_ERROR("Unable to create link to dnsmasq configuration file: %m.");
-                return LE_FAULT;
-            }
-            filePtr = fopen (DNSMASQ_CFG_FILE, "w");
-            if (filePtr != NULL)
-            {
-                //Interface is generated when COMMAND_DNSMASQ_RESTART called
-                fprintf(filePtr, "dhcp-range=%s,%s,%dh\n", ipStartPtr, ipStopPtr, 24);
-                fprintf(filePtr, "dhcp-option=%d,%s\n", 3, ipApPtr);
-                fprintf(filePtr, "dhcp-option=%d,%s\n", 6, ipApPtr);
-                fclose(filePtr);
-            }
-            else
-            {
-                LE_ERROR("Unable to open the dnsmasq configuration file: %m.");
-                return LE_FAULT;
-            }
-
-            LE_INFO("@AP=%s, @APstart=%s, @APstop=%s", ipApPtr, ipStartPtr, ipStopPtr);
-
-            // Insert the rule allowing the DHCP ports on WLAN
-            systemResult = system(WIFI_SCRIPT_PATH COMMAND_IPTABLE_DHCP_INSERT);
-            if (0 != WEXITSTATUS (systemResult))
-            {
-                LE_ERROR("Unable to allow DHCP ports.");
-                return LE_FAULT;
-            }
-
-            systemResult = system(WIFI_SCRIPT_PATH COMMAND_DNSMASQ_RESTART);
-            if (0 != WEXITSTATUS (systemResult))
-            {
-                LE_ERROR("Unable to restart the DHCP server.");
-                return LE_FAULT;
-            }
+            idlePtr = &stations[i];
         }
     }
 
-    return LE_OK;
+    if ((NULL != idlePtr) && (idlePtr->inactiveMs >= ADMISSION_MIN_IDLE_MS))
+    {
+        LE_INFO("Access point full: %s idle for %" PRIu32 " ms evicted for %s", idlePtr->macAddr,
+                idlePtr->inactiveMs, macAddr);
+        snprintf(cmd, sizeof(cmd), "DEAUTHENTICATE %s reason=%d", idlePtr->macAddr,
+                 REASON_DISASSOC_INACTIVITY);
+    }
+    else
+    {
+        LE_INFO("Access point full: no idle station to evict, %s refused", macAddr);
+        snprintf(cmd, sizeof(cmd), "DEAUTHENTICATE %s reason=%d", macAddr,
+                 REASON_DISASSOC_AP_BUSY);
+    }
+    return HostapdCommand(cmd);
 }
@@ -8,6 +8,7 @@
 // -------------------------------------------------------------------------------------------------
 #include <sys/types.h>
 #include <sys/wait.h>
+#include <ctype.h>
 
 #include "legato.h"
 
@@ -25,15 +26,22 @@
 #define WPA_SUPPLICANT_FILE "/tmp/wpa_supplicant.conf"
 
 // Set of commands to drive the WiFi features.
-#define COMMAND_WIFI_HW_START           "WIFI_START"
-#define COMMAND_WIFI_HW_STOP            "WIFI_STOP"
+// The radio and its events are shared with the access point, the client being their CLIENT user.
+#define COMMAND_WIFI_HW_START           "WIFI_START CLIENT"
+#define COMMAND_WIFI_HW_STOP            "WIFI_STOP CLIENT"
 #define COMMAND_WIFI_CHECK_HWSTATUS     "WIFI_CHECK_HWSTATUS"
-#define COMMAND_WIFI_SET_EVENT          "WIFI_SET_EVENT"
-#define COMMAND_WIFI_UNSET_EVENT        "WIFI_UNSET_EVENT"
+#define COMMAND_WIFI_SET_EVENT          "WIFI_SET_EVENT CLIENT"
+#define COMMAND_WIFI_UNSET_EVENT        "WIFI_UNSET_EVENT CLIENT"
+#define COMMAND_WIFI_GET_INTERFACES     "WIFI_GET_INTERFACES"
 #define COMMAND_WIFICLIENT_START_SCAN   "WIFICLIENT_START_SCAN"
 #define COMMAND_WIFICLIENT_DISCONNECT   "WIFICLIENT_DISCONNECT"
 //Trailing space is needed to pass another argument by WIFI_SCRIPT_PATH
 #define COMMAND_WIFICLIENT_CONNECT      "WIFICLIENT_CONNECT "
+#define COMMAND_WIFICLIENT_ROAM         "WIFICLIENT_ROAM "
+#define COMMAND_WIFICLIENT_SCAN_SSID    "WIFICLIENT_START_SCAN_SSID "
+#define COMMAND_WIFICLIENT_LINK_SIGNAL  "WIFICLIENT_GET_LINK_SIGNAL"
+#define COMMAND_WIFICLIENT_STATION_INFO "WIFICLIENT_GET_STATION_INFO"
+#define COMMAND_WIFICLIENT_SET_CQM      "WIFICLIENT_SET_CQM "
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -43,8 +51,15 @@
 #define WPA_SUPPLICANT_CONFIG_COMMON \
 "ctrl_interface=/var/run/wpa_supplicant\n \
 ctrl_interface_group=0\n \
-update_config=1\n \
-network={\n \
+update_config=1\n"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * The beginning of a network block of the wpa configuration.
+ */
+//--------------------------------------------------------------------------------------------------
+#define WPA_SUPPLICANT_CONFIG_NETWORK \
+" network={\n \
 ssid=\"%.*s\"\n \
 scan_ssid=%d\n"
 
@@ -102,6 +117,18 @@ static char SavedPassword[LE_WIFIDEFS_MAX_PASSWORD_BYTES] = {0};
 //--------------------------------------------------------------------------------------------------
 static bool HiddenAccessPoint = false;
 //--------------------------------------------------------------------------------------------------
+/**
+ * Indicates if IEEE 802.11r fast BSS transition is negotiated with the Access Point or not
+ */
+//--------------------------------------------------------------------------------------------------
+static bool FastTransition = false;
+//--------------------------------------------------------------------------------------------------
+/**
+ * Access point preferred for the initial association with the next network configured
+ */
+//--------------------------------------------------------------------------------------------------
+static char BssidHint[LE_WIFIDEFS_MAX_BSSID_BYTES] = {0};
+//--------------------------------------------------------------------------------------------------
 /**
  * The handle of the input pipe used to be notified of the WiFi events during the scan.
  */
@@ -119,6 +146,23 @@ static FILE *IwThreadPipePtr  = NULL;
  */
 //--------------------------------------------------------------------------------------------------
 static bool  IsScanRunning    = false;
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of beacon loss events reported since the last connection, for the drivers which do not
+ * count them.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t BeaconLossCount = 0;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Network interface of the station, and the WiFi platform adaptor shell script with the option
+ * selecting it. Trailing space is needed to pass the command.
+ */
+//--------------------------------------------------------------------------------------------------
+static char ClientIfName[LE_WIFIDEFS_MAX_IFNAME_BYTES] = PA_WIFICLIENT_INTERFACE;
+static char ScriptPath[sizeof(WIFI_SCRIPT_PATH "-i ") + LE_WIFIDEFS_MAX_IFNAME_BYTES] =
+    WIFI_SCRIPT_PATH "-i " PA_WIFICLIENT_INTERFACE " ";
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -169,6 +213,210 @@ static le_mem_PoolRef_t WifiPaEventPool;
 //--------------------------------------------------------------------------------------------------
 #define TEMP_CONFIG_MAX_BYTES 512
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum numbers of bytes in a network block written to wpa_supplicant.conf
+ */
+//--------------------------------------------------------------------------------------------------
+#define NETWORK_BLOCK_MAX_BYTES (TEMP_CONFIG_MAX_BYTES + TEMP_STRING_MAX_BYTES)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Network blocks added by pa_wifiClient_AddNetwork(), written by pa_wifiClient_ConnectNetworks().
+ */
+//--------------------------------------------------------------------------------------------------
+static char   NetworkBlocks[PA_WIFICLIENT_MAX_NETWORKS][NETWORK_BLOCK_MAX_BYTES];
+static size_t NetworkBlockCount = 0;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Time at which each phase of the ongoing connection attempt has been reached, 0 if not reached.
+ * The authentication and association phases are reported by the WiFi events thread.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    bool          isRunning;    ///< Connection attempt ongoing.
+    le_clk_Time_t start;        ///< Connection requested.
+    le_clk_Time_t config;       ///< wpa_supplicant configuration generated.
+    le_clk_Time_t supplicant;   ///< wpa_supplicant started.
+    le_clk_Time_t auth;         ///< Authentication done.
+    le_clk_Time_t assoc;        ///< Association done.
+    le_clk_Time_t handshake;    ///< 4-way handshake or EAP completed.
+}
+ConnectPhases_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Phases of the ongoing connection attempt, shared with the WiFi events thread, and the timing of
+ * the last one.
+ */
+//--------------------------------------------------------------------------------------------------
+static ConnectPhases_t               ConnectPhases;
+static le_mutex_Ref_t                ConnectPhasesMutex = NULL;
+static pa_wifiClient_ConnectTiming_t LastConnectTiming;
+static bool                          HasConnectTiming = false;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start timing a connection attempt.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StartConnectPhases
+(
+    void
+)
+{
+    le_mutex_Lock(ConnectPhasesMutex);
+    memset(&ConnectPhases, 0, sizeof(ConnectPhases));
+    ConnectPhases.start = le_clk_GetRelativeTime();
+    ConnectPhases.isRunning = true;
+    le_mutex_Unlock(ConnectPhasesMutex);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Record the time a phase of the ongoing connection attempt has been reached, the first time only.
+ */
+//--------------------------------------------------------------------------------------------------
+static void MarkConnectPhase
+(
+    le_clk_Time_t *phasePtr
+)
+{
+    le_mutex_Lock(ConnectPhasesMutex);
+    if (ConnectPhases.isRunning && (0 == phasePtr->sec) && (0 == phasePtr->usec))
+    {
+        *phasePtr = le_clk_GetRelativeTime();
+    }
+    le_mutex_Unlock(ConnectPhasesMutex);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Duration in ms from the previous phase reached to the given one, 0 if it has not been reached.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t ConnectPhaseMs
+(
+    le_clk_Time_t *previousPtr,
+    le_clk_Time_t phase
+)
+{
+    le_clk_Time_t duration;
+
+    if (((0 == phase.sec) && (0 == phase.usec)) || le_clk_GreaterThan(*previousPtr, phase))
+    {
+        return 0;
+    }
+    duration = le_clk_Sub(phase, *previousPtr);
+    *previousPtr = phase;
+    return (uint32_t)((duration.sec * 1000) + (duration.usec / 1000));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stop timing the ongoing connection attempt and compute the duration of its phases.
+ */
+//--------------------------------------------------------------------------------------------------
+static void EndConnectPhases
+(
+    le_result_t result
+)
+{
+    le_clk_Time_t previous;
+    le_clk_Time_t now = le_clk_GetRelativeTime();
+
+    le_mutex_Lock(ConnectPhasesMutex);
+    ConnectPhases.isRunning = false;
+    previous = ConnectPhases.start;
+    LastConnectTiming.result = result;
+    LastConnectTiming.configMs = ConnectPhaseMs(&previous, ConnectPhases.config);
+    LastConnectTiming.supplicantMs = ConnectPhaseMs(&previous, ConnectPhases.supplicant);
+    LastConnectTiming.authMs = ConnectPhaseMs(&previous, ConnectPhases.auth);
+    LastConnectTiming.assocMs = ConnectPhaseMs(&previous, ConnectPhases.assoc);
+    LastConnectTiming.handshakeMs = ConnectPhaseMs(&previous, ConnectPhases.handshake);
+    previous = ConnectPhases.start;
+    LastConnectTiming.totalMs = ConnectPhaseMs(&previous, now);
+    HasConnectTiming = true;
+    le_mutex_Unlock(ConnectPhasesMutex);
+
+    LE_DEBUG("Connection phases (ms): config %u, supplicant %u, auth %u, assoc %u, handshake %u,"
+             " total %u", LastConnectTiming.configMs, LastConnectTiming.supplicantMs,
+             LastConnectTiming.authMs, LastConnectTiming.assocMs, LastConnectTiming.handshakeMs,
+             LastConnectTiming.totalMs);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Report a connection quality monitor event read from the WiFi events.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReportCqmEvent
+(
+    le_wifiClient_Event_t event,
+        ///< [IN]
+        ///< Event to report
+    char *pathPtr
+        ///< [IN]
+        ///< WiFi event line, starting with the WLAN interface name
+)
+{
+    char *ret;
+    le_wifiClient_EventInd_t* WifiClientPaEventPtr = le_mem_ForceAlloc(WifiPaEventPool);
+
+    memset(WifiClientPaEventPtr, 0, sizeof(le_wifiClient_EventInd_t));
+    WifiClientPaEventPtr->event = event;
+    WifiClientPaEventPtr->disconnectionCause = LE_WIFICLIENT_UNKNOWN_CAUSE;
+    // Retrieve WLAN interface name
+    ret = strtok_r(pathPtr, " :", &pathPtr);
+    if (NULL != ret)
+    {
+        le_utf8_Copy(WifiClientPaEventPtr->ifName, ret, sizeof(WifiClientPaEventPtr->ifName),
+                     NULL);
+    }
+
+    LE_DEBUG("WiFi event: %d, interface: %s", event, WifiClientPaEventPtr->ifName);
+    le_event_ReportWithRefCounting(WifiClientPaEventId, WifiClientPaEventPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Run a command of the WiFi platform adaptor shell script on the interface of the station.
+ *
+ * @return The status of the command, as returned by system().
+ */
+//--------------------------------------------------------------------------------------------------
+static int RunScript
+(
+    const char *commandPtr
+)
+{
+    char cmd[TEMP_STRING_MAX_BYTES];
+
+    snprintf(cmd, sizeof(cmd), "%s%s", ScriptPath, commandPtr);
+    return system(cmd);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Run a command of the WiFi platform adaptor shell script on the interface of the station, to
+ * read its output.
+ *
+ * @return The pipe of the command output, NULL on failure.
+ */
+//--------------------------------------------------------------------------------------------------
+static FILE *OpenScript
+(
+    const char *commandPtr
+)
+{
+    char cmd[TEMP_STRING_MAX_BYTES];
+
+    snprintf(cmd, sizeof(cmd), "%s%s", ScriptPath, commandPtr);
+    return popen(cmd, "r");
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Thread destructor
@@ -182,7 +430,7 @@ static void ThreadDestructor
     int systemResult;
 
     // Kill the script launched by popen() in Client thread
-    systemResult = system(WIFI_SCRIPT_PATH COMMAND_WIFI_UNSET_EVENT);
+    systemResult = RunScript(COMMAND_WIFI_UNSET_EVENT);
 
     if ((!WIFEXITED(systemResult)) || (0 != WEXITSTATUS(systemResult)))
     {
@@ -281,7 +529,7 @@ static void *WifiClientPaThreadMain
 
     LE_INFO("Wifi event report thread started!");
 
-    IwThreadPipePtr = popen(WIFI_SCRIPT_PATH COMMAND_WIFI_SET_EVENT, "r");
+    IwThreadPipePtr = OpenScript(COMMAND_WIFI_SET_EVENT);
 
     if (NULL == IwThreadPipePtr)
     {
@@ -299,9 +547,47 @@ static void *WifiClientPaThreadMain
     {
         LE_DEBUG("PARSING:%s: len:%d", path, (int) strnlen(path, sizeof(path) - 1));
 
+        // Skip the events of the other interfaces of the radio, e.g. of the access point in
+        // concurrent mode: "<ifname> (phy #<n>): <event>"
+        if ((NULL != strstr(path, " (phy #")) &&
+            ((0 != strncmp(path, ClientIfName, strlen(ClientIfName))) ||
+             (0 != strncmp(path + strlen(ClientIfName), " (phy #", sizeof(" (phy #") - 1))))
+        {
+            continue;
+        }
+
+        // Connection phases reported by the driver
+        if (NULL != strstr(path, ": auth"))
+        {
+            MarkConnectPhase(&ConnectPhases.auth);
+        }
+        else if ((NULL != strstr(path, ": assoc")) || (NULL != strstr(path, "connected to")))
+        {
+            MarkConnectPhase(&ConnectPhases.assoc);
+        }
+
         if (NULL != strstr(path, "Beacon loss"))
         {
             cause = LE_WIFICLIENT_BEACON_LOSS;
+            BeaconLossCount++;
+        }
+        // Connection quality monitor thresholds crossed, as configured by
+        // pa_wifiClient_SetRssiThreshold()
+        if (NULL != strstr(path, "connection quality monitor event"))
+        {
+            if (NULL != strstr(path, "RSSI went below threshold"))
+            {
+                ReportCqmEvent(LE_WIFICLIENT_EVENT_RSSI_LOW, path);
+            }
+            else if (NULL != strstr(path, "RSSI went above threshold"))
+            {
+                ReportCqmEvent(LE_WIFICLIENT_EVENT_RSSI_HIGH, path);
+            }
+            else if (NULL != strstr(path, "beacon loss"))
+            {
+                BeaconLossCount++;
+            }
+            continue;
         }
         if (NULL != (ret = strstr(path, "del station")))
         {
@@ -315,6 +601,7 @@ static void *WifiClientPaThreadMain
             LE_INFO("FOUND connected");
 
             cause = LE_WIFICLIENT_UNKNOWN_CAUSE;
+            BeaconLossCount = 0;
             le_wifiClient_EventInd_t* WifiClientPaEventPtr = le_mem_ForceAlloc(WifiPaEventPool);
             memset(WifiClientPaEventPtr, 0, sizeof(le_wifiClient_EventInd_t));
             WifiClientPaEventPtr->event = LE_WIFICLIENT_EVENT_CONNECTED;
@@ -358,7 +645,7 @@ static void *WifiClientPaThreadMain
                 if (NULL != strstr(path, "local request"))
                 {
                     // Check WLAN interface, not available means hardware removed
-                    systemResult = system(WIFI_SCRIPT_PATH COMMAND_WIFI_CHECK_HWSTATUS);
+                    systemResult = RunScript(COMMAND_WIFI_CHECK_HWSTATUS);
 
                     switch (WEXITSTATUS(systemResult))
                     {
@@ -454,6 +741,7 @@ le_result_t pa_wifiClient_Init
     // Create the event for signaling user handlers.
     WifiClientPaEventId = le_event_CreateIdWithRefCounting("WifiConnectEvent");
     WifiPaEventPool = le_mem_CreatePool("WifiPaEventPool", sizeof(le_wifiClient_EventInd_t));
+    ConnectPhasesMutex = le_mutex_CreateNonRecursive("WifiConnectPhases");
 
     return LE_OK;
 }
@@ -492,7 +780,7 @@ le_result_t pa_wifiClient_Start
     int systemResult;
     le_result_t result = LE_OK;
 
-    systemResult = system(WIFI_SCRIPT_PATH COMMAND_WIFI_HW_START);
+    systemResult = RunScript(COMMAND_WIFI_HW_START);
     /**
      * Returned values:
      *   0: if the interface is correctly moutned
@@ -549,7 +837,7 @@ le_result_t pa_wifiClient_Stop
     void
 )
 {
-    int systemResult = system(WIFI_SCRIPT_PATH COMMAND_WIFI_HW_STOP);
+    int systemResult = RunScript(COMMAND_WIFI_HW_STOP);
     /**
      * Returned values:
      *  0: if the interface is correctly unmounted
@@ -607,7 +895,7 @@ le_result_t pa_wifiClient_Scan
 
     IsScanRunning = true;
     /* Open the command for reading. */
-    IwScanPipePtr = popen(WIFI_SCRIPT_PATH COMMAND_WIFICLIENT_START_SCAN, "r");
+    IwScanPipePtr = OpenScript(COMMAND_WIFICLIENT_START_SCAN);
 
     if (NULL == IwScanPipePtr)
     {
@@ -622,6 +910,78 @@ le_result_t pa_wifiClient_Scan
     return result;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function starts a scan directed to the given SSID, by probing it explicitly instead of
+ * listening to all beacons. It behaves as pa_wifiClient_Scan(): results are read via
+ * pa_wifiClient_GetScanResult and pa_wifiClient_ScanDone MUST be called when the reading is done.
+ *
+ * @return LE_FAULT          The function failed.
+ * @return LE_BAD_PARAMETER  Invalid parameter.
+ * @return LE_BUSY           The function is already ongoing.
+ * @return LE_OK             The function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiClient_ScanSsid
+(
+    const uint8_t *ssidPtr,
+        ///< [IN]
+        ///< SSID to probe
+    size_t ssidNumElements
+        ///< [IN]
+        ///< The number of bytes in the SSID
+)
+{
+    char        tmpString[TEMP_STRING_MAX_BYTES];
+    le_result_t result = LE_OK;
+
+    if ((NULL == ssidPtr) || (0 == ssidNumElements) ||
+        (ssidNumElements > LE_WIFIDEFS_MAX_SSID_LENGTH))
+    {
+        LE_ERROR("Invalid SSID");
+        return LE_BAD_PARAMETER;
+    }
+
+    // The SSID is passed single-quoted to the script: it must not contain any quote itself
+    if ((NULL != memchr(ssidPtr, '\'', ssidNumElements)) ||
+        (NULL != memchr(ssidPtr, '\0', ssidNumElements)))
+    {
+        LE_ERROR("SSID cannot be passed to a directed scan");
+        return LE_BAD_PARAMETER;
+    }
+
+    LE_INFO("Scanning SSID \"%.*s\"", (int)ssidNumElements, (const char *)ssidPtr);
+    if (IsScanRunning)
+    {
+        LE_ERROR("Scan is already running");
+        return LE_BUSY;
+    }
+
+    if (NULL != IwScanPipePtr)
+    {
+        return LE_BUSY;
+    }
+
+    snprintf(tmpString, sizeof(tmpString), "%s%s'%.*s'", ScriptPath,
+             COMMAND_WIFICLIENT_SCAN_SSID, (int)ssidNumElements, (const char *)ssidPtr);
+
+    IsScanRunning = true;
+    /* Open the command for reading. */
+    IwScanPipePtr = popen(tmpString, "r");
+
+    if (NULL == IwScanPipePtr)
+    {
+        LE_ERROR("Failed to run command \"%s\": errno:%d: \"%s\" ",
+                tmpString,
+                errno,
+                strerror(errno));
+        result = LE_FAULT;
+    }
+
+    IsScanRunning = false;
+    return result;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This function is used to find out if a scan is currently running.
@@ -664,9 +1024,11 @@ le_result_t pa_wifiClient_GetScanResult
     const char bssidPrefix[] = "BSS ";
     const char ssidPrefix[] = "\tSSID: ";
     const char signalPrefix[] = "\tsignal: ";
+    const char freqPrefix[] = "\tfreq: ";
     const unsigned int bssidPrefixLen = NUM_ARRAY_MEMBERS(bssidPrefix) - 1;
     const unsigned int ssidPrefixLen = NUM_ARRAY_MEMBERS(ssidPrefix) - 1;
     const unsigned int signalPrefixLen = NUM_ARRAY_MEMBERS(signalPrefix) - 1;
+    const unsigned int freqPrefixLen = NUM_ARRAY_MEMBERS(freqPrefix) - 1;
     char path[PATH_MAX_BYTES];
     struct timeval tv;
     fd_set fds;
@@ -694,6 +1056,7 @@ le_result_t pa_wifiClient_GetScanResult
     accessPointPtr->ssidLength = 0;
     memset(&accessPointPtr->ssidBytes, 0, LE_WIFIDEFS_MAX_SSID_BYTES);
     memset(&accessPointPtr->bssid, 0, LE_WIFIDEFS_MAX_BSSID_BYTES);
+    accessPointPtr->frequency = 0;
 
     /* Read the output a line at a time - output it. */
     while (IwScanPipePtr)
@@ -747,6 +1110,11 @@ le_result_t pa_wifiClient_GetScanResult
                     accessPointPtr->signalStrength = strtol(&path[signalPrefixLen], NULL, 10);
                     LE_DEBUG("signal(%d)", accessPointPtr->signalStrength);
                 }
+                else if (0 == strncmp(freqPrefix, path, freqPrefixLen))
+                {
+                    accessPointPtr->frequency = strtoul(&path[freqPrefixLen], NULL, 10);
+                    LE_DEBUG("frequency(%u)", accessPointPtr->frequency);
+                }
                 else if (0 == strncmp(bssidPrefix, path, bssidPrefixLen))
                 {
                     LE_DEBUG("FOUND BSSID: '%s'", &path[bssidPrefixLen]);
@@ -755,11 +1123,16 @@ le_result_t pa_wifiClient_GetScanResult
                     LE_DEBUG("BSSID: '%s'", &accessPointPtr->bssid[0]);
                     if ('\0' == scanIfName[0])
                     {
-                        if (NULL != (retStart = strstr(path, "wlan")) &&
-                            NULL != (retEnd = strchr(path, ')')))
+                        // e.g. "BSS 12:34:56:78:9a:bc(on wlan0)"
+                        if (NULL != (retStart = strstr(path, "(on ")) &&
+                            NULL != (retEnd = strchr(retStart, ')')))
                             {
-                                strncpy(scanIfName, retStart, retEnd - retStart);
-                                scanIfName[LE_WIFIDEFS_MAX_IFNAME_LENGTH] = '\0';
+                                retStart += sizeof("(on ") - 1;
+                                if (retEnd - retStart <= LE_WIFIDEFS_MAX_IFNAME_LENGTH)
+                                {
+                                    memcpy(scanIfName, retStart, retEnd - retStart);
+                                    scanIfName[retEnd - retStart] = '\0';
+                                }
                                 LE_DEBUG("Interface: '%s'", scanIfName);
                             }
 
@@ -886,21 +1259,22 @@ static le_result_t WriteClientCfgFile
 
 //--------------------------------------------------------------------------------------------------
 /**
- * This function generates the WPA supplicant configuration file.
+ * This function generates a network block of the WPA supplicant configuration, using the security
+ * parameters currently set. A priority of 0 is the wpa_supplicant default and is not written.
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t GenerateWpaSupplicant
+static le_result_t GenerateNetworkBlock
 (
-    char *ssidPtr,
-    const uint32_t ssidLength
+    const char *ssidPtr,
+    const uint32_t ssidLength,
+    int32_t priority,
+    char *blockPtr,
+    size_t blockSize
 )
 {
-    FILE    *filePtr;
     char     tmpConfig[TEMP_CONFIG_MAX_BYTES];
     char     tmpString[TEMP_STRING_MAX_BYTES];
 
-    LE_DEBUG("Generate Wpa Supplicant");
-
     // Check SSID
     if ((NULL == ssidPtr) || (0 == ssidLength) || (ssidLength > LE_WIFIDEFS_MAX_SSID_LENGTH))
     {
@@ -908,29 +1282,23 @@ static le_result_t GenerateWpaSupplicant
         return LE_FAULT;
     }
 
-    // Create the WPA supplicant file
-    filePtr = fopen(WPA_SUPPLICANT_FILE, "w");
-    if (filePtr == NULL)
-    {
-        LE_ERROR("Unable to create \"%s\" file.", WPA_SUPPLICANT_FILE);
-        return LE_FAULT;
-    }
-
-    //used to store configuration to be written into wpa_supplicant.conf
-    memset(tmpConfig, '\0', sizeof(tmpConfig));
     //used to store optional elements to be appended
     memset(tmpString, '\0', sizeof(tmpString));
-    //common contents of wpa_supplicant.conf
-    snprintf(tmpConfig, sizeof(tmpConfig), WPA_SUPPLICANT_CONFIG_COMMON,
-             ssidLength, (char *)ssidPtr, HiddenAccessPoint);
-
-    //The common part and the security protocol part are written to wpa_supplicant.conf
-    //separately for easier debug.
-    tmpConfig[TEMP_CONFIG_MAX_BYTES - 1] = '\0';
-    if (LE_OK != WriteClientCfgFile(tmpConfig, filePtr))
+    //common contents of the network block
+    snprintf(blockPtr, blockSize, WPA_SUPPLICANT_CONFIG_NETWORK,
+             ssidLength, ssidPtr, HiddenAccessPoint);
+    if (0 != priority)
     {
-        LE_ERROR("Unable to write wpa_supplicant common part");
-        goto WRONG_CONFIG;
+        snprintf(tmpString, sizeof(tmpString), "priority=%d\n", (int)priority);
+        le_utf8_Append(blockPtr, tmpString, blockSize, NULL);
+        memset(tmpString, '\0', sizeof(tmpString));
+    }
+    if ('\0' != BssidHint[0])
+    {
+        snprintf(tmpString, sizeof(tmpString), "bssid_hint=%s\n", BssidHint);
+        le_utf8_Append(blockPtr, tmpString, blockSize, NULL);
+        memset(tmpString, '\0', sizeof(tmpString));
+        BssidHint[0] = '\0';
     }
 
     memset(tmpConfig, '\0', sizeof(tmpConfig));
@@ -945,7 +1313,7 @@ static le_result_t GenerateWpaSupplicant
             if (0 == SavedWepKey[0])
             {
                 LE_ERROR("No valid WEP key");
-                goto WRONG_CONFIG;
+                return LE_FAULT;
             }
             le_utf8_Copy(tmpConfig, "key_mgmt=NONE\n", sizeof(tmpConfig), NULL);
             snprintf(tmpString, sizeof(tmpString), "wep_key0=\"%s\"\n", SavedWepKey);
@@ -958,7 +1326,19 @@ static le_result_t GenerateWpaSupplicant
             if ((0 == SavedPassphrase[0]) && (0 == SavedPreSharedKey[0]))
             {
                 LE_ERROR("No valid PassPhrase or PreSharedKey");
-                goto WRONG_CONFIG;
+                return LE_FAULT;
+            }
+            // Fast BSS transition is only defined for RSN, keep plain WPA-PSK as fallback
+            if (FastTransition)
+            {
+                if (LE_WIFICLIENT_SECURITY_WPA2_PSK_PERSONAL == SavedSecurityProtocol)
+                {
+                    le_utf8_Copy(tmpConfig, "key_mgmt=FT-PSK WPA-PSK\n", sizeof(tmpConfig), NULL);
+                }
+                else
+                {
+                    LE_WARN("Fast BSS transition requires WPA2, ignored");
+                }
             }
             // Passphrase is set, generate psk here
             if (0 != SavedPassphrase[0])
@@ -969,7 +1349,7 @@ static le_result_t GenerateWpaSupplicant
             {
                 snprintf(tmpString, sizeof(tmpString), "psk=%s\n", SavedPreSharedKey);
             }
-            le_utf8_Copy(tmpConfig, tmpString, sizeof(tmpConfig), NULL);
+            le_utf8_Append(tmpConfig, tmpString, sizeof(tmpConfig), NULL);
             break;
 
         case LE_WIFICLIENT_SECURITY_WPA_EAP_PEAP0_ENTERPRISE:
@@ -978,9 +1358,21 @@ static le_result_t GenerateWpaSupplicant
             if ((0 == SavedUsername[0]) && (0 == SavedPassword[0]))
             {
                 LE_ERROR("No valid Username or Password");
-                goto WRONG_CONFIG;
+                return LE_FAULT;
+            }
+            if (FastTransition &&
+                (LE_WIFICLIENT_SECURITY_WPA2_EAP_PEAP0_ENTERPRISE == SavedSecurityProtocol))
+            {
+                le_utf8_Copy(tmpConfig, "key_mgmt=FT-EAP WPA-EAP\n", sizeof(tmpConfig), NULL);
+            }
+            else
+            {
+                if (FastTransition)
+                {
+                    LE_WARN("Fast BSS transition requires WPA2, ignored");
+                }
+                le_utf8_Copy(tmpConfig, "key_mgmt=WPA-EAP\n", sizeof(tmpConfig), NULL);
             }
-            le_utf8_Copy(tmpConfig, "key_mgmt=WPA-EAP\n", sizeof(tmpConfig), NULL);
             le_utf8_Append(tmpConfig, "eap=PEAP\n", sizeof(tmpConfig), NULL);
             snprintf(tmpString, sizeof(tmpString), "identity=\"%s\"\n", SavedUsername);
             le_utf8_Append(tmpConfig, tmpString, sizeof(tmpConfig), NULL);
@@ -992,82 +1384,158 @@ static le_result_t GenerateWpaSupplicant
             break;
 
         default:
-            LE_ERROR("No valid Security Protocol");;
-            goto WRONG_CONFIG;
+            LE_ERROR("No valid Security Protocol");
+            return LE_FAULT;
     }
 
     // Append "}" to complete the network block
     le_utf8_Append(tmpConfig, "}\n", sizeof(tmpConfig), NULL);
     tmpConfig[TEMP_CONFIG_MAX_BYTES - 1] = '\0';
 
-    if (LE_OK != WriteClientCfgFile(tmpConfig, filePtr))
+    if (LE_OK != le_utf8_Append(blockPtr, tmpConfig, blockSize, NULL))
     {
-        LE_ERROR("Unable to write wpa_supplicant security protocol part");
-        goto WRONG_CONFIG;
+        LE_ERROR("Network block too long");
+        return LE_FAULT;
     }
-
-    fclose(filePtr);
     return LE_OK;
-
-WRONG_CONFIG:
-
-    LE_ERROR("Unable to generate the WPA supplicant file \"%s\".", WPA_SUPPLICANT_FILE);
-    fclose(filePtr);
-    return LE_FAULT;
 }
 
-
 //--------------------------------------------------------------------------------------------------
 /**
- * This function connects a wifiClient.
- *
- * @return LE_FAULT             The function failed.
- * @return LE_BAD_PARAMETER     Invalid parameter.
- * @return LE_DUPLICATE         Duplicated request.
- * @return LE_TIMEOUT           Connection request time out.
- * @return LE_OK                The function succeeded.
+ * This function writes the WPA supplicant configuration file made of the given network blocks.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t pa_wifiClient_Connect
+static le_result_t WriteWpaSupplicant
 (
-    uint8_t ssidBytes[LE_WIFIDEFS_MAX_SSID_BYTES],
-        ///< [IN]
-        ///< Contains ssidLength number of bytes
-    uint8_t ssidLength
-        ///< [IN]
-        ///< The number of Bytes in the ssidBytes
+    char blocks[][NETWORK_BLOCK_MAX_BYTES],
+    size_t blockCount
 )
 {
-    int         systemResult;
-    char        tmpString[TEMP_STRING_MAX_BYTES];
-    le_result_t result  = LE_OK;
+    FILE    *filePtr;
+    size_t   i;
 
-    // Check SSID
-    if (( 0 == ssidLength) || (ssidLength > LE_WIFIDEFS_MAX_SSID_LENGTH))
+    // Create the WPA supplicant file
+    filePtr = fopen(WPA_SUPPLICANT_FILE, "w");
+    if (filePtr == NULL)
     {
-        LE_ERROR("Invalid SSID");
-        return LE_BAD_PARAMETER;
+        LE_ERROR("Unable to create \"%s\" file.", WPA_SUPPLICANT_FILE);
+        return LE_FAULT;
     }
 
-    LE_INFO("Connecting over SSID length %d SSID: \"%.*s\"", ssidLength, ssidLength,
-            (char *)ssidBytes);
+    //The common part and the network blocks are written to wpa_supplicant.conf
+    //separately for easier debug.
+    if (LE_OK != WriteClientCfgFile(WPA_SUPPLICANT_CONFIG_COMMON, filePtr))
+    {
+        LE_ERROR("Unable to write wpa_supplicant common part");
+        goto WRONG_CONFIG;
+    }
 
-    if (LE_OK != GenerateWpaSupplicant((char *)&ssidBytes[0], ssidLength))
+    for (i = 0; i < blockCount; i++)
     {
-        return LE_BAD_PARAMETER;
+        if (LE_OK != WriteClientCfgFile(blocks[i], filePtr))
+        {
+            LE_ERROR("Unable to write wpa_supplicant network block %zu", i);
+            goto WRONG_CONFIG;
+        }
+    }
+
+    fclose(filePtr);
+    return LE_OK;
+
+WRONG_CONFIG:
+
+    LE_ERROR("Unable to generate the WPA supplicant file \"%s\".", WPA_SUPPLICANT_FILE);
+    fclose(filePtr);
+    return LE_FAULT;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function generates the WPA supplicant configuration file.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t GenerateWpaSupplicant
+(
+    char *ssidPtr,
+    const uint32_t ssidLength
+)
+{
+    char        block[1][NETWORK_BLOCK_MAX_BYTES];
+    le_result_t result;
+
+    LE_DEBUG("Generate Wpa Supplicant");
+
+    memset(block, '\0', sizeof(block));
+    result = GenerateNetworkBlock(ssidPtr, ssidLength, 0, block[0], sizeof(block[0]));
+    if (LE_OK == result)
+    {
+        result = WriteWpaSupplicant(block, 1);
     }
-    le_utf8_Copy(tmpString, WIFI_SCRIPT_PATH, sizeof(tmpString), NULL);
+    else
+    {
+        LE_ERROR("Unable to generate the WPA supplicant file \"%s\".", WPA_SUPPLICANT_FILE);
+    }
+
+    // The block holds the credentials
+    memset(block, '\0', sizeof(block));
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function starts wpa_supplicant with the generated configuration file and waits for the
+ * connection.
+ *
+ * @return LE_FAULT             The function failed.
+ * @return LE_DUPLICATE         Duplicated request.
+ * @return LE_TIMEOUT           Connection request time out, or the 4-way handshake or EAP exchange
+ *                              did not complete.
+ * @return LE_OK                The function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t StartWpaSupplicant
+(
+    void
+)
+{
+    int         systemResult;
+    char        tmpString[TEMP_STRING_MAX_BYTES];
+    char        path[PATH_MAX_BYTES];
+    FILE       *filePtr;
+    le_result_t result  = LE_OK;
+
+    le_utf8_Copy(tmpString, ScriptPath, sizeof(tmpString), NULL);
     le_utf8_Append(tmpString, COMMAND_WIFICLIENT_CONNECT, sizeof(tmpString), NULL);
     le_utf8_Append(tmpString, WPA_SUPPLICANT_FILE, sizeof(tmpString), NULL);
 
-    systemResult = system(tmpString);
+    filePtr = popen(tmpString, "r");
+    if (NULL == filePtr)
+    {
+        LE_ERROR("Failed to run command:\"%s\" errno:%d %s", tmpString, errno, strerror(errno));
+        return LE_FAULT;
+    }
+
+    // The script reports the phases it goes through
+    while (NULL != fgets(path, sizeof(path), filePtr))
+    {
+        if (NULL != strstr(path, "Checking connection"))
+        {
+            MarkConnectPhase(&ConnectPhases.supplicant);
+        }
+        else if (NULL != strstr(path, "Authorized"))
+        {
+            MarkConnectPhase(&ConnectPhases.handshake);
+        }
+    }
+
+    systemResult = pclose(filePtr);
     // Return value of 0 means WiFi client connected.
     if (0 == WEXITSTATUS(systemResult))
     {
         LE_DEBUG("WiFi Client connected");
         result = LE_OK;
     }
-    // Return value of 8 means connection time out.
+    // Return value of 8 means connection or authorization time out.
     else if ( PA_TIMEOUT == WEXITSTATUS(systemResult))
     {
         LE_DEBUG("Connection time out");
@@ -1089,6 +1557,177 @@ le_result_t pa_wifiClient_Connect
     return result;
 }
 
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function connects a wifiClient.
+ *
+ * @return LE_FAULT             The function failed.
+ * @return LE_BAD_PARAMETER     Invalid parameter.
+ * @return LE_DUPLICATE         Duplicated request.
+ * @return LE_TIMEOUT           Connection request time out.
+ * @return LE_OK                The function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiClient_Connect
+(
+    uint8_t ssidBytes[LE_WIFIDEFS_MAX_SSID_BYTES],
+        ///< [IN]
+        ///< Contains ssidLength number of bytes
+    uint8_t ssidLength
+        ///< [IN]
+        ///< The number of Bytes in the ssidBytes
+)
+{
+    le_result_t result;
+
+    // Check SSID
+    if (( 0 == ssidLength) || (ssidLength > LE_WIFIDEFS_MAX_SSID_LENGTH))
+    {
+        LE_ERROR("Invalid SSID");
+        return LE_BAD_PARAMETER;
+    }
+
+    LE_INFO("Connecting over SSID length %d SSID: \"%.*s\"", ssidLength, ssidLength,
+            (char *)ssidBytes);
+
+    StartConnectPhases();
+    if (LE_OK != GenerateWpaSupplicant((char *)&ssidBytes[0], ssidLength))
+    {
+        EndConnectPhases(LE_BAD_PARAMETER);
+        return LE_BAD_PARAMETER;
+    }
+    MarkConnectPhase(&ConnectPhases.config);
+
+    result = StartWpaSupplicant();
+    EndConnectPhases(result);
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function adds a network, with the security parameters currently set, to the ones
+ * pa_wifiClient_ConnectNetworks() will connect to.
+ *
+ * @return LE_BAD_PARAMETER     Invalid parameter.
+ * @return LE_OUT_OF_RANGE      Too many networks.
+ * @return LE_OK                The function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiClient_AddNetwork
+(
+    const uint8_t *ssidPtr,
+        ///< [IN]
+        ///< The SSID as an octet array.
+
+    size_t ssidNumElements,
+        ///< [IN]
+        ///< The length of the SSID in octets.
+
+    int32_t priority
+        ///< [IN]
+        ///< wpa_supplicant priority of the network, the highest is selected first.
+)
+{
+    if (NetworkBlockCount >= PA_WIFICLIENT_MAX_NETWORKS)
+    {
+        LE_ERROR("Too many networks");
+        return LE_OUT_OF_RANGE;
+    }
+
+    memset(NetworkBlocks[NetworkBlockCount], '\0', NETWORK_BLOCK_MAX_BYTES);
+    if (LE_OK != GenerateNetworkBlock((const char *)ssidPtr, ssidNumElements, priority,
+                                      NetworkBlocks[NetworkBlockCount], NETWORK_BLOCK_MAX_BYTES))
+    {
+        return LE_BAD_PARAMETER;
+    }
+
+    LE_DEBUG("Network %zu: SSID \"%.*s\" priority %d", NetworkBlockCount, (int)ssidNumElements,
+             (const char *)ssidPtr, (int)priority);
+    NetworkBlockCount++;
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function connects a wifiClient to the best of the networks added by
+ * pa_wifiClient_AddNetwork(), which are then cleared. wpa_supplicant selects the network of
+ * highest priority among the ones in range, and falls back to the others without a restart.
+ *
+ * @return LE_FAULT             The function failed.
+ * @return LE_BAD_PARAMETER     No network added.
+ * @return LE_DUPLICATE         Duplicated request.
+ * @return LE_TIMEOUT           Connection request time out.
+ * @return LE_OK                The function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiClient_ConnectNetworks
+(
+    void
+)
+{
+    le_result_t result;
+
+    if (0 == NetworkBlockCount)
+    {
+        LE_ERROR("No network to connect to");
+        return LE_BAD_PARAMETER;
+    }
+
+    LE_INFO("Connecting over %zu networks", NetworkBlockCount);
+    StartConnectPhases();
+    result = WriteWpaSupplicant(NetworkBlocks, NetworkBlockCount);
+
+    // The blocks hold the credentials
+    memset(NetworkBlocks, '\0', sizeof(NetworkBlocks));
+    NetworkBlockCount = 0;
+
+    if (LE_OK != result)
+    {
+        EndConnectPhases(LE_FAULT);
+        return LE_FAULT;
+    }
+    MarkConnectPhase(&ConnectPhases.config);
+
+    result = StartWpaSupplicant();
+    EndConnectPhases(result);
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function gets the duration of the phases of the last connection attempt made by
+ * pa_wifiClient_Connect() or pa_wifiClient_ConnectNetworks().
+ *
+ * @return LE_BAD_PARAMETER     Invalid parameter.
+ * @return LE_NOT_FOUND         No connection attempt made.
+ * @return LE_OK                The function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiClient_GetConnectTiming
+(
+    pa_wifiClient_ConnectTiming_t *timingPtr
+        ///< [OUT]
+        ///< Duration of the phases of the last connection attempt.
+)
+{
+    le_result_t result = LE_NOT_FOUND;
+
+    if (NULL == timingPtr)
+    {
+        return LE_BAD_PARAMETER;
+    }
+
+    le_mutex_Lock(ConnectPhasesMutex);
+    if (HasConnectTiming)
+    {
+        *timingPtr = LastConnectTiming;
+        result = LE_OK;
+    }
+    le_mutex_Unlock(ConnectPhasesMutex);
+    return result;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This function disconnects a wifiClient.
@@ -1106,7 +1745,7 @@ le_result_t pa_wifiClient_Disconnect
     le_result_t result       = LE_OK;
 
     // Terminate connection
-    systemResult = system(WIFI_SCRIPT_PATH COMMAND_WIFICLIENT_DISCONNECT);
+    systemResult = RunScript(COMMAND_WIFICLIENT_DISCONNECT);
     if (0 == WEXITSTATUS(systemResult))
     {
         LE_INFO("WiFi Client Command \"%s\" OK:", COMMAND_WIFICLIENT_DISCONNECT);
@@ -1121,6 +1760,462 @@ le_result_t pa_wifiClient_Disconnect
     return result;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function makes the connected wifiClient reassociate with another BSS of the same ESS, given
+ * its BSSID. With IEEE 802.11r fast BSS transition enabled, the keys are derived from the existing
+ * association so no full authentication is done.
+ *
+ * @return LE_FAULT             The function failed.
+ * @return LE_BAD_PARAMETER     Invalid parameter.
+ * @return LE_TIMEOUT           Reassociation request time out.
+ * @return LE_OK                The function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiClient_Roam
+(
+    const char *bssidPtr
+        ///< [IN]
+        ///< BSSID of the target access point
+)
+{
+    int             systemResult;
+    char            tmpString[TEMP_STRING_MAX_BYTES];
+    le_clk_Time_t   startTime;
+    le_clk_Time_t   roamTime;
+    le_result_t     result = LE_OK;
+
+    if ((NULL == bssidPtr) ||
+        (LE_WIFIDEFS_MAX_BSSID_LENGTH != strnlen(bssidPtr, LE_WIFIDEFS_MAX_BSSID_BYTES)))
+    {
+        LE_ERROR("Invalid BSSID");
+        return LE_BAD_PARAMETER;
+    }
+
+    LE_INFO("Roaming to BSSID %s", bssidPtr);
+
+    le_utf8_Copy(tmpString, ScriptPath, sizeof(tmpString), NULL);
+    le_utf8_Append(tmpString, COMMAND_WIFICLIENT_ROAM, sizeof(tmpString), NULL);
+    le_utf8_Append(tmpString, bssidPtr, sizeof(tmpString), NULL);
+
+    startTime = le_clk_GetRelativeTime();
+    systemResult = system(tmpString);
+    roamTime = le_clk_Sub(le_clk_GetRelativeTime(), startTime);
+
+    // Return value of 0 means WiFi client is associated with the target BSS.
+    if (0 == WEXITSTATUS(systemResult))
+    {
+        LE_INFO("Roamed to %s in %ld ms", bssidPtr,
+                (long)(roamTime.sec * 1000 + roamTime.usec / 1000));
+        result = LE_OK;
+    }
+    // Return value of 8 means reassociation time out.
+    else if (PA_TIMEOUT == WEXITSTATUS(systemResult))
+    {
+        LE_WARN("Roaming to %s time out", bssidPtr);
+        result = LE_TIMEOUT;
+    }
+    else
+    {
+        LE_ERROR("WiFi Client Command %s Failed: (%d)", tmpString, systemResult);
+        result = LE_FAULT;
+    }
+
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function gets the BSSID and the signal strength of the BSS the wifiClient is currently
+ * associated with.
+ *
+ * @return LE_FAULT             The function failed.
+ * @return LE_BAD_PARAMETER     Invalid parameter.
+ * @return LE_NOT_FOUND         The wifiClient is not associated.
+ * @return LE_OK                The function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiClient_GetLinkSignal
+(
+    char *bssidPtr,
+        ///< [OUT]
+        ///< BSSID of the associated access point
+    size_t bssidSize,
+        ///< [IN]
+        ///< Size of the BSSID buffer
+    int16_t *signalPtr
+        ///< [OUT]
+        ///< Signal strength in dBm
+)
+{
+    const char bssidPrefix[] = "Connected to ";
+    const char signalPrefix[] = "\tsignal: ";
+    const unsigned int bssidPrefixLen = NUM_ARRAY_MEMBERS(bssidPrefix) - 1;
+    const unsigned int signalPrefixLen = NUM_ARRAY_MEMBERS(signalPrefix) - 1;
+    char        path[PATH_MAX_BYTES];
+    FILE       *linkPipePtr;
+    bool        isBssidFound = false;
+    bool        isSignalFound = false;
+    int         st;
+
+    if ((NULL == bssidPtr) || (bssidSize < LE_WIFIDEFS_MAX_BSSID_BYTES) || (NULL == signalPtr))
+    {
+        LE_ERROR("Invalid parameter");
+        return LE_BAD_PARAMETER;
+    }
+
+    linkPipePtr = OpenScript(COMMAND_WIFICLIENT_LINK_SIGNAL);
+    if (NULL == linkPipePtr)
+    {
+        LE_ERROR("Failed to run command \"%s\": errno:%d: \"%s\" ",
+                COMMAND_WIFICLIENT_LINK_SIGNAL,
+                errno,
+                strerror(errno));
+        return LE_FAULT;
+    }
+
+    while (NULL != fgets(path, sizeof(path), linkPipePtr))
+    {
+        if (0 == strncmp(bssidPrefix, path, bssidPrefixLen))
+        {
+            memcpy(bssidPtr, &path[bssidPrefixLen], LE_WIFIDEFS_MAX_BSSID_LENGTH);
+            bssidPtr[LE_WIFIDEFS_MAX_BSSID_LENGTH] = '\0';
+            isBssidFound = true;
+        }
+        else if (0 == strncmp(signalPrefix, path, signalPrefixLen))
+        {
+            *signalPtr = strtol(&path[signalPrefixLen], NULL, 10);
+            isSignalFound = true;
+        }
+    }
+
+    st = pclose(linkPipePtr);
+    if (!WIFEXITED(st) || (0 != WEXITSTATUS(st)))
+    {
+        LE_ERROR("WiFi Client Command \"%s\" Failed: (%d)", COMMAND_WIFICLIENT_LINK_SIGNAL, st);
+        return LE_FAULT;
+    }
+
+    if (!isBssidFound || !isSignalFound)
+    {
+        LE_DEBUG("Not associated");
+        return LE_NOT_FOUND;
+    }
+
+    LE_DEBUG("Associated with %s, signal %d dBm", bssidPtr, *signalPtr);
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Parse a bitrate of the station dump, e.g. "65.0 MBit/s MCS 7", into kbit/s.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t ParseBitrate
+(
+    const char *valuePtr
+)
+{
+    return (uint32_t)(strtod(valuePtr, NULL) * 1000);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function gets the live statistics of the link with the associated access point.
+ *
+ * @return LE_BAD_PARAMETER     Invalid parameter.
+ * @return LE_FAULT             The function failed.
+ * @return LE_NOT_FOUND         The wifiClient is not associated.
+ * @return LE_OK                The function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiClient_GetStationInfo
+(
+    pa_wifiClient_StationInfo_t *infoPtr
+        ///< [OUT]
+        ///< Statistics of the link
+)
+{
+    const char stationPrefix[]    = "Station ";
+    const char signalPrefix[]     = "\tsignal:";
+    const char txBitratePrefix[]  = "\ttx bitrate:";
+    const char rxBitratePrefix[]  = "\trx bitrate:";
+    const char txRetriesPrefix[]  = "\ttx retries:";
+    const char txFailedPrefix[]   = "\ttx failed:";
+    const char beaconLossPrefix[] = "\tbeacon loss:";
+    char        path[PATH_MAX_BYTES];
+    FILE       *stationPipePtr;
+    bool        isStationFound = false;
+    bool        isBeaconLossFound = false;
+    int         st;
+
+    if (NULL == infoPtr)
+    {
+        LE_ERROR("Invalid parameter");
+        return LE_BAD_PARAMETER;
+    }
+
+    stationPipePtr = OpenScript(COMMAND_WIFICLIENT_STATION_INFO);
+    if (NULL == stationPipePtr)
+    {
+        LE_ERROR("Failed to run command \"%s\": errno:%d: \"%s\" ",
+                COMMAND_WIFICLIENT_STATION_INFO,
+                errno,
+                strerror(errno));
+        return LE_FAULT;
+    }
+
+    memset(infoPtr, 0, sizeof(*infoPtr));
+    // A client is associated with one station only: the access point
+    while (NULL != fgets(path, sizeof(path), stationPipePtr))
+    {
+        if (0 == strncmp(stationPrefix, path, sizeof(stationPrefix) - 1))
+        {
+            isStationFound = true;
+        }
+        else if (0 == strncmp(signalPrefix, path, sizeof(signalPrefix) - 1))
+        {
+            infoPtr->signal = strtol(&path[sizeof(signalPrefix) - 1], NULL, 10);
+        }
+        else if (0 == strncmp(txBitratePrefix, path, sizeof(txBitratePrefix) - 1))
+        {
+            infoPtr->txBitrate = ParseBitrate(&path[sizeof(txBitratePrefix) - 1]);
+        }
+        else if (0 == strncmp(rxBitratePrefix, path, sizeof(rxBitratePrefix) - 1))
+        {
+            infoPtr->rxBitrate = ParseBitrate(&path[sizeof(rxBitratePrefix) - 1]);
+        }
+        else if (0 == strncmp(txRetriesPrefix, path, sizeof(txRetriesPrefix) - 1))
+        {
+            infoPtr->txRetries = strtoul(&path[sizeof(txRetriesPrefix) - 1], NULL, 10);
+        }
+        else if (0 == strncmp(txFailedPrefix, path, sizeof(txFailedPrefix) - 1))
+        {
+            infoPtr->txFailed = strtoul(&path[sizeof(txFailedPrefix) - 1], NULL, 10);
+        }
+        else if (0 == strncmp(beaconLossPrefix, path, sizeof(beaconLossPrefix) - 1))
+        {
+            infoPtr->beaconLoss = strtoul(&path[sizeof(beaconLossPrefix) - 1], NULL, 10);
+            isBeaconLossFound = true;
+        }
+    }
+
+    st = pclose(stationPipePtr);
+    if (!WIFEXITED(st) || (0 != WEXITSTATUS(st)))
+    {
+        LE_ERROR("WiFi Client Command \"%s\" Failed: (%d)", COMMAND_WIFICLIENT_STATION_INFO, st);
+        return LE_FAULT;
+    }
+
+    if (!isStationFound)
+    {
+        LE_DEBUG("Not associated");
+        return LE_NOT_FOUND;
+    }
+
+    if (!isBeaconLossFound)
+    {
+        infoPtr->beaconLoss = BeaconLossCount;
+    }
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function sets the connection quality monitor signal threshold. The driver reports
+ * LE_WIFICLIENT_EVENT_RSSI_LOW and LE_WIFICLIENT_EVENT_RSSI_HIGH when the signal crosses it.
+ *
+ * @return LE_FAULT             The function failed.
+ * @return LE_OK                The function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiClient_SetRssiThreshold
+(
+    int16_t threshold,
+        ///< [IN]
+        ///< Signal strength threshold in dBm, 0 to disable the monitoring
+    uint8_t hysteresis
+        ///< [IN]
+        ///< Hysteresis in dB around the threshold
+)
+{
+    char tmpString[TEMP_STRING_MAX_BYTES];
+    int  systemResult;
+
+    if (0 == threshold)
+    {
+        snprintf(tmpString, sizeof(tmpString), "%s%soff", ScriptPath,
+                 COMMAND_WIFICLIENT_SET_CQM);
+    }
+    else
+    {
+        snprintf(tmpString, sizeof(tmpString), "%s%s%d %u", ScriptPath,
+                 COMMAND_WIFICLIENT_SET_CQM, threshold, hysteresis);
+    }
+
+    systemResult = system(tmpString);
+    if ((!WIFEXITED(systemResult)) || (0 != WEXITSTATUS(systemResult)))
+    {
+        LE_ERROR("WiFi Client Command \"%s\" Failed: (%d)", tmpString, systemResult);
+        return LE_FAULT;
+    }
+
+    LE_DEBUG("Signal threshold set to %d dBm, hysteresis %u dB", threshold, hysteresis);
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether a network interface name only has the characters allowed in the names of the
+ * interfaces: letters, digits, '_', '.' and '-'. It is passed to the script through the shell.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsValidInterfaceName
+(
+    const char *ifNamePtr
+)
+{
+    const char *charPtr;
+
+    if ((NULL == ifNamePtr) || ('\0' == ifNamePtr[0]))
+    {
+        return false;
+    }
+    for (charPtr = ifNamePtr; '\0' != *charPtr; charPtr++)
+    {
+        if ((!isalnum((unsigned char)*charPtr)) && ('_' != *charPtr) && ('.' != *charPtr) &&
+            ('-' != *charPtr))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Select the network interface of the station, on which the next start of the client runs.
+ *
+ * @return LE_BAD_PARAMETER The interface name is empty, too long or has invalid characters.
+ * @return LE_OK            The function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiClient_SetInterface
+(
+    const char *ifNamePtr
+        ///< [IN]
+        ///< Network interface of the station
+)
+{
+    if ((NULL == ifNamePtr) ||
+        (LE_WIFIDEFS_MAX_IFNAME_LENGTH < strnlen(ifNamePtr, LE_WIFIDEFS_MAX_IFNAME_BYTES)) ||
+        (!IsValidInterfaceName(ifNamePtr)))
+    {
+        LE_ERROR("Invalid interface name");
+        return LE_BAD_PARAMETER;
+    }
+
+    le_utf8_Copy(ClientIfName, ifNamePtr, sizeof(ClientIfName), NULL);
+    snprintf(ScriptPath, sizeof(ScriptPath), "%s-i %s ", WIFI_SCRIPT_PATH, ClientIfName);
+    LE_INFO("Station interface set to %s", ClientIfName);
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the network interface of the station.
+ *
+ * @return LE_OVERFLOW      The buffer is too small.
+ * @return LE_OK            The function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiClient_GetInterface
+(
+    char   *ifNamePtr,
+        ///< [OUT]
+        ///< Network interface of the station
+    size_t  ifNameSize
+        ///< [IN]
+        ///< Size of the interface name buffer
+)
+{
+    return le_utf8_Copy(ifNamePtr, ClientIfName, ifNameSize, NULL);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the WiFi interfaces of all the radios of the module, as listed by the driver.
+ *
+ * @return LE_BAD_PARAMETER Some parameter is invalid.
+ * @return LE_FAULT         The function failed.
+ * @return LE_OK            The function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiClient_GetInterfaces
+(
+    le_wifiClient_InterfaceInfo_t *interfacesPtr,
+        ///< [OUT]
+        ///< WiFi interfaces and their radio
+    size_t *numInterfacesPtr
+        ///< [INOUT]
+        ///< In: size of the interfaces array. Out: number of interfaces returned.
+)
+{
+    const char phyPrefix[]       = "phy#";
+    const char interfacePrefix[] = "\tInterface ";
+    char       path[TEMP_STRING_MAX_BYTES];
+    FILE      *ifacePipePtr;
+    uint32_t   phyIndex = 0;
+    size_t     numInterfaces = 0;
+    int        st;
+
+    if ((NULL == interfacesPtr) || (NULL == numInterfacesPtr))
+    {
+        LE_ERROR("Invalid parameter");
+        return LE_BAD_PARAMETER;
+    }
+
+    ifacePipePtr = OpenScript(COMMAND_WIFI_GET_INTERFACES);
+    if (NULL == ifacePipePtr)
+    {
+        LE_ERROR("Failed to run command \"%s\": errno:%d: \"%s\" ",
+                COMMAND_WIFI_GET_INTERFACES,
+                errno,
+                strerror(errno));
+        return LE_FAULT;
+    }
+
+    while (NULL != fgets(path, sizeof(path), ifacePipePtr))
+    {
+        if (0 == strncmp(phyPrefix, path, sizeof(phyPrefix) - 1))
+        {
+            phyIndex = strtoul(&path[sizeof(phyPrefix) - 1], NULL, 10);
+        }
+        else if ((0 == strncmp(interfacePrefix, path, sizeof(interfacePrefix) - 1)) &&
+                 (numInterfaces < *numInterfacesPtr))
+        {
+            le_wifiClient_InterfaceInfo_t *infoPtr = &interfacesPtr[numInterfaces++];
+
+            // "\tInterface wlan0\n"
+            path[strcspn(path, "\n")] = '\0';
+            memset(infoPtr, 0, sizeof(*infoPtr));
+            le_utf8_Copy(infoPtr->ifName, &path[sizeof(interfacePrefix) - 1],
+                         sizeof(infoPtr->ifName), NULL);
+            infoPtr->phyIndex = phyIndex;
+        }
+    }
+
+    st = pclose(ifacePipePtr);
+    if (!WIFEXITED(st) || (0 != WEXITSTATUS(st)))
+    {
+        LE_ERROR("WiFi Client Command \"%s\" Failed: (%d)", COMMAND_WIFI_GET_INTERFACES, st);
+        return LE_FAULT;
+    }
+
+    *numInterfacesPtr = numInterfaces;
+    return LE_OK;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Clears all username, password, PreShared Key, passphrase settings previously made by
@@ -1142,6 +2237,8 @@ le_result_t pa_wifiClient_ClearAllCredentials
     memset(SavedPreSharedKey, '\0', LE_WIFIDEFS_MAX_PSK_BYTES);
     memset(SavedUsername, '\0', LE_WIFIDEFS_MAX_USERNAME_BYTES);
     memset(SavedPassword, '\0', LE_WIFIDEFS_MAX_PASSWORD_BYTES);
+    memset(NetworkBlocks, '\0', sizeof(NetworkBlocks));
+    NetworkBlockCount = 0;
     return LE_OK;
 }
 
@@ -1229,6 +2326,51 @@ void pa_wifiClient_SetHiddenNetworkAttribute
     HiddenAccessPoint = hidden;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function specifies whether IEEE 802.11r fast BSS transition (FT-PSK or FT-EAP key
+ * management) is to be negotiated with the target Access Point.
+ *
+ * @note By default, this attribute is not set. When enabled, plain WPA2-PSK or WPA2-EAP remains
+ * allowed so that the client can still connect to access points without 802.11r support.
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_wifiClient_SetFastTransition
+(
+    bool enable
+        ///< [IN]
+        ///< If TRUE, fast BSS transition is negotiated with the access point.
+)
+{
+    LE_DEBUG("Set whether fast BSS transition is used or not: %d", enable);
+    FastTransition = enable;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function sets the access point preferred for the initial association with the next network
+ * configured, through the wpa_supplicant bssid_hint. Unlike a BSSID restriction, wpa_supplicant
+ * may still select or roam to another access point of the network.
+ *
+ * @note The hint applies to the next network only.
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_wifiClient_SetBssidHint
+(
+    const char *bssidPtr
+        ///< [IN]
+        ///< BSSID of the preferred access point, NULL or empty for none.
+)
+{
+    if (NULL == bssidPtr)
+    {
+        BssidHint[0] = '\0';
+        return;
+    }
+    LE_DEBUG("Preferred access point: %s", bssidPtr);
+    le_utf8_Copy(BssidHint, bssidPtr, sizeof(BssidHint), NULL);
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Set the PassPhrase used to create PSK (WPA-Personal).
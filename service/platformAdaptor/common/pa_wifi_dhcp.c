@@ -0,0 +1,612 @@
+// -------------------------------------------------------------------------------------------------
+/**
+ *  WiFi Client DHCP Platform Adapter
+ *
+ *  Minimal DHCPv4 client (RFC 2131) run on the WiFi interface once associated. Unlike an external
+ *  DHCP client, it can request the address of a cached lease directly (INIT-REBOOT state), which
+ *  takes a single REQUEST/ACK round trip instead of the full DISCOVER/OFFER/REQUEST/ACK exchange.
+ *
+ *  Copyright (C) Sierra Wireless Inc.
+ *
+ */
+// -------------------------------------------------------------------------------------------------
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <net/if.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <poll.h>
+
+#include "legato.h"
+
+#include "interfaces.h"
+
+#include "pa_wifi.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * WiFi platform adaptor shell script
+ */
+//--------------------------------------------------------------------------------------------------
+//Trailing space is needed to pass argument
+#define WIFI_SCRIPT_PATH "/legato/systems/current/apps/wifiService/read-only/pa_wifi "
+
+//Trailing space is needed to pass another argument by WIFI_SCRIPT_PATH
+#define COMMAND_WIFICLIENT_SET_IP       "WIFICLIENT_SET_IP "
+#define COMMAND_WIFICLIENT_CLEAR_IP     "WIFICLIENT_CLEAR_IP "
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum numbers of bytes in temparatory string
+ */
+//--------------------------------------------------------------------------------------------------
+#define TEMP_STRING_MAX_BYTES 192
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * DHCP protocol values (RFC 2131 and RFC 2132).
+ */
+//--------------------------------------------------------------------------------------------------
+#define DHCP_SERVER_PORT            67
+#define DHCP_CLIENT_PORT            68
+#define DHCP_OP_REQUEST             1
+#define DHCP_OP_REPLY               2
+#define DHCP_HTYPE_ETHERNET         1
+#define DHCP_FLAG_BROADCAST         0x8000
+#define DHCP_MAGIC_COOKIE           0x63825363
+#define DHCP_OPTIONS_MAX_BYTES      312
+
+#define DHCP_OPTION_PAD             0
+#define DHCP_OPTION_SUBNET_MASK     1
+#define DHCP_OPTION_ROUTER          3
+#define DHCP_OPTION_DNS             6
+#define DHCP_OPTION_REQUESTED_IP    50
+#define DHCP_OPTION_LEASE_TIME      51
+#define DHCP_OPTION_MESSAGE_TYPE    53
+#define DHCP_OPTION_SERVER_ID       54
+#define DHCP_OPTION_PARAMETER_LIST  55
+#define DHCP_OPTION_END             255
+
+#define DHCP_DISCOVER               1
+#define DHCP_OFFER                  2
+#define DHCP_REQUEST                3
+#define DHCP_ACK                    5
+#define DHCP_NAK                    6
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of transmissions of a message, and time to wait for the reply of each one. A cached lease
+ * is requested quickly: the server answers at once or the full exchange is needed anyway.
+ */
+//--------------------------------------------------------------------------------------------------
+#define DHCP_TRANSMISSIONS          3
+#define DHCP_REPLY_TIMEOUT_MS       1000
+#define DHCP_REBOOT_TRANSMISSIONS   2
+#define DHCP_REBOOT_TIMEOUT_MS      500
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * DHCP message, as sent over UDP.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct __attribute__((packed))
+{
+    uint8_t  op;                                ///< Message op code.
+    uint8_t  htype;                             ///< Hardware address type.
+    uint8_t  hlen;                              ///< Hardware address length.
+    uint8_t  hops;                              ///< Relay agent hops.
+    uint32_t xid;                               ///< Transaction ID.
+    uint16_t secs;                              ///< Seconds elapsed since the start.
+    uint16_t flags;                             ///< Flags.
+    uint32_t ciaddr;                            ///< Client IP address.
+    uint32_t yiaddr;                            ///< 'your' (client) IP address.
+    uint32_t siaddr;                            ///< Next server IP address.
+    uint32_t giaddr;                            ///< Relay agent IP address.
+    uint8_t  chaddr[16];                        ///< Client hardware address.
+    uint8_t  sname[64];                         ///< Server host name.
+    uint8_t  file[128];                         ///< Boot file name.
+    uint32_t magic;                             ///< Magic cookie.
+    uint8_t  options[DHCP_OPTIONS_MAX_BYTES];   ///< Options.
+}
+DhcpMessage_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * DHCP exchange on an interface.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    int      fd;            ///< UDP socket bound to the DHCP client port of the interface.
+    uint32_t xid;           ///< Transaction ID of the exchange.
+    uint8_t  mac[6];        ///< Hardware address of the interface.
+}
+DhcpExchange_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Append an option to a DHCP message.
+ *
+ * @return Offset of the next option.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t AddOption
+(
+    DhcpMessage_t *msgPtr,
+    size_t         offset,
+    uint8_t        code,
+    const void    *dataPtr,
+    uint8_t        length
+)
+{
+    msgPtr->options[offset++] = code;
+    msgPtr->options[offset++] = length;
+    memcpy(&msgPtr->options[offset], dataPtr, length);
+    return offset + length;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Build a DHCP DISCOVER or REQUEST message.
+ *
+ * @return Length of the message in bytes.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t BuildMessage
+(
+    const DhcpExchange_t            *exchangePtr,
+    uint8_t                          type,
+    pa_wifiClient_DhcpRequest_t      request,
+    const pa_wifiClient_DhcpLease_t *leasePtr,
+    DhcpMessage_t                   *msgPtr
+)
+{
+    const uint8_t paramList[] = { DHCP_OPTION_SUBNET_MASK, DHCP_OPTION_ROUTER, DHCP_OPTION_DNS,
+                                  DHCP_OPTION_LEASE_TIME };
+    size_t offset = 0;
+
+    memset(msgPtr, 0, sizeof(*msgPtr));
+    msgPtr->op = DHCP_OP_REQUEST;
+    msgPtr->htype = DHCP_HTYPE_ETHERNET;
+    msgPtr->hlen = sizeof(exchangePtr->mac);
+    msgPtr->xid = exchangePtr->xid;
+    memcpy(msgPtr->chaddr, exchangePtr->mac, sizeof(exchangePtr->mac));
+    msgPtr->magic = htonl(DHCP_MAGIC_COOKIE);
+
+    offset = AddOption(msgPtr, offset, DHCP_OPTION_MESSAGE_TYPE, &type, 1);
+    if (PA_WIFICLIENT_DHCP_RENEW == request)
+    {
+        // The address is in use: the server answers to it
+        msgPtr->ciaddr = leasePtr->address;
+    }
+    else
+    {
+        // No address yet: the server must broadcast its reply
+        msgPtr->flags = htons(DHCP_FLAG_BROADCAST);
+        if (DHCP_REQUEST == type)
+        {
+            offset = AddOption(msgPtr, offset, DHCP_OPTION_REQUESTED_IP, &leasePtr->address,
+                               sizeof(leasePtr->address));
+        }
+        // Only a REQUEST answering an OFFER selects a server. INIT-REBOOT must not
+        if ((DHCP_REQUEST == type) && (PA_WIFICLIENT_DHCP_DISCOVER == request))
+        {
+            offset = AddOption(msgPtr, offset, DHCP_OPTION_SERVER_ID, &leasePtr->server,
+                               sizeof(leasePtr->server));
+        }
+    }
+    offset = AddOption(msgPtr, offset, DHCP_OPTION_PARAMETER_LIST, paramList, sizeof(paramList));
+    msgPtr->options[offset++] = DHCP_OPTION_END;
+
+    return offsetof(DhcpMessage_t, options) + offset;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Parse the options of a DHCP reply into the lease.
+ *
+ * @return The DHCP message type, 0 if absent.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint8_t ParseReply
+(
+    const DhcpMessage_t       *msgPtr,
+    size_t                     length,
+    pa_wifiClient_DhcpLease_t *leasePtr
+)
+{
+    size_t   optionsLen = length - offsetof(DhcpMessage_t, options);
+    size_t   offset = 0;
+    uint8_t  type = 0;
+    uint32_t leaseTime;
+
+    leasePtr->address = msgPtr->yiaddr;
+    while (offset < optionsLen)
+    {
+        uint8_t code = msgPtr->options[offset++];
+        uint8_t len;
+        const uint8_t *dataPtr;
+
+        if (DHCP_OPTION_END == code)
+        {
+            break;
+        }
+        if (DHCP_OPTION_PAD == code)
+        {
+            continue;
+        }
+        if (offset >= optionsLen)
+        {
+            break;
+        }
+        len = msgPtr->options[offset++];
+        if ((offset + len) > optionsLen)
+        {
+            break;
+        }
+        dataPtr = &msgPtr->options[offset];
+
+        switch (code)
+        {
+            case DHCP_OPTION_MESSAGE_TYPE:
+                type = (len >= 1) ? dataPtr[0] : 0;
+                break;
+            case DHCP_OPTION_SUBNET_MASK:
+                if (len >= 4)
+                {
+                    memcpy(&leasePtr->netmask, dataPtr, 4);
+                }
+                break;
+            case DHCP_OPTION_ROUTER:
+                if (len >= 4)
+                {
+                    memcpy(&leasePtr->gateway, dataPtr, 4);
+                }
+                break;
+            case DHCP_OPTION_DNS:
+                if (len >= 4)
+                {
+                    memcpy(&leasePtr->dns, dataPtr, 4);
+                }
+                break;
+            case DHCP_OPTION_SERVER_ID:
+                if (len >= 4)
+                {
+                    memcpy(&leasePtr->server, dataPtr, 4);
+                }
+                break;
+            case DHCP_OPTION_LEASE_TIME:
+                if (len >= 4)
+                {
+                    memcpy(&leaseTime, dataPtr, 4);
+                    leasePtr->leaseTime = ntohl(leaseTime);
+                }
+                break;
+            default:
+                break;
+        }
+        offset += len;
+    }
+    return type;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send a DHCP message and wait for the reply of the given types, retransmitting it if needed.
+ *
+ * @return LE_OK        A reply has been received.
+ * @return LE_TIMEOUT   No reply.
+ * @return LE_FAULT     The message could not be sent.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t Transact
+(
+    const DhcpExchange_t            *exchangePtr,
+    const DhcpMessage_t             *msgPtr,
+    size_t                           msgLen,
+    uint32_t                         destination,
+    int                              transmissions,
+    int                              timeoutMs,
+    uint8_t                         *typePtr,
+    pa_wifiClient_DhcpLease_t       *leasePtr
+)
+{
+    struct sockaddr_in to;
+    DhcpMessage_t      reply;
+    int                i;
+
+    memset(&to, 0, sizeof(to));
+    to.sin_family = AF_INET;
+    to.sin_port = htons(DHCP_SERVER_PORT);
+    to.sin_addr.s_addr = destination;
+
+    for (i = 0; i < transmissions; i++)
+    {
+        le_clk_Time_t deadline = le_clk_Add(le_clk_GetRelativeTime(),
+                                            (le_clk_Time_t){ timeoutMs / 1000,
+                                                             (timeoutMs % 1000) * 1000 });
+
+        if (sendto(exchangePtr->fd, msgPtr, msgLen, 0, (struct sockaddr *)&to, sizeof(to)) < 0)
+        {
+            LE_ERROR("Failed to send DHCP message: errno:%d %s", errno, strerror(errno));
+            return LE_FAULT;
+        }
+
+        for (;;)
+        {
+            le_clk_Time_t  remaining;
+            struct pollfd  pfd = { .fd = exchangePtr->fd, .events = POLLIN };
+            ssize_t        len;
+            pa_wifiClient_DhcpLease_t lease;
+
+            remaining = le_clk_Sub(deadline, le_clk_GetRelativeTime());
+            if ((remaining.sec < 0) || (remaining.usec < 0) ||
+                (poll(&pfd, 1, (remaining.sec * 1000) + (remaining.usec / 1000)) <= 0))
+            {
+                break;
+            }
+
+            len = recv(exchangePtr->fd, &reply, sizeof(reply), 0);
+            if ((len < (ssize_t)offsetof(DhcpMessage_t, options)) ||
+                (DHCP_OP_REPLY != reply.op) || (exchangePtr->xid != reply.xid) ||
+                (htonl(DHCP_MAGIC_COOKIE) != reply.magic) ||
+                (0 != memcmp(reply.chaddr, exchangePtr->mac, sizeof(exchangePtr->mac))))
+            {
+                // Not for this exchange
+                continue;
+            }
+
+            lease = *leasePtr;
+            *typePtr = ParseReply(&reply, len, &lease);
+            if ((DHCP_OFFER == *typePtr) || (DHCP_ACK == *typePtr) || (DHCP_NAK == *typePtr))
+            {
+                *leasePtr = lease;
+                return LE_OK;
+            }
+        }
+        LE_DEBUG("No DHCP reply, transmission %d", i + 1);
+    }
+    return LE_TIMEOUT;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Open the UDP socket of the DHCP client on the interface and get its hardware address.
+ *
+ * @return LE_OK     The function succeeded.
+ * @return LE_FAULT  The function failed.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t OpenExchange
+(
+    const char     *ifNamePtr,
+    DhcpExchange_t *exchangePtr
+)
+{
+    struct sockaddr_in addr;
+    struct ifreq       ifr;
+    int                on = 1;
+
+    exchangePtr->fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (exchangePtr->fd < 0)
+    {
+        LE_ERROR("Failed to open DHCP socket: errno:%d %s", errno, strerror(errno));
+        return LE_FAULT;
+    }
+
+    memset(&ifr, 0, sizeof(ifr));
+    le_utf8_Copy(ifr.ifr_name, ifNamePtr, sizeof(ifr.ifr_name), NULL);
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(DHCP_CLIENT_PORT);
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+
+    if ((setsockopt(exchangePtr->fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on)) < 0) ||
+        (setsockopt(exchangePtr->fd, SOL_SOCKET, SO_BROADCAST, &on, sizeof(on)) < 0) ||
+        (setsockopt(exchangePtr->fd, SOL_SOCKET, SO_BINDTODEVICE, &ifr, sizeof(ifr)) < 0) ||
+        (bind(exchangePtr->fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) ||
+        (ioctl(exchangePtr->fd, SIOCGIFHWADDR, &ifr) < 0))
+    {
+        LE_ERROR("Failed to set up DHCP socket on %s: errno:%d %s", ifNamePtr, errno,
+                 strerror(errno));
+        close(exchangePtr->fd);
+        return LE_FAULT;
+    }
+
+    memcpy(exchangePtr->mac, ifr.ifr_hwaddr.sa_data, sizeof(exchangePtr->mac));
+    exchangePtr->xid = (uint32_t)rand();
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function gets a DHCP lease on the given interface, which must be associated.
+ * With PA_WIFICLIENT_DHCP_INIT_REBOOT and PA_WIFICLIENT_DHCP_RENEW, the lease given is requested
+ * again. On success, the lease is updated with the one granted by the server.
+ *
+ * @return LE_BAD_PARAMETER     Invalid parameter.
+ * @return LE_NOT_POSSIBLE      The server refused the lease (DHCPNAK).
+ * @return LE_TIMEOUT           No answer from a DHCP server.
+ * @return LE_FAULT             The function failed.
+ * @return LE_OK                The function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiClient_RequestLease
+(
+    const char *ifNamePtr,
+        ///< [IN]
+        ///< WLAN interface name
+    pa_wifiClient_DhcpRequest_t request,
+        ///< [IN]
+        ///< State from which the lease is requested
+    pa_wifiClient_DhcpLease_t *leasePtr
+        ///< [IN/OUT]
+        ///< Lease to request again, then lease granted
+)
+{
+    DhcpExchange_t            exchange;
+    DhcpMessage_t             msg;
+    pa_wifiClient_DhcpLease_t lease;
+    size_t                    msgLen;
+    uint8_t                   type = 0;
+    le_result_t               result;
+
+    if ((NULL == ifNamePtr) || (NULL == leasePtr) ||
+        ((PA_WIFICLIENT_DHCP_DISCOVER != request) && (0 == leasePtr->address)))
+    {
+        LE_ERROR("Invalid parameter");
+        return LE_BAD_PARAMETER;
+    }
+
+    if (LE_OK != OpenExchange(ifNamePtr, &exchange))
+    {
+        return LE_FAULT;
+    }
+
+    lease = *leasePtr;
+    if (PA_WIFICLIENT_DHCP_DISCOVER == request)
+    {
+        memset(&lease, 0, sizeof(lease));
+        msgLen = BuildMessage(&exchange, DHCP_DISCOVER, request, &lease, &msg);
+        result = Transact(&exchange, &msg, msgLen, htonl(INADDR_BROADCAST), DHCP_TRANSMISSIONS,
+                          DHCP_REPLY_TIMEOUT_MS, &type, &lease);
+        if ((LE_OK == result) && (DHCP_OFFER != type))
+        {
+            result = LE_FAULT;
+        }
+        if (LE_OK != result)
+        {
+            LE_WARN("No DHCP offer on %s", ifNamePtr);
+            close(exchange.fd);
+            return result;
+        }
+        LE_DEBUG("DHCP offer of %s", inet_ntoa((struct in_addr){ lease.address }));
+    }
+
+    msgLen = BuildMessage(&exchange, DHCP_REQUEST, request, &lease, &msg);
+    if (PA_WIFICLIENT_DHCP_INIT_REBOOT == request)
+    {
+        result = Transact(&exchange, &msg, msgLen, htonl(INADDR_BROADCAST),
+                          DHCP_REBOOT_TRANSMISSIONS, DHCP_REBOOT_TIMEOUT_MS, &type, &lease);
+    }
+    else
+    {
+        result = Transact(&exchange, &msg, msgLen, htonl(INADDR_BROADCAST), DHCP_TRANSMISSIONS,
+                          DHCP_REPLY_TIMEOUT_MS, &type, &lease);
+    }
+    close(exchange.fd);
+
+    if (LE_OK != result)
+    {
+        LE_WARN("No DHCP answer on %s", ifNamePtr);
+        return result;
+    }
+    if (DHCP_NAK == type)
+    {
+        LE_WARN("DHCP lease of %s refused", inet_ntoa((struct in_addr){ lease.address }));
+        return LE_NOT_POSSIBLE;
+    }
+    if (DHCP_ACK != type)
+    {
+        return LE_FAULT;
+    }
+
+    *leasePtr = lease;
+    LE_INFO("DHCP lease of %s for %u s", inet_ntoa((struct in_addr){ lease.address }),
+            lease.leaseTime);
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function sets the address, default route and DNS server of a DHCP lease on the given
+ * interface.
+ *
+ * @return LE_BAD_PARAMETER     Invalid parameter.
+ * @return LE_FAULT             The function failed.
+ * @return LE_OK                The function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiClient_SetIpConfig
+(
+    const char *ifNamePtr,
+        ///< [IN]
+        ///< WLAN interface name
+    const pa_wifiClient_DhcpLease_t *leasePtr
+        ///< [IN]
+        ///< Lease granted by the DHCP server
+)
+{
+    char tmpString[TEMP_STRING_MAX_BYTES];
+    char address[INET_ADDRSTRLEN];
+    char netmask[INET_ADDRSTRLEN];
+    char gateway[INET_ADDRSTRLEN];
+    char dns[INET_ADDRSTRLEN];
+    int  systemResult;
+
+    if ((NULL == ifNamePtr) || (NULL == leasePtr) || (0 == leasePtr->address))
+    {
+        LE_ERROR("Invalid parameter");
+        return LE_BAD_PARAMETER;
+    }
+
+    inet_ntop(AF_INET, &leasePtr->address, address, sizeof(address));
+    inet_ntop(AF_INET, &leasePtr->netmask, netmask, sizeof(netmask));
+    inet_ntop(AF_INET, &leasePtr->gateway, gateway, sizeof(gateway));
+    inet_ntop(AF_INET, &leasePtr->dns, dns, sizeof(dns));
+
+    snprintf(tmpString, sizeof(tmpString), "%s%s%s %s %s %s %s", WIFI_SCRIPT_PATH,
+             COMMAND_WIFICLIENT_SET_IP, ifNamePtr, address, netmask, gateway, dns);
+
+    systemResult = system(tmpString);
+    if ((!WIFEXITED(systemResult)) || (0 != WEXITSTATUS(systemResult)))
+    {
+        LE_ERROR("WiFi Client Command \"%s\" Failed: (%d)", tmpString, systemResult);
+        return LE_FAULT;
+    }
+
+    LE_DEBUG("IP address %s set on %s", address, ifNamePtr);
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function removes the address and default route set by pa_wifiClient_SetIpConfig() from the
+ * given interface.
+ *
+ * @return LE_BAD_PARAMETER     Invalid parameter.
+ * @return LE_FAULT             The function failed.
+ * @return LE_OK                The function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiClient_ClearIpConfig
+(
+    const char *ifNamePtr
+        ///< [IN]
+        ///< WLAN interface name
+)
+{
+    char tmpString[TEMP_STRING_MAX_BYTES];
+    int  systemResult;
+
+    if ((NULL == ifNamePtr) || ('\0' == ifNamePtr[0]))
+    {
+        LE_ERROR("Invalid parameter");
+        return LE_BAD_PARAMETER;
+    }
+
+    snprintf(tmpString, sizeof(tmpString), "%s%s%s", WIFI_SCRIPT_PATH,
+             COMMAND_WIFICLIENT_CLEAR_IP, ifNamePtr);
+
+    systemResult = system(tmpString);
+    if ((!WIFEXITED(systemResult)) || (0 != WEXITSTATUS(systemResult)))
+    {
+        LE_ERROR("WiFi Client Command \"%s\" Failed: (%d)", tmpString, systemResult);
+        return LE_FAULT;
+    }
+
+    LE_DEBUG("IP address removed from %s", ifNamePtr);
+    return LE_OK;
+}
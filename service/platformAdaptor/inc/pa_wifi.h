@@ -25,6 +25,21 @@
 #define PA_DUPLICATE        14
 #define PA_NOT_FOUND        50
 #define PA_NOT_POSSIBLE     100
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of networks pa_wifiClient_ConnectNetworks() connects to.
+ */
+//--------------------------------------------------------------------------------------------------
+#define PA_WIFICLIENT_MAX_NETWORKS  8
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Default network interface of the station.
+ */
+//--------------------------------------------------------------------------------------------------
+#define PA_WIFICLIENT_INTERFACE     "wlan0"
+
 //--------------------------------------------------------------------------------------------------
 /**
  * AccessPoint structure.
@@ -37,8 +52,69 @@ typedef struct
     uint8_t  ssidLength;                            ///< The number of bytes in the ssidBytes.
     uint8_t  ssidBytes[LE_WIFIDEFS_MAX_SSID_BYTES]; ///< Contains ssidLength number of bytes.
     char     bssid[LE_WIFIDEFS_MAX_BSSID_BYTES];    ///< Contains the bssid.
+    uint16_t frequency;                             ///< Channel frequency in MHz, 0 if not found.
 } pa_wifiClient_AccessPoint_t;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Duration of the phases of a connection attempt. A phase not reached or not reported by the
+ * driver lasts 0 ms.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_result_t result;         ///< Result of the connection attempt.
+    uint32_t    configMs;       ///< wpa_supplicant configuration generation.
+    uint32_t    supplicantMs;   ///< wpa_supplicant start.
+    uint32_t    authMs;         ///< IEEE 802.11 authentication, including the scan.
+    uint32_t    assocMs;        ///< IEEE 802.11 association.
+    uint32_t    handshakeMs;    ///< 4-way handshake or EAP completion.
+    uint32_t    totalMs;        ///< Whole connection attempt.
+} pa_wifiClient_ConnectTiming_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Live statistics of the link with the associated access point.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    int16_t  signal;        ///< Signal strength in dBm.
+    uint32_t txBitrate;     ///< Bitrate of the last frame sent, in kbit/s.
+    uint32_t rxBitrate;     ///< Bitrate of the last frame received, in kbit/s.
+    uint32_t txRetries;     ///< Number of retried transmissions.
+    uint32_t txFailed;      ///< Number of failed transmissions.
+    uint32_t beaconLoss;    ///< Number of beacon loss events.
+} pa_wifiClient_StationInfo_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * DHCP client state from which a lease is requested.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    PA_WIFICLIENT_DHCP_DISCOVER,    ///< Full DISCOVER/OFFER/REQUEST/ACK exchange.
+    PA_WIFICLIENT_DHCP_INIT_REBOOT, ///< REQUEST of the address of a cached lease.
+    PA_WIFICLIENT_DHCP_RENEW        ///< REQUEST extending the lease in use.
+}
+pa_wifiClient_DhcpRequest_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * DHCP lease. Addresses are IPv4 addresses in network byte order, 0 when not provided.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t address;       ///< Address leased.
+    uint32_t netmask;       ///< Subnet mask.
+    uint32_t gateway;       ///< Default router.
+    uint32_t dns;           ///< DNS server.
+    uint32_t server;        ///< DHCP server identifier.
+    uint32_t leaseTime;     ///< Lease duration in seconds.
+} pa_wifiClient_DhcpLease_t;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Event handler for PA WiFi access point changes.
@@ -154,6 +230,28 @@ LE_SHARED le_result_t pa_wifiClient_Scan
     void
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function starts a scan directed to the given SSID, by probing it explicitly instead of
+ * listening to all beacons. It behaves as pa_wifiClient_Scan(): results are read via
+ * pa_wifiClient_GetScanResult and pa_wifiClient_ScanDone MUST be called when the reading is done.
+ *
+ * @return LE_FAULT          The function failed.
+ * @return LE_BAD_PARAMETER  Invalid parameter.
+ * @return LE_BUSY           The function is already ongoing.
+ * @return LE_OK             The function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t pa_wifiClient_ScanSsid
+(
+    const uint8_t *ssidPtr,
+        ///< [IN]
+        ///< SSID to probe
+    size_t ssidNumElements
+        ///< [IN]
+        ///< The number of bytes in the SSID
+);
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This function is used to find out if a scan is currently running.
@@ -225,6 +323,65 @@ LE_SHARED le_result_t pa_wifiClient_Connect
         ///< The number of bytes in the ssidBytes
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function adds a network, with the security parameters currently set, to the ones
+ * pa_wifiClient_ConnectNetworks() will connect to.
+ *
+ * @return LE_BAD_PARAMETER     Invalid parameter.
+ * @return LE_OUT_OF_RANGE      Too many networks.
+ * @return LE_OK                The function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t pa_wifiClient_AddNetwork
+(
+    const uint8_t *ssidPtr,
+        ///< [IN]
+        ///< The SSID as an octet array.
+
+    size_t ssidNumElements,
+        ///< [IN]
+        ///< The length of the SSID in octets.
+
+    int32_t priority
+        ///< [IN]
+        ///< wpa_supplicant priority of the network, the highest is selected first.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function connects a wifiClient to the best of the networks added by
+ * pa_wifiClient_AddNetwork(), which are then cleared.
+ *
+ * @return LE_FAULT             The function failed.
+ * @return LE_BAD_PARAMETER     No network added.
+ * @return LE_DUPLICATE         Duplicated request.
+ * @return LE_TIMEOUT           Connection request time out.
+ * @return LE_OK                The function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t pa_wifiClient_ConnectNetworks
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function gets the duration of the phases of the last connection attempt made by
+ * pa_wifiClient_Connect() or pa_wifiClient_ConnectNetworks().
+ *
+ * @return LE_BAD_PARAMETER     Invalid parameter.
+ * @return LE_NOT_FOUND         No connection attempt made.
+ * @return LE_OK                The function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t pa_wifiClient_GetConnectTiming
+(
+    pa_wifiClient_ConnectTiming_t *timingPtr
+        ///< [OUT]
+        ///< Duration of the phases of the last connection attempt.
+);
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This function disconnects a wifiClient.
@@ -238,6 +395,200 @@ LE_SHARED le_result_t pa_wifiClient_Disconnect
     void
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function makes the connected wifiClient reassociate with another BSS of the same ESS, given
+ * its BSSID. With IEEE 802.11r fast BSS transition enabled, the keys are derived from the existing
+ * association so no full authentication is done.
+ *
+ * @return LE_FAULT             The function failed.
+ * @return LE_BAD_PARAMETER     Invalid parameter.
+ * @return LE_TIMEOUT           Reassociation request time out.
+ * @return LE_OK                The function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t pa_wifiClient_Roam
+(
+    const char *bssidPtr
+        ///< [IN]
+        ///< BSSID of the target access point
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function gets the BSSID and the signal strength of the BSS the wifiClient is currently
+ * associated with.
+ *
+ * @return LE_FAULT             The function failed.
+ * @return LE_BAD_PARAMETER     Invalid parameter.
+ * @return LE_NOT_FOUND         The wifiClient is not associated.
+ * @return LE_OK                The function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t pa_wifiClient_GetLinkSignal
+(
+    char *bssidPtr,
+        ///< [OUT]
+        ///< BSSID of the associated access point
+    size_t bssidSize,
+        ///< [IN]
+        ///< Size of the BSSID buffer
+    int16_t *signalPtr
+        ///< [OUT]
+        ///< Signal strength in dBm
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function gets the live statistics of the link with the associated access point.
+ *
+ * @return LE_BAD_PARAMETER     Invalid parameter.
+ * @return LE_FAULT             The function failed.
+ * @return LE_NOT_FOUND         The wifiClient is not associated.
+ * @return LE_OK                The function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t pa_wifiClient_GetStationInfo
+(
+    pa_wifiClient_StationInfo_t *infoPtr
+        ///< [OUT]
+        ///< Statistics of the link
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function sets the connection quality monitor signal threshold. The driver reports
+ * LE_WIFICLIENT_EVENT_RSSI_LOW and LE_WIFICLIENT_EVENT_RSSI_HIGH when the signal crosses it.
+ *
+ * @return LE_FAULT             The function failed.
+ * @return LE_OK                The function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t pa_wifiClient_SetRssiThreshold
+(
+    int16_t threshold,
+        ///< [IN]
+        ///< Signal strength threshold in dBm, 0 to disable the monitoring
+    uint8_t hysteresis
+        ///< [IN]
+        ///< Hysteresis in dB around the threshold
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Select the network interface of the station, on which the next start of the client runs.
+ *
+ * @return LE_BAD_PARAMETER The interface name is empty, too long or has invalid characters.
+ * @return LE_OK            The function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t pa_wifiClient_SetInterface
+(
+    const char *ifNamePtr
+        ///< [IN]
+        ///< Network interface of the station
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the network interface of the station.
+ *
+ * @return LE_OVERFLOW      The buffer is too small.
+ * @return LE_OK            The function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t pa_wifiClient_GetInterface
+(
+    char   *ifNamePtr,
+        ///< [OUT]
+        ///< Network interface of the station
+    size_t  ifNameSize
+        ///< [IN]
+        ///< Size of the interface name buffer
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the WiFi interfaces of all the radios of the module, as listed by the driver.
+ *
+ * @return LE_BAD_PARAMETER Some parameter is invalid.
+ * @return LE_FAULT         The function failed.
+ * @return LE_OK            The function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t pa_wifiClient_GetInterfaces
+(
+    le_wifiClient_InterfaceInfo_t *interfacesPtr,
+        ///< [OUT]
+        ///< WiFi interfaces and their radio
+    size_t *numInterfacesPtr
+        ///< [INOUT]
+        ///< In: size of the interfaces array. Out: number of interfaces returned.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function gets a DHCP lease on the given interface, which must be associated.
+ * With PA_WIFICLIENT_DHCP_INIT_REBOOT and PA_WIFICLIENT_DHCP_RENEW, the lease given is requested
+ * again. On success, the lease is updated with the one granted by the server.
+ *
+ * @return LE_BAD_PARAMETER     Invalid parameter.
+ * @return LE_NOT_POSSIBLE      The server refused the lease (DHCPNAK).
+ * @return LE_TIMEOUT           No answer from a DHCP server.
+ * @return LE_FAULT             The function failed.
+ * @return LE_OK                The function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t pa_wifiClient_RequestLease
+(
+    const char *ifNamePtr,
+        ///< [IN]
+        ///< WLAN interface name
+    pa_wifiClient_DhcpRequest_t request,
+        ///< [IN]
+        ///< State from which the lease is requested
+    pa_wifiClient_DhcpLease_t *leasePtr
+        ///< [IN/OUT]
+        ///< Lease to request again, then lease granted
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function sets the address, default route and DNS server of a DHCP lease on the given
+ * interface.
+ *
+ * @return LE_BAD_PARAMETER     Invalid parameter.
+ * @return LE_FAULT             The function failed.
+ * @return LE_OK                The function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t pa_wifiClient_SetIpConfig
+(
+    const char *ifNamePtr,
+        ///< [IN]
+        ///< WLAN interface name
+    const pa_wifiClient_DhcpLease_t *leasePtr
+        ///< [IN]
+        ///< Lease granted by the DHCP server
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function removes the address and default route set by pa_wifiClient_SetIpConfig() from the
+ * given interface.
+ *
+ * @return LE_BAD_PARAMETER     Invalid parameter.
+ * @return LE_FAULT             The function failed.
+ * @return LE_OK                The function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t pa_wifiClient_ClearIpConfig
+(
+    const char *ifNamePtr
+        ///< [IN]
+        ///< WLAN interface name
+);
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Set the username and password (WPA-Entreprise).
@@ -305,6 +656,38 @@ LE_SHARED void pa_wifiClient_SetHiddenNetworkAttribute
         ///< If TRUE, the WIFI client will be able to connect to a hidden access point.
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function specifies whether IEEE 802.11r fast BSS transition (FT-PSK or FT-EAP key
+ * management) is to be negotiated with the target Access Point.
+ *
+ * @note By default, this attribute is not set. When enabled, plain WPA2-PSK or WPA2-EAP remains
+ * allowed so that the client can still connect to access points without 802.11r support.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED void pa_wifiClient_SetFastTransition
+(
+    bool enable
+        ///< [IN]
+        ///< If TRUE, fast BSS transition is negotiated with the access point.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function sets the access point preferred for the initial association with the next network
+ * configured, through the wpa_supplicant bssid_hint. Unlike a BSSID restriction, wpa_supplicant
+ * may still select or roam to another access point of the network.
+ *
+ * @note The hint applies to the next network only.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED void pa_wifiClient_SetBssidHint
+(
+    const char *bssidPtr
+        ///< [IN]
+        ///< BSSID of the preferred access point, NULL or empty for none.
+);
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Set the WEP key (WEP)
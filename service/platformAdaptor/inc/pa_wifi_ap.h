@@ -20,6 +20,34 @@
 #define PA_NOT_FOUND        50
 #define PA_NOT_POSSIBLE     100
 //--------------------------------------------------------------------------------------------------
+/**
+ * Default network interface of the access point.
+ */
+//--------------------------------------------------------------------------------------------------
+#define PA_WIFIAP_INTERFACE "wlan0"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Virtual network interface of the access point in concurrent mode, created on the radio of the
+ * station interface.
+ */
+//--------------------------------------------------------------------------------------------------
+#define PA_WIFIAP_CONCURRENT_INTERFACE "ap0"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of additional BSS sharing the radio of the access point
+ */
+//--------------------------------------------------------------------------------------------------
+#define PA_WIFIAP_MAX_BSS 3
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of stations with a rate limit
+ */
+//--------------------------------------------------------------------------------------------------
+#define PA_WIFIAP_MAX_RATE_LIMITS 16
+//--------------------------------------------------------------------------------------------------
 /**
  * Event handler for PA WiFi access point changes.
  *
@@ -56,6 +84,59 @@ LE_SHARED le_result_t pa_wifiAp_AddEventHandler
         ///< Associated event context
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Event handler for PA WiFi access point changes, with the MAC address of the station concerned.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef void (*pa_wifiAp_EventIndHandlerFunc_t)
+(
+    const le_wifiAp_EventInd_t *wifiEventPtr,
+        ///< [IN]
+        ///< WiFi event to process
+    void *contextPtr
+        ///< [IN]
+        ///< Associated WiFi event context
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add handler function for WiFi related events, with the MAC address of the station concerned.
+ *
+ * @return LE_BAD_PARAMETER Some parameter is invalid.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t pa_wifiAp_AddEventIndHandler
+(
+    pa_wifiAp_EventIndHandlerFunc_t handlerPtr,
+        ///< [IN]
+        ///< Event handler function pointer
+
+    void *contextPtr
+        ///< [IN]
+        ///< Associated event context
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the statistics of the stations associated with the access point, as dumped by the driver.
+ *
+ * @return LE_BAD_PARAMETER Some parameter is invalid.
+ * @return LE_FAULT         The function failed.
+ * @return LE_OK            The function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t pa_wifiAp_GetStations
+(
+    le_wifiAp_StationInfo_t *stationsPtr,
+        ///< [OUT]
+        ///< Statistics of the stations
+    size_t *numStationsPtr
+        ///< [INOUT]
+        ///< In: size of the stations array. Out: number of stations returned.
+);
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This function must be called to initialize the PA WiFi Access Point.
@@ -115,11 +196,13 @@ le_result_t pa_wifiAp_Stop
 //--------------------------------------------------------------------------------------------------
 /**
  * Set the security protocol to use.
+ * If the access point is started, the setting is applied at once without a restart.
  *
  * @note WEP is not supported as it is unsecure and has been deprecated in favor of WPA/WPA2.
  * This limitation applies to access point mode only.
  *
  * @return LE_BAD_PARAMETER Some parameter is invalid.
+ * @return LE_FAULT         The started access point could not be reconfigured.
  * @return LE_OK            Function succeeded.
  */
 //--------------------------------------------------------------------------------------------------
@@ -133,10 +216,12 @@ le_result_t pa_wifiAp_SetSecurityProtocol
 //--------------------------------------------------------------------------------------------------
 /**
  * Set the Service Set IDentification (SSID) of the access point.
+ * If the access point is started, the setting is applied at once without a restart.
  *
  * @note The SSID does not have to be human readable ASCII values, but often is.
  *
  * @return LE_BAD_PARAMETER Some parameter is invalid.
+ * @return LE_FAULT         The started access point could not be reconfigured.
  * @return LE_OK            Function succeeded.
  */
 //--------------------------------------------------------------------------------------------------
@@ -154,12 +239,14 @@ le_result_t pa_wifiAp_SetSsid
 //--------------------------------------------------------------------------------------------------
 /**
  * Set the passphrase used to generate the PSK.
+ * If the access point is started, the setting is applied at once without a restart.
  *
  * @note This is one way to authenticate against the access point. The other one is provided by the
  * le_wifiAp_SetPreSharedKey() function. Both ways are exclusive and are effective only when used
  * with WPA-personal authentication.
  *
  * @return LE_BAD_PARAMETER Parameter is invalid.
+ * @return LE_FAULT         The started access point could not be reconfigured.
  * @return LE_OK            Function succeeded.
  */
 //--------------------------------------------------------------------------------------------------
@@ -173,12 +260,14 @@ le_result_t pa_wifiAp_SetPassPhrase
 //--------------------------------------------------------------------------------------------------
 /**
  * Set the pre-shared key (PSK).
+ * If the access point is started, the setting is applied at once without a restart.
  *
  * @note This is one way to authenticate against the access point. The other one is provided by the
  * le_wifiAp_SetPassPhrase() function. Both ways are exclusive and are effective only when used
  * with WPA-personal authentication.
  *
  * @return LE_BAD_PARAMETER Parameter is invalid.
+ * @return LE_FAULT         The started access point could not be reconfigured.
  * @return LE_OK            Function succeeded.
  */
 //--------------------------------------------------------------------------------------------------
@@ -194,7 +283,9 @@ le_result_t pa_wifiAp_SetPreSharedKey
  * Set if the Access Point should announce it's presence.
  * Default value is TRUE.
  * If the value is set to FALSE, the access point will be hidden.
+ * If the access point is started, the setting is applied at once without a restart.
  *
+ * @return LE_FAULT         The started access point could not be reconfigured.
  * @return LE_OK            Function succeeded.
  *
  */
@@ -268,8 +359,11 @@ le_result_t pa_wifiAp_SetCountryCode
  * The channel number must be between 1 and 14 for IEEE 802.11b/g.
  * The channel number must be between 7 and 196 for IEEE 802.11a.
  * The channel number must be between 1 and 6 for IEEE 802.11ad.
+ * If the access point is started, the setting is applied at once without a restart.
+ * The automatic channel selection is disabled.
  * @return
  *      - LE_OUT_OF_RANGE if requested channel number is out of range.
+ *      - LE_FAULT if the started access point could not be reconfigured.
  *      - LE_OK if the function succeeded.
  *
  */
@@ -281,14 +375,200 @@ le_result_t pa_wifiAp_SetChannel
         ///< the channel number.
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Move the started access point to another channel without disconnecting the stations. The switch
+ * is announced in the given number of beacons (CSA), and LE_WIFIAP_EVENT_CHANNEL_SWITCHED is
+ * reported once it has occurred. The channel must be valid for the IEEE standard, as for
+ * pa_wifiAp_SetChannel(). The automatic channel selection is disabled.
+ *
+ * @return LE_OUT_OF_RANGE  The channel number is out of range, or the number of beacons is 0.
+ * @return LE_UNAVAILABLE   The access point is not started.
+ * @return LE_UNSUPPORTED   The driver does not support the channel switch: the channel is kept.
+ * @return LE_FAULT         The function failed.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_SwitchChannel
+(
+    uint16_t channelNumber,
+        ///< [IN]
+        ///< The channel number.
+    uint8_t beaconCount
+        ///< [IN]
+        ///< Number of beacons announcing the switch before it occurs.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Enable or disable the automatic channel selection. When enabled, the least loaded channel is
+ * selected from a scan and a survey of the channels before the access point starts. While started,
+ * the channel is re-evaluated periodically and switched live if the load of the current channel
+ * crosses the threshold.
+ *
+ * @return LE_BAD_PARAMETER Some parameter is invalid.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_SetAutoChannel
+(
+    bool isEnabled,
+        ///< [IN]
+        ///< Whether the channel is selected automatically.
+    uint32_t periodSec,
+        ///< [IN]
+        ///< Period in seconds of the re-evaluation while started, 0 to select on start only.
+    uint8_t loadThreshold
+        ///< [IN]
+        ///< Load in percent of the current channel above which another channel is selected.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the channel width. The 40 MHz width requires IEEE 802.11n, the 80 MHz width IEEE 802.11ac in
+ * the 5 GHz band: the width is narrowed on a channel or a hardware mode which does not allow it.
+ * If the access point is started, the setting is applied by a restart of hostapd.
+ *
+ * @return LE_BAD_PARAMETER Some parameter is invalid.
+ * @return LE_UNSUPPORTED   The radio does not support the width.
+ * @return LE_FAULT         The started access point could not be reconfigured.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_SetChannelWidth
+(
+    le_wifiAp_ChannelWidth_t width
+        ///< [IN]
+        ///< The channel width.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the optional HT/VHT capabilities of the access point and its number of spatial streams. The
+ * number of spatial streams takes effect on the next start of the access point.
+ * If the access point is started, the capabilities are applied by a restart of hostapd.
+ *
+ * @return LE_BAD_PARAMETER Some parameter is invalid.
+ * @return LE_UNSUPPORTED   The radio does not support a capability or the number of streams.
+ * @return LE_FAULT         The started access point could not be reconfigured.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_SetPhyCapabilities
+(
+    le_wifiAp_PhyCapBitMask_t capMask,
+        ///< [IN]
+        ///< The optional capabilities to enable.
+    uint8_t numSpatialStreams
+        ///< [IN]
+        ///< The number of spatial streams, 0 for all the streams of the radio.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the capabilities of the radio in the band of the hardware mode.
+ *
+ * @return LE_BAD_PARAMETER Some parameter is invalid.
+ * @return LE_UNAVAILABLE   The WiFi hardware is not started: the capabilities are unknown.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_GetPhyCapabilities
+(
+    le_wifiAp_ChannelWidth_t *maxWidthPtr,
+        ///< [OUT]
+        ///< The widest channel supported.
+    le_wifiAp_PhyCapBitMask_t *capMaskPtr,
+        ///< [OUT]
+        ///< The optional capabilities supported, in HT or in VHT.
+    uint8_t *numSpatialStreamsPtr
+        ///< [OUT]
+        ///< The number of spatial streams.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the tuning profile of the radio. The overridden tuning parameters are reset to the values of
+ * the profile.
+ * If the access point is started, the setting is applied by a restart of hostapd.
+ *
+ * @return LE_BAD_PARAMETER Some parameter is invalid.
+ * @return LE_FAULT         The started access point could not be reconfigured.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_SetProfile
+(
+    le_wifiAp_Profile_t profile
+        ///< [IN]
+        ///< The tuning profile.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Override a tuning parameter of the profile.
+ * If the access point is started, the setting is applied by a restart of hostapd.
+ *
+ * @return LE_BAD_PARAMETER Some parameter is invalid.
+ * @return LE_OUT_OF_RANGE  The value is out of the range of the parameter.
+ * @return LE_FAULT         The started access point could not be reconfigured.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_SetTuningParameter
+(
+    le_wifiAp_TuningParam_t param,
+        ///< [IN]
+        ///< The tuning parameter.
+    int32_t value
+        ///< [IN]
+        ///< The value of the parameter.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the value of a tuning parameter: its override, or else its value in the profile.
+ *
+ * @return LE_BAD_PARAMETER Some parameter is invalid.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_GetTuningParameter
+(
+    le_wifiAp_TuningParam_t param,
+        ///< [IN]
+        ///< The tuning parameter.
+    int32_t *valuePtr
+        ///< [OUT]
+        ///< The value of the parameter.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the channel of the access point, as set or as selected automatically.
+ *
+ * @return LE_BAD_PARAMETER Some parameter is invalid.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_GetChannel
+(
+    uint16_t *channelNumberPtr
+        ///< [OUT]
+        ///< The channel number.
+);
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Set the maximum number of clients connected to WiFi access point at the same time.
  * Default value is 10.
+ * If the access point is started, the setting is applied at once without a restart.
  *
- * @note This value depends on the hardware/software capabilities of the WiFi module used.
+ * @note This value depends on the hardware/software capabilities of the WiFi module used. They are
+ * discovered from the driver when the access point starts.
  *
  * @return LE_OUT_OF_RANGE  Requested number of users exceeds the capabilities of the Access Point.
+ * @return LE_FAULT         The started access point could not be reconfigured.
  * @return LE_OK            Function succeeded.
  *
  */
@@ -300,13 +580,32 @@ le_result_t pa_wifiAp_SetMaxNumberClients
         ///< the maximum number of clients regarding the WiFi driver and hardware capabilities.
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the maximum number of clients the driver supports in access point mode.
+ *
+ * @return LE_BAD_PARAMETER Some parameter is invalid.
+ * @return LE_UNAVAILABLE   The WiFi hardware is not started or the driver does not report the
+ *                          capability: the capability is unknown.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_GetMaxNumberClientsCapability
+(
+    uint32_t *maxNumberClientsPtr
+        ///< [OUT]
+        ///< The maximum number of clients supported by the driver.
+);
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Define the access point IP address and the client IP addresses range.
  *
- * @note The access point IP address must be defined outside the client IP addresses range.
+ * @note The access point IP address must be defined outside the client IP addresses range. The
+ * addresses are served by the DHCP server of the WiFi service.
  *
  * @return LE_BAD_PARAMETER At least, one of the given IP addresses is invalid.
+ * @return LE_NOT_PERMITTED The access point is bridged with its uplink.
  * @return LE_FAULT         A system call has failed.
  * @return LE_OK            Function succeeded.
  *
@@ -324,4 +623,467 @@ le_result_t pa_wifiAp_SetIpRange
         ///< [IN]
         ///< the stop IP address of the Access Point.
 );
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the uplink of the access point: the WiFi interface is either bridged at layer 2 with the
+ * uplink interface, or routed to it with NAT. Default is no uplink.
+ * If the access point is started, a NAT uplink is applied at once without a restart.
+ *
+ * @return LE_BAD_PARAMETER Some parameter is invalid, or the uplink interface does not exist.
+ * @return LE_BUSY          The access point is started and the bridge mode is set or requested.
+ * @return LE_FAULT         The uplink could not be set up.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_SetUplink
+(
+    le_wifiAp_UplinkMode_t mode,
+        ///< [IN]
+        ///< The uplink mode.
+    const char *ifNamePtr
+        ///< [IN]
+        ///< The uplink interface, ignored without uplink.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the uplink of the access point.
+ *
+ * @return LE_BAD_PARAMETER Some parameter is invalid.
+ * @return LE_OVERFLOW      The interface name does not fit in the buffer.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_GetUplink
+(
+    le_wifiAp_UplinkMode_t *modePtr,
+        ///< [OUT]
+        ///< The uplink mode.
+    char *ifNamePtr,
+        ///< [OUT]
+        ///< The uplink interface, empty without uplink.
+    size_t ifNameSize
+        ///< [IN]
+        ///< The size in bytes of the interface name buffer.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Enable or disable the fast path of the NAT uplink, which offloads the established flows to a
+ * flowtable. Default is disabled.
+ * If the access point is started with a NAT uplink, the setting is applied at once.
+ *
+ * @return LE_FAULT  The flowtable could not be installed: the flows stay on the netfilter path.
+ * @return LE_OK     Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_SetNatOffload
+(
+    bool enable
+        ///< [IN]
+        ///< True to offload the established flows.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the traffic statistics of the access point: byte counters of the WiFi interface, throughput
+ * since the previous call and number of flows offloaded to the fast path of the NAT uplink.
+ *
+ * @return LE_BAD_PARAMETER Some parameter is invalid.
+ * @return LE_FAULT         The function failed.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_GetUplinkStats
+(
+    le_wifiAp_UplinkStats_t *statsPtr
+        ///< [OUT]
+        ///< Statistics of the uplink.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create an additional BSS sharing the radio of the access point, with its own interface. It is
+ * started with the access point, once given an SSID. Its security is disabled and its client
+ * limit is the default one.
+ *
+ * @return LE_BAD_PARAMETER Some parameter is invalid.
+ * @return LE_BUSY          The access point is started.
+ * @return LE_NO_MEMORY     The maximum number of BSS is reached.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_CreateBss
+(
+    uint8_t *bssIndexPtr
+        ///< [OUT]
+        ///< Index of the BSS.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete an additional BSS of the access point.
+ *
+ * @return LE_BAD_PARAMETER Some parameter is invalid.
+ * @return LE_BUSY          The access point is started.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_DeleteBss
+(
+    uint8_t bssIndex
+        ///< [IN]
+        ///< Index of the BSS.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the network interface of an additional BSS of the access point.
+ *
+ * @return LE_BAD_PARAMETER Some parameter is invalid.
+ * @return LE_OVERFLOW      The interface name does not fit in the buffer.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_GetBssInterface
+(
+    uint8_t bssIndex,
+        ///< [IN]
+        ///< Index of the BSS.
+    char *ifNamePtr,
+        ///< [OUT]
+        ///< The network interface of the BSS.
+    size_t ifNameSize
+        ///< [IN]
+        ///< The size in bytes of the interface name buffer.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the SSID of an additional BSS of the access point.
+ * If the access point is started, the setting is applied at once: the BSS alone is reloaded,
+ * or the whole radio if hostapd cannot reload a single BSS.
+ *
+ * @return LE_BAD_PARAMETER Some parameter is invalid.
+ * @return LE_FAULT         The started access point could not be reconfigured.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_SetBssSsid
+(
+    uint8_t bssIndex,
+        ///< [IN]
+        ///< Index of the BSS.
+    const uint8_t *ssidPtr,
+        ///< [IN]
+        ///< The SSID to set as an octet array.
+    size_t ssidNumElements
+        ///< [IN]
+        ///< The length of the SSID in bytes.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the security protocol of an additional BSS of the access point.
+ * If the access point is started, the setting is applied at once: the BSS alone is reloaded,
+ * or the whole radio if hostapd cannot reload a single BSS.
+ *
+ * @return LE_BAD_PARAMETER Some parameter is invalid.
+ * @return LE_FAULT         The started access point could not be reconfigured.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_SetBssSecurityProtocol
+(
+    uint8_t bssIndex,
+        ///< [IN]
+        ///< Index of the BSS.
+    le_wifiAp_SecurityProtocol_t securityProtocol
+        ///< [IN]
+        ///< The security protocol used to communicate with the BSS.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the passphrase used to generate the PSK of an additional BSS of the access point.
+ * If the access point is started, the setting is applied at once: the BSS alone is reloaded,
+ * or the whole radio if hostapd cannot reload a single BSS.
+ *
+ * @return LE_BAD_PARAMETER Some parameter is invalid.
+ * @return LE_FAULT         The started access point could not be reconfigured.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_SetBssPassPhrase
+(
+    uint8_t bssIndex,
+        ///< [IN]
+        ///< Index of the BSS.
+    const char *passphrasePtr
+        ///< [IN]
+        ///< Passphrase to authenticate against the BSS.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the pre-shared key (PSK) of an additional BSS of the access point.
+ * If the access point is started, the setting is applied at once: the BSS alone is reloaded,
+ * or the whole radio if hostapd cannot reload a single BSS.
+ *
+ * @return LE_BAD_PARAMETER Some parameter is invalid.
+ * @return LE_FAULT         The started access point could not be reconfigured.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_SetBssPreSharedKey
+(
+    uint8_t bssIndex,
+        ///< [IN]
+        ///< Index of the BSS.
+    const char *preSharedKeyPtr
+        ///< [IN]
+        ///< Pre-shared key used to authenticate against the BSS.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the maximum number of clients connected to an additional BSS of the access point at the
+ * same time. Default value is 10.
+ * If the access point is started, the setting is applied at once: the BSS alone is reloaded,
+ * or the whole radio if hostapd cannot reload a single BSS.
+ *
+ * @return LE_BAD_PARAMETER Some parameter is invalid.
+ * @return LE_OUT_OF_RANGE  Requested number of users exceeds the capabilities of the Access Point.
+ * @return LE_FAULT         The started access point could not be reconfigured.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_SetBssMaxNumberClients
+(
+    uint8_t bssIndex,
+        ///< [IN]
+        ///< Index of the BSS.
+    int maxNumberClients
+        ///< [IN]
+        ///< The maximum number of clients of the BSS.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Define the IP address of an additional BSS of the access point and its client IP addresses
+ * range. The BSS interface exists only while the access point is started.
+ *
+ * @return LE_BAD_PARAMETER At least, one of the given IP addresses is invalid.
+ * @return LE_NOT_PERMITTED The access point is bridged with its uplink.
+ * @return LE_FAULT         A system call has failed.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_SetBssIpRange
+(
+    uint8_t bssIndex,
+        ///< [IN]
+        ///< Index of the BSS.
+    const char *ipApPtr,
+        ///< [IN]
+        ///< the IP address of the BSS.
+    const char *ipStartPtr,
+        ///< [IN]
+        ///< the start IP address of the BSS clients.
+    const char *ipStopPtr
+        ///< [IN]
+        ///< the stop IP address of the BSS clients.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the concurrent mode of the access point: it runs on a virtual interface next to the station
+ * interface of the WiFi client, on the channel of the station if connected. Default is disabled.
+ *
+ * @return LE_BUSY          The access point is started.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_SetConcurrentMode
+(
+    bool isConcurrent
+        ///< [IN]
+        ///< True to run the access point concurrently with the station.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the network interface of the access point, depending on the concurrent mode.
+ *
+ * @return LE_OVERFLOW      The interface name is too long for the buffer.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_GetInterface
+(
+    char *ifNamePtr,
+        ///< [OUT]
+        ///< The network interface of the access point.
+    size_t ifNameSize
+        ///< [IN]
+        ///< Size of the interface name buffer.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Select the network interface of the radio of the access point, for a module with several radios.
+ * In concurrent mode, it must be the station interface of the WiFi client. Default is
+ * PA_WIFIAP_INTERFACE.
+ *
+ * @return LE_BAD_PARAMETER The interface name is empty, too long for the names of the additional
+ *                          BSS, or has invalid characters.
+ * @return LE_BUSY          The access point is started.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_SetInterface
+(
+    const char *ifNamePtr
+        ///< [IN]
+        ///< Network interface of the radio of the access point.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Limit the rates of a station of the access point, whether associated or not. The downlink is
+ * shaped in queues of its own, one per WMM access category each limited to the rate, and the
+ * excess of the uplink is dropped. A rate of 0 does not limit the direction, and both at 0 remove
+ * the limits of the station.
+ * If the access point is started, the limits are applied at once.
+ *
+ * @return LE_BAD_PARAMETER The MAC address is invalid.
+ * @return LE_NO_MEMORY     PA_WIFIAP_MAX_RATE_LIMITS stations are already limited.
+ * @return LE_FAULT         The limits could not be applied to the started access point.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_SetStationRateLimit
+(
+    const char *macAddrPtr,
+        ///< [IN]
+        ///< MAC address of the station.
+    uint32_t downlinkKbps,
+        ///< [IN]
+        ///< Rate to the station in kbit/s, 0 for no limit.
+    uint32_t uplinkKbps
+        ///< [IN]
+        ///< Rate from the station in kbit/s, 0 for no limit.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the rate limits of a station and the counters of its shaping: the downlink packets dropped
+ * and queued by its queue, and the uplink packets dropped. The counters are 0 while the access
+ * point is stopped.
+ *
+ * @return LE_BAD_PARAMETER Some parameter is invalid.
+ * @return LE_NOT_FOUND     The station has no rate limit.
+ * @return LE_FAULT         The counters could not be read.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_GetStationShapingStats
+(
+    const char *macAddrPtr,
+        ///< [IN]
+        ///< MAC address of the station.
+    le_wifiAp_StationShapingStats_t *statsPtr
+        ///< [OUT]
+        ///< Rate limits and shaping counters of the station.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Enable or disable the airtime fairness scheduling of the driver: the stations get an equal share
+ * of the airtime whatever their rate, so that a slow or busy station does not starve the others.
+ * Default is disabled. If the access point is started, the setting is applied at once.
+ *
+ * @return LE_UNSUPPORTED   The driver does not schedule the airtime fairly.
+ * @return LE_FAULT         The setting could not be applied to the started access point.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_SetAirtimeFairness
+(
+    bool enable
+        ///< [IN]
+        ///< True to share the airtime fairly between the stations.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the time after which a station which sends nothing is disconnected by hostapd, freeing its
+ * slot. Default is 300 seconds. If the access point is started, the setting is applied at once.
+ *
+ * @return LE_OUT_OF_RANGE  The timeout is 0.
+ * @return LE_FAULT         The started access point could not be reconfigured.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_SetInactivityTimeout
+(
+    uint32_t timeoutSec
+        ///< [IN]
+        ///< Inactivity timeout in seconds.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Enable or disable the eviction of the most idle station when a new one associates to the full
+ * access point. Default is disabled: the new stations are refused.
+ * If the access point is started, the setting is applied at once.
+ *
+ * @return LE_FAULT         The started access point could not be reconfigured.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_SetEvictIdleWhenFull
+(
+    bool enable
+        ///< [IN]
+        ///< True to evict the most idle station for a new one.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the signal strength under which the association of a station is rejected, so that slow and
+ * distant stations do not lower the rate of the others. 0 accepts all the stations, as by default.
+ * If the access point is started, the setting is applied at once.
+ *
+ * @return LE_OUT_OF_RANGE  The signal strength is not between -100 and -1 dBm, or 0.
+ * @return LE_FAULT         The started access point could not be reconfigured.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_SetMinAssocRssi
+(
+    int16_t rssi
+        ///< [IN]
+        ///< Signal strength in dBm, 0 for no minimum.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Apply the admission policy once a station has associated: above the maximum number of clients,
+ * the most idle station is disconnected if it has been idle long enough, else the new one is.
+ * It must be called from the thread which started the access point, which owns the control
+ * interface of hostapd.
+ *
+ * @return LE_BAD_PARAMETER The MAC address is invalid.
+ * @return LE_FAULT         The stations could not be dumped or disconnected.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_AdmitStation
+(
+    const char *macAddrPtr
+        ///< [IN]
+        ///< MAC address of the station which has associated.
+);
 #endif // PA_WIFI_AP_H
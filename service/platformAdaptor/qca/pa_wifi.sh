@@ -2,6 +2,7 @@
 # Copyright (C) Sierra Wireless Inc.
 #
 # ($1:) -d Debug logs
+# ($1 $2:) -i <interface> WiFi interface (default wlan0)
 # $1: Command (ex:  WIFI_START
 #                   WIFICLIENT_CONNECT
 # $2: wpa_supplicant.conf file directory
@@ -11,9 +12,29 @@ if [ "$1" = "-d" ]; then
     set -x
 fi
 
+if [ "$1" = "-i" ]; then
+    WIFI_IFACE=$2
+    shift 2
+fi
+
 CMD=$1
 # WiFi interface
-IFACE=wlan0
+IFACE=${WIFI_IFACE:-wlan0}
+# Virtual interface of the WiFi access point running concurrently with the station on IFACE
+AP_VIFACE=ap0
+# Interface of the WiFi access point: the virtual one when created, else the WiFi interface
+if [ -e /sys/class/net/${AP_VIFACE} ]; then
+    AP_IFACE=${AP_VIFACE}
+else
+    AP_IFACE=${IFACE}
+fi
+# Markers of the users of the WiFi driver, AP and CLIENT, which may run concurrently on one radio
+# or on distinct radios
+RADIO_USERS=/tmp/wifi_radio_
+# Bridge of the WiFi access point with its uplink interface
+BRIDGE=br-wlan
+# nftables table of the NAT fast path of the WiFi access point
+NFT_TABLE=wifiap
 # If WLAN interface does not exist but driver is installed, means WiFi hardware is absent
 HARDWAREABSENCE=50
 # QCA wifi module name
@@ -29,7 +50,7 @@ ERROR=127
 export PATH=/legato/systems/current/bin:/usr/local/bin:/usr/bin:/bin:/usr/local/sbin:/usr/sbin:/sbin
 
 # Check the connection on the WiFi network interface.
-# Exit with 0 if connected otherwise exit with 8 (time out)
+# Exit with 0 if connected and authorized otherwise exit with 8 (time out)
 CheckConnection()
 {
     retries=10
@@ -45,14 +66,63 @@ CheckConnection()
         # Connection request time out.
         exit ${TIMEOUT}
     fi
-    # Connected.
-    exit ${SUCCESS}
+    # Associated. Report when the 4-way handshake or EAP completes, polled every 100ms
+    for j in $(seq 1 50)
+    do
+        if /sbin/wpa_cli -i${IFACE} status | grep -q "wpa_state=COMPLETED"; then
+            echo "Authorized"
+            # Connected.
+            exit ${SUCCESS}
+        fi
+        usleep 100000
+    done
+    # Associated but never authorized: the handshake or EAP exchange timed out.
+    exit ${TIMEOUT}
+}
+
+# Check the reassociation with the given BSSID on the WiFi network interface.
+# Exit with 0 if associated otherwise exit with 8 (time out)
+CheckRoam()
+{
+    retries=100
+    echo "Checking reassociation..."
+    # Poll every 20ms: a fast BSS transition completes in a few tens of ms
+    for i in $(seq 1 ${retries})
+    do
+        (/usr/sbin/iw ${IFACE} link | grep -i "Connected to $1") && exit ${SUCCESS}
+        usleep 20000
+    done
+    # Reassociation request time out.
+    exit ${TIMEOUT}
+}
+
+# Mark the user of the radio given in $1 (AP or CLIENT), if any
+MarkRadioUser()
+{
+    [ -z "$1" ] || touch ${RADIO_USERS}$1
+}
+
+# Tell whether the radio is used by another user than the one given in $1
+IsRadioShared()
+{
+    for USER_FILE in ${RADIO_USERS}*
+    do
+        [ -e "${USER_FILE}" ] && [ "${USER_FILE}" != "${RADIO_USERS}$1" ] && return 0
+    done
+    return 1
 }
 
 echo "${CMD}"
 case ${CMD} in
     WIFI_START)
         retries=10
+        # $2: User of the radio, AP or CLIENT
+        RADIO_USER=$2
+        # The radio is already started by its other user
+        if IsRadioShared ${RADIO_USER} && [ -e /sys/class/net/${IFACE} ]; then
+            MarkRadioUser ${RADIO_USER}
+            exit ${SUCCESS}
+        fi
         # Do clean up, even just after reboot
         /usr/bin/qca9377 wifi client stop > /dev/null 2>&1
         sleep 1
@@ -66,6 +136,7 @@ case ${CMD} in
         done
         if [ "${i}" -ne "${retries}" ]; then
             /sbin/ifconfig ${IFACE} up
+            MarkRadioUser ${RADIO_USER}
             exit ${SUCCESS}
         fi
         moduleString=$(/sbin/lsmod | grep ${QCAWIFIMOD}) > /dev/null
@@ -79,18 +150,41 @@ case ${CMD} in
         exit ${ret} ;;
 
   WIFI_STOP)
+    # $2: User of the radio, AP or CLIENT
+    RADIO_USER=$2
     # If wpa_supplicant is still running, terminate it
-    (/bin/ps -ax | grep wpa_supplicant | grep ${IFACE} >/dev/null 2>&1) \
-    && /sbin/wpa_cli -i${IFACE} terminate
+    [ "${RADIO_USER}" = "AP" ] || \
+    ((/bin/ps -ax | grep wpa_supplicant | grep ${IFACE} >/dev/null 2>&1) \
+    && /sbin/wpa_cli -i${IFACE} terminate)
+    [ -z "${RADIO_USER}" ] || rm -f ${RADIO_USERS}${RADIO_USER}
+    # The radio is still used by its other user
+    IsRadioShared ${RADIO_USER} && exit ${SUCCESS}
     # Unmount the WiFi network interface
     /usr/bin/qca9377 wifi client stop > /dev/null 2>&1 || exit ${ERROR}
+    rm -f ${RADIO_USERS}*
     ;;
 
   WIFI_SET_EVENT)
+    # $2: User of the events, AP or CLIENT, to stop them apart from the ones of the other user
+    if [ -n "$2" ]; then
+        echo $$ > /tmp/wifi_event_$2.pid
+        exec /usr/sbin/iw event
+    fi
     /usr/sbin/iw event || exit ${ERROR}
     ;;
 
+  WIFI_GET_INTERFACES)
+    # WiFi interfaces of all the radios, listed by radio
+    /usr/sbin/iw dev || exit ${ERROR}
+    ;;
+
   WIFI_UNSET_EVENT)
+    if [ -n "$2" ]; then
+        [ -f /tmp/wifi_event_$2.pid ] || exit ${SUCCESS}
+        /bin/kill -9 "$(cat /tmp/wifi_event_$2.pid)"
+        rm -f /tmp/wifi_event_$2.pid
+        exit ${SUCCESS}
+    fi
     count=$(/usr/bin/pgrep -c iw)
     [ "${count}" -eq 0 ] && exit ${SUCCESS}
     for i in $(seq 1 "${count}")
@@ -115,39 +209,77 @@ case ${CMD} in
     exit ${NODRIVER} ;;
 
   WIFIAP_HOSTAPD_START)
-    (/bin/hostapd /tmp/hostapd.conf -i${IFACE} -B) && exit ${SUCCESS}
-    # Fail to start hostapd, do cleanup
-    /usr/bin/qca9377 wifi client stop
+    (/bin/hostapd /tmp/hostapd.conf -i${AP_IFACE} -B) && exit ${SUCCESS}
+    # Fail to start hostapd, do cleanup unless the station uses the radio
+    rm -f ${RADIO_USERS}AP
+    IsRadioShared AP || /usr/bin/qca9377 wifi client stop
     exit ${ERROR} ;;
 
   WIFIAP_HOSTAPD_STOP)
-    rm -f /tmp/dnsmasq.wlan.conf
-    touch /tmp/dnsmasq.wlan.conf
-    /etc/init.d/dnsmasq stop
     killall hostapd
     sleep 1;
     pidof hostapd && (kill -9 "$(pidof hostapd)" || exit ${ERROR})
-    pidof dnsmasq && (kill -9 "$(pidof dnsmasq)" || exit ${ERROR})
-    /etc/init.d/dnsmasq start || exit ${ERROR}
     ;;
 
   WIFIAP_WLAN_UP)
     AP_IP=$2
-    /sbin/ifconfig | grep ${IFACE} || exit ${ERROR}
-    /sbin/ifconfig ${IFACE} "${AP_IP}" up || exit ${ERROR}
+    # Interface of an additional BSS, the main one by default
+    AP_IFACE=${3:-${AP_IFACE}}
+    /sbin/ifconfig | grep ${AP_IFACE} || exit ${ERROR}
+    /sbin/ifconfig ${AP_IFACE} "${AP_IP}" up || exit ${ERROR}
+    ;;
+
+  WIFIAP_GET_STATIONS)
+    /usr/sbin/iw dev ${AP_IFACE} station dump || exit ${ERROR}
+    ;;
+
+  WIFIAP_GET_PHY_INFO)
+    /usr/sbin/iw phy $(cat /sys/class/net/${IFACE}/phy80211/name) info || exit ${ERROR}
+    ;;
+
+  WIFIAP_CHANNEL_SURVEY)
+    /sbin/ifconfig ${IFACE} up || exit ${ERROR}
+    # The scan refreshes the survey of the channels other than the current one
+    /usr/sbin/iw dev ${IFACE} scan ap-force | grep '^BSS\|freq:'
+    /usr/sbin/iw dev ${IFACE} survey dump || exit ${ERROR}
     ;;
 
-  DNSMASQ_RESTART)
-    echo "interface=${IFACE}" >> /tmp/dnsmasq.wlan.conf
-    /etc/init.d/dnsmasq stop
-    pkill -9 dnsmasq
-    /etc/init.d/dnsmasq start || exit ${ERROR}
+  WIFIAP_SET_ANTENNA)
+    ANTENNA_MASK=$2
+    /sbin/ifconfig ${IFACE} down
+    /usr/sbin/iw phy $(cat /sys/class/net/${IFACE}/phy80211/name) set antenna ${ANTENNA_MASK} || exit ${ERROR}
+    ;;
+
+  WIFIAP_VIF_ADD)
+    [ -e /sys/class/net/${AP_VIFACE} ] && exit ${SUCCESS}
+    # Virtual interface of the access point on the radio of the station, with a locally
+    # administered MAC address derived from the one of the station
+    MAC=$(cat /sys/class/net/${IFACE}/address)
+    /usr/sbin/iw dev ${IFACE} interface add ${AP_VIFACE} type __ap || exit ${ERROR}
+    /sbin/ip link set ${AP_VIFACE} address "02:${MAC#*:}" || exit ${ERROR}
+    ;;
+
+  WIFIAP_VIF_DEL)
+    [ -e /sys/class/net/${AP_VIFACE} ] || exit ${SUCCESS}
+    /usr/sbin/iw dev ${AP_VIFACE} del || exit ${ERROR}
+    ;;
+
+  WIFIAP_GET_STA_FREQUENCY)
+    # Frequency of the station, if connected, which the concurrent access point must share
+    /usr/sbin/iw dev ${IFACE} link | grep 'freq:'
     ;;
 
   WIFICLIENT_START_SCAN)
     (/usr/sbin/iw dev ${IFACE} scan | grep 'BSS\|SSID\|signal') || exit ${ERROR}
     ;;
 
+  WIFICLIENT_START_SCAN_SSID)
+    SSID=$2
+    [ -n "${SSID}" ] || exit ${ERROR}
+    # Probe the given SSID only
+    (/usr/sbin/iw dev ${IFACE} scan ssid "${SSID}" | grep 'BSS\|SSID\|signal') || exit ${ERROR}
+    ;;
+
   WIFICLIENT_CONNECT)
     WPA_CFG=$2
     [ -f "${WPA_CFG}" ] || exit ${ERROR}
@@ -161,13 +293,186 @@ case ${CMD} in
     echo "WiFi client disconnected."
     ;;
 
+  WIFICLIENT_ROAM)
+    BSSID=$2
+    [ -n "${BSSID}" ] || exit ${ERROR}
+    /sbin/wpa_cli -i${IFACE} roam "${BSSID}" | grep OK || exit ${ERROR}
+    CheckRoam "${BSSID}" ;;
+
+  WIFICLIENT_GET_LINK_SIGNAL)
+    /usr/sbin/iw dev ${IFACE} link || exit ${ERROR}
+    ;;
+
+  WIFICLIENT_GET_STATION_INFO)
+    /usr/sbin/iw dev ${IFACE} station dump || exit ${ERROR}
+    ;;
+
+  WIFICLIENT_SET_CQM)
+    # $2: RSSI threshold in dBm or "off", $3: hysteresis in dB
+    [ -n "$2" ] || exit ${ERROR}
+    /usr/sbin/iw dev ${IFACE} cqm rssi $2 $3 || exit ${ERROR}
+    ;;
+
+  WIFICLIENT_SET_IP)
+    # $2: interface, $3: address, $4: netmask, $5: gateway, $6: DNS server
+    [ -n "$3" ] || exit ${ERROR}
+    /sbin/ifconfig $2 $3 netmask $4 up || exit ${ERROR}
+    if [ "$5" != "0.0.0.0" ]; then
+        while /sbin/route del default dev $2 2>/dev/null; do :; done
+        /sbin/route add default gw $5 dev $2 || exit ${ERROR}
+    fi
+    [ "$6" = "0.0.0.0" ] || echo "nameserver $6" > /etc/resolv.conf
+    ;;
+
+  WIFICLIENT_CLEAR_IP)
+    # $2: interface
+    [ -n "$2" ] || exit ${ERROR}
+    while /sbin/route del default dev $2 2>/dev/null; do :; done
+    /sbin/ifconfig $2 0.0.0.0 || exit ${ERROR}
+    ;;
+
+  WIFIAP_BRIDGE_START)
+    UPLINK=$2
+    [ -n "${UPLINK}" ] || exit ${ERROR}
+    # hostapd adds the WiFi interface to the bridge set in hostapd.conf
+    /sbin/ip link show ${BRIDGE} > /dev/null 2>&1 || \
+     /sbin/ip link add name ${BRIDGE} type bridge || exit ${ERROR}
+    /sbin/ip link set ${UPLINK} master ${BRIDGE} || exit ${ERROR}
+    /sbin/ip link set ${UPLINK} up || exit ${ERROR}
+    /sbin/ip link set ${BRIDGE} up || exit ${ERROR}
+    ;;
+
+  WIFIAP_BRIDGE_STOP)
+    UPLINK=$2
+    [ -n "${UPLINK}" ] && /sbin/ip link set ${UPLINK} nomaster
+    /sbin/ip link del ${BRIDGE} || exit ${ERROR}
+    ;;
+
+  WIFIAP_NAT_START)
+    UPLINK=$2
+    [ -n "${UPLINK}" ] || exit ${ERROR}
+    echo 1 > /proc/sys/net/ipv4/ip_forward || exit ${ERROR}
+    /usr/sbin/iptables -t nat -I POSTROUTING -o ${UPLINK} -j MASQUERADE || exit ${ERROR}
+    /usr/sbin/iptables -I FORWARD -i ${UPLINK} -o ${AP_IFACE}+ -m state \
+     --state RELATED,ESTABLISHED -j ACCEPT || exit ${ERROR}
+    /usr/sbin/iptables -I FORWARD -i ${AP_IFACE}+ -o ${UPLINK} -j ACCEPT || exit ${ERROR}
+    ;;
+
+  WIFIAP_NAT_STOP)
+    UPLINK=$2
+    [ -n "${UPLINK}" ] || exit ${ERROR}
+    /usr/sbin/iptables -t nat -D POSTROUTING -o ${UPLINK} -j MASQUERADE || exit ${ERROR}
+    /usr/sbin/iptables -D FORWARD -i ${UPLINK} -o ${AP_IFACE}+ -m state \
+     --state RELATED,ESTABLISHED -j ACCEPT || exit ${ERROR}
+    /usr/sbin/iptables -D FORWARD -i ${AP_IFACE}+ -o ${UPLINK} -j ACCEPT || exit ${ERROR}
+    ;;
+
+  WIFIAP_NAT_OFFLOAD_START)
+    UPLINK=$2
+    [ -n "${UPLINK}" ] || exit ${ERROR}
+    # Established flows bypass the netfilter hooks, NAT included, through the flowtable
+    /usr/sbin/nft add table inet ${NFT_TABLE} || exit ${ERROR}
+    /usr/sbin/nft add flowtable inet ${NFT_TABLE} ft \
+     "{ hook ingress priority 0; devices = { ${AP_IFACE}, ${UPLINK} }; }" || exit ${ERROR}
+    /usr/sbin/nft add chain inet ${NFT_TABLE} forward \
+     "{ type filter hook forward priority 0; policy accept; }" || exit ${ERROR}
+    /usr/sbin/nft add rule inet ${NFT_TABLE} forward \
+     meta l4proto { tcp, udp } flow add @ft || exit ${ERROR}
+    ;;
+
+  WIFIAP_NAT_OFFLOAD_STOP)
+    /usr/sbin/nft delete table inet ${NFT_TABLE} || exit ${ERROR}
+    ;;
+
+  WIFIAP_NAT_STATS)
+    echo "rx bytes: $(cat /sys/class/net/${AP_IFACE}/statistics/rx_bytes)"
+    echo "tx bytes: $(cat /sys/class/net/${AP_IFACE}/statistics/tx_bytes)"
+    echo "offloaded flows: $(grep -c OFFLOAD /proc/net/nf_conntrack 2> /dev/null)"
+    ;;
+
+  WIFIAP_SHAPING_START)
+    # The mq root keeps the queue of each access category (WMM). An HTB without default class is
+    # attached to each queue: the stations without a rate limit are not shaped
+    /sbin/tc qdisc replace dev ${AP_IFACE} root handle 1: mq || exit ${ERROR}
+    for AC in $(seq 1 $(ls -d /sys/class/net/${AP_IFACE}/queues/tx-* | wc -l))
+    do
+        /sbin/tc qdisc replace dev ${AP_IFACE} parent 1:${AC} handle 1${AC}: htb || exit ${ERROR}
+    done
+    /sbin/tc qdisc replace dev ${AP_IFACE} handle ffff: ingress || exit ${ERROR}
+    ;;
+
+  WIFIAP_SHAPING_STOP)
+    /sbin/tc qdisc del dev ${AP_IFACE} root
+    /sbin/tc qdisc del dev ${AP_IFACE} ingress
+    ;;
+
+  WIFIAP_SET_STA_RATE)
+    # $2: Slot of the station from 1, $3: MAC address of the station,
+    # $4: Downlink and $5: uplink rates in kbit/s, 0 for no limit
+    SLOT=$2
+    MINOR=$(printf '%x' ${SLOT})
+    # Remove the previous limits of the slot
+    /sbin/tc filter del dev ${AP_IFACE} parent ffff: prio ${SLOT} 2> /dev/null
+    # The downlink is shaped in the HTB of each access category, each one up to the rate
+    for AC in $(seq 1 $(ls -d /sys/class/net/${AP_IFACE}/queues/tx-* | wc -l))
+    do
+        /sbin/tc filter del dev ${AP_IFACE} parent 1${AC}: prio ${SLOT} 2> /dev/null
+        /sbin/tc class del dev ${AP_IFACE} classid 1${AC}:${MINOR} 2> /dev/null
+        if [ "$4" -ne 0 ]; then
+            /sbin/tc class add dev ${AP_IFACE} parent 1${AC}: classid 1${AC}:${MINOR} htb \
+             rate $4kbit ceil $4kbit || exit ${ERROR}
+            /sbin/tc filter add dev ${AP_IFACE} parent 1${AC}: protocol all prio ${SLOT} \
+             u32 match ether dst $3 flowid 1${AC}:${MINOR} || exit ${ERROR}
+        fi
+    done
+    if [ "$5" -ne 0 ]; then
+        # Burst of 100 ms of traffic, at least 16 kB
+        BURST=$(( $5 * 100 / 8 ))
+        [ ${BURST} -lt 16000 ] && BURST=16000
+        /sbin/tc filter add dev ${AP_IFACE} parent ffff: protocol all prio ${SLOT} \
+         u32 match ether src $3 police rate $5kbit burst ${BURST} drop flowid :1 || exit ${ERROR}
+    fi
+    ;;
+
+  WIFIAP_GET_STA_SHAPING_STATS)
+    # $2: Slot of the station from 1
+    SLOT=$2
+    # "Sent 0 bytes 0 pkt (dropped 0, overlimits 0 requeues 0)", "backlog 0b 0p requeues 0",
+    # the sizes being possibly given in Kb or Mb, summed over the classes of the access categories
+    for AC in $(seq 1 $(ls -d /sys/class/net/${AP_IFACE}/queues/tx-* | wc -l))
+    do
+        /sbin/tc -s class show dev ${AP_IFACE} classid 1${AC}:$(printf '%x' ${SLOT})
+    done | awk '
+        / Sent / { dropped += $7 }
+        / backlog / { size = $2; unit = 1;
+                      if (size ~ /Kb$/) unit = 1024; if (size ~ /Mb$/) unit = 1048576;
+                      bytes += (size + 0) * unit; packets += $3 }
+        END { print "tx dropped: " dropped + 0;
+              printf "tx backlog: %d %d\n", bytes, packets }' || exit ${ERROR}
+    /sbin/tc -s filter show dev ${AP_IFACE} parent ffff: prio ${SLOT} | awk '
+        / Sent / { print "rx dropped: " $7 + 0 }' || exit ${ERROR}
+    ;;
+
+  WIFIAP_SET_AIRTIME_FAIRNESS)
+    # $2: 1 to share the airtime fairly between the stations, for transmission and reception
+    FLAGS=/sys/kernel/debug/ieee80211/$(cat /sys/class/net/${IFACE}/phy80211/name)/airtime_flags
+    [ -w ${FLAGS} ] || exit ${ERROR}
+    if [ "$2" = "1" ]; then
+        echo 3 > ${FLAGS} || exit ${ERROR}
+    else
+        echo 0 > ${FLAGS} || exit ${ERROR}
+    fi
+    ;;
+
   IPTABLE_DHCP_INSERT)
-    /usr/sbin/iptables -I INPUT -i ${IFACE} -p udp -m udp \
+    DHCP_IFACE=${2:-${AP_IFACE}}
+    /usr/sbin/iptables -I INPUT -i ${DHCP_IFACE} -p udp -m udp \
      --sport 67:68 --dport 67:68 -j ACCEPT  || exit ${ERROR}
     ;;
 
   IPTABLE_DHCP_DELETE)
-    /usr/sbin/iptables -D INPUT -i ${IFACE} -p udp -m udp \
+    DHCP_IFACE=${2:-${AP_IFACE}}
+    /usr/sbin/iptables -D INPUT -i ${DHCP_IFACE} -p udp -m udp \
      --sport 67:68 --dport 67:68 -j ACCEPT  || exit ${ERROR}
     ;;
 
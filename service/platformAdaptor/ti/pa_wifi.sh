@@ -2,6 +2,7 @@
 # Copyright (C) Sierra Wireless Inc.
 #
 # ($1:) -d Debug logs
+# ($1 $2:) -i <interface> WiFi interface (default wlan0)
 # $1: Command (ex:  WIFI_START
 #                   WIFICLIENT_CONNECT
 # $2: wpa_supplicant.conf file directory
@@ -11,9 +12,29 @@ if [ "$1" = "-d" ]; then
     set -x
 fi
 
+if [ "$1" = "-i" ]; then
+    WIFI_IFACE=$2
+    shift 2
+fi
+
 CMD=$1
 # WiFi interface
-IFACE=wlan0
+IFACE=${WIFI_IFACE:-wlan0}
+# Virtual interface of the WiFi access point running concurrently with the station on IFACE
+AP_VIFACE=ap0
+# Interface of the WiFi access point: the virtual one when created, else the WiFi interface
+if [ -e /sys/class/net/${AP_VIFACE} ]; then
+    AP_IFACE=${AP_VIFACE}
+else
+    AP_IFACE=${IFACE}
+fi
+# Markers of the users of the WiFi driver, AP and CLIENT, which may run concurrently on one radio
+# or on distinct radios
+RADIO_USERS=/tmp/wifi_radio_
+# Bridge of the WiFi access point with its uplink interface
+BRIDGE=br-wlan
+# nftables table of the NAT fast path of the WiFi access point
+NFT_TABLE=wifiap
 # If WLAN interface exists but can not be brought up, means WiFi hardware is inserted,
 # drivers are loaded successfully, but firmware failed to boot, tiwifi.sh returns 100
 FIRMWAREFAILURE=100
@@ -26,7 +47,7 @@ TIMEOUT=8
 export PATH=/legato/systems/current/bin:/usr/local/bin:/usr/bin:/bin:/usr/local/sbin:/usr/sbin:/sbin
 
 # Check the connection on the WiFi network interface.
-# Exit with 0 if connected otherwise exit with 8 (time out)
+# Exit with 0 if connected and authorized otherwise exit with 8 (time out)
 CheckConnection()
 {
     local retries=10
@@ -42,8 +63,50 @@ CheckConnection()
         # Connection request time out.
         exit ${TIMEOUT}
     fi
-    # Connected.
-    exit 0
+    # Associated. Report when the 4-way handshake or EAP completes, polled every 100ms
+    for j in $(seq 1 50)
+    do
+        if /sbin/wpa_cli -i$1 status | grep -q "wpa_state=COMPLETED"; then
+            echo "Authorized"
+            # Connected.
+            exit 0
+        fi
+        usleep 100000
+    done
+    # Associated but never authorized: the handshake or EAP exchange timed out.
+    exit ${TIMEOUT}
+}
+
+# Check the reassociation with the given BSSID on the WiFi network interface.
+# Exit with 0 if associated otherwise exit with 8 (time out)
+CheckRoam()
+{
+    local retries=100
+    echo "Checking reassociation..."
+    # Poll every 20ms: a fast BSS transition completes in a few tens of ms
+    for i in $(seq 1 ${retries})
+    do
+        (/usr/sbin/iw $1 link | grep -i "Connected to $2") && exit 0
+        usleep 20000
+    done
+    # Reassociation request time out.
+    exit ${TIMEOUT}
+}
+
+# Mark the user of the radio given in $1 (AP or CLIENT), if any
+MarkRadioUser()
+{
+    [ -z "$1" ] || touch ${RADIO_USERS}$1
+}
+
+# Tell whether the radio is used by another user than the one given in $1
+IsRadioShared()
+{
+    for USER_FILE in ${RADIO_USERS}*
+    do
+        [ -e "${USER_FILE}" ] && [ "${USER_FILE}" != "${RADIO_USERS}$1" ] && return 0
+    done
+    return 1
 }
 
 WiFiReset()
@@ -55,7 +118,7 @@ WiFiReset()
         sleep 1
         /etc/init.d/tiwifi stop
         sleep 1
-        /etc/init.d/tiwifi start && exit 0
+        /etc/init.d/tiwifi start && MarkRadioUser ${RADIO_USER} && exit 0
     done
     exit 127
 }
@@ -63,8 +126,15 @@ WiFiReset()
 case ${CMD} in
   WIFI_START)
     echo "WIFI_START"
+    # $2: User of the radio, AP or CLIENT
+    RADIO_USER=$2
+    # The radio is already started by its other user
+    if IsRadioShared ${RADIO_USER} && [ -e /sys/class/net/${IFACE} ]; then
+        MarkRadioUser ${RADIO_USER}
+        exit 0
+    fi
     # Mount the WiFi network interface
-    /etc/init.d/tiwifi start && exit 0
+    /etc/init.d/tiwifi start && MarkRadioUser ${RADIO_USER} && exit 0
     # Store failure reason
     FAILUREREASON=$?
     # If tiwifi.sh indicates firmware fails to boot, do reset
@@ -85,20 +155,44 @@ case ${CMD} in
 
   WIFI_STOP)
     echo "WIFI_STOP"
+    # $2: User of the radio, AP or CLIENT
+    RADIO_USER=$2
     # If wpa_supplicant is still running, terminate it
-    (/bin/ps -ax | grep wpa_supplicant | grep ${IFACE} >/dev/null 2>&1) \
-    && /sbin/wpa_cli -i${IFACE} terminate
+    [ "${RADIO_USER}" = "AP" ] || \
+    ((/bin/ps -ax | grep wpa_supplicant | grep ${IFACE} >/dev/null 2>&1) \
+    && /sbin/wpa_cli -i${IFACE} terminate)
+    [ -z "${RADIO_USER}" ] || rm -f ${RADIO_USERS}${RADIO_USER}
+    # The radio is still used by its other user
+    IsRadioShared ${RADIO_USER} && exit 0
     # Unmount the WiFi network interface
     /etc/init.d/tiwifi stop || exit 127
+    rm -f ${RADIO_USERS}*
     exit 0 ;;
 
   WIFI_SET_EVENT)
     echo "WIFI_SET_EVENT"
+    # $2: User of the events, AP or CLIENT, to stop them apart from the ones of the other user
+    if [ -n "$2" ]; then
+        echo $$ > /tmp/wifi_event_$2.pid
+        exec /usr/sbin/iw event
+    fi
     /usr/sbin/iw event || exit 127
     exit 0 ;;
 
+  WIFI_GET_INTERFACES)
+    echo "WIFI_GET_INTERFACES"
+    # WiFi interfaces of all the radios, listed by radio
+    /usr/sbin/iw dev || exit 127
+    exit 0 ;;
+
   WIFI_UNSET_EVENT)
     echo "WIFI_UNSET_EVENT"
+    if [ -n "$2" ]; then
+        [ -f /tmp/wifi_event_$2.pid ] || exit 0
+        /bin/kill -9 $(cat /tmp/wifi_event_$2.pid)
+        rm -f /tmp/wifi_event_$2.pid
+        exit 0
+    fi
     count=$(/usr/bin/pgrep -c iw)
     [ "${count}" -eq 0 ] && exit 0
     for i in $(seq 1 ${count})
@@ -125,35 +219,73 @@ case ${CMD} in
 
   WIFIAP_HOSTAPD_START)
     echo "WIFIAP_HOSTAPD_START"
-    (/bin/hostapd /tmp/hostapd.conf -i${IFACE} -B) && exit 0
-    # Fail to start hostapd, do cleanup
-    /etc/init.d/tiwifi stop
+    (/bin/hostapd /tmp/hostapd.conf -i${AP_IFACE} -B) && exit 0
+    # Fail to start hostapd, do cleanup unless the station uses the radio
+    rm -f ${RADIO_USERS}AP
+    IsRadioShared AP || /etc/init.d/tiwifi stop
     exit 127 ;;
 
   WIFIAP_HOSTAPD_STOP)
     echo "WIFIAP_HOSTAPD_STOP"
-    rm -f /tmp/dnsmasq.wlan.conf
-    touch /tmp/dnsmasq.wlan.conf
-    /etc/init.d/dnsmasq stop
     killall hostapd
     sleep 1;
     pidof hostapd && (kill -9 `pidof hostapd` || exit 127)
-    pidof dnsmasq && (kill -9 `pidof dnsmasq` || exit 127)
-    /etc/init.d/dnsmasq start || exit 127
     exit 0 ;;
 
   WIFIAP_WLAN_UP)
     echo "WIFIAP_WLAN_UP"
     AP_IP=$2
-    /sbin/ifconfig | grep ${IFACE} || exit 127
-    /sbin/ifconfig ${IFACE} ${AP_IP} up || exit 127
+    # Interface of an additional BSS, the main one by default
+    AP_IFACE=${3:-${AP_IFACE}}
+    /sbin/ifconfig | grep ${AP_IFACE} || exit 127
+    /sbin/ifconfig ${AP_IFACE} ${AP_IP} up || exit 127
+    exit 0 ;;
+
+  WIFIAP_GET_STATIONS)
+    echo "WIFIAP_GET_STATIONS"
+    /usr/sbin/iw dev ${AP_IFACE} station dump || exit 127
+    exit 0 ;;
+
+  WIFIAP_GET_PHY_INFO)
+    echo "WIFIAP_GET_PHY_INFO"
+    /usr/sbin/iw phy $(cat /sys/class/net/${IFACE}/phy80211/name) info || exit 127
+    exit 0 ;;
+
+  WIFIAP_CHANNEL_SURVEY)
+    echo "WIFIAP_CHANNEL_SURVEY"
+    /sbin/ifconfig ${IFACE} up || exit 127
+    # The scan refreshes the survey of the channels other than the current one
+    /usr/sbin/iw dev ${IFACE} scan ap-force | grep '^BSS\|freq:'
+    /usr/sbin/iw dev ${IFACE} survey dump || exit 127
     exit 0 ;;
 
-  DNSMASQ_RESTART)
-    echo "interface=${IFACE}" >> /tmp/dnsmasq.wlan.conf
-    /etc/init.d/dnsmasq stop
-    pkill -9 dnsmasq
-    /etc/init.d/dnsmasq start || exit 127
+  WIFIAP_SET_ANTENNA)
+    echo "WIFIAP_SET_ANTENNA"
+    ANTENNA_MASK=$2
+    /sbin/ifconfig ${IFACE} down
+    /usr/sbin/iw phy $(cat /sys/class/net/${IFACE}/phy80211/name) set antenna ${ANTENNA_MASK} || exit 127
+    exit 0 ;;
+
+  WIFIAP_VIF_ADD)
+    echo "WIFIAP_VIF_ADD"
+    [ -e /sys/class/net/${AP_VIFACE} ] && exit 0
+    # Virtual interface of the access point on the radio of the station, with a locally
+    # administered MAC address derived from the one of the station
+    MAC=$(cat /sys/class/net/${IFACE}/address)
+    /usr/sbin/iw dev ${IFACE} interface add ${AP_VIFACE} type __ap || exit 127
+    /sbin/ip link set ${AP_VIFACE} address 02:${MAC#*:} || exit 127
+    exit 0 ;;
+
+  WIFIAP_VIF_DEL)
+    echo "WIFIAP_VIF_DEL"
+    [ -e /sys/class/net/${AP_VIFACE} ] || exit 0
+    /usr/sbin/iw dev ${AP_VIFACE} del || exit 127
+    exit 0 ;;
+
+  WIFIAP_GET_STA_FREQUENCY)
+    echo "WIFIAP_GET_STA_FREQUENCY"
+    # Frequency of the station, if connected, which the concurrent access point must share
+    /usr/sbin/iw dev ${IFACE} link | grep 'freq:'
     exit 0 ;;
 
   WIFICLIENT_START_SCAN)
@@ -161,6 +293,14 @@ case ${CMD} in
     (/usr/sbin/iw dev ${IFACE} scan | grep 'BSS\|SSID\|signal') || exit 127
     exit 0 ;;
 
+  WIFICLIENT_START_SCAN_SSID)
+    echo "WIFICLIENT_START_SCAN_SSID"
+    SSID=$2
+    [ -n "${SSID}" ] || exit 127
+    # Probe the given SSID only
+    (/usr/sbin/iw dev ${IFACE} scan ssid "${SSID}" | grep 'BSS\|SSID\|signal') || exit 127
+    exit 0 ;;
+
   WIFICLIENT_CONNECT)
     echo "WIFICLIENT_CONNECT"
     WPA_CFG=$2
@@ -176,15 +316,206 @@ case ${CMD} in
     echo "WiFi client disconnected."
     exit 0 ;;
 
+  WIFICLIENT_ROAM)
+    echo "WIFICLIENT_ROAM"
+    BSSID=$2
+    [ -n "${BSSID}" ] || exit 127
+    /sbin/wpa_cli -i${IFACE} roam ${BSSID} | grep OK || exit 127
+    CheckRoam ${IFACE} ${BSSID} ;;
+
+  WIFICLIENT_GET_LINK_SIGNAL)
+    echo "WIFICLIENT_GET_LINK_SIGNAL"
+    /usr/sbin/iw dev ${IFACE} link || exit 127
+    exit 0 ;;
+
+  WIFICLIENT_GET_STATION_INFO)
+    echo "WIFICLIENT_GET_STATION_INFO"
+    /usr/sbin/iw dev ${IFACE} station dump || exit 127
+    exit 0 ;;
+
+  WIFICLIENT_SET_CQM)
+    echo "WIFICLIENT_SET_CQM"
+    # $2: RSSI threshold in dBm or "off", $3: hysteresis in dB
+    [ -n "$2" ] || exit 127
+    /usr/sbin/iw dev ${IFACE} cqm rssi $2 $3 || exit 127
+    exit 0 ;;
+
+  WIFICLIENT_SET_IP)
+    echo "WIFICLIENT_SET_IP"
+    # $2: interface, $3: address, $4: netmask, $5: gateway, $6: DNS server
+    [ -n "$3" ] || exit 127
+    /sbin/ifconfig $2 $3 netmask $4 up || exit 127
+    if [ "$5" != "0.0.0.0" ]; then
+        while /sbin/route del default dev $2 2>/dev/null; do :; done
+        /sbin/route add default gw $5 dev $2 || exit 127
+    fi
+    [ "$6" = "0.0.0.0" ] || echo "nameserver $6" > /etc/resolv.conf
+    exit 0 ;;
+
+  WIFICLIENT_CLEAR_IP)
+    echo "WIFICLIENT_CLEAR_IP"
+    # $2: interface
+    [ -n "$2" ] || exit 127
+    while /sbin/route del default dev $2 2>/dev/null; do :; done
+    /sbin/ifconfig $2 0.0.0.0 || exit 127
+    exit 0 ;;
+
+  WIFIAP_BRIDGE_START)
+    echo "WIFIAP_BRIDGE_START"
+    UPLINK=$2
+    [ -n "${UPLINK}" ] || exit 127
+    # hostapd adds the WiFi interface to the bridge set in hostapd.conf
+    /sbin/ip link show ${BRIDGE} > /dev/null 2>&1 || \
+     /sbin/ip link add name ${BRIDGE} type bridge || exit 127
+    /sbin/ip link set ${UPLINK} master ${BRIDGE} || exit 127
+    /sbin/ip link set ${UPLINK} up || exit 127
+    /sbin/ip link set ${BRIDGE} up || exit 127
+    exit 0 ;;
+
+  WIFIAP_BRIDGE_STOP)
+    echo "WIFIAP_BRIDGE_STOP"
+    UPLINK=$2
+    [ -n "${UPLINK}" ] && /sbin/ip link set ${UPLINK} nomaster
+    /sbin/ip link del ${BRIDGE} || exit 127
+    exit 0 ;;
+
+  WIFIAP_NAT_START)
+    echo "WIFIAP_NAT_START"
+    UPLINK=$2
+    [ -n "${UPLINK}" ] || exit 127
+    echo 1 > /proc/sys/net/ipv4/ip_forward || exit 127
+    /usr/sbin/iptables -t nat -I POSTROUTING -o ${UPLINK} -j MASQUERADE || exit 127
+    /usr/sbin/iptables -I FORWARD -i ${UPLINK} -o ${AP_IFACE}+ -m state \
+     --state RELATED,ESTABLISHED -j ACCEPT || exit 127
+    /usr/sbin/iptables -I FORWARD -i ${AP_IFACE}+ -o ${UPLINK} -j ACCEPT || exit 127
+    exit 0 ;;
+
+  WIFIAP_NAT_STOP)
+    echo "WIFIAP_NAT_STOP"
+    UPLINK=$2
+    [ -n "${UPLINK}" ] || exit 127
+    /usr/sbin/iptables -t nat -D POSTROUTING -o ${UPLINK} -j MASQUERADE || exit 127
+    /usr/sbin/iptables -D FORWARD -i ${UPLINK} -o ${AP_IFACE}+ -m state \
+     --state RELATED,ESTABLISHED -j ACCEPT || exit 127
+    /usr/sbin/iptables -D FORWARD -i ${AP_IFACE}+ -o ${UPLINK} -j ACCEPT || exit 127
+    exit 0 ;;
+
+  WIFIAP_NAT_OFFLOAD_START)
+    echo "WIFIAP_NAT_OFFLOAD_START"
+    UPLINK=$2
+    [ -n "${UPLINK}" ] || exit 127
+    # Established flows bypass the netfilter hooks, NAT included, through the flowtable
+    /usr/sbin/nft add table inet ${NFT_TABLE} || exit 127
+    /usr/sbin/nft add flowtable inet ${NFT_TABLE} ft \
+     "{ hook ingress priority 0; devices = { ${AP_IFACE}, ${UPLINK} }; }" || exit 127
+    /usr/sbin/nft add chain inet ${NFT_TABLE} forward \
+     "{ type filter hook forward priority 0; policy accept; }" || exit 127
+    /usr/sbin/nft add rule inet ${NFT_TABLE} forward \
+     meta l4proto { tcp, udp } flow add @ft || exit 127
+    exit 0 ;;
+
+  WIFIAP_NAT_OFFLOAD_STOP)
+    echo "WIFIAP_NAT_OFFLOAD_STOP"
+    /usr/sbin/nft delete table inet ${NFT_TABLE} || exit 127
+    exit 0 ;;
+
+  WIFIAP_NAT_STATS)
+    echo "WIFIAP_NAT_STATS"
+    echo "rx bytes: $(cat /sys/class/net/${AP_IFACE}/statistics/rx_bytes)"
+    echo "tx bytes: $(cat /sys/class/net/${AP_IFACE}/statistics/tx_bytes)"
+    echo "offloaded flows: $(grep -c OFFLOAD /proc/net/nf_conntrack 2> /dev/null)"
+    exit 0 ;;
+
+  WIFIAP_SHAPING_START)
+    echo "WIFIAP_SHAPING_START"
+    # The mq root keeps the queue of each access category (WMM). An HTB without default class is
+    # attached to each queue: the stations without a rate limit are not shaped
+    /sbin/tc qdisc replace dev ${AP_IFACE} root handle 1: mq || exit 127
+    for AC in $(seq 1 $(ls -d /sys/class/net/${AP_IFACE}/queues/tx-* | wc -l))
+    do
+        /sbin/tc qdisc replace dev ${AP_IFACE} parent 1:${AC} handle 1${AC}: htb || exit 127
+    done
+    /sbin/tc qdisc replace dev ${AP_IFACE} handle ffff: ingress || exit 127
+    exit 0 ;;
+
+  WIFIAP_SHAPING_STOP)
+    echo "WIFIAP_SHAPING_STOP"
+    /sbin/tc qdisc del dev ${AP_IFACE} root
+    /sbin/tc qdisc del dev ${AP_IFACE} ingress
+    exit 0 ;;
+
+  WIFIAP_SET_STA_RATE)
+    echo "WIFIAP_SET_STA_RATE"
+    # $2: Slot of the station from 1, $3: MAC address of the station,
+    # $4: Downlink and $5: uplink rates in kbit/s, 0 for no limit
+    SLOT=$2
+    MINOR=$(printf '%x' ${SLOT})
+    # Remove the previous limits of the slot
+    /sbin/tc filter del dev ${AP_IFACE} parent ffff: prio ${SLOT} 2> /dev/null
+    # The downlink is shaped in the HTB of each access category, each one up to the rate
+    for AC in $(seq 1 $(ls -d /sys/class/net/${AP_IFACE}/queues/tx-* | wc -l))
+    do
+        /sbin/tc filter del dev ${AP_IFACE} parent 1${AC}: prio ${SLOT} 2> /dev/null
+        /sbin/tc class del dev ${AP_IFACE} classid 1${AC}:${MINOR} 2> /dev/null
+        if [ "$4" -ne 0 ]; then
+            /sbin/tc class add dev ${AP_IFACE} parent 1${AC}: classid 1${AC}:${MINOR} htb \
+             rate $4kbit ceil $4kbit || exit 127
+            /sbin/tc filter add dev ${AP_IFACE} parent 1${AC}: protocol all prio ${SLOT} \
+             u32 match ether dst $3 flowid 1${AC}:${MINOR} || exit 127
+        fi
+    done
+    if [ "$5" -ne 0 ]; then
+        # Burst of 100 ms of traffic, at least 16 kB
+        BURST=$(( $5 * 100 / 8 ))
+        [ ${BURST} -lt 16000 ] && BURST=16000
+        /sbin/tc filter add dev ${AP_IFACE} parent ffff: protocol all prio ${SLOT} \
+         u32 match ether src $3 police rate $5kbit burst ${BURST} drop flowid :1 || exit 127
+    fi
+    exit 0 ;;
+
+  WIFIAP_GET_STA_SHAPING_STATS)
+    echo "WIFIAP_GET_STA_SHAPING_STATS"
+    # $2: Slot of the station from 1
+    SLOT=$2
+    # "Sent 0 bytes 0 pkt (dropped 0, overlimits 0 requeues 0)", "backlog 0b 0p requeues 0",
+    # the sizes being possibly given in Kb or Mb, summed over the classes of the access categories
+    for AC in $(seq 1 $(ls -d /sys/class/net/${AP_IFACE}/queues/tx-* | wc -l))
+    do
+        /sbin/tc -s class show dev ${AP_IFACE} classid 1${AC}:$(printf '%x' ${SLOT})
+    done | awk '
+        / Sent / { dropped += $7 }
+        / backlog / { size = $2; unit = 1;
+                      if (size ~ /Kb$/) unit = 1024; if (size ~ /Mb$/) unit = 1048576;
+                      bytes += (size + 0) * unit; packets += $3 }
+        END { print "tx dropped: " dropped + 0;
+              printf "tx backlog: %d %d\n", bytes, packets }' || exit 127
+    /sbin/tc -s filter show dev ${AP_IFACE} parent ffff: prio ${SLOT} | awk '
+        / Sent / { print "rx dropped: " $7 + 0 }' || exit 127
+    exit 0 ;;
+
+  WIFIAP_SET_AIRTIME_FAIRNESS)
+    echo "WIFIAP_SET_AIRTIME_FAIRNESS"
+    # $2: 1 to share the airtime fairly between the stations, for transmission and reception
+    FLAGS=/sys/kernel/debug/ieee80211/$(cat /sys/class/net/${IFACE}/phy80211/name)/airtime_flags
+    [ -w ${FLAGS} ] || exit 127
+    if [ "$2" = "1" ]; then
+        echo 3 > ${FLAGS} || exit 127
+    else
+        echo 0 > ${FLAGS} || exit 127
+    fi
+    exit 0 ;;
+
   IPTABLE_DHCP_INSERT)
     echo "IPTABLE_DHCP_INSERT"
-    /usr/sbin/iptables -I INPUT -i ${IFACE} -p udp -m udp \
+    DHCP_IFACE=${2:-${AP_IFACE}}
+    /usr/sbin/iptables -I INPUT -i ${DHCP_IFACE} -p udp -m udp \
      --sport 67:68 --dport 67:68 -j ACCEPT  || exit 127
     exit 0 ;;
 
   IPTABLE_DHCP_DELETE)
     echo "IPTABLE_DHCP_DELETE"
-    /usr/sbin/iptables -D INPUT -i ${IFACE} -p udp -m udp \
+    DHCP_IFACE=${2:-${AP_IFACE}}
+    /usr/sbin/iptables -D INPUT -i ${DHCP_IFACE} -p udp -m udp \
      --sport 67:68 --dport 67:68 -j ACCEPT  || exit 127
     exit 0 ;;
 